@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationprofiler.h
+// ============
+// count the heap allocations of each frame by profile zone
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+
+/***********************************************************
+ *  AllocationProfiler
+ *
+ *  This class counts the calls to the global operator new
+ *  made between BeginFrame() and EndFrame(), attributed to
+ *  the ProfileZone that was current at each call.  Counting
+ *  needs a build with WORKSPACE_ALLOCATION_PROFILER defined,
+ *  which replaces the global operator new and delete.
+ ***********************************************************/
+class AllocationProfiler
+{
+public:
+	// true when the counting operator new is compiled in
+	static bool IsAvailable();
+
+	// reset the counts and start counting
+	static void BeginFrame();
+	// stop counting and return the allocations since BeginFrame()
+	static unsigned int EndFrame();
+
+	// print the allocations of the last frame by zone
+	static void PrintFrameReport(FILE* output);
+};
@@ -0,0 +1,487 @@
+///////////////////////////////////////////////////////////////////////////////
+// bakedscene.h
+// ============
+// scenes/office.json baked into constexpr tables
+//
+//  Generated by SceneCompiler --cpp, do not edit
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneBake.h"
+
+constexpr int g_BakedTextureCount = 5;
+constexpr SceneBake::BAKED_TEXTURE g_BakedTextures[] =
+{
+	{ "Wood", "C:/Users/NFigu/Pictures/dfc59b634fc228887ca8668526b24100.jpg" },
+	{ "Metal", "C:/Users/NFigu/Pictures/images.jpg" },
+	{ "Magazine Cover", "C:/Users/NFigu/Pictures/download.jpg" },
+	{ "Black Metal", "C:/Users/NFigu/Pictures/d7i46lm-d44c1ab4-227d-4009-9114-e549c1420d21.jpg" },
+	{ "White", "C:/Users/NFigu/Pictures/images (1).jpg" },
+};
+
+constexpr int g_BakedMaterialCount = 4;
+constexpr SceneBake::BAKED_MATERIAL g_BakedMaterials[] =
+{
+	{ "Paper", { 0.8f, 0.8f, 0.8f }, 0.2f, { 0.9f, 0.9f, 0.9f }, { 0.05f, 0.05f, 0.05f }, 10.0f },
+	{ "Wood", { 0.2f, 0.1f, 0.1f }, 0.3f, { 0.6f, 0.4f, 0.2f }, { 0.1f, 0.1f, 0.1f }, 25.0f },
+	{ "Plastic", { 0.1f, 0.1f, 0.1f }, 0.1f, { 0.7f, 0.7f, 0.7f }, { 0.6f, 0.6f, 0.6f }, 30.0f },
+	{ "Metal", { 0.1f, 0.1f, 0.1f }, 0.1f, { 0.7f, 0.7f, 0.7f }, { 1.0f, 1.0f, 1.0f }, 80.0f },
+};
+
+constexpr int g_BakedLightCount = 3;
+constexpr SceneBake::BAKED_LIGHT g_BakedLights[] =
+{
+	{ { -3.0f, 4.0f, 6.0f }, { 0.1f, 0.1f, 0.1f }, { 0.7f, 0.7f, 0.6f }, { 0.1f, 0.1f, 0.1f }, 15.0f, 0.1f, 12.0f },
+	{ { 3.0f, 4.0f, 6.0f }, { 0.1f, 0.1f, 0.1f }, { 0.7f, 0.7f, 0.6f }, { 0.1f, 0.1f, 0.1f }, 15.0f, 0.1f, 12.0f },
+	{ { 0.0f, 3.0f, 20.0f }, { 0.2f, 0.2f, 0.2f }, { 0.8f, 0.8f, 0.8f }, { 0.1f, 0.1f, 0.1f }, 12.0f, 0.1f, 25.0f },
+};
+
+constexpr int g_BakedDrawCount = 44;
+constexpr SceneBake::BAKED_DRAW g_BakedDraws[] =
+{
+	// floor
+	{
+		SceneBake::GetModelMatrix(
+			85.0f, 1.0f, 200.0f,
+			0.0f, 0.0f, 0.0f,
+			0.0f, -32.0f, -200.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		0, 0, 1, 14u
+	},
+	// handle_mug
+	{
+		SceneBake::GetModelMatrix(
+			0.35f, 0.35f, 0.4f,
+			0.0f, 0.0f, 0.0f,
+			-11.3f, -8.85f, -33.4f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		3, 4, 3, 6u
+	},
+	// lip_mug
+	{
+		SceneBake::GetModelMatrix(
+			0.55f, 0.55f, 0.4f,
+			90.0f, 0.0f, 0.0f,
+			-10.5f, -8.4f, -33.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		3, 4, 3, 0u
+	},
+	// monitor_stand
+	{
+		SceneBake::GetModelMatrix(
+			0.25f, 2.3f, 0.25f,
+			0.0f, 0.0f, 0.0f,
+			7.7f, -9.6f, -30.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 1, 3, 2u
+	},
+	// mug
+	{
+		SceneBake::GetModelMatrix(
+			0.6f, 1.0f, 0.6f,
+			0.0f, 0.0f, 0.0f,
+			-10.5f, -9.4f, -33.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 4, 3, 2u
+	},
+	// middle_dish
+	{
+		SceneBake::GetModelMatrix(
+			0.75f, 0.75f, 0.3f,
+			90.0f, 0.0f, 0.0f,
+			-10.5f, -9.38f, -33.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		3, 4, 3, 0u
+	},
+	// left_monitor_leg
+	{
+		SceneBake::GetModelMatrix(
+			2.2f, 0.3f, 0.2f,
+			0.0f, -125.0f, 0.0f,
+			8.9f, -9.6f, -31.8f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 1, 3, 2u
+	},
+	// right_monitor_leg
+	{
+		SceneBake::GetModelMatrix(
+			2.2f, 0.3f, 0.2f,
+			0.0f, 3.0f, 0.0f,
+			5.7f, -9.6f, -29.9f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 1, 3, 0u
+	},
+	// bottom_dish
+	{
+		SceneBake::GetModelMatrix(
+			0.6f, 0.6f, 0.4f,
+			90.0f, 0.0f, 0.0f,
+			-10.5f, -9.5f, -33.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		3, 4, 3, 2u
+	},
+	// mouse
+	{
+		SceneBake::GetModelMatrix(
+			0.65f, 0.75f, 0.65f,
+			0.0f, 30.0f, 90.0f,
+			-3.0f, -9.4f, -38.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 4, 2, 4u
+	},
+	// player
+	{
+		SceneBake::GetModelMatrix(
+			3.15f, 2.5f, 2.65f,
+			0.0f, 30.0f, 0.0f,
+			-4.3f, -8.5f, -23.2f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 4, 2, 0u
+	},
+	// right_book_end
+	{
+		SceneBake::GetModelMatrix(
+			2.6f, 1.0f, 1.5f,
+			0.0f, 30.0f, 90.0f,
+			18.14f, -7.8f, -36.48f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 6u
+	},
+	// 5th_left_book_end
+	{
+		SceneBake::GetModelMatrix(
+			3.0f, 1.0f, 1.5f,
+			0.0f, 30.0f, 90.0f,
+			20.0f, -7.4f, -37.6f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 0u
+	},
+	// 4th_left_book_end
+	{
+		SceneBake::GetModelMatrix(
+			2.4f, 1.0f, 1.2f,
+			0.0f, 30.0f, 90.0f,
+			20.5f, -7.6f, -37.9f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 0u
+	},
+	// 3rd_left_book_end
+	{
+		SceneBake::GetModelMatrix(
+			2.0f, 1.0f, 1.0f,
+			0.0f, 30.0f, 90.0f,
+			20.9f, -7.8f, -38.1f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 0u
+	},
+	// 2nd_left_book_end
+	{
+		SceneBake::GetModelMatrix(
+			1.6f, 1.0f, 0.8f,
+			0.0f, 30.0f, 90.0f,
+			21.3f, -8.2f, -38.4f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 0u
+	},
+	// 1st_left_book_end
+	{
+		SceneBake::GetModelMatrix(
+			1.2f, 1.0f, 0.6f,
+			0.0f, 30.0f, 90.0f,
+			21.8f, -8.6f, -38.7f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 0, 1, 0u
+	},
+	// right_standing_book
+	{
+		SceneBake::GetModelMatrix(
+			6.5f, 1.0f, 3.5f,
+			0.0f, 30.0f, 90.0f,
+			18.14f, -6.5f, -36.48f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, -1, 1, 1u
+	},
+	// left_standing_book
+	{
+		SceneBake::GetModelMatrix(
+			6.5f, 1.0f, 3.5f,
+			0.0f, 30.0f, 90.0f,
+			19.0f, -6.5f, -37.0f),
+		{ 0.6706f, 0.8588f, 0.8902f, 1.0f }, { 1.0f, 1.0f },
+		1, -1, 1, 1u
+	},
+	// back_right_book
+	{
+		SceneBake::GetModelMatrix(
+			6.5f, 1.4f, 3.5f,
+			0.0f, 30.0f, 0.0f,
+			-4.0f, -9.5f, -23.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, -1, 1, 1u
+	},
+	// monitor
+	{
+		SceneBake::GetModelMatrix(
+			14.0f, 0.3f, 8.5f,
+			90.0f, 0.0f, -30.0f,
+			7.75f, -3.0f, -30.2f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 2, 2, 6u
+	},
+	// keyboard
+	{
+		SceneBake::GetModelMatrix(
+			7.0f, 0.3f, 3.0f,
+			0.0f, 30.0f, 0.0f,
+			2.0f, -9.5f, -41.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 4, 2, 2u
+	},
+	// desktop
+	{
+		SceneBake::GetModelMatrix(
+			35.0f, 0.8f, 18.0f,
+			0.0f, 30.0f, 0.0f,
+			5.0f, -10.0f, -35.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 0, 1, 6u
+	},
+	// drawer_compartment
+	{
+		SceneBake::GetModelMatrix(
+			10.0f, 4.5f, 14.3f,
+			0.0f, 30.0f, 0.0f,
+			14.5f, -12.0f, -40.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 0, 1, 0u
+	},
+	// physical_drawer_bottom
+	{
+		SceneBake::GetModelMatrix(
+			3.8f, 1.0f, 4.0f,
+			0.0f, 30.0f, 0.0f,
+			10.1f, -14.2f, -48.95f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		0, 0, 1, 0u
+	},
+	// magazine_drawer
+	{
+		SceneBake::GetModelMatrix(
+			2.8f, 1.0f, 3.7f,
+			0.0f, 30.0f, 0.0f,
+			10.0f, -14.1f, -48.95f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		0, 2, 0, 6u
+	},
+	// left_pen_drawer
+	{
+		SceneBake::GetModelMatrix(
+			0.2f, 3.0f, 0.2f,
+			90.0f, 0.0f, -30.0f,
+			9.0f, -13.8f, -51.7f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 4, 2, 6u
+	},
+	// right_pen_drawer
+	{
+		SceneBake::GetModelMatrix(
+			0.2f, 3.0f, 0.2f,
+			90.0f, 0.0f, -65.0f,
+			7.1f, -13.8f, -50.7f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		2, 4, 2, 0u
+	},
+	// right_side_drawer
+	{
+		SceneBake::GetModelMatrix(
+			8.0f, 2.5f, 0.8f,
+			0.0f, 120.0f, 0.0f,
+			6.75f, -13.0f, -47.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 0, 1, 6u
+	},
+	// left_side_drawer
+	{
+		SceneBake::GetModelMatrix(
+			8.0f, 2.5f, 0.8f,
+			0.0f, 120.0f, 0.0f,
+			13.0f, -13.0f, -51.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 0, 1, 0u
+	},
+	// drawer_track
+	{
+		SceneBake::GetModelMatrix(
+			8.3f, 0.5f, 0.1f,
+			0.0f, 120.0f, 0.0f,
+			13.5f, -13.8f, -51.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 1, 3, 6u
+	},
+	// drawer_front
+	{
+		SceneBake::GetModelMatrix(
+			9.0f, 3.5f, 0.8f,
+			0.0f, 30.0f, 0.0f,
+			8.1f, -12.5f, -52.5f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 0, 1, 6u
+	},
+	// back_right_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			-5.0f, -20.99f, -22.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 6u
+	},
+	// middle_back_right_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			3.0f, -20.99f, -26.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// front_right_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			-12.0f, -20.99f, -34.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// middle_left_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			19.5f, -20.99f, -42.8f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// front_middle_left_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			6.47f, -20.99f, -43.55f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// back_left_leg_desk
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 22.0f, 1.0f,
+			0.0f, 30.0f, 0.0f,
+			13.0f, -20.99f, -32.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// top_front_cross_beam
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 21.0f, 1.0f,
+			0.0f, 30.0f, 90.0f,
+			-3.0f, -11.0f, -38.4f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// bottom_left_leg_cross_beam
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 10.65f, 1.0f,
+			0.0f, 30.0f, 90.0f,
+			14.8f, -29.0f, -40.2f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// bottom_right_leg_cross_beam
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 13.5f, 1.0f,
+			0.0f, 120.0f, 90.0f,
+			9.645f, -29.0f, -38.0f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// far_back_right_bottom_leg_cross_beam
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 8.75f, 1.0f,
+			0.0f, 30.0f, 90.0f,
+			-0.75f, -29.0f, -24.25f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// second_bottom_left_leg_cross_beam
+	{
+		SceneBake::GetModelMatrix(
+			1.0f, 13.9f, 1.0f,
+			0.0f, 120.0f, 90.0f,
+			-8.2f, -29.0f, -27.6f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 3, 3, 0u
+	},
+	// computer
+	{
+		SceneBake::GetModelMatrix(
+			10.0f, 18.0f, 5.0f,
+			0.0f, 120.0f, 0.0f,
+			-4.7f, -29.0f, -30.2f),
+		{ 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f },
+		1, 4, 3, 2u
+	},
+};
+
+constexpr const char* g_BakedDrawIDs[] =
+{
+	"floor",
+	"handle_mug",
+	"lip_mug",
+	"monitor_stand",
+	"mug",
+	"middle_dish",
+	"left_monitor_leg",
+	"right_monitor_leg",
+	"bottom_dish",
+	"mouse",
+	"player",
+	"right_book_end",
+	"5th_left_book_end",
+	"4th_left_book_end",
+	"3rd_left_book_end",
+	"2nd_left_book_end",
+	"1st_left_book_end",
+	"right_standing_book",
+	"left_standing_book",
+	"back_right_book",
+	"monitor",
+	"keyboard",
+	"desktop",
+	"drawer_compartment",
+	"physical_drawer_bottom",
+	"magazine_drawer",
+	"left_pen_drawer",
+	"right_pen_drawer",
+	"right_side_drawer",
+	"left_side_drawer",
+	"drawer_track",
+	"drawer_front",
+	"back_right_leg_desk",
+	"middle_back_right_leg_desk",
+	"front_right_leg_desk",
+	"middle_left_leg_desk",
+	"front_middle_left_leg_desk",
+	"back_left_leg_desk",
+	"top_front_cross_beam",
+	"bottom_left_leg_cross_beam",
+	"bottom_right_leg_cross_beam",
+	"far_back_right_bottom_leg_cross_beam",
+	"second_bottom_left_leg_cross_beam",
+	"computer",
+};
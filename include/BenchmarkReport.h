@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarkreport.h
+// ============
+// collect per-frame benchmark samples and write them as a JSON report
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  BenchmarkReport
+ *
+ *  This class collects the frame time and draw calls of every
+ *  benchmarked frame, grouped by workload (scene), and writes
+ *  the raw samples with a summary to a JSON file.
+ ***********************************************************/
+class BenchmarkReport
+{
+public:
+	struct SCENE_SAMPLES
+	{
+		std::string name;
+		std::vector<float> frameMs;
+		std::vector<int> drawCalls;
+	};
+
+	// set the renderer string that the samples were taken on
+	void SetRenderer(const char* renderer);
+	// reserve room for the samples of the named scene, so that
+	// adding frames does not allocate while benchmarking
+	void ReserveFrames(const std::string& scene, size_t frames);
+	// add the samples of one frame to the named scene
+	void AddFrame(const std::string& scene, float frameMs, int drawCalls);
+	// print the summary of every scene to the console
+	void PrintSummary() const;
+	// write the samples and summary as a JSON file
+	bool WriteJSON(const std::string& filename) const;
+
+private:
+	// find the samples of the named scene, adding it when new
+	SCENE_SAMPLES& FindScene(const std::string& scene);
+
+	std::string m_renderer;
+	std::vector<SCENE_SAMPLES> m_scenes;
+};
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugdraw.h
+// ============
+// batched debug lines for bounds, frusta and light volumes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+#include <cstdint>
+
+/***********************************************************
+ *  DebugDraw
+ *
+ *  This class collects debug lines and shapes added during
+ *  the frame into a persistently mapped vertex buffer, and
+ *  draws them all with one line draw at the end of the frame.
+ *  Each shape belongs to a category that can be toggled, F5
+ *  to F8 switch the categories and F9 freezes the frustum.
+ ***********************************************************/
+class DebugDraw
+{
+public:
+	enum DEBUG_CATEGORY
+	{
+		// bounding box of every draw of the frame packet
+		CATEGORY_BOUNDS,
+		// the camera frustum frozen when it was switched on
+		CATEGORY_FRUSTUM,
+		// the position and radius of every light
+		CATEGORY_LIGHTS,
+		// shapes added by other code while tuning
+		CATEGORY_USER,
+		CATEGORY_COUNT
+	};
+
+	// show or hide the shapes of a category
+	static void SetCategory(DEBUG_CATEGORY category, bool bEnable);
+	static bool IsCategoryEnabled(DEBUG_CATEGORY category);
+	// whether any category is shown
+	static bool IsEnabled();
+	// toggle categories and freeze the frustum from the function keys
+	static void ProcessKeys(GLFWwindow* pWindow);
+
+	// printable name of a category, as used on the command line
+	static const char* GetCategoryName(DEBUG_CATEGORY category);
+	static bool FindCategory(const char* name, DEBUG_CATEGORY& category);
+
+	// add shapes to the current frame, colors are 0xRRGGBBAA
+	static void Line(DEBUG_CATEGORY category, const glm::vec3& from, const glm::vec3& to, uint32_t color);
+	static void Box(DEBUG_CATEGORY category, const glm::mat4& transform, const glm::vec3& boundsMin, const glm::vec3& boundsMax, uint32_t color);
+	static void Sphere(DEBUG_CATEGORY category, const glm::vec3& center, float radius, uint32_t color);
+	static void Frustum(DEBUG_CATEGORY category, const glm::mat4& viewProjection, uint32_t color);
+	static void Cross(DEBUG_CATEGORY category, const glm::vec3& center, float size, uint32_t color);
+
+	// add the bounds, frustum and lights of the rendered scene
+	static void AddSceneShapes(SceneManager* pSceneManager, ViewManager* pViewManager);
+	// draw the shapes of the frame with one draw and start a new frame
+	static void Flush(ViewManager* pViewManager);
+	// free the OpenGL objects, the context must still exist
+	static void Destroy();
+
+	// vertices dropped because the frame's region was full
+	static unsigned long GetDroppedVertices();
+};
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviews.h
+// ============
+// heatmap render modes and pipeline statistics for finding wasted shading
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/***********************************************************
+ *  DebugViews
+ *
+ *  This class replaces the shaded frame with a heatmap of the
+ *  overdraw, of the lights reaching each pixel, or of the
+ *  screen size of the triangles, drawn from the geometry of
+ *  the frame packet with its own shaders.  It also measures
+ *  the shaded pass with pipeline statistics queries.  Views
+ *  are selected with F1 to F4 and F12 exports the frame.
+ ***********************************************************/
+class DebugViews
+{
+public:
+	enum DEBUG_VIEW
+	{
+		VIEW_SHADED,
+		VIEW_OVERDRAW,
+		VIEW_LIGHT_COUNT,
+		VIEW_TRIANGLE_DENSITY,
+		VIEW_COUNT
+	};
+
+	// pipeline statistics of the shaded pass
+	enum PIPELINE_STATISTIC
+	{
+		STAT_VERTICES_SUBMITTED,
+		STAT_PRIMITIVES_SUBMITTED,
+		STAT_CLIPPING_INPUT_PRIMITIVES,
+		STAT_CLIPPING_OUTPUT_PRIMITIVES,
+		STAT_FRAGMENT_SHADER_INVOCATIONS,
+		STAT_COUNT
+	};
+
+	// select the view drawn over the shaded frame
+	static void SetView(DEBUG_VIEW view);
+	static DEBUG_VIEW GetView();
+	// measure the shaded pass even while no debug view is shown
+	static void EnableStatistics(bool bEnable);
+
+	// switch views and request exports from the function keys
+	static void ProcessKeys(GLFWwindow* pWindow);
+	// export the next rendered frame as a PPM image
+	static void RequestExport(const char* filename);
+
+	// bracket the shaded pass of the frame
+	static void BeginStatistics();
+	static void EndStatistics();
+	// draw the selected view into the back buffer
+	static void Render(SceneManager* pSceneManager, ViewManager* pViewManager);
+	// free the OpenGL objects, the context must still exist
+	static void Destroy();
+
+	// printable name of a view, as used on the command line
+	static const char* GetViewName(DEBUG_VIEW view);
+	static bool FindView(const char* name, DEBUG_VIEW& view);
+
+	// statistics of the last measured frame and their totals
+	static uint64_t GetLastStatistic(PIPELINE_STATISTIC statistic);
+	static uint64_t GetTotalStatistic(PIPELINE_STATISTIC statistic);
+
+	// print the statistics totals
+	static void PrintStatistics(FILE* output);
+	// write the statistics as the members of a JSON object
+	static void WriteJSON(FILE* output, const char* indent);
+};
@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// linear allocator for the transient data of a single frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class hands out memory for data that only lives for
+ *  one frame, such as the frame's draw commands, by bumping
+ *  an offset into a block that is reset when the frame is
+ *  done.  With two buffers, the data of the previous frame
+ *  stays valid while the next one is recorded, for rendering
+ *  that is pipelined by a frame.  Requests that do not fit
+ *  fall back to the heap until the next reset, and raise the
+ *  capacity to what the frame asked for, which each buffer
+ *  takes up when it is next reset, so only the frames that
+ *  first outgrow the buffers touch the heap.
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// constructor
+	FrameArena(size_t bytesPerFrame, int bufferCount);
+	// destructor
+	~FrameArena();
+
+	// allocate memory that is valid until the buffer is reused
+	void* Allocate(size_t bytes, size_t alignment);
+	// move to the next buffer and reset it for a new frame
+	void BeginFrame();
+
+	// bytes used in the current frame
+	size_t GetUsedBytes() const { return(m_offset); }
+	// most bytes used by a single frame so far
+	size_t GetHighWater() const { return(m_highWater); }
+	// bytes available to each frame, grown after an overflow
+	size_t GetCapacity() const { return(m_capacity); }
+	// allocations that did not fit and went to the heap
+	size_t GetOverflowCount() const { return(m_overflowCount); }
+
+	// STL allocator that takes its memory from a FrameArena,
+	// deallocation is a no-op since the frame reset frees all
+	template <typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator(FrameArena* pArena) : m_pArena(pArena) {}
+		template <typename U>
+		Allocator(const Allocator<U>& other) : m_pArena(other.m_pArena) {}
+
+		T* allocate(size_t count)
+		{
+			return(static_cast<T*>(m_pArena->Allocate(count * sizeof(T), alignof(T))));
+		}
+		void deallocate(T*, size_t) {}
+
+		template <typename U>
+		bool operator==(const Allocator<U>& other) const { return(m_pArena == other.m_pArena); }
+		template <typename U>
+		bool operator!=(const Allocator<U>& other) const { return(m_pArena != other.m_pArena); }
+
+		FrameArena* m_pArena;
+	};
+
+private:
+	// one block per buffer, with its size, which lags the
+	// capacity until the buffer is reset
+	std::vector<unsigned char*> m_buffers;
+	std::vector<size_t> m_bufferBytes;
+	// buffer used by the current frame
+	int m_currentBuffer;
+	// next free byte in the current buffer
+	size_t m_offset;
+	size_t m_capacity;
+	size_t m_highWater;
+	// heap blocks of the allocations that did not fit, per buffer
+	std::vector<std::vector<void*>> m_overflow;
+	size_t m_overflowCount;
+	// bytes the current frame took from the heap
+	size_t m_overflowBytes;
+};
+
+// vector whose storage comes from a FrameArena
+template <typename T>
+using FrameVector = std::vector<T, FrameArena::Allocator<T>>;
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// framestats.h
+// ============
+// per-frame statistics shown in the window title and written as JSON
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// GLEW library, ahead of GLFW so GLFW does not pull in gl.h
+#include <GL/glew.h>
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+#include <cstdio>
+
+/***********************************************************
+ *  FrameStats
+ *
+ *  This class collects the frame time and draw calls of every
+ *  frame.  The stats overlay shows the recent averages and
+ *  the tracked memory in the window title, and the totals can
+ *  be written as a JSON report when the application exits.
+ ***********************************************************/
+class FrameStats
+{
+public:
+	// constructor
+	FrameStats();
+
+	// show the overlay in the title of the window
+	void SetOverlayWindow(GLFWwindow* pWindow, const char* baseTitle);
+	// add the measurements of a completed frame
+	void EndFrame(float frameMs, int drawCalls);
+	// set the usage of the per-frame arena for the report
+	void SetArenaUsage(size_t highWater, size_t capacity, size_t overflows);
+	// hand the latest values to the metrics server
+	void PublishMetrics() const;
+	// write the totals and the memory report as JSON
+	bool WriteJSON(const char* filename) const;
+
+private:
+	// window showing the overlay, and its normal title
+	GLFWwindow* m_pWindow;
+	const char* m_baseTitle;
+	// overlay text, kept in place to avoid per-frame allocations
+	char m_overlayText[256];
+
+	// totals since the start of the application
+	unsigned long m_frameCount;
+	double m_totalFrameMs;
+	float m_lastFrameMs;
+	float m_maxFrameMs;
+	int m_lastDrawCalls;
+	// per-frame arena usage
+	size_t m_arenaHighWater;
+	size_t m_arenaCapacity;
+	size_t m_arenaOverflows;
+
+	// sums over the current overlay refresh interval
+	int m_intervalFrames;
+	double m_intervalFrameMs;
+	double m_intervalStart;
+
+	// refresh the overlay text with the interval averages
+	void UpdateOverlay();
+};
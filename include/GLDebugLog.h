@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////////////
+// gldebuglog.h
+// ============
+// capture the driver's KHR_debug messages and attribute them to zones
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+
+/***********************************************************
+ *  GLDebugLog
+ *
+ *  This class installs a KHR_debug message callback that
+ *  counts the driver's messages, such as performance warnings
+ *  about implicit syncs, shader recompiles and buffer
+ *  reallocations.  Messages are deduplicated by source, type
+ *  and id, and the first occurrence of each is kept with the
+ *  profiling zone and frame it came from.
+ ***********************************************************/
+class GLDebugLog
+{
+public:
+	// install the callback, the context should be a debug context
+	static bool Install();
+	// advance the frame number the messages are attributed to
+	static void NextFrame();
+
+	// number of distinct messages and of all messages received
+	static size_t GetMessageCount();
+	static unsigned long GetTotalCount();
+
+	// print every distinct message with its count
+	static void PrintReport(FILE* output);
+	// write the messages as the members of a JSON object
+	static void WriteJSON(FILE* output, const char* indent);
+};
@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+// glhooks.h
+// ============
+// observe the OpenGL calls made through the GLEW function pointers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  GLHooks
+ *
+ *  This class wraps selected GLEW function pointers so that
+ *  buffer allocations made by any code in the process, such
+ *  as the shape meshes, are accounted in the MemoryTracker under
+ *  the current resource tag.
+ ***********************************************************/
+class GLHooks
+{
+public:
+	// wrap the GLEW function pointers, call after glewInit()
+	static void Install();
+
+	// tag used for the resources created until the next call,
+	// NULL restores the default "untagged" tag
+	static void SetResourceTag(const char* tag);
+};
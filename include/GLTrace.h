@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+// gltrace.h
+// ============
+// record the OpenGL command stream into a binary trace for replaying
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+/***********************************************************
+ *  GLTrace
+ *
+ *  This class records the OpenGL calls of the application,
+ *  with the data of every buffer, texture and shader upload,
+ *  into a compact binary trace.  The GLTraceReplay tool runs
+ *  the recorded frames in a loop with timing, so the GPU and
+ *  driver cost of a frame can be compared across drivers and
+ *  machines without the scene's CPU code.
+ *
+ *  A trace starts with a TRACE_HEADER followed by records.
+ *  Each record is an opcode byte, a count of 32-bit fields,
+ *  the byte size of its data, the fields and then the data.
+ *  Values are stored in the byte order of the recording host.
+ *
+ *  Recording needs a Linux build with WORKSPACE_GL_TRACE
+ *  defined, which wraps the OpenGL 1.1 functions of libGL.
+ ***********************************************************/
+class GLTrace
+{
+public:
+	enum OPCODE
+	{
+		TRACE_FRAME_END = 1,
+		TRACE_GEN_BUFFERS,
+		TRACE_DELETE_BUFFERS,
+		TRACE_BIND_BUFFER,
+		TRACE_BUFFER_DATA,
+		TRACE_BUFFER_SUB_DATA,
+		TRACE_GEN_VERTEX_ARRAYS,
+		TRACE_DELETE_VERTEX_ARRAYS,
+		TRACE_BIND_VERTEX_ARRAY,
+		TRACE_VERTEX_ATTRIB_POINTER,
+		TRACE_ENABLE_VERTEX_ATTRIB_ARRAY,
+		TRACE_DISABLE_VERTEX_ATTRIB_ARRAY,
+		TRACE_CREATE_SHADER,
+		TRACE_SHADER_SOURCE,
+		TRACE_COMPILE_SHADER,
+		TRACE_DELETE_SHADER,
+		TRACE_CREATE_PROGRAM,
+		TRACE_ATTACH_SHADER,
+		TRACE_LINK_PROGRAM,
+		TRACE_USE_PROGRAM,
+		TRACE_DELETE_PROGRAM,
+		TRACE_GET_UNIFORM_LOCATION,
+		TRACE_UNIFORM,
+		TRACE_ACTIVE_TEXTURE,
+		TRACE_GENERATE_MIPMAP,
+		TRACE_GEN_TEXTURES,
+		TRACE_DELETE_TEXTURES,
+		TRACE_BIND_TEXTURE,
+		TRACE_TEX_PARAMETER_I,
+		TRACE_TEX_IMAGE_2D,
+		TRACE_PIXEL_STORE_I,
+		TRACE_DRAW_ARRAYS,
+		TRACE_DRAW_ELEMENTS,
+		TRACE_ENABLE,
+		TRACE_DISABLE,
+		TRACE_BLEND_FUNC,
+		TRACE_CLEAR,
+		TRACE_CLEAR_COLOR,
+		TRACE_VIEWPORT,
+		TRACE_OPCODE_COUNT
+	};
+
+	// the glUniform function a TRACE_UNIFORM record came from
+	enum UNIFORM_FUNCTION
+	{
+		UNIFORM_1I,
+		UNIFORM_1F,
+		UNIFORM_2F,
+		UNIFORM_3F,
+		UNIFORM_4F,
+		UNIFORM_1IV,
+		UNIFORM_1FV,
+		UNIFORM_2FV,
+		UNIFORM_3FV,
+		UNIFORM_4FV,
+		UNIFORM_MATRIX_4FV
+	};
+
+	struct TRACE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		// reads back as 0x01020304 on a host of the same byte order
+		uint32_t byteOrder;
+		// size of the default framebuffer when recording started
+		int32_t width;
+		int32_t height;
+	};
+
+	static const uint32_t VERSION = 1;
+	static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	// start recording into the file, for the given number of
+	// frames, call right after glewInit() so the scene's
+	// resource uploads are part of the trace
+	static bool StartRecording(const char* filename, unsigned int frameCount);
+	// mark the end of a frame, stopping after the last one
+	static void EndFrame();
+	// close the trace file
+	static void StopRecording();
+	// leave the calls out of the trace for a while, such as the
+	// frames rendered to calibrate the renderer, and go on
+	static void PauseRecording();
+	static void ResumeRecording();
+	// true while calls are being recorded
+	static bool IsRecording();
+};
@@ -0,0 +1,37 @@
+///////////////////////////////////////////////////////////////////////////////
+// imageio.h
+// ============
+// capture the rendered frame and read or write it as a raw RGB image
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  ImageIO
+ *
+ *  This class contains helpers for reading back the OpenGL
+ *  framebuffer and storing the pixels as binary PPM files,
+ *  which need no external image library to read or write.
+ ***********************************************************/
+class ImageIO
+{
+public:
+	struct RGB_IMAGE
+	{
+		int width;
+		int height;
+		// tightly packed RGB pixels, top row first
+		std::vector<unsigned char> pixels;
+	};
+
+	// read the current read framebuffer into an RGB image
+	static bool CaptureFramebuffer(int width, int height, RGB_IMAGE& image);
+	// write an RGB image as a binary PPM file
+	static bool WritePPM(const std::string& filename, const RGB_IMAGE& image);
+	// read a binary PPM file into an RGB image
+	static bool ReadPPM(const std::string& filename, RGB_IMAGE& image);
+};
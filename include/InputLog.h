@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputlog.h
+// ============
+// record and replay the per-frame camera input as a compact binary log
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/***********************************************************
+ *  InputLog
+ *
+ *  This class reads and writes the camera input of each frame
+ *  to a binary file.  Every frame stores its time step and the
+ *  navigation key state; mouse and scroll deltas are only
+ *  stored for the frames that have them.
+ ***********************************************************/
+class InputLog
+{
+public:
+	// constructor
+	InputLog();
+	// destructor
+	~InputLog();
+
+	// navigation keys, one bit each in INPUT_FRAME::keys
+	enum INPUT_KEY
+	{
+		KEY_W = 1 << 0,
+		KEY_A = 1 << 1,
+		KEY_S = 1 << 2,
+		KEY_D = 1 << 3,
+		KEY_Q = 1 << 4,
+		KEY_E = 1 << 5,
+		KEY_O = 1 << 6,
+		KEY_P = 1 << 7
+	};
+
+	struct INPUT_FRAME
+	{
+		float deltaTime;
+		uint8_t keys;
+		float mouseOffsetX;
+		float mouseOffsetY;
+		float scrollOffset;
+	};
+
+	// open a new log for writing frames
+	bool OpenForWrite(const char* filename);
+	// open an existing log for reading frames
+	bool OpenForRead(const char* filename);
+	// append one frame to the log
+	bool WriteFrame(const INPUT_FRAME& frame);
+	// read the next frame, returns false at the end of the log
+	bool ReadFrame(INPUT_FRAME& frame);
+	// close the log, completing the header when writing
+	void Close();
+
+	bool IsWriting() const { return((NULL != m_pFile) && (m_bWriting == true)); }
+	bool IsReading() const { return((NULL != m_pFile) && (m_bWriting == false)); }
+	uint32_t GetFrameCount() const { return(m_frameCount); }
+
+private:
+	// open log file
+	FILE* m_pFile;
+	// true when the log was opened for writing
+	bool m_bWriting;
+	// frames written, or frames stored in the log being read
+	uint32_t m_frameCount;
+	// frames read so far
+	uint32_t m_framesRead;
+};
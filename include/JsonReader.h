@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonreader.h
+// ============
+// parse JSON text, such as the reports the application writes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/***********************************************************
+ *  JsonReader
+ *
+ *  This class parses JSON text into a tree of values.  It
+ *  accepts the full JSON grammar, with \u escapes decoded to
+ *  UTF-8, and reports the line of the first error.
+ ***********************************************************/
+class JsonReader
+{
+public:
+	enum JSON_TYPE
+	{
+		JSON_NULL,
+		JSON_BOOL,
+		JSON_NUMBER,
+		JSON_STRING,
+		JSON_ARRAY,
+		JSON_OBJECT
+	};
+
+	struct JSON_VALUE
+	{
+		JSON_TYPE type = JSON_NULL;
+		bool bValue = false;
+		double number = 0.0;
+		std::string text;
+		// elements of an array
+		std::vector<JSON_VALUE> elements;
+		// members of an object, in the order they were written
+		std::vector<std::pair<std::string, JSON_VALUE>> members;
+	};
+
+	// parse JSON text into a value
+	static bool Parse(const std::string& text, JSON_VALUE& value, std::string& error);
+	// read and parse a JSON file
+	static bool ReadFile(const std::string& filename, JSON_VALUE& value, std::string& error);
+
+	// find a member of an object, NULL when missing
+	static const JSON_VALUE* Find(const JSON_VALUE& object, const char* name);
+	// get a member of the expected type, or the default
+	static double GetNumber(const JSON_VALUE& object, const char* name, double defaultValue);
+	static std::string GetString(const JSON_VALUE& object, const char* name, const std::string& defaultValue);
+	static bool GetBool(const JSON_VALUE& object, const char* name, bool bDefault);
+};
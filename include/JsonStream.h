@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonstream.h
+// ============
+// read JSON text one value at a time, without building a tree
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  JsonStream
+ *
+ *  This class is a pull reader over JSON text.  The caller
+ *  walks the document with BeginObject()/NextMember() and
+ *  BeginArray()/NextElement(), reading each value straight
+ *  into its own data, so large files load in one pass with
+ *  no intermediate tree.  The first error stops the reader
+ *  and is kept with its line.
+ ***********************************************************/
+class JsonStream
+{
+public:
+	// constructor
+	JsonStream();
+
+	// read a whole file, or take a copy of text, to walk
+	bool Open(const std::string& filename);
+	void SetText(const std::string& text);
+
+	// enter an object, then get the name of each member until
+	// false is returned at the closing brace
+	bool BeginObject();
+	bool NextMember(std::string& name);
+	// enter an array, then advance to each element until false
+	// is returned at the closing bracket
+	bool BeginArray();
+	bool NextElement();
+
+	// read a value of the expected type
+	bool ReadString(std::string& text);
+	bool ReadNumber(double& number);
+	bool ReadFloat(float& number);
+	bool ReadBool(bool& bValue);
+	// read an array of exactly count numbers
+	bool ReadFloats(float* values, int count);
+	// step over a value of any type
+	bool SkipValue();
+
+	// whether the next value is null, consuming it if so
+	bool ReadNull();
+	// whether only white space is left
+	bool IsAtEnd();
+
+	// stop with an error found by the caller, such as a value
+	// out of range, reported at the current line
+	bool Fail(const std::string& message);
+	bool HasError() const { return(m_error.empty() == false); }
+	// the first error with its line
+	const std::string& GetError() const { return(m_error); }
+	// line of the current position, from 1
+	int GetLine() const { return(m_line); }
+
+private:
+	std::string m_text;
+	size_t m_offset;
+	int m_line;
+	std::string m_error;
+	// for each open object or array, whether the next member or
+	// element is the first one
+	std::vector<bool> m_bFirst;
+
+	void SkipSpace();
+	bool Expect(char c, const char* message);
+	bool ReadHex4(unsigned int& value);
+};
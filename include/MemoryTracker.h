@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////
+// memorytracker.h
+// ============
+// account for the CPU and GPU memory held by every scene resource
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/***********************************************************
+ *  MemoryTracker
+ *
+ *  This class is a registry of the byte size of every GPU
+ *  resource (texture mips, mesh, uniform and storage buffers)
+ *  and every major CPU allocation.  It keeps totals and
+ *  high-water marks by category and by asset tag.
+ ***********************************************************/
+class MemoryTracker
+{
+public:
+	enum MEMORY_CATEGORY
+	{
+		MEMORY_TEXTURE,
+		MEMORY_MESH_BUFFER,
+		MEMORY_UNIFORM_BUFFER,
+		MEMORY_STORAGE_BUFFER,
+		MEMORY_OTHER_BUFFER,
+		MEMORY_CPU,
+		MEMORY_CATEGORY_COUNT
+	};
+
+	// record a resource, replacing an earlier record with the same id
+	static void Register(
+		MEMORY_CATEGORY category,
+		uint64_t resourceID,
+		const std::string& tag,
+		const std::string& detail,
+		size_t bytes);
+	// remove the record of a released resource
+	static void Release(MEMORY_CATEGORY category, uint64_t resourceID);
+
+	// current and peak bytes of one category
+	static size_t GetCategoryBytes(MEMORY_CATEGORY category);
+	static size_t GetCategoryHighWater(MEMORY_CATEGORY category);
+	// current bytes of every GPU category together
+	static size_t GetGPUBytes();
+	// current bytes of CPU allocations
+	static size_t GetCPUBytes();
+
+	// printable name of a category
+	static const char* GetCategoryName(MEMORY_CATEGORY category);
+
+	// print the totals by category and by tag
+	static void PrintReport(FILE* output);
+	// write the totals as the members of a JSON object
+	static void WriteJSON(FILE* output, const char* indent);
+
+	// dump the report when SIGUSR1 (SIGBREAK on Windows) arrives
+	static void InstallDumpSignal();
+	// print the report if the dump signal arrived since the last call
+	static void PollDumpSignal();
+};
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.h
+// ============
+// reorder indexed triangle meshes for the GPU and measure them
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  MeshOptimizer
+ *
+ *  This class reorders the triangles and vertices of indexed
+ *  triangle lists, which are usually in the order of the
+ *  loops that generated them.  The passes are run in order:
+ *  WeldVertices() merges the vertices generated more than
+ *  once, so the triangles around them can share their cache
+ *  entries and fetches; OptimizeVertexCache() orders the
+ *  triangles so vertices are reused while they are in the
+ *  post-transform cache, with Forsyth's scoring;
+ *  OptimizeOverdraw() then moves whole clusters of that order
+ *  so the outward facing ones are drawn first, as long as the
+ *  cache efficiency stays within a threshold.  The Analyze
+ *  methods measure an order by simulating the caches.
+ ***********************************************************/
+class MeshOptimizer
+{
+public:
+	// post-transform cache efficiency of an index order
+	struct CACHE_STATISTICS
+	{
+		// vertex shader runs per triangle, 0.5 at best, 3 at worst
+		float ACMR;
+		// vertex shader runs per used vertex, 1 at best
+		float ATVR;
+	};
+
+	// memory efficiency of the vertex fetches of an index order
+	struct FETCH_STATISTICS
+	{
+		size_t bytesFetched;
+		// bytes fetched over the bytes of the used vertices
+		float overfetch;
+	};
+
+	// entries of the simulated post-transform cache
+	static const unsigned int CACHE_SIZE = 16;
+
+	// merge the vertices whose bytes are equal, getting for each
+	// new vertex the old one to copy, in the order they were
+	// generated; returns the new vertex count
+	static size_t WeldVertices(
+		std::vector<uint32_t>& indices,
+		std::vector<uint32_t>& vertexOrder,
+		const void* pVertices,
+		size_t vertexCount,
+		size_t vertexBytes);
+	// order the triangles for post-transform cache reuse
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+	// order clusters of the triangles to draw outward facing ones
+	// first; the positions are read every stride floats, and the
+	// ACMR may grow by the threshold factor
+	static void OptimizeOverdraw(
+		std::vector<uint32_t>& indices,
+		const float* pPositions,
+		size_t stride,
+		size_t vertexCount,
+		float threshold);
+
+	// simulate a FIFO post-transform cache
+	static CACHE_STATISTICS AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned int cacheSize = CACHE_SIZE);
+	// simulate the cache lines read by the vertex fetches
+	static FETCH_STATISTICS AnalyzeVertexFetch(const std::vector<uint32_t>& indices, size_t vertexCount, size_t vertexBytes);
+};
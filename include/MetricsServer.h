@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+// metricsserver.h
+// ============
+// serve the frame statistics as Prometheus text from a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MemoryTracker.h"
+
+#include <cstdint>
+
+/***********************************************************
+ *  MetricsServer
+ *
+ *  This class serves the latest frame statistics in the
+ *  Prometheus text format over HTTP, on a localhost port or a
+ *  Unix domain socket.  The render thread publishes a snapshot
+ *  every frame into a sequence lock, and the server thread
+ *  copies it out without ever taking a lock the render thread
+ *  could wait on, so a scrape never stalls a frame.
+ ***********************************************************/
+class MetricsServer
+{
+public:
+	// values published every frame, every field is 8 bytes so the
+	// snapshot can be copied as atomic words
+	struct FRAME_METRICS
+	{
+		uint64_t frames;
+		double frameSecondsSum;
+		double frameSeconds;
+		double maxFrameSeconds;
+		uint64_t drawCalls;
+		uint64_t memoryBytes[MemoryTracker::MEMORY_CATEGORY_COUNT];
+		uint64_t arenaHighWaterBytes;
+		uint64_t arenaOverflows;
+		uint64_t glDebugMessages;
+	};
+
+	// listen on "<port>" (localhost only) or "unix:<path>"
+	static bool Start(const char* address);
+	// close the socket and join the server thread
+	static void Stop();
+	// whether the server is running and wants snapshots
+	static bool IsRunning();
+
+	// replace the snapshot served to the next scrape
+	static void Publish(const FRAME_METRICS& metrics);
+};
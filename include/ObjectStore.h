@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// objectstore.h
+// ============
+// hold the objects of a scene as chunks of component arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <vector>
+
+/***********************************************************
+ *  ObjectStore
+ *
+ *  This class holds the objects of a retained scene in draw
+ *  order, split into chunks of a fixed number of objects.
+ *  Each component of the objects in a chunk is kept in its
+ *  own array aligned to a cache line, so a pass only reads
+ *  the components it needs: culling reads the world boxes,
+ *  which are split by axis so its loops run over plain floats
+ *  and vectorize, and recording reads the draw settings of
+ *  the objects culling left visible.  Every object of these
+ *  scenes has the same components, so one chunk layout is
+ *  used.  Removing an object moves the last one into its
+ *  place, so the arrays stay packed.
+ ***********************************************************/
+class ObjectStore
+{
+public:
+	// constructor
+	ObjectStore();
+	// destructor
+	~ObjectStore();
+
+	// objects held by one chunk
+	static constexpr uint32_t CHUNK_OBJECTS = 64;
+
+	enum OBJECT_FLAG
+	{
+		// drawn with its texture instead of its color
+		FLAG_TEXTURED = 1
+	};
+
+	// the components of up to CHUNK_OBJECTS objects
+	struct CHUNK
+	{
+		alignas(64) glm::mat4 transforms[CHUNK_OBJECTS];
+		// world space box of each object, by axis
+		alignas(64) float boundsMinX[CHUNK_OBJECTS];
+		alignas(64) float boundsMinY[CHUNK_OBJECTS];
+		alignas(64) float boundsMinZ[CHUNK_OBJECTS];
+		alignas(64) float boundsMaxX[CHUNK_OBJECTS];
+		alignas(64) float boundsMaxY[CHUNK_OBJECTS];
+		alignas(64) float boundsMaxZ[CHUNK_OBJECTS];
+		alignas(64) glm::vec4 colors[CHUNK_OBJECTS];
+		alignas(64) glm::vec2 UVscales[CHUNK_OBJECTS];
+		alignas(64) int32_t materialIDs[CHUNK_OBJECTS];
+		// slot of the texture, kept by untextured objects too
+		alignas(64) int32_t textureSlots[CHUNK_OBJECTS];
+		alignas(64) uint8_t meshes[CHUNK_OBJECTS];
+		alignas(64) uint8_t flags[CHUNK_OBJECTS];
+		// written by Cull(), non-zero for the objects in view
+		alignas(64) uint8_t visible[CHUNK_OBJECTS];
+	};
+
+	// number of objects, and the chunks holding them
+	uint32_t GetCount() const { return(m_count); }
+	uint32_t GetChunkCount() const { return((m_count + CHUNK_OBJECTS - 1) / CHUNK_OBJECTS); }
+	const CHUNK& GetChunk(uint32_t chunk) const { return(*m_chunks[chunk]); }
+	uint32_t GetChunkObjectCount(uint32_t chunk) const;
+	// bytes of the allocated chunks
+	size_t GetBytes() const { return(m_chunks.size() * sizeof(CHUNK)); }
+
+	// remove all objects, keeping the chunks for reuse
+	void Clear();
+	// add an object at the end of the draw order
+	void Add(const SceneManager::DRAW_COMMAND& draw);
+	// remove an object, moving the last one into its place
+	void Remove(uint32_t index);
+
+	// get an object as a draw, without state bits, and set one
+	SceneManager::DRAW_COMMAND GetDraw(uint32_t index) const;
+	void SetDraw(uint32_t index, const SceneManager::DRAW_COMMAND& draw);
+	// change one component of an object; a negative texture slot
+	// draws the object with its color
+	void SetTransform(uint32_t index, const glm::mat4& model);
+	void SetMaterial(uint32_t index, int materialIndex);
+	void SetTexture(uint32_t index, int textureSlot);
+
+	// mark the objects whose world boxes are in the frustum of
+	// the passed in matrix, and get their number
+	uint32_t Cull(const glm::mat4& viewProjection);
+	// get the six planes of a frustum, facing inwards
+	static void GetFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+private:
+	std::vector<CHUNK*> m_chunks;
+	uint32_t m_count;
+
+	// compute the world box of an object from its transform
+	void UpdateBounds(CHUNK& chunk, uint32_t object);
+};
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// prefabstore.h
+// ============
+// hold the prefabs of a scene and the instances placing them
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  PrefabStore
+ *
+ *  This class holds assemblies of draws defined once, the
+ *  prefabs, and the instances placing them with a root
+ *  transform.  An instance is culled as a whole by the box
+ *  around its prefab's parts, so culling costs one test per
+ *  instance however many parts it has.  After culling the
+ *  visible instances are listed grouped by prefab, so they
+ *  can be recorded part by part: the draws of one part of
+ *  every visible instance follow each other and only change
+ *  the model matrix between them.
+ ***********************************************************/
+class PrefabStore
+{
+public:
+	// constructor
+	PrefabStore();
+
+	// a prefab, as a range of parts placed relative to its root
+	struct PREFAB
+	{
+		std::string id;
+		uint32_t firstPart;
+		uint32_t partCount;
+		// box around the parts, relative to the root
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		// range of the visible instances listed by Cull()
+		uint32_t firstVisible;
+		uint32_t visibleCount;
+	};
+
+	uint32_t GetPrefabCount() const { return((uint32_t)m_prefabs.size()); }
+	const PREFAB& GetPrefab(uint32_t prefab) const { return(m_prefabs[prefab]); }
+	// a part's draw, its model matrix relative to the root
+	const SceneManager::DRAW_COMMAND& GetPart(uint32_t part) const { return(m_parts[part]); }
+	uint32_t GetInstanceCount() const { return((uint32_t)m_roots.size()); }
+	const glm::mat4& GetRoot(uint32_t instance) const { return(m_roots[instance]); }
+	// visible instances grouped by prefab, see PREFAB
+	const uint32_t* GetVisibleInstances() const { return(m_visibleInstances.data()); }
+	// draws the visible instances expand to, and all of them
+	uint32_t GetVisibleDrawCount() const { return(m_visibleDraws); }
+	uint32_t GetDrawCount() const;
+	// bytes of the prefabs and instances
+	size_t GetBytes() const;
+
+	// remove all prefabs and instances
+	void Clear();
+	// add a prefab, parts with their state bits unset
+	void AddPrefab(const std::string& id, const std::vector<SceneManager::DRAW_COMMAND>& parts);
+	// place a prefab by its id, false when there is none
+	bool AddInstance(const std::string& prefab, const glm::mat4& root);
+
+	// list the instances whose boxes are in the frustum of the
+	// passed in matrix, and get their number
+	uint32_t Cull(const glm::mat4& viewProjection);
+
+private:
+	std::vector<PREFAB> m_prefabs;
+	std::vector<SceneManager::DRAW_COMMAND> m_parts;
+
+	// the instances, one array per component
+	std::vector<glm::mat4> m_roots;
+	std::vector<uint32_t> m_instancePrefabs;
+	// world space box of each instance, by axis
+	std::vector<float> m_boundsMinX;
+	std::vector<float> m_boundsMinY;
+	std::vector<float> m_boundsMinZ;
+	std::vector<float> m_boundsMaxX;
+	std::vector<float> m_boundsMaxY;
+	std::vector<float> m_boundsMaxZ;
+	// written by Cull()
+	std::vector<uint8_t> m_visible;
+	std::vector<uint32_t> m_visibleInstances;
+	uint32_t m_visibleDraws;
+};
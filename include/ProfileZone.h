@@ -0,0 +1,32 @@
+///////////////////////////////////////////////////////////////////////////////
+// profilezone.h
+// ============
+// name the code that is currently running, for attributing costs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  ProfileZone
+ *
+ *  This class names the zone of code running on the current
+ *  thread for the lifetime of the object.  Profilers read
+ *  the innermost zone to attribute what they measure, such
+ *  as heap allocations, to a part of the frame.
+ ***********************************************************/
+class ProfileZone
+{
+public:
+	// constructor, the name must be a string literal
+	ProfileZone(const char* name);
+	// destructor
+	~ProfileZone();
+
+	// name of the innermost zone on this thread
+	static const char* GetCurrent();
+
+private:
+	// zone that was current when this one was entered
+	const char* m_previous;
+};
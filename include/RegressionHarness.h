@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionharness.h
+// ============
+// render fixed camera poses and compare them against golden images
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ImageIO.h"
+
+#include <string>
+
+/***********************************************************
+ *  RegressionHarness
+ *
+ *  This class renders the scene from a fixed set of camera
+ *  poses, compares each frame against a stored golden image
+ *  with a perceptual (SSIM) metric, and checks the frame time
+ *  and draw call budgets of every pose.  The golden images
+ *  are not part of the repository; they are rendered once on
+ *  llvmpipe with --update-golden, and until then the poses
+ *  without one are reported as missing rather than failed.
+ *  The office scene's resolved textures and materials are
+ *  also checked against the original scene code.
+ ***********************************************************/
+class RegressionHarness
+{
+public:
+	// constructor
+	RegressionHarness(
+		GLFWwindow* pWindow,
+		ViewManager* pViewManager,
+		SceneManager* pSceneManager,
+		void (*renderFrame)());
+
+	struct REGRESSION_POSE
+	{
+		const char* name;
+		glm::vec3 position;
+		glm::vec3 front;
+		float zoom;
+		bool bOrthographic;
+		// lowest accepted structural similarity to the golden image
+		float minSSIM;
+		// budget for the median frame time, the mesh draws are
+		// budgeted by the draws of the loaded scene
+		float maxFrameMs;
+		// budget for the heap allocations of each timed frame
+		unsigned int maxAllocations;
+	};
+
+	// render every pose and return the number of failed checks
+	int Run(const std::string& goldenDir, bool bUpdateGolden);
+	// get the number of poses the last Run() found no golden
+	// image for
+	int GetMissingGoldenCount() const { return(m_missingGoldens); }
+
+	// compare the textures and materials the scene file resolves
+	// for each object with the original office scene, returning
+	// the number of objects that differ
+	static int CheckBaselineScene(const char* filename);
+
+	// force Mesa llvmpipe so golden images match across hosts
+	static void UseSoftwareRenderer();
+
+	// compute the mean structural similarity of two images
+	static float ComputeSSIM(
+		const ImageIO::RGB_IMAGE& imageA,
+		const ImageIO::RGB_IMAGE& imageB);
+
+private:
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// pointer to view manager object
+	ViewManager* m_pViewManager;
+	// pointer to scene manager object
+	SceneManager* m_pSceneManager;
+	// renders one complete frame into the back buffer
+	void (*m_renderFrame)();
+	// poses of the last run without a golden image
+	int m_missingGoldens;
+
+	// render the pose and measure the median frame time and
+	// the most heap allocations made by one timed frame
+	float RenderPose(const REGRESSION_POSE& pose, unsigned int& maxAllocations);
+};
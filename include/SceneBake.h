@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebake.h
+// ============
+// compile-time transform math and the tables of a baked scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  SceneBake
+ *
+ *  This class holds the constexpr math that builds a model
+ *  matrix from an object's scale, rotation and position, and
+ *  the types of the tables a baked scene is generated into.
+ *  The SceneCompiler tool writes a scene as a header of
+ *  constexpr tables that call GetModelMatrix(), so the
+ *  compiler computes every matrix and places the draws in
+ *  read-only data.  The scene file loader uses the same
+ *  functions at run time, so both paths make equal matrices
+ *  as long as the build does not fuse multiply-adds
+ *  (-ffp-contract=off on targets with FMA).
+ ***********************************************************/
+class SceneBake
+{
+public:
+	// column-major 4x4 matrix, laid out like glm::mat4
+	struct MATRIX
+	{
+		float values[16];
+	};
+
+	struct BAKED_TEXTURE
+	{
+		const char* tag;
+		const char* path;
+	};
+
+	struct BAKED_MATERIAL
+	{
+		const char* tag;
+		float ambientColor[3];
+		float ambientStrength;
+		float diffuseColor[3];
+		float specularColor[3];
+		float shininess;
+	};
+
+	struct BAKED_LIGHT
+	{
+		float position[3];
+		float ambientColor[3];
+		float diffuseColor[3];
+		float specularColor[3];
+		float focalStrength;
+		float specularIntensity;
+		float radius;
+	};
+
+	// one draw of a baked scene, the texture and material are
+	// indices into their tables, or -1; it holds no pointers, so
+	// the table needs no relocation and stays in read-only data
+	struct BAKED_DRAW
+	{
+		MATRIX model;
+		float color[4];
+		float UVscale[2];
+		int mesh;
+		int texture;
+		int material;
+		unsigned int stateBits;
+	};
+
+	// degrees to radians, as glm::radians() computes it
+	static constexpr float Radians(float degrees)
+	{
+		return(degrees * 0.01745329251994329576923690768489f);
+	}
+
+	// sine and cosine in double precision, for rounding to float;
+	// the angle is brought into [-pi, pi] and summed as a series
+	static constexpr double Sin(double angle)
+	{
+		const double PI = 3.14159265358979323846;
+		double turns = angle / (2.0 * PI);
+		long long whole = (long long)(turns + ((turns >= 0.0) ? 0.5 : -0.5));
+		double x = angle - (double)whole * (2.0 * PI);
+
+		double term = x;
+		double sum = x;
+		for (int i = 1; i < 20; i++)
+		{
+			term *= -x * x / (double)((2 * i) * (2 * i + 1));
+			sum += term;
+		}
+		return(sum);
+	}
+
+	static constexpr double Cos(double angle)
+	{
+		const double PI = 3.14159265358979323846;
+		return(Sin(angle + PI / 2.0));
+	}
+
+	static constexpr MATRIX Identity()
+	{
+		MATRIX result = {};
+		result.values[0] = 1.0f;
+		result.values[5] = 1.0f;
+		result.values[10] = 1.0f;
+		result.values[15] = 1.0f;
+		return(result);
+	}
+
+	// the product a * b, each column summed in the same order as
+	// glm's mat4 product
+	static constexpr MATRIX Multiply(const MATRIX& a, const MATRIX& b)
+	{
+		MATRIX result = {};
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				result.values[column * 4 + row] =
+					a.values[0 * 4 + row] * b.values[column * 4 + 0] +
+					a.values[1 * 4 + row] * b.values[column * 4 + 1] +
+					a.values[2 * 4 + row] * b.values[column * 4 + 2] +
+					a.values[3 * 4 + row] * b.values[column * 4 + 3];
+			}
+		}
+		return(result);
+	}
+
+	static constexpr MATRIX Scale(float x, float y, float z)
+	{
+		MATRIX result = Identity();
+		result.values[0] = x;
+		result.values[5] = y;
+		result.values[10] = z;
+		return(result);
+	}
+
+	static constexpr MATRIX Translate(float x, float y, float z)
+	{
+		MATRIX result = Identity();
+		result.values[12] = x;
+		result.values[13] = y;
+		result.values[14] = z;
+		return(result);
+	}
+
+	// rotation about one axis, the row and column of the axis
+	// are left as in the identity
+	static constexpr MATRIX Rotate(float degrees, int axis)
+	{
+		const float radians = Radians(degrees);
+		const float c = (float)Cos(radians);
+		const float s = (float)Sin(radians);
+		const int first = (axis + 1) % 3;
+		const int second = (axis + 2) % 3;
+
+		MATRIX result = Identity();
+		result.values[first * 4 + first] = c;
+		result.values[first * 4 + second] = s;
+		result.values[second * 4 + first] = -s;
+		result.values[second * 4 + second] = c;
+		return(result);
+	}
+
+	// scaled, rotated about X, Y and Z in degrees, then translated
+	static constexpr MATRIX GetModelMatrix(
+		float scaleX, float scaleY, float scaleZ,
+		float rotationX, float rotationY, float rotationZ,
+		float positionX, float positionY, float positionZ)
+	{
+		return(Multiply(
+			Multiply(
+				Multiply(
+					Multiply(Translate(positionX, positionY, positionZ), Rotate(rotationX, 0)),
+					Rotate(rotationY, 1)),
+				Rotate(rotationZ, 2)),
+			Scale(scaleX, scaleY, scaleZ)));
+	}
+};
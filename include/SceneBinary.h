@@ -0,0 +1,254 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebinary.h
+// ============
+// write compiled binary scenes and map them for use in place
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneFile.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneBinary
+ *
+ *  This class writes a scene, read from its description
+ *  file, as a compiled binary scene, and maps compiled scenes
+ *  into memory read-only.  The objects are stored as arrays
+ *  of one field each, so the renderer uses them where they
+ *  are mapped and nothing is parsed or copied at load time.
+ *
+ *  A compiled scene starts with a BINARY_HEADER giving the
+ *  counts and the offset of each section.  Sections start on
+ *  64-byte boundaries.  The objects are stored parents before
+ *  children, in draw order, and strings are offsets into the
+ *  string table, each ending with a zero byte.  Values are
+ *  stored in the byte order of the compiling host.
+ *
+ *  The objects are partitioned into sectors, each one a
+ *  contiguous range of every per-object section, so a sector
+ *  can be read on its own for streaming.  The first object of
+ *  a sector has the state bits of a first draw.  A scene
+ *  compiled without a sector size is a single sector in the
+ *  order of its description file.
+ ***********************************************************/
+class SceneBinary
+{
+public:
+	// constructor
+	SceneBinary();
+	// destructor
+	~SceneBinary();
+
+	// the sections of a compiled scene
+	enum SECTION
+	{
+		// per object: glm::mat4 model matrix
+		SECTION_TRANSFORMS,
+		// per object: glm::vec3 world space box
+		SECTION_BOUNDS_MIN,
+		SECTION_BOUNDS_MAX,
+		// per object: glm::vec4 color of an untextured draw
+		SECTION_COLORS,
+		// per object: glm::vec2 texture UV scale
+		SECTION_UV_SCALES,
+		// per object: uint32_t SceneManager::MESH_TYPE
+		SECTION_MESHES,
+		// per object: int32_t index into the materials, or -1
+		SECTION_MATERIAL_IDS,
+		// per object: int32_t index into the textures, or -1
+		// when the color is drawn
+		SECTION_TEXTURE_IDS,
+		// per object: int32_t index of the parent, or -1
+		SECTION_PARENTS,
+		// per object: uint32_t DRAW_STATE bits after the object
+		// before it
+		SECTION_STATE_BITS,
+		// per object: uint32_t string offset of the id
+		SECTION_OBJECT_IDS,
+		// BINARY_TEXTURE, BINARY_MATERIAL and BINARY_LIGHT tables
+		SECTION_TEXTURES,
+		SECTION_MATERIALS,
+		SECTION_LIGHTS,
+		// BINARY_SECTOR table
+		SECTION_SECTORS,
+		// uint32_t texture indices used by the sectors, each
+		// sector's in a contiguous range
+		SECTION_SECTOR_TEXTURES,
+		// zero terminated strings
+		SECTION_STRINGS,
+		SECTION_COUNT
+	};
+
+	struct BINARY_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		// reads back as 0x01020304 on a host of the same byte order
+		uint32_t byteOrder;
+		uint32_t objectCount;
+		uint32_t textureCount;
+		uint32_t materialCount;
+		uint32_t lightCount;
+		uint32_t stringBytes;
+		uint32_t sectorCount;
+		uint32_t sectorTextureCount;
+		// edge of the grid cells the objects were sorted into,
+		// zero when the scene is a single sector
+		float sectorSize;
+		uint64_t fileBytes;
+		uint64_t sectionOffsets[SECTION_COUNT];
+	};
+
+	struct BINARY_TEXTURE
+	{
+		uint32_t tag;
+		uint32_t path;
+	};
+
+	struct BINARY_MATERIAL
+	{
+		float ambientColor[3];
+		float ambientStrength;
+		float diffuseColor[3];
+		float specularColor[3];
+		float shininess;
+		uint32_t tag;
+	};
+
+	struct BINARY_LIGHT
+	{
+		float position[3];
+		float ambientColor[3];
+		float diffuseColor[3];
+		float specularColor[3];
+		float focalStrength;
+		float specularIntensity;
+		float radius;
+	};
+
+	struct BINARY_SECTOR
+	{
+		// world space box around the sector's objects
+		float boundsMin[3];
+		float boundsMax[3];
+		// average color of the objects, drawn as the coarse proxy
+		// of a sector that is not loaded
+		float proxyColor[4];
+		uint32_t firstObject;
+		uint32_t objectCount;
+		uint32_t firstTexture;
+		uint32_t textureCount;
+	};
+
+	// a scene read from its description file, to be compiled
+	struct SCENE_SOURCE
+	{
+		std::vector<SceneFile::SCENE_TEXTURE> textures;
+		std::vector<SceneManager::OBJECT_MATERIAL> materials;
+		std::vector<SceneManager::LIGHT_SOURCE> lights;
+		std::vector<SceneFile::SCENE_PREFAB> prefabs;
+		// the objects in file order, the static ones among them,
+		// as an object without a material or texture keeps the
+		// ones of the object before it, static or not
+		std::vector<SceneFile::SCENE_OBJECT> objects;
+		// the objects placing a prefab, kept apart from the others
+		std::vector<SceneFile::SCENE_OBJECT> instances;
+	};
+
+	// the arrays and tables of a compiled scene, as written
+	struct COMPILED_SCENE
+	{
+		std::vector<glm::mat4> transforms;
+		std::vector<glm::vec3> boundsMin;
+		std::vector<glm::vec3> boundsMax;
+		std::vector<glm::vec4> colors;
+		std::vector<glm::vec2> UVscales;
+		std::vector<uint32_t> meshes;
+		std::vector<int32_t> materialIDs;
+		std::vector<int32_t> textureIDs;
+		std::vector<int32_t> parents;
+		std::vector<uint32_t> stateBits;
+		std::vector<uint32_t> objectIDs;
+		std::vector<BINARY_TEXTURE> textures;
+		std::vector<BINARY_MATERIAL> materials;
+		std::vector<BINARY_LIGHT> lights;
+		std::vector<BINARY_SECTOR> sectors;
+		std::vector<uint32_t> sectorTextures;
+		std::vector<char> strings;
+		float sectorSize;
+	};
+
+	static const uint32_t VERSION = 2;
+	static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+	// read a whole scene description file
+	static bool ReadSource(const char* filename, SCENE_SOURCE& source, std::string& error);
+	// resolve a scene's tags and compute its arrays, sorting the
+	// objects into sectors when a sector size is given; prefab
+	// instances are expanded into their parts
+	static bool Compile(const SCENE_SOURCE& source, COMPILED_SCENE& compiled, std::string& error, float sectorSize = 0.0f);
+	// compile a scene into a binary file
+	static bool Write(const char* filename, const SCENE_SOURCE& source, std::string& error, float sectorSize = 0.0f);
+	// whether the file starts like a compiled scene
+	static bool IsBinaryScene(const char* filename);
+	// read a range of elements of a section from an open compiled
+	// scene, without mapping it
+	static bool ReadSection(FILE* file, const BINARY_HEADER& header, SECTION section, uint32_t first, uint32_t count, void* pDestination);
+
+	// map a compiled scene, checking its header and sections
+	bool Open(const char* filename);
+	void Close();
+	bool IsOpen() const { return(NULL != m_pHeader); }
+	// size of the mapped file
+	uint64_t GetFileBytes() const { return(m_dataBytes); }
+	const std::string& GetError() const { return(m_error); }
+	const BINARY_HEADER& GetHeader() const { return(*m_pHeader); }
+
+	// the mapped arrays, valid until Close()
+	uint32_t GetObjectCount() const { return(m_pHeader->objectCount); }
+	const glm::mat4* GetTransforms() const { return((const glm::mat4*)GetSection(SECTION_TRANSFORMS)); }
+	const glm::vec3* GetBoundsMin() const { return((const glm::vec3*)GetSection(SECTION_BOUNDS_MIN)); }
+	const glm::vec3* GetBoundsMax() const { return((const glm::vec3*)GetSection(SECTION_BOUNDS_MAX)); }
+	const glm::vec4* GetColors() const { return((const glm::vec4*)GetSection(SECTION_COLORS)); }
+	const glm::vec2* GetUVScales() const { return((const glm::vec2*)GetSection(SECTION_UV_SCALES)); }
+	const uint32_t* GetMeshes() const { return((const uint32_t*)GetSection(SECTION_MESHES)); }
+	const int32_t* GetMaterialIDs() const { return((const int32_t*)GetSection(SECTION_MATERIAL_IDS)); }
+	const int32_t* GetTextureIDs() const { return((const int32_t*)GetSection(SECTION_TEXTURE_IDS)); }
+	const int32_t* GetParents() const { return((const int32_t*)GetSection(SECTION_PARENTS)); }
+	const uint32_t* GetStateBits() const { return((const uint32_t*)GetSection(SECTION_STATE_BITS)); }
+	const uint32_t* GetObjectIDs() const { return((const uint32_t*)GetSection(SECTION_OBJECT_IDS)); }
+	// the arrays of all the objects, as the renderer reads them
+	SceneManager::OBJECT_ARRAYS GetObjectArrays() const;
+
+	uint32_t GetTextureCount() const { return(m_pHeader->textureCount); }
+	const BINARY_TEXTURE* GetTextures() const { return((const BINARY_TEXTURE*)GetSection(SECTION_TEXTURES)); }
+	uint32_t GetMaterialCount() const { return(m_pHeader->materialCount); }
+	const BINARY_MATERIAL* GetMaterials() const { return((const BINARY_MATERIAL*)GetSection(SECTION_MATERIALS)); }
+	uint32_t GetLightCount() const { return(m_pHeader->lightCount); }
+	const BINARY_LIGHT* GetLights() const { return((const BINARY_LIGHT*)GetSection(SECTION_LIGHTS)); }
+	uint32_t GetSectorCount() const { return(m_pHeader->sectorCount); }
+	const BINARY_SECTOR* GetSectors() const { return((const BINARY_SECTOR*)GetSection(SECTION_SECTORS)); }
+	const uint32_t* GetSectorTextures() const { return((const uint32_t*)GetSection(SECTION_SECTOR_TEXTURES)); }
+	float GetSectorSize() const { return(m_pHeader->sectorSize); }
+	// get a string by its offset, empty when out of range
+	const char* GetString(uint32_t offset) const;
+
+private:
+	const unsigned char* m_pData;
+	uint64_t m_dataBytes;
+	const BINARY_HEADER* m_pHeader;
+	std::string m_error;
+#ifdef _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#endif
+
+	const unsigned char* GetSection(SECTION section) const { return(m_pData + m_pHeader->sectionOffsets[section]); }
+	bool CheckHeader();
+};
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// read the textures, materials, lights, prefabs and objects of a scene file
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "JsonStream.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class reads a JSON scene description one entry at a
+ *  time.  Each call to Next() fills in the next texture,
+ *  material, light, prefab or object in file order, so the caller can
+ *  put it straight where it is used without the whole file
+ *  being held as a tree.  Members that are not known are
+ *  skipped, members that are left out keep their defaults.
+ *
+ *  {
+ *    "textures":  [ { "tag", "path" } ],
+ *    "materials": [ { "tag", "ambientColor", "ambientStrength",
+ *                     "diffuseColor", "specularColor", "shininess" } ],
+ *    "lights":    [ { "position", "ambientColor", "diffuseColor",
+ *                     "specularColor", "focalStrength",
+ *                     "specularIntensity", "radius" } ],
+ *    "prefabs":   [ { "id", "parts": [ objects ] } ],
+ *    "objects":   [ { "id", "mesh", "scale", "rotation", "position",
+ *                     "material", "texture" or "color", "UVscale",
+ *                     "static" }
+ *                   or { "id", "prefab", "scale", "rotation", "position" } ]
+ *  }
+ *
+ *  A prefab is an assembly of parts placed relative to its
+ *  root, an object naming a prefab instead of a mesh places
+ *  the whole assembly with its transform.  Prefabs have to
+ *  come before the objects using them, and their parts cannot
+ *  be prefabs themselves.  An object marked static never moves
+ *  and is merged with the other static objects when loaded.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+
+	// kinds of entries in a scene file
+	enum ENTRY_TYPE
+	{
+		ENTRY_TEXTURE,
+		ENTRY_MATERIAL,
+		ENTRY_LIGHT,
+		ENTRY_PREFAB,
+		ENTRY_OBJECT
+	};
+
+	// one texture image and the tag it is used by
+	struct SCENE_TEXTURE
+	{
+		std::string tag;
+		std::string path;
+	};
+
+	// one drawn object, the rotation is in degrees about X, Y
+	// and Z, applied in that order; without a texture the color
+	// is drawn.  An instance of a prefab has its tag and no mesh
+	struct SCENE_OBJECT
+	{
+		std::string id;
+		std::string prefab;
+		SceneManager::MESH_TYPE mesh;
+		glm::vec3 scale;
+		glm::vec3 rotation;
+		glm::vec3 position;
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		std::string texture;
+		std::string material;
+		// never moves, so it can be merged into static geometry
+		bool bStatic;
+	};
+
+	// an assembly of objects, each placed relative to the root
+	// of the instances
+	struct SCENE_PREFAB
+	{
+		std::string id;
+		std::vector<SCENE_OBJECT> parts;
+	};
+
+	// the entry read by Next(), only the member of its type is
+	// filled in
+	struct SCENE_ENTRY
+	{
+		ENTRY_TYPE type;
+		SCENE_TEXTURE texture;
+		SceneManager::OBJECT_MATERIAL material;
+		SceneManager::LIGHT_SOURCE light;
+		SCENE_PREFAB prefab;
+		SCENE_OBJECT object;
+	};
+
+	// open a scene file, or scene text, for reading
+	bool Open(const std::string& filename);
+	void SetText(const std::string& text);
+	// read the next entry, false at the end of the file or on an
+	// error, which HasError() tells apart
+	bool Next(SCENE_ENTRY& entry);
+
+	bool HasError() const { return(m_json.HasError()); }
+	// the first error with its line
+	const std::string& GetError() const { return(m_json.GetError()); }
+
+	// get the name of a mesh, as used in scene files
+	static const char* GetMeshName(SceneManager::MESH_TYPE mesh);
+	// find a mesh by name
+	static bool FindMeshType(const char* name, SceneManager::MESH_TYPE& mesh);
+	// get the bounds of a basic shape mesh in its model space
+	static void GetMeshBounds(SceneManager::MESH_TYPE mesh, glm::vec3& boundsMin, glm::vec3& boundsMax);
+	// get the world space box around a mesh drawn with a model matrix
+	static void GetWorldBounds(SceneManager::MESH_TYPE mesh, const glm::mat4& model, glm::vec3& boundsMin, glm::vec3& boundsMax);
+	// get the world space box around a model space box
+	static void GetBoxWorldBounds(const glm::vec3& localMin, const glm::vec3& localMax, const glm::mat4& model, glm::vec3& boundsMin, glm::vec3& boundsMax);
+	// whether an object is merged into the static geometry,
+	// blended objects keep their place in the draw order
+	static bool IsStaticObject(const SCENE_OBJECT& object);
+	// get the model matrix of an object's transform
+	static glm::mat4 GetModelMatrix(const SCENE_OBJECT& object);
+	// get the state bits of a draw following the passed in one,
+	// or the first draw when there is none
+	static unsigned int GetStateBits(
+		const SceneManager::DRAW_COMMAND* pPrevious,
+		const SceneManager::DRAW_COMMAND& command);
+
+private:
+	// the sections of the file
+	enum SECTION
+	{
+		SECTION_NONE,
+		SECTION_TEXTURES,
+		SECTION_MATERIALS,
+		SECTION_LIGHTS,
+		SECTION_PREFABS,
+		SECTION_OBJECTS,
+		SECTION_UNKNOWN
+	};
+
+	JsonStream m_json;
+	// whether the top-level object has been entered
+	bool m_bStarted;
+	// the array being read, none between sections
+	SECTION m_section;
+	// reused member name
+	std::string m_name;
+
+	bool ReadTexture(SCENE_TEXTURE& texture);
+	bool ReadMaterial(SceneManager::OBJECT_MATERIAL& material);
+	bool ReadLight(SceneManager::LIGHT_SOURCE& light);
+	bool ReadPrefab(SCENE_PREFAB& prefab);
+	bool ReadObject(SCENE_OBJECT& object);
+	bool ReadVec3(glm::vec3& value);
+};
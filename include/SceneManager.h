@@ -1,110 +1,479 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void LoadSceneTextures();
-	void PrepareScene();
-	void RenderScene();
-	void DefineObjectMaterials();
-	void SetupSceneLights();
-
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "FrameArena.h"
+
+#include <string>
+#include <vector>
+
+class SceneBinary;
+class SceneStreamer;
+class ScenePreloader;
+class ObjectStore;
+class PrefabStore;
+class StaticBatches;
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	struct LIGHT_SOURCE
+	{
+		glm::vec3 position;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+		// distance the light is meant to reach, drawn as its
+		// debug volume; the shader does not attenuate by it
+		float radius;
+	};
+
+	// basic shape meshes that can be drawn in the scene
+	enum MESH_TYPE
+	{
+		MESH_PLANE,
+		MESH_BOX,
+		MESH_CYLINDER,
+		MESH_TORUS,
+		MESH_COUNT,
+		// a batch of merged static geometry, not a scene file mesh
+		MESH_STATIC_BATCH
+	};
+
+	// which shader settings a draw command changes, in the
+	// order the setters were called before the draw
+	enum DRAW_STATE
+	{
+		DRAW_STATE_COLOR = 1,
+		DRAW_STATE_TEXTURE = 2,
+		DRAW_STATE_MATERIAL = 4,
+		DRAW_STATE_UVSCALE = 8
+	};
+
+	// ways of sending the frame packet's shader settings
+	enum SUBMIT_STRATEGY
+	{
+		// the settings changed by the setters before each draw
+		SUBMIT_CHANGED_STATE,
+		// every setting before every draw
+		SUBMIT_FULL_STATE,
+		// the settings whose values differ from the last ones sent
+		SUBMIT_FILTERED_STATE,
+		SUBMIT_STRATEGY_COUNT
+	};
+
+	// passes the frame packet is rendered with
+	enum RENDER_MODE
+	{
+		// one shaded pass
+		RENDER_FORWARD,
+		// a depth-only pass of the opaque draws first, so the
+		// shaded pass only shades the visible fragments
+		RENDER_DEPTH_PREPASS,
+		RENDER_MODE_COUNT
+	};
+
+	// one recorded draw of the frame packet, the shader settings
+	// are the ones in effect for the draw, the state bits tell
+	// which of them have to be sent before it
+	struct DRAW_COMMAND
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		MESH_TYPE mesh;
+		// the static batch drawn, for MESH_STATIC_BATCH
+		uint32_t batch;
+		int textureSlot;
+		int materialIndex;
+		bool bUseTexture;
+		unsigned int stateBits;
+	};
+
+	// the per-object arrays of a compiled scene that draws are
+	// recorded from, where they are mapped or where a streamed
+	// sector was read to
+	struct OBJECT_ARRAYS
+	{
+		uint32_t count;
+		const glm::mat4* pTransforms;
+		const glm::vec4* pColors;
+		const glm::vec2* pUVScales;
+		const uint32_t* pMeshes;
+		const int32_t* pMaterialIDs;
+		const int32_t* pTextureIDs;
+		const uint32_t* pStateBits;
+	};
+
+	// handle of an object of the retained draw list, valid until
+	// the object is destroyed or the list is read again; a zero
+	// generation is never valid
+	struct OBJECT_HANDLE
+	{
+		uint32_t slot;
+		uint32_t generation;
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// vertex array and buffers of a basic shape mesh, uploaded
+	// from the optimized triangles of ShapeGeometry
+	struct SHAPE_MESH
+	{
+		GLuint vertexArray;
+		GLuint vertexBuffer;
+		GLuint indexBuffer;
+		GLsizei indexCount;
+	};
+	SHAPE_MESH m_shapeMeshes[MESH_COUNT];
+	// total number of loaded textures
+	int m_loadedTextures;
+	// loaded textures info
+	TEXTURE_INFO m_textureIDs[16];
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// light sources set into the shader
+	std::vector<LIGHT_SOURCE> m_lightSources;
+	// number of mesh draws issued by the last RenderScene() call
+	int m_drawCallCount;
+	// memory for the transient data of the frame being rendered
+	FrameArena m_frameArena;
+	// draws recorded by RenderScene(), submitted at its end
+	FrameVector<DRAW_COMMAND> m_framePacket;
+	// objects loaded from the scene file, culled and recorded
+	// into every frame packet, and the id of each object
+	ObjectStore* m_pSceneObjects;
+	std::vector<std::string> m_sceneObjectIDs;
+	// prefabs of the scene file and the instances placing them,
+	// culled by instance and recorded after the objects
+	PrefabStore* m_pScenePrefabs;
+	// static objects of the scene file merged into batches, and
+	// the edge of the grid cells splitting them
+	StaticBatches* m_pStaticBatches;
+	float m_staticChunkSize;
+	// compiled scene whose mapped arrays are drawn instead of the
+	// retained draws
+	SceneBinary* m_pSceneBinary;
+	// slot of each texture of a compiled or baked scene
+	std::vector<int> m_sceneTextureSlots;
+	// a texture failed to load, so the compiled or baked state
+	// bits do not hold and every setting is sent before every draw
+	bool m_bSceneFullState;
+	// streams the sectors of a compiled scene around the camera,
+	// when a budget is set before the scene is prepared
+	SceneStreamer* m_pSceneStreamer;
+	size_t m_streamBudgetBytes;
+	float m_streamRadius;
+	// camera position of the last streaming update
+	glm::vec3 m_streamCameraPosition;
+
+	// slot map from object handles to the retained draws, which
+	// stay densely packed in draw order
+	struct OBJECT_SLOT
+	{
+		// the object's draw while it exists, the next free slot
+		// while it does not
+		uint32_t index;
+		uint32_t generation;
+	};
+	struct OBJECT_SLOTS
+	{
+		std::vector<OBJECT_SLOT> slots;
+		// slot of each retained draw
+		std::vector<uint32_t> drawSlots;
+		// head of the free slots
+		uint32_t firstFree;
+	};
+	OBJECT_SLOTS m_objectSlots;
+	// generation given to the next object, counting across the
+	// resident scenes so a handle only matches its own object
+	uint32_t m_nextObjectGeneration;
+
+	// a scene description file held in memory, ready to switch
+	// to; the one being drawn keeps its objects, materials and
+	// lights in the members above, and its entry holds them
+	// while another one is drawn
+	struct RESIDENT_SCENE
+	{
+		std::string filename;
+		std::vector<OBJECT_MATERIAL> materials;
+		std::vector<LIGHT_SOURCE> lights;
+		ObjectStore* pObjects;
+		std::vector<std::string> objectIDs;
+		PrefabStore* pPrefabs;
+		StaticBatches* pStatic;
+		OBJECT_SLOTS objectSlots;
+		// texture slots the scene holds a reference to
+		std::vector<int> textureSlots;
+		bool bReady;
+		bool bFailed;
+	};
+	std::vector<RESIDENT_SCENE> m_residentScenes;
+	int m_activeScene;
+	// resident scenes using each texture slot, the textures are
+	// shared by tag and freed with their last scene
+	int m_textureReferences[16];
+	// reads the scene being preloaded, and its index
+	ScenePreloader* m_pScenePreloader;
+	int m_preloadingScene;
+	// how the frame packet is sent to OpenGL
+	SUBMIT_STRATEGY m_submitStrategy;
+	// passes the frame packet is rendered with
+	RENDER_MODE m_renderMode;
+	// camera matrices of the frame, for the depth pre-pass
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	// depth-only program of the pre-pass and its uniforms
+	GLuint m_depthProgram;
+	GLint m_depthModelLocation;
+	GLint m_depthViewLocation;
+	GLint m_depthProjectionLocation;
+
+	// lights the scene shader has room for
+	static const int MAX_SCENE_LIGHTS = 4;
+
+	// locations of the members of one light in the shader
+	struct LIGHT_UNIFORMS
+	{
+		GLint position;
+		GLint ambientColor;
+		GLint diffuseColor;
+		GLint specularColor;
+		GLint focalStrength;
+		GLint specularIntensity;
+	};
+
+	// shader uniform locations, looked up once so that setting
+	// them needs no string handling during the frame
+	struct SHADER_UNIFORMS
+	{
+		GLint model;
+		GLint objectColor;
+		GLint objectTexture;
+		GLint useTexture;
+		GLint UVscale;
+		GLint ambientColor;
+		GLint ambientStrength;
+		GLint diffuseColor;
+		GLint specularColor;
+		GLint shininess;
+		GLint useLighting;
+		LIGHT_UNIFORMS lights[MAX_SCENE_LIGHTS];
+	};
+	SHADER_UNIFORMS m_uniforms;
+
+	// look up the uniform locations of the active shader program
+	void FindShaderUniforms();
+
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, std::string tag);
+	// create an OpenGL texture with mipmaps from decoded pixels,
+	// 0 when the channel count is not supported
+	GLuint UploadGLTexture(const unsigned char* image, int width, int height, int colorChannels, const std::string& tag, size_t& bytes);
+	// upload a streamed or preloaded texture into a free slot, -1
+	// when none is free, and free a slot keeping the slots of the
+	// others
+	int AddTextureToFreeSlot(const unsigned char* image, int width, int height, int colorChannels, const std::string& tag, size_t& bytes);
+	void ReleaseTextureSlot(int slot);
+	// bind loaded OpenGL textures to slots in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find the slot of a loaded texture by tag
+	int FindTextureSlot(const char* tag);
+	// find the index of a defined material by tag
+	int FindMaterialIndex(const char* tag);
+
+	// upload a basic shape mesh, and free all of them
+	void LoadShapeMesh(MESH_TYPE mesh);
+	void DestroyShapeMeshes();
+	// send the recorded draws of the frame to OpenGL
+	void SubmitFramePacket();
+	// build the depth-only program of the pre-pass
+	void CreateDepthProgram();
+	// lay down the depth of the opaque recorded draws
+	void SubmitDepthPrepass();
+	// draw the loaded basic shape mesh or static batch of a draw
+	bool DrawBasicMesh(const DRAW_COMMAND& command);
+	// send the shader settings of a draw for each strategy
+	void SubmitChangedState(const DRAW_COMMAND& command);
+	void SubmitFullState(const DRAW_COMMAND& command);
+	void SubmitFilteredState(const DRAW_COMMAND& command, const DRAW_COMMAND*& pLastSent);
+	// send the values of a material into the shader
+	void SubmitMaterial(int materialIndex);
+	// read the textures, materials, lights and objects of a
+	// scene description file
+	bool LoadSceneFile(const char* filename);
+	// set the texture and material of a scene file object's draw
+	// from their tags
+	void ResolveSceneDraw(const std::string& id, const std::string& texture, const std::string& material, const std::vector<OBJECT_MATERIAL>& materials, DRAW_COMMAND& command);
+	// count a resident scene's reference to a texture slot once
+	void AddSceneTextureReference(RESIDENT_SCENE& scene, int slot);
+	// build the preloaded scene once its file has been read
+	void FinishPreloadedScene();
+	// account the materials and the retained draws of a scene,
+	// recorded by the stores themselves so the records follow
+	// their scene when it is switched out and back in
+	void RegisterSceneMemory(const std::vector<OBJECT_MATERIAL>& materials, const ObjectStore* pObjects, const PrefabStore* pPrefabs, const StaticBatches* pStatic);
+	void ReleaseSceneMemory(const std::vector<OBJECT_MATERIAL>& materials, const ObjectStore* pObjects, const PrefabStore* pPrefabs, const StaticBatches* pStatic);
+	// give every draw of a retained list a new handle, and take
+	// or give back one slot
+	void ResetObjectSlots(OBJECT_SLOTS& objectSlots, size_t drawCount);
+	uint32_t AllocateObjectSlot(OBJECT_SLOTS& objectSlots, size_t drawIndex);
+	void FreeObjectSlot(OBJECT_SLOTS& objectSlots, uint32_t slot);
+	// the position of a valid handle's object
+	bool FindObjectIndex(OBJECT_HANDLE object, uint32_t& index) const;
+	// map a compiled scene and load its textures, materials and
+	// lights
+	bool LoadSceneBinary(const char* filename);
+	// record the draws of a compiled scene's object arrays
+	void RecordObjectArrays(const OBJECT_ARRAYS& arrays, bool bFullState);
+	// record the objects culling left visible, with the state
+	// bits that follow from the draw recorded before each
+	void RecordSceneObjects();
+	// record the parts of the prefab instances culling left
+	// visible, one part of every instance after the other
+	void RecordScenePrefabs();
+	// record the static batches culling left visible
+	void RecordStaticBatches();
+	// record the resident sectors of a streamed scene, and the
+	// proxies of the others
+	void RecordStreamedScene();
+	// load the textures, materials and lights of the scene baked
+	// into the build, and record its draws
+	bool LoadBakedScene();
+	void RecordBakedScene();
+	// load the textures of a compiled or baked scene into slots
+	void LoadSceneTexture(int index, const char* path, const char* tag);
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	bool PrepareScene(const char* sceneFile);
+	void RenderScene();
+	void SetupSceneLights();
+
+	// get the number of mesh draws issued by the last rendered frame
+	int GetDrawCallCount() const { return(m_drawCallCount); }
+	// get the most draws a frame of the loaded scene records,
+	// when nothing is culled
+	uint32_t GetSceneDrawCount() const;
+	// select how the frame packet is sent to OpenGL
+	void SetSubmitStrategy(SUBMIT_STRATEGY strategy) { m_submitStrategy = strategy; }
+	SUBMIT_STRATEGY GetSubmitStrategy() const { return(m_submitStrategy); }
+	// get the name of a strategy, as used on the command line
+	static const char* GetSubmitStrategyName(SUBMIT_STRATEGY strategy);
+	// find a strategy by name
+	static bool FindSubmitStrategy(const char* name, SUBMIT_STRATEGY& strategy);
+
+	// select the passes the frame packet is rendered with
+	void SetRenderMode(RENDER_MODE mode);
+	RENDER_MODE GetRenderMode() const { return(m_renderMode); }
+	// get the name of a render mode, as used on the command line
+	static const char* GetRenderModeName(RENDER_MODE mode);
+	// find a render mode by name
+	static bool FindRenderMode(const char* name, RENDER_MODE& mode);
+	// set the camera matrices of the frame about to be rendered
+	void SetViewMatrices(const glm::mat4& view, const glm::mat4& projection);
+	// stream the sectors of a compiled scene within a memory
+	// budget, set before the scene is prepared; a zero radius
+	// follows the scene's sector size
+	void SetStreaming(size_t budgetBytes, float radius);
+	// edge of the grid cells the static objects are merged by,
+	// set before the scene is prepared; zero merges all of a
+	// kind into one batch
+	void SetStaticChunkSize(float chunkSize) { m_staticChunkSize = chunkSize; }
+	// get the world box of a static batch
+	void GetStaticBatchBounds(uint32_t batch, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+	// follow the camera with the streamed sectors, once a frame
+	void UpdateStreaming(const glm::vec3& position, const glm::vec3& velocity);
+
+	// draw the meshes recorded in the last frame packet with
+	// only their model matrix, for the program that is in use
+	void DrawFramePacketGeometry(GLint modelLocation);
+	// get the draws recorded by the last RenderScene() call
+	const FrameVector<DRAW_COMMAND>& GetFramePacket() const { return(m_framePacket); }
+	// read another scene description file in the background,
+	// sharing the meshes, programs and textures with the scenes
+	// already resident; returns the scene's index, or -1 when
+	// another scene is still preloading
+	int PreloadScene(const char* sceneFile);
+	// finish the preloaded scene a piece at a time, once a frame
+	void UpdatePreloading();
+	bool IsSceneReady(int scene) const;
+	bool HasSceneFailed(int scene) const;
+	// draw a ready resident scene from the next frame on
+	bool SwitchScene(int scene);
+	// free a resident scene that is not drawn, and the textures
+	// no other scene uses
+	bool UnloadScene(int scene);
+	int GetActiveScene() const { return(m_activeScene); }
+	const char* GetSceneFilename(int scene) const { return(m_residentScenes[scene].filename.c_str()); }
+	// apply the changes of an edited scene file to the loaded
+	// scene, matching its objects by id
+	bool ReloadSceneFile(const char* filename);
+	// check that the scene baked into the build matches what the
+	// scene file loader makes of the passed in scene file
+	static bool VerifyBakedScene(const char* sceneFile);
+	// add, remove and change objects of the retained draw list,
+	// each in constant time; removing moves the last draw into
+	// the hole, which changes the draw order, and a new object
+	// keeps the material and texture of the draw last in that
+	// order, like a scene file object without them
+	OBJECT_HANDLE CreateObject(const char* id, MESH_TYPE mesh, const glm::mat4& model, const glm::vec4& color);
+	bool DestroyObject(OBJECT_HANDLE object);
+	bool SetObjectTransform(OBJECT_HANDLE object, const glm::mat4& model);
+	bool SetObjectMaterial(OBJECT_HANDLE object, const char* materialTag);
+	// a NULL tag draws the object with its color
+	bool SetObjectTexture(OBJECT_HANDLE object, const char* textureTag);
+	bool IsObjectValid(OBJECT_HANDLE object) const;
+	// get the handle of an object by its id, searching the list
+	OBJECT_HANDLE FindObject(const char* id) const;
+	// get the ids of the scene file's objects, in draw order
+	const std::vector<std::string>& GetSceneObjectIDs() const { return(m_sceneObjectIDs); }
+	// get the light sources of the scene
+	const std::vector<LIGHT_SOURCE>& GetLightSources() const { return(m_lightSources); }
+
+	// get the per-frame arena, for reporting its usage
+	const FrameArena& GetFrameArena() const { return(m_frameArena); }
+
 };
\ No newline at end of file
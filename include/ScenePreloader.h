@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenepreloader.h
+// ============
+// read the next scene description file on a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneBinary.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  ScenePreloader
+ *
+ *  This class reads a scene description file and decodes the
+ *  images of its textures on a background thread, while the
+ *  render thread keeps drawing the current scene.  Textures
+ *  whose tags are already resident are not decoded, as the
+ *  scene that is loaded will share them.  The render thread
+ *  polls IsFinished() once a frame and then takes the decoded
+ *  images one at a time, so the uploads can be spread over
+ *  the frames.  One file is read at a time.
+ ***********************************************************/
+class ScenePreloader
+{
+public:
+	// constructor
+	ScenePreloader();
+	// destructor
+	~ScenePreloader();
+
+	// pixels of a texture decoded by the background thread
+	struct DECODED_IMAGE
+	{
+		std::string tag;
+		unsigned char* pPixels;
+		int width;
+		int height;
+		int channels;
+	};
+
+	// start reading a scene file, skipping the images of the
+	// passed in resident texture tags
+	bool Start(const char* filename, const std::vector<std::string>& residentTags);
+	// whether a file is being read or its results not yet taken
+	bool IsBusy() const { return(m_thread.joinable()); }
+	// whether the background thread is done with the file
+	bool IsFinished() const { return(m_bFinished.load(std::memory_order_acquire)); }
+	// whether the finished file was read without errors
+	bool HasSucceeded() const { return(m_bSucceeded); }
+	const std::string& GetError() const { return(m_error); }
+	const std::string& GetFilename() const { return(m_filename); }
+
+	// the scene read by the finished thread
+	const SceneBinary::SCENE_SOURCE& GetSource() const { return(m_source); }
+	// take the next decoded image, and free its pixels after
+	bool TakeImage(DECODED_IMAGE& image);
+	static void FreeImage(DECODED_IMAGE& image);
+	// wait for the thread and drop what it read, ready for the
+	// next file
+	void Reset();
+
+private:
+	// read the file and decode its images
+	void ThreadMain();
+
+	std::string m_filename;
+	std::vector<std::string> m_residentTags;
+	std::thread m_thread;
+	// set by the background thread once the results below are
+	// written, they are only read by the render thread after
+	std::atomic<bool> m_bFinished;
+	bool m_bSucceeded;
+	std::string m_error;
+	SceneBinary::SCENE_SOURCE m_source;
+	std::vector<DECODED_IMAGE> m_images;
+	// images handed out by TakeImage()
+	size_t m_takenImages;
+};
@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenestreamer.h
+// ============
+// load and unload the sectors of a compiled scene around the camera
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneBinary.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  SceneStreamer
+ *
+ *  This class keeps the sectors of a compiled scene near the
+ *  camera in memory.  Background threads read the object
+ *  ranges of the sectors and decode the textures they use;
+ *  the render thread only hands out the requests and takes
+ *  the finished work in Update(), so a frame never waits for
+ *  the disk.  Sectors are wanted within the load radius of
+ *  the camera or of where its velocity takes it, and are kept
+ *  until they are a margin further away.  When the memory
+ *  budget is full, sectors further away than a wanted one are
+ *  dropped to make room, and the rest stay unloaded.
+ *
+ *  Textures are held while a resident sector uses them.  The
+ *  decoded pixels are handed to the scene manager, which owns
+ *  the texture slots, and the slots it gives them are kept
+ *  here until the texture is released.
+ ***********************************************************/
+class SceneStreamer
+{
+public:
+	// constructor
+	SceneStreamer();
+	// destructor
+	~SceneStreamer();
+
+	struct STREAM_SETTINGS
+	{
+		// bytes of sector arrays and textures held at most
+		size_t budgetBytes;
+		// distance from the camera to a sector's box within which
+		// it is loaded, and the further distance it is kept to
+		float loadRadius;
+		float unloadMargin;
+		// seconds of camera motion to load ahead for
+		float lookAheadSeconds;
+		int threadCount;
+	};
+
+	// a texture decoded by a background thread, waiting to be
+	// uploaded by the render thread
+	struct DECODED_TEXTURE
+	{
+		uint32_t textureID;
+		unsigned char* pPixels;
+		int width;
+		int height;
+		int channels;
+	};
+
+	// start the threads streaming the sectors of a mapped scene
+	bool Start(const char* filename, const SceneBinary* pScene, const STREAM_SETTINGS& settings);
+	// stop the threads and free the loaded sectors
+	void Stop();
+	bool IsRunning() const { return(m_threads.empty() == false); }
+
+	// choose the sectors to hold for the camera, hand out their
+	// reads and take the finished ones, once a frame
+	void Update(const glm::vec3& position, const glm::vec3& velocity);
+
+	// whether a sector's arrays are loaded, and its textures
+	bool IsSectorResident(uint32_t sector) const { return(m_sectors[sector].state == SECTOR_RESIDENT); }
+	bool AreSectorTexturesResident(uint32_t sector) const;
+	// the loaded arrays of a resident sector
+	SceneManager::OBJECT_ARRAYS GetSectorObjects(uint32_t sector) const;
+
+	// take a decoded texture to upload, and free its pixels after
+	void TakeDecodedTexture(DECODED_TEXTURE& texture);
+	bool HasDecodedTexture() const { return(m_decodedTextures.empty() == false); }
+	static void FreeDecodedTexture(DECODED_TEXTURE& texture);
+	// record the slot an uploaded texture got, -1 when none was free
+	void SetTextureSlot(uint32_t textureID, int slot, size_t bytes);
+	// take a texture no resident sector uses any more
+	bool TakeReleasedTexture(uint32_t& textureID);
+
+	// bytes of the resident sectors and textures
+	size_t GetResidentBytes() const { return(m_residentBytes); }
+	uint32_t GetResidentSectorCount() const { return(m_residentSectors); }
+
+	// print the loads, unloads and memory of the run
+	void PrintReport(FILE* output) const;
+
+private:
+	enum SECTOR_STATE
+	{
+		SECTOR_UNLOADED,
+		// handed to a thread, not finished yet
+		SECTOR_LOADING,
+		SECTOR_RESIDENT
+	};
+
+	// the arrays of one sector, read by a background thread
+	struct SECTOR_DATA
+	{
+		std::vector<glm::mat4> transforms;
+		std::vector<glm::vec4> colors;
+		std::vector<glm::vec2> UVscales;
+		std::vector<uint32_t> meshes;
+		std::vector<int32_t> materialIDs;
+		std::vector<int32_t> textureIDs;
+		std::vector<uint32_t> stateBits;
+		size_t bytes;
+	};
+
+	struct SECTOR_SLOT
+	{
+		SECTOR_STATE state;
+		// counts the loads, so a finished read of a sector that
+		// was dropped meanwhile is recognized and discarded
+		uint32_t generation;
+		SECTOR_DATA* pData;
+		// distance to the camera or to where it is heading
+		float distance;
+		// the read failed, the proxy is drawn from then on
+		bool bFailed;
+	};
+
+	struct TEXTURE_SLOT
+	{
+		// resident sectors using the texture
+		int references;
+		// handed to a thread or waiting for upload
+		bool bDecoding;
+		// texture slot of the scene manager, -1 when not uploaded
+		int slot;
+		size_t bytes;
+	};
+
+	enum REQUEST_TYPE
+	{
+		REQUEST_SECTOR,
+		REQUEST_TEXTURE
+	};
+
+	// work for the background threads, and the finished work
+	struct REQUEST
+	{
+		REQUEST_TYPE type;
+		uint32_t index;
+		uint32_t generation;
+		SECTOR_DATA* pData;
+		DECODED_TEXTURE texture;
+		bool bSucceeded;
+	};
+
+	std::string m_filename;
+	const SceneBinary* m_pScene;
+	STREAM_SETTINGS m_settings;
+
+	// state of the sectors and textures, render thread only
+	std::vector<SECTOR_SLOT> m_sectors;
+	std::vector<TEXTURE_SLOT> m_textures;
+	// sector indices ordered by distance, reused every frame
+	std::vector<uint32_t> m_sectorOrder;
+	std::vector<DECODED_TEXTURE> m_decodedTextures;
+	std::vector<uint32_t> m_releasedTextures;
+	// work in flight, to keep the queue short and near the camera
+	int m_inFlight;
+	size_t m_inFlightBytes;
+	size_t m_residentBytes;
+	uint32_t m_residentSectors;
+	// no slot was free for the last upload, retried once one is
+	bool m_bTextureSlotsFull;
+
+	// statistics of the run
+	uint64_t m_sectorLoads;
+	uint64_t m_sectorUnloads;
+	uint64_t m_discardedLoads;
+	uint64_t m_budgetDeferrals;
+	size_t m_peakResidentBytes;
+
+	// shared with the background threads
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::deque<REQUEST> m_requests;
+	std::vector<REQUEST> m_finished;
+	// taken from m_finished under the lock, reused every frame
+	std::vector<REQUEST> m_taken;
+	bool m_bStopping;
+	std::vector<std::thread> m_threads;
+
+	// read the requests handed to a background thread
+	void ThreadMain();
+	bool ReadSector(FILE* file, uint32_t sector, SECTOR_DATA& data) const;
+	bool DecodeTexture(uint32_t textureID, DECODED_TEXTURE& texture) const;
+
+	// take the finished work of the background threads
+	void TakeFinished();
+	// hand a request to the background threads
+	void Queue(REQUEST_TYPE type, uint32_t index, bool bUrgent);
+	// drop a resident sector and its texture references
+	void UnloadSector(uint32_t sector);
+	// count a texture reference, requesting the texture if needed
+	void AddTextureReference(uint32_t textureID);
+	void ReleaseTextureReference(uint32_t textureID);
+	// distance from a point to a sector's box
+	float GetSectorDistance(uint32_t sector, const glm::vec3& point) const;
+	// estimated bytes of a sector's arrays
+	size_t GetSectorBytes(uint32_t sector) const;
+};
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenewatcher.h
+// ============
+// notice edits of the scene description file while the application runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/***********************************************************
+ *  SceneWatcher
+ *
+ *  This class watches the scene description file for edits.
+ *  On Linux it is told of writes through inotify on the
+ *  file's directory, so editors that save by renaming a new
+ *  file over the old one are noticed too; elsewhere the
+ *  file's time and size are checked twice a second.  A change
+ *  is only reported once the file has been quiet for a short
+ *  time, so a save made of several writes reloads once.
+ ***********************************************************/
+class SceneWatcher
+{
+public:
+	// constructor
+	SceneWatcher();
+	// destructor
+	~SceneWatcher();
+
+	// start watching the passed in file
+	bool Start(const char* filename);
+	// stop watching
+	void Stop();
+	// whether a file is watched
+	bool IsWatching() const { return(m_bWatching); }
+	// whether the file changed since the last call, checked once
+	// a frame; it does not block and does not allocate
+	bool HasChanged();
+
+private:
+	// whether the file changed since the last check
+	bool PollChanges();
+
+	bool m_bWatching;
+	std::string m_filename;
+	// name of the file within its directory, to filter events
+	std::string m_baseName;
+	// inotify descriptor and watch, -1 when not used
+	int m_notifyFD;
+	int m_watchFD;
+	// time and size at the last check when polling the file
+	long long m_modifiedTime;
+	long long m_fileSize;
+	std::chrono::steady_clock::time_point m_nextPoll;
+	// a change was seen and is reported once the file is quiet
+	bool m_bPending;
+	std::chrono::steady_clock::time_point m_lastEvent;
+};
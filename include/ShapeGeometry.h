@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.h
+// ============
+// generate the primitive shapes as indexed triangles in model space
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <vector>
+
+/***********************************************************
+ *  ShapeGeometry
+ *
+ *  This class generates the triangles of the primitive shapes
+ *  on the CPU.  The scene uploads them as the meshes every
+ *  object is drawn with, and the static batches merge them in
+ *  world space.  The vertices are laid out as the shape
+ *  meshes lay out theirs, and the shapes are generated to
+ *  the same extents.
+ *
+ *  The shapes are built once, welded and reordered by
+ *  MeshOptimizer, which reports the vertex cache and fetch
+ *  statistics of each shape before and after, so the scene
+ *  compiler can print them without a GL context.
+ ***********************************************************/
+class ShapeGeometry
+{
+public:
+	// one vertex, position, normal and texture coordinates
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 UV;
+	};
+
+	// the triangles of a shape in model space
+	struct GEOMETRY
+	{
+		std::vector<VERTEX> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	// build and optimize the shapes now rather than on first use
+	static void Prepare();
+	// the triangles of a shape, built on first use
+	static const GEOMETRY& GetMeshGeometry(SceneManager::MESH_TYPE mesh);
+};
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+// startupprofiler.h
+// ============
+// time every startup phase and asset up to the first presented frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+/***********************************************************
+ *  StartupProfiler
+ *
+ *  This class records the wall, CPU and I/O time of the
+ *  startup phases and of the assets loaded within them, from
+ *  process start to the first glfwSwapBuffers().  Phases can
+ *  nest, so an asset is recorded inside its loading phase.
+ ***********************************************************/
+class StartupProfiler
+{
+public:
+	// open a phase, nested inside the currently open phase
+	static void BeginPhase(const std::string& name);
+	// close the most recently opened phase
+	static void EndPhase();
+	// add time spent waiting on file reads to the open phases
+	static void AddIOTime(double milliseconds);
+
+	// mark the first presented frame, which ends the profile
+	static void MarkFirstFrame();
+	static bool IsFirstFrameMarked();
+	// milliseconds from process start to the first frame
+	static double GetTimeToFirstFrame();
+
+	// print the phases as a table
+	static void PrintReport(FILE* output);
+	// write the phases as a JSON file
+	static bool WriteJSON(const char* filename);
+
+	// opens a phase for the lifetime of the object
+	class Scope
+	{
+	public:
+		Scope(const std::string& name) { BeginPhase(name); }
+		~Scope() { EndPhase(); }
+	};
+};
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatches.h
+// ============
+// merge the static objects of a scene into world space batches
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <vector>
+
+/***********************************************************
+ *  StaticBatches
+ *
+ *  This class merges the objects of a scene that never move
+ *  into batches of world space geometry.  Objects drawn with
+ *  the same shader settings, and whose boxes are centered in
+ *  the same cell of a grid, share a batch, so a batch is one
+ *  draw with the identity model matrix in place of a draw per
+ *  object, and can still be culled by its box.  The vertices
+ *  of all batches are held in one vertex and index buffer.
+ *
+ *  The shapes come from ShapeGeometry, which lays out their
+ *  vertices as the shape meshes do, position, normal and
+ *  texture coordinates in attributes 0 to 2, so the scene
+ *  shader draws them unchanged.  Batches copy the optimized
+ *  order of each shape object by object.
+ ***********************************************************/
+class StaticBatches
+{
+public:
+	// constructor
+	StaticBatches();
+	// destructor
+	~StaticBatches();
+
+	// one merged draw, a range of the index buffer
+	struct BATCH
+	{
+		// the shader settings, with the identity model matrix
+		SceneManager::DRAW_COMMAND draw;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		uint32_t objectCount;
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+	};
+
+	// add a static object, merged by the next Build()
+	void Add(const SceneManager::DRAW_COMMAND& draw);
+	uint32_t GetObjectCount() const { return((uint32_t)m_objects.size()); }
+	// merge the added objects into batches by grid cells of the
+	// passed in edge, zero for one cell, and upload them
+	void Build(float chunkSize);
+	// remove the objects and batches and free the buffers
+	void Clear();
+
+	uint32_t GetBatchCount() const { return((uint32_t)m_batches.size()); }
+	const BATCH& GetBatch(uint32_t batch) const { return(m_batches[batch]); }
+	// mark the batches whose boxes are in the frustum of the
+	// passed in matrix, and get their number
+	uint32_t Cull(const glm::mat4& viewProjection);
+	bool IsVisible(uint32_t batch) const { return(0 != m_visible[batch]); }
+	// draw a batch with the program in use
+	void Draw(uint32_t batch) const;
+
+	// bytes of the object and batch tables, and of the buffers
+	size_t GetBytes() const;
+	size_t GetBufferBytes() const { return(m_bufferBytes); }
+
+private:
+	// the objects as they were added, kept to build again
+	std::vector<SceneManager::DRAW_COMMAND> m_objects;
+	std::vector<BATCH> m_batches;
+	// written by Cull()
+	std::vector<uint8_t> m_visible;
+
+	GLuint m_vertexArray;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	size_t m_bufferBytes;
+
+	// free the vertex array and buffers
+	void DestroyBuffers();
+};
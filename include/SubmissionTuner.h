@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+// submissiontuner.h
+// ============
+// pick the fastest way of submitting the scene's draws on this renderer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+#include <string>
+
+/***********************************************************
+ *  SubmissionTuner
+ *
+ *  This class times every submission strategy of the scene
+ *  manager on the real scene at startup, from a fixed camera
+ *  pose, and selects the fastest.  The choice is cached per
+ *  GL_RENDERER string so later runs on the same driver skip
+ *  the calibration.
+ ***********************************************************/
+class SubmissionTuner
+{
+public:
+	// constructor
+	SubmissionTuner(
+		SceneManager* pSceneManager,
+		ViewManager* pViewManager);
+
+	// select the cached strategy for the current renderer, or
+	// calibrate and cache it when there is none
+	void SelectStrategy(const char* cacheFile, bool bRecalibrate);
+	// time every strategy and return the fastest
+	SceneManager::SUBMIT_STRATEGY Calibrate();
+
+	// read and write the strategy cached for a renderer
+	static bool LoadCachedStrategy(
+		const char* cacheFile,
+		const std::string& renderer,
+		SceneManager::SUBMIT_STRATEGY& strategy);
+	static bool SaveCachedStrategy(
+		const char* cacheFile,
+		const std::string& renderer,
+		SceneManager::SUBMIT_STRATEGY strategy);
+
+private:
+	// pointer to scene manager object
+	SceneManager* m_pSceneManager;
+	// pointer to view manager object
+	ViewManager* m_pViewManager;
+};
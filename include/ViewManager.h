@@ -1,48 +1,104 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	// scroll wheel callback for scroll wheel activity
-	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "InputLog.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	// scroll wheel callback for scroll wheel activity
+	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+
+	// recorded or replayed camera input
+	InputLog m_inputLog;
+	// locations of the view uniforms in the shader program
+	GLint m_viewLocation;
+	GLint m_projectionLocation;
+	GLint m_viewPositionLocation;
+	// matrices set into the shader by the last PrepareSceneView()
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	// camera position of the last frame and the smoothed velocity
+	glm::vec3 m_lastCameraPosition;
+	glm::vec3 m_cameraVelocity;
+
+	// process keyboard events for interaction with the 3D scene
+	void ProcessKeyboardEvents();
+	// collect the live keyboard and mouse input for this frame
+	void CaptureInputFrame(InputLog::INPUT_FRAME& input);
+	// move the camera according to one frame of input
+	void ApplyInputFrame(const InputLog::INPUT_FRAME& input);
+	// get the projection of the window for a camera zoom
+	glm::mat4 GetProjection(float zoom, bool bOrthographic) const;
+	// set the prepared matrices and the camera position into
+	// the shader
+	void SetShaderView(const glm::vec3& position);
+
+public:
+	// set the size of the display window before it is created
+	void SetWindowSize(int width, int height);
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+
+	// get the matrices of the last prepared view
+	const glm::mat4& GetViewMatrix() const { return(m_view); }
+	const glm::mat4& GetProjectionMatrix() const { return(m_projection); }
+	// get the camera position and its velocity in units a second
+	glm::vec3 GetCameraPosition() const;
+	const glm::vec3& GetCameraVelocity() const { return(m_cameraVelocity); }
+
+	// place the camera at a fixed pose for repeatable rendering
+	void SetCameraPose(
+		glm::vec3 position,
+		glm::vec3 front,
+		float zoom,
+		bool bOrthographic);
+
+	// set the matrices of a fixed camera pose into the shader,
+	// leaving the camera, its velocity and the input untouched
+	void PrepareFixedView(
+		glm::vec3 position,
+		glm::vec3 front,
+		float zoom,
+		bool bOrthographic);
+
+	// record the camera input of every frame into a log file
+	bool StartRecording(const char* filename);
+	// drive the camera from a recorded log instead of live input
+	bool StartReplay(const char* filename);
+	// true once every frame of the replayed log has been used
+	bool IsReplayFinished() const;
+	// number of frames stored in the replayed log
+	unsigned int GetReplayFrameCount() const;
 };
\ No newline at end of file
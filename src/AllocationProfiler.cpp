@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationprofiler.cpp
+// ============
+// count the heap allocations of each frame by profile zone
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationProfiler.h"
+#include "ProfileZone.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// declaration of global variables
+namespace
+{
+	// most zones that are told apart in one frame, further
+	// zones are counted under the last entry
+	const int MAX_ZONES = 32;
+
+	struct ZONE_COUNT
+	{
+		const char* zone;
+		unsigned int allocations;
+	};
+
+	std::atomic<bool> g_bCounting(false);
+	std::atomic<unsigned int> g_FrameAllocations(0);
+
+	// zone table, guarded by a spin lock since a mutex could
+	// itself allocate on some platforms
+	std::atomic_flag g_ZoneLock = ATOMIC_FLAG_INIT;
+	ZONE_COUNT g_Zones[MAX_ZONES];
+	int g_ZoneCount = 0;
+
+	// count one allocation against the current zone
+	void CountAllocation()
+	{
+		if (g_bCounting.load(std::memory_order_relaxed) == false)
+		{
+			return;
+		}
+
+		g_FrameAllocations++;
+
+		const char* zone = ProfileZone::GetCurrent();
+		while (g_ZoneLock.test_and_set(std::memory_order_acquire))
+		{
+		}
+
+		int index = 0;
+		while ((index < g_ZoneCount) && (g_Zones[index].zone != zone))
+		{
+			index++;
+		}
+		if (index == g_ZoneCount)
+		{
+			if (g_ZoneCount < MAX_ZONES)
+			{
+				g_Zones[index].zone = zone;
+				g_Zones[index].allocations = 0;
+				g_ZoneCount++;
+			}
+			else
+			{
+				index = MAX_ZONES - 1;
+			}
+		}
+		g_Zones[index].allocations++;
+
+		g_ZoneLock.clear(std::memory_order_release);
+	}
+}
+
+#ifdef WORKSPACE_ALLOCATION_PROFILER
+
+// counting replacements of the global allocation functions
+void* operator new(std::size_t size)
+{
+	CountAllocation();
+	void* memory = malloc((size > 0) ? size : 1);
+	if (NULL == memory)
+	{
+		throw std::bad_alloc();
+	}
+	return(memory);
+}
+
+void* operator new[](std::size_t size)
+{
+	return(operator new(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	CountAllocation();
+	return(malloc((size > 0) ? size : 1));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return(operator new(size, std::nothrow));
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	free(memory);
+}
+
+#endif
+
+/***********************************************************
+ *  IsAvailable()
+ ***********************************************************/
+bool AllocationProfiler::IsAvailable()
+{
+#ifdef WORKSPACE_ALLOCATION_PROFILER
+	return(true);
+#else
+	return(false);
+#endif
+}
+
+/***********************************************************
+ *  BeginFrame()
+ ***********************************************************/
+void AllocationProfiler::BeginFrame()
+{
+	while (g_ZoneLock.test_and_set(std::memory_order_acquire))
+	{
+	}
+	g_ZoneCount = 0;
+	g_ZoneLock.clear(std::memory_order_release);
+
+	g_FrameAllocations = 0;
+	g_bCounting = true;
+}
+
+/***********************************************************
+ *  EndFrame()
+ ***********************************************************/
+unsigned int AllocationProfiler::EndFrame()
+{
+	g_bCounting = false;
+	return(g_FrameAllocations);
+}
+
+/***********************************************************
+ *  PrintFrameReport()
+ *
+ *  This method is used for printing the allocations of the
+ *  last frame by zone.  It uses only stdio so that it does
+ *  not add allocations of its own.
+ ***********************************************************/
+void AllocationProfiler::PrintFrameReport(FILE* output)
+{
+	fprintf(output, "Heap allocations in frame: %u\n", g_FrameAllocations.load());
+	for (int i = 0; i < g_ZoneCount; i++)
+	{
+		fprintf(output, "  %-24s %u\n", g_Zones[i].zone, g_Zones[i].allocations);
+	}
+	fflush(output);
+}
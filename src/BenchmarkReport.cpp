@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarkreport.cpp
+// ============
+// collect per-frame benchmark samples and write them as a JSON report
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+// declaration of global functions
+namespace
+{
+	// percentile of the samples with nearest-rank selection
+	float Percentile(std::vector<float> samples, float percent)
+	{
+		if (samples.empty())
+		{
+			return(0.0f);
+		}
+		std::sort(samples.begin(), samples.end());
+		size_t rank = (size_t)(percent / 100.0f * (samples.size() - 1) + 0.5f);
+		return(samples[rank]);
+	}
+
+	// write a string with the characters JSON needs escaped
+	void WriteJSONString(FILE* file, const std::string& text)
+	{
+		fputc('"', file);
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				fputc('\\', file);
+			}
+			fputc(((unsigned char)c < 0x20) ? ' ' : c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+/***********************************************************
+ *  SetRenderer()
+ *
+ *  This method is used for naming the OpenGL renderer that
+ *  produced the samples.
+ ***********************************************************/
+void BenchmarkReport::SetRenderer(const char* renderer)
+{
+	m_renderer = (NULL != renderer) ? renderer : "";
+}
+
+/***********************************************************
+ *  AddFrame()
+ *
+ *  This method is used for adding the samples of one frame.
+ ***********************************************************/
+void BenchmarkReport::AddFrame(const std::string& scene, float frameMs, int drawCalls)
+{
+	SCENE_SAMPLES& samples = FindScene(scene);
+	samples.frameMs.push_back(frameMs);
+	samples.drawCalls.push_back(drawCalls);
+}
+
+/***********************************************************
+ *  ReserveFrames()
+ ***********************************************************/
+void BenchmarkReport::ReserveFrames(const std::string& scene, size_t frames)
+{
+	SCENE_SAMPLES& samples = FindScene(scene);
+	samples.frameMs.reserve(frames);
+	samples.drawCalls.reserve(frames);
+}
+
+/***********************************************************
+ *  FindScene()
+ ***********************************************************/
+BenchmarkReport::SCENE_SAMPLES& BenchmarkReport::FindScene(const std::string& scene)
+{
+	for (SCENE_SAMPLES& samples : m_scenes)
+	{
+		if (samples.name == scene)
+		{
+			return(samples);
+		}
+	}
+
+	m_scenes.push_back(SCENE_SAMPLES());
+	m_scenes.back().name = scene;
+	return(m_scenes.back());
+}
+
+/***********************************************************
+ *  PrintSummary()
+ *
+ *  This method is used for printing the frame time summary of
+ *  every scene.
+ ***********************************************************/
+void BenchmarkReport::PrintSummary() const
+{
+	for (const SCENE_SAMPLES& scene : m_scenes)
+	{
+		float totalMs = 0.0f;
+		for (float frameMs : scene.frameMs)
+		{
+			totalMs += frameMs;
+		}
+
+		std::cout << "INFO: Benchmark " << scene.name
+			<< ": " << scene.frameMs.size() << " frames"
+			<< ", mean " << totalMs / std::max<size_t>(scene.frameMs.size(), 1) << " ms"
+			<< ", median " << Percentile(scene.frameMs, 50.0f) << " ms"
+			<< ", p99 " << Percentile(scene.frameMs, 99.0f) << " ms" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the report.  The raw
+ *  samples are kept so that reports can be compared with
+ *  statistical tests, not just by their means.
+ ***********************************************************/
+bool BenchmarkReport::WriteJSON(const std::string& filename) const
+{
+	FILE* file = fopen(filename.c_str(), "w");
+	if (NULL == file)
+	{
+		std::cout << "Could not write benchmark report:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\n  \"renderer\": ");
+	WriteJSONString(file, m_renderer);
+	fprintf(file, ",\n  \"scenes\": {");
+
+	for (size_t i = 0; i < m_scenes.size(); i++)
+	{
+		const SCENE_SAMPLES& scene = m_scenes[i];
+
+		fprintf(file, "%s\n    ", (i > 0) ? "," : "");
+		WriteJSONString(file, scene.name);
+		fprintf(file, ": {\n      \"median_frame_ms\": %.4f,\n      \"p99_frame_ms\": %.4f,\n      \"frame_ms\": [",
+			Percentile(scene.frameMs, 50.0f),
+			Percentile(scene.frameMs, 99.0f));
+		for (size_t j = 0; j < scene.frameMs.size(); j++)
+		{
+			fprintf(file, "%s%.4f", (j > 0) ? ", " : "", scene.frameMs[j]);
+		}
+		fprintf(file, "],\n      \"draw_calls\": [");
+		for (size_t j = 0; j < scene.drawCalls.size(); j++)
+		{
+			fprintf(file, "%s%d", (j > 0) ? ", " : "", scene.drawCalls[j]);
+		}
+		fprintf(file, "]\n    }");
+	}
+
+	fprintf(file, "\n  }\n}\n");
+	fclose(file);
+
+	return(true);
+}
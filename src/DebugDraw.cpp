@@ -0,0 +1,593 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugdraw.cpp
+// ============
+// batched debug lines for bounds, frusta and light volumes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DebugDraw.h"
+#include "SceneFile.h"
+#include "GLHooks.h"
+#include "ProfileZone.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// regions of the vertex buffer used in turn, so the CPU can
+	// write one frame while the GPU still reads the earlier ones
+	const int REGION_COUNT = 3;
+	// vertices one frame can add, further ones are dropped
+	const int REGION_VERTICES = 32768;
+	// segments of each circle of a sphere
+	const int CIRCLE_SEGMENTS = 24;
+	// nanoseconds to wait for the GPU to release a region
+	const GLuint64 FENCE_TIMEOUT = 1000000000;
+
+	struct DEBUG_VERTEX
+	{
+		float position[3];
+		uint8_t color[4];
+	};
+
+	const char* const g_LineVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+uniform mat4 viewProjection;
+out vec4 lineColor;
+void main()
+{
+	lineColor = inColor;
+	gl_Position = viewProjection * vec4(inPosition, 1.0);
+}
+)";
+
+	const char* const g_LineFragmentShader = R"(
+#version 330 core
+in vec4 lineColor;
+out vec4 color;
+void main()
+{
+	color = lineColor;
+}
+)";
+
+	const char* const g_CategoryNames[DebugDraw::CATEGORY_COUNT] =
+	{
+		"bounds",
+		"frustum",
+		"lights",
+		"user"
+	};
+
+	// function keys toggling each category, F9 freezes the frustum
+	const int g_CategoryKeys[DebugDraw::CATEGORY_COUNT] = { GLFW_KEY_F5, GLFW_KEY_F6, GLFW_KEY_F7, GLFW_KEY_F8 };
+
+	// colors of the scene shapes
+	const uint32_t BOUNDS_COLOR = 0xFFD040FF;
+	const uint32_t FRUSTUM_COLOR = 0x40FFFFFF;
+	const uint32_t LIGHT_COLOR = 0xFF8020FF;
+
+	bool g_bCategories[DebugDraw::CATEGORY_COUNT];
+	bool g_bKeyDown[DebugDraw::CATEGORY_COUNT + 1];
+
+	// camera frustum shown by the frustum category
+	bool g_bFrustumFrozen = false;
+	glm::mat4 g_FrozenViewProjection(1.0f);
+
+	bool g_bInitialized = false;
+	GLuint g_Program = 0;
+	GLint g_ViewProjectionLocation = -1;
+	GLuint g_VertexArray = 0;
+	GLuint g_Buffer = 0;
+
+	// with buffer storage the regions stay mapped for the life of
+	// the buffer, otherwise the vertices are staged and uploaded
+	bool g_bPersistent = false;
+	DEBUG_VERTEX* g_pMapped = NULL;
+	std::vector<DEBUG_VERTEX> g_Staging;
+	GLsync g_Fences[REGION_COUNT];
+
+	// region being written this frame and the vertices in it
+	int g_Region = 0;
+	DEBUG_VERTEX* g_pRegion = NULL;
+	int g_VertexCount = 0;
+	unsigned long g_DroppedVertices = 0;
+
+	// compile one shader stage, printing the log on failure
+	GLuint CompileShader(GLenum stage, const char* source)
+	{
+		GLuint shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			char log[1024];
+			glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+			std::cout << "ERROR: Debug draw shader failed to compile: " << log << std::endl;
+		}
+
+		return(shader);
+	}
+
+	// create the program, vertex array and buffer on first use
+	void Initialize()
+	{
+		GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, g_LineVertexShader);
+		GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, g_LineFragmentShader);
+		g_Program = glCreateProgram();
+		glAttachShader(g_Program, vertexShader);
+		glAttachShader(g_Program, fragmentShader);
+		glLinkProgram(g_Program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		g_ViewProjectionLocation = glGetUniformLocation(g_Program, "viewProjection");
+
+		const GLsizeiptr bufferBytes = (GLsizeiptr)sizeof(DEBUG_VERTEX) * REGION_VERTICES * REGION_COUNT;
+		g_bPersistent = (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+
+		GLHooks::SetResourceTag("debug draw");
+		glGenVertexArrays(1, &g_VertexArray);
+		glBindVertexArray(g_VertexArray);
+		glGenBuffers(1, &g_Buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, g_Buffer);
+		if (g_bPersistent == true)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_ARRAY_BUFFER, bufferBytes, NULL, flags);
+			g_pMapped = (DEBUG_VERTEX*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferBytes, flags);
+			g_bPersistent = (NULL != g_pMapped);
+		}
+		if (g_bPersistent == false)
+		{
+			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(DEBUG_VERTEX) * REGION_VERTICES, NULL, GL_STREAM_DRAW);
+			g_Staging.resize(REGION_VERTICES);
+			std::cout << "INFO: Debug draw uploads each frame, persistent mapping is not supported" << std::endl;
+		}
+		GLHooks::SetResourceTag(NULL);
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DEBUG_VERTEX), (void*)offsetof(DEBUG_VERTEX, position));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DEBUG_VERTEX), (void*)offsetof(DEBUG_VERTEX, color));
+		glEnableVertexAttribArray(1);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		memset(g_Fences, 0, sizeof(g_Fences));
+		g_bInitialized = true;
+	}
+
+	// open the region of the frame, waiting until the GPU has
+	// finished drawing it REGION_COUNT frames ago
+	void OpenRegion()
+	{
+		if (g_bInitialized == false)
+		{
+			Initialize();
+		}
+
+		if (g_bPersistent == false)
+		{
+			g_pRegion = g_Staging.data();
+			return;
+		}
+
+		GLsync fence = g_Fences[g_Region];
+		if (NULL != fence)
+		{
+			GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+			if ((result == GL_TIMEOUT_EXPIRED) || (result == GL_WAIT_FAILED))
+			{
+				std::cout << "WARNING: Debug draw waited too long for the GPU" << std::endl;
+			}
+			glDeleteSync(fence);
+			g_Fences[g_Region] = NULL;
+		}
+		g_pRegion = g_pMapped + (size_t)g_Region * REGION_VERTICES;
+	}
+
+	void AddVertex(const glm::vec3& position, uint32_t color)
+	{
+		if (NULL == g_pRegion)
+		{
+			OpenRegion();
+		}
+		if (g_VertexCount >= REGION_VERTICES)
+		{
+			g_DroppedVertices++;
+			return;
+		}
+
+		DEBUG_VERTEX& vertex = g_pRegion[g_VertexCount++];
+		vertex.position[0] = position.x;
+		vertex.position[1] = position.y;
+		vertex.position[2] = position.z;
+		vertex.color[0] = (uint8_t)(color >> 24);
+		vertex.color[1] = (uint8_t)(color >> 16);
+		vertex.color[2] = (uint8_t)(color >> 8);
+		vertex.color[3] = (uint8_t)color;
+	}
+
+	// the 12 edges between the 8 corners of a box, corner bit 0
+	// selects x, bit 1 selects y and bit 2 selects z
+	const int g_BoxEdges[12][2] =
+	{
+		{ 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+		{ 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+	};
+
+	void AddBoxEdges(const glm::vec3 corners[8], uint32_t color)
+	{
+		for (int i = 0; i < 12; i++)
+		{
+			AddVertex(corners[g_BoxEdges[i][0]], color);
+			AddVertex(corners[g_BoxEdges[i][1]], color);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetCategory()
+ ***********************************************************/
+void DebugDraw::SetCategory(DEBUG_CATEGORY category, bool bEnable)
+{
+	if ((category < 0) || (category >= CATEGORY_COUNT))
+	{
+		return;
+	}
+	g_bCategories[category] = bEnable;
+
+	// the frustum shown is the one of the moment it is switched on
+	if (category == CATEGORY_FRUSTUM)
+	{
+		g_bFrustumFrozen = false;
+	}
+}
+
+/***********************************************************
+ *  IsCategoryEnabled()
+ ***********************************************************/
+bool DebugDraw::IsCategoryEnabled(DEBUG_CATEGORY category)
+{
+	return(g_bCategories[category]);
+}
+
+/***********************************************************
+ *  IsEnabled()
+ ***********************************************************/
+bool DebugDraw::IsEnabled()
+{
+	for (int i = 0; i < CATEGORY_COUNT; i++)
+	{
+		if (g_bCategories[i] == true)
+		{
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  ProcessKeys()
+ *
+ *  This method is used for toggling a category when one of
+ *  the keys F5 to F8 is pressed, and freezing the frustum of
+ *  the current camera when F9 is pressed.
+ ***********************************************************/
+void DebugDraw::ProcessKeys(GLFWwindow* pWindow)
+{
+	for (int i = 0; i <= CATEGORY_COUNT; i++)
+	{
+		int key = (i < CATEGORY_COUNT) ? g_CategoryKeys[i] : GLFW_KEY_F9;
+		bool bDown = (glfwGetKey(pWindow, key) == GLFW_PRESS);
+		if ((bDown == true) && (g_bKeyDown[i] == false))
+		{
+			if (i < CATEGORY_COUNT)
+			{
+				SetCategory((DEBUG_CATEGORY)i, !g_bCategories[i]);
+				std::cout << "INFO: Debug draw " << g_CategoryNames[i] << (g_bCategories[i] ? " on" : " off") << std::endl;
+			}
+			else
+			{
+				g_bFrustumFrozen = false;
+			}
+		}
+		g_bKeyDown[i] = bDown;
+	}
+}
+
+/***********************************************************
+ *  GetCategoryName()
+ ***********************************************************/
+const char* DebugDraw::GetCategoryName(DEBUG_CATEGORY category)
+{
+	if ((category < 0) || (category >= CATEGORY_COUNT))
+	{
+		return("unknown");
+	}
+	return(g_CategoryNames[category]);
+}
+
+/***********************************************************
+ *  FindCategory()
+ ***********************************************************/
+bool DebugDraw::FindCategory(const char* name, DEBUG_CATEGORY& category)
+{
+	for (int i = 0; i < CATEGORY_COUNT; i++)
+	{
+		if (strcmp(name, g_CategoryNames[i]) == 0)
+		{
+			category = (DEBUG_CATEGORY)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  Line()
+ ***********************************************************/
+void DebugDraw::Line(DEBUG_CATEGORY category, const glm::vec3& from, const glm::vec3& to, uint32_t color)
+{
+	if (g_bCategories[category] == false)
+	{
+		return;
+	}
+	AddVertex(from, color);
+	AddVertex(to, color);
+}
+
+/***********************************************************
+ *  Box()
+ *
+ *  This method is used for adding the edges of a box given by
+ *  its bounds in the space of the transform.
+ ***********************************************************/
+void DebugDraw::Box(
+	DEBUG_CATEGORY category,
+	const glm::mat4& transform,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	uint32_t color)
+{
+	if (g_bCategories[category] == false)
+	{
+		return;
+	}
+
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec4 corner(
+			(i & 1) ? boundsMax.x : boundsMin.x,
+			(i & 2) ? boundsMax.y : boundsMin.y,
+			(i & 4) ? boundsMax.z : boundsMin.z,
+			1.0f);
+		corners[i] = glm::vec3(transform * corner);
+	}
+	AddBoxEdges(corners, color);
+}
+
+/***********************************************************
+ *  Sphere()
+ *
+ *  This method is used for adding a sphere as three circles
+ *  around its axes.
+ ***********************************************************/
+void DebugDraw::Sphere(DEBUG_CATEGORY category, const glm::vec3& center, float radius, uint32_t color)
+{
+	if (g_bCategories[category] == false)
+	{
+		return;
+	}
+
+	const float step = 6.2831853f / CIRCLE_SEGMENTS;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		glm::vec3 previous;
+		for (int i = 0; i <= CIRCLE_SEGMENTS; i++)
+		{
+			float c = cosf(i * step) * radius;
+			float s = sinf(i * step) * radius;
+			glm::vec3 offset = (axis == 0) ? glm::vec3(0.0f, c, s) :
+				((axis == 1) ? glm::vec3(c, 0.0f, s) : glm::vec3(c, s, 0.0f));
+			glm::vec3 point = center + offset;
+			if (i > 0)
+			{
+				AddVertex(previous, color);
+				AddVertex(point, color);
+			}
+			previous = point;
+		}
+	}
+}
+
+/***********************************************************
+ *  Frustum()
+ *
+ *  This method is used for adding the edges of the volume a
+ *  view-projection matrix maps to the clip cube.
+ ***********************************************************/
+void DebugDraw::Frustum(DEBUG_CATEGORY category, const glm::mat4& viewProjection, uint32_t color)
+{
+	if (g_bCategories[category] == false)
+	{
+		return;
+	}
+
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec4 corner = inverse * glm::vec4(
+			(i & 1) ? 1.0f : -1.0f,
+			(i & 2) ? 1.0f : -1.0f,
+			(i & 4) ? 1.0f : -1.0f,
+			1.0f);
+		corners[i] = glm::vec3(corner) / corner.w;
+	}
+	AddBoxEdges(corners, color);
+}
+
+/***********************************************************
+ *  Cross()
+ ***********************************************************/
+void DebugDraw::Cross(DEBUG_CATEGORY category, const glm::vec3& center, float size, uint32_t color)
+{
+	Line(category, center - glm::vec3(size, 0.0f, 0.0f), center + glm::vec3(size, 0.0f, 0.0f), color);
+	Line(category, center - glm::vec3(0.0f, size, 0.0f), center + glm::vec3(0.0f, size, 0.0f), color);
+	Line(category, center - glm::vec3(0.0f, 0.0f, size), center + glm::vec3(0.0f, 0.0f, size), color);
+}
+
+/***********************************************************
+ *  AddSceneShapes()
+ *
+ *  This method is used for adding the shapes of the enabled
+ *  scene categories: the bounds of every draw of the frame
+ *  packet, the frozen camera frustum and the light volumes.
+ ***********************************************************/
+void DebugDraw::AddSceneShapes(SceneManager* pSceneManager, ViewManager* pViewManager)
+{
+	if (g_bCategories[CATEGORY_BOUNDS] == true)
+	{
+		for (const SceneManager::DRAW_COMMAND& command : pSceneManager->GetFramePacket())
+		{
+			glm::vec3 boundsMin;
+			glm::vec3 boundsMax;
+			if (command.mesh == SceneManager::MESH_STATIC_BATCH)
+			{
+				// a batch is in world space already
+				pSceneManager->GetStaticBatchBounds(command.batch, boundsMin, boundsMax);
+			}
+			else
+			{
+				SceneFile::GetMeshBounds(command.mesh, boundsMin, boundsMax);
+			}
+			Box(CATEGORY_BOUNDS, command.model, boundsMin, boundsMax, BOUNDS_COLOR);
+		}
+	}
+
+	if (g_bCategories[CATEGORY_FRUSTUM] == true)
+	{
+		if (g_bFrustumFrozen == false)
+		{
+			g_FrozenViewProjection = pViewManager->GetProjectionMatrix() * pViewManager->GetViewMatrix();
+			g_bFrustumFrozen = true;
+		}
+		Frustum(CATEGORY_FRUSTUM, g_FrozenViewProjection, FRUSTUM_COLOR);
+	}
+
+	if (g_bCategories[CATEGORY_LIGHTS] == true)
+	{
+		for (const SceneManager::LIGHT_SOURCE& light : pSceneManager->GetLightSources())
+		{
+			Cross(CATEGORY_LIGHTS, light.position, 0.25f, LIGHT_COLOR);
+			Sphere(CATEGORY_LIGHTS, light.position, light.radius, LIGHT_COLOR);
+		}
+	}
+}
+
+/***********************************************************
+ *  Flush()
+ *
+ *  This method is used for drawing every line added during
+ *  the frame with a single draw, fencing the region so it is
+ *  not written again before the GPU has read it.
+ ***********************************************************/
+void DebugDraw::Flush(ViewManager* pViewManager)
+{
+	if ((NULL == g_pRegion) || (g_VertexCount == 0))
+	{
+		g_pRegion = NULL;
+		return;
+	}
+
+	ProfileZone zone("DebugDraw");
+
+	GLint first = 0;
+	if (g_bPersistent == true)
+	{
+		first = g_Region * REGION_VERTICES;
+	}
+	else
+	{
+		// orphan the buffer so the upload does not wait for the GPU
+		glBindBuffer(GL_ARRAY_BUFFER, g_Buffer);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(DEBUG_VERTEX) * REGION_VERTICES, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)sizeof(DEBUG_VERTEX) * g_VertexCount, g_Staging.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	GLint previousProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+	glm::mat4 viewProjection = pViewManager->GetProjectionMatrix() * pViewManager->GetViewMatrix();
+	glUseProgram(g_Program);
+	glUniformMatrix4fv(g_ViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+	glBindVertexArray(g_VertexArray);
+	glDrawArrays(GL_LINES, first, g_VertexCount);
+	glBindVertexArray(0);
+	glUseProgram(previousProgram);
+
+	if (g_bPersistent == true)
+	{
+		g_Fences[g_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		g_Region = (g_Region + 1) % REGION_COUNT;
+	}
+	g_pRegion = NULL;
+	g_VertexCount = 0;
+}
+
+/***********************************************************
+ *  Destroy()
+ ***********************************************************/
+void DebugDraw::Destroy()
+{
+	if (g_bInitialized == false)
+	{
+		return;
+	}
+
+	for (int i = 0; i < REGION_COUNT; i++)
+	{
+		if (NULL != g_Fences[i])
+		{
+			glDeleteSync(g_Fences[i]);
+			g_Fences[i] = NULL;
+		}
+	}
+	if (g_bPersistent == true)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, g_Buffer);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		g_pMapped = NULL;
+	}
+	glDeleteBuffers(1, &g_Buffer);
+	glDeleteVertexArrays(1, &g_VertexArray);
+	glDeleteProgram(g_Program);
+	g_pRegion = NULL;
+	g_VertexCount = 0;
+	g_bInitialized = false;
+}
+
+/***********************************************************
+ *  GetDroppedVertices()
+ ***********************************************************/
+unsigned long DebugDraw::GetDroppedVertices()
+{
+	return(g_DroppedVertices);
+}
@@ -0,0 +1,744 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviews.cpp
+// ============
+// heatmap render modes and pipeline statistics for finding wasted shading
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DebugViews.h"
+#include "ImageIO.h"
+#include "ProfileZone.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// lights the light count view can take, as in the shader
+	const int MAX_LIGHTS = 4;
+	// texture unit for the heatmap values, above the scene's slots
+	const int VALUE_TEXTURE_UNIT = 31;
+	// values shown as the hottest color by each view
+	const float OVERDRAW_SCALE = 8.0f;
+	const float DENSITY_SCALE = 1.0f;
+
+	// the scene's meshes keep their positions in attribute 0 and
+	// their normals in attribute 1
+	const char* const g_GeometryVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+out vec3 worldPosition;
+out vec3 worldNormal;
+void main()
+{
+	vec4 world = model * vec4(inPosition, 1.0);
+	worldPosition = world.xyz;
+	worldNormal = mat3(transpose(inverse(model))) * inNormal;
+	gl_Position = projection * view * world;
+}
+)";
+
+	// every fragment adds one, with depth testing off
+	const char* const g_OverdrawFragmentShader = R"(
+#version 330 core
+out float value;
+void main()
+{
+	value = 1.0;
+}
+)";
+
+	// the number of lights whose diffuse term reaches the pixel
+	const char* const g_LightCountFragmentShader = R"(
+#version 330 core
+#define MAX_LIGHTS 4
+uniform int lightCount;
+uniform vec3 lightPositions[MAX_LIGHTS];
+in vec3 worldPosition;
+in vec3 worldNormal;
+out float value;
+void main()
+{
+	vec3 normal = normalize(worldNormal);
+	float count = 0.0;
+	for (int i = 0; i < lightCount; i++)
+	{
+		vec3 lightDirection = normalize(lightPositions[i] - worldPosition);
+		if (dot(normal, lightDirection) > 0.01)
+		{
+			count += 1.0;
+		}
+	}
+	value = count;
+}
+)";
+
+	// the screen area of each triangle, from 1 for a triangle of
+	// a pixel or less to 0 for one of 4096 pixels or more
+	const char* const g_DensityGeometryShader = R"(
+#version 330 core
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+uniform vec2 viewportSize;
+flat out float density;
+void main()
+{
+	vec2 corners[3];
+	bool bBehind = false;
+	for (int i = 0; i < 3; i++)
+	{
+		vec4 position = gl_in[i].gl_Position;
+		bBehind = bBehind || (position.w <= 0.0);
+		corners[i] = (position.xy / max(position.w, 0.0001) * 0.5 + 0.5) * viewportSize;
+	}
+	vec2 edgeA = corners[1] - corners[0];
+	vec2 edgeB = corners[2] - corners[0];
+	float area = 0.5 * abs(edgeA.x * edgeB.y - edgeA.y * edgeB.x);
+	float value = bBehind ? 0.0 : clamp(1.0 - log2(max(area, 1.0)) / 12.0, 0.0, 1.0);
+	for (int i = 0; i < 3; i++)
+	{
+		density = value;
+		gl_Position = gl_in[i].gl_Position;
+		EmitVertex();
+	}
+	EndPrimitive();
+}
+)";
+
+	const char* const g_DensityFragmentShader = R"(
+#version 330 core
+flat in float density;
+out float value;
+void main()
+{
+	value = max(density, 0.0001);
+}
+)";
+
+	// a triangle covering the screen, with no vertex buffer
+	const char* const g_ResolveVertexShader = R"(
+#version 330 core
+void main()
+{
+	const vec2 corners[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+	gl_Position = vec4(corners[gl_VertexID], 0.0, 1.0);
+}
+)";
+
+	// map the values to a blue, green, yellow and red ramp,
+	// pixels without any value stay black
+	const char* const g_ResolveFragmentShader = R"(
+#version 330 core
+uniform sampler2D values;
+uniform float scale;
+out vec4 color;
+void main()
+{
+	float value = texelFetch(values, ivec2(gl_FragCoord.xy), 0).r;
+	if (value <= 0.0)
+	{
+		color = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+	float t = clamp(value / scale, 0.0, 1.0);
+	vec3 ramp = mix(vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 0.0), clamp(t * 3.0, 0.0, 1.0));
+	ramp = mix(ramp, vec3(1.0, 1.0, 0.0), clamp(t * 3.0 - 1.0, 0.0, 1.0));
+	ramp = mix(ramp, vec3(1.0, 0.0, 0.0), clamp(t * 3.0 - 2.0, 0.0, 1.0));
+	color = vec4(ramp, 1.0);
+}
+)";
+
+	// a program and the locations of its uniforms
+	struct DEBUG_PROGRAM
+	{
+		GLuint program = 0;
+		GLint model = -1;
+		GLint view = -1;
+		GLint projection = -1;
+	};
+
+	const GLenum g_StatisticTargets[DebugViews::STAT_COUNT] =
+	{
+		GL_VERTICES_SUBMITTED_ARB,
+		GL_PRIMITIVES_SUBMITTED_ARB,
+		GL_CLIPPING_INPUT_PRIMITIVES_ARB,
+		GL_CLIPPING_OUTPUT_PRIMITIVES_ARB,
+		GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+	};
+
+	const char* const g_StatisticNames[DebugViews::STAT_COUNT] =
+	{
+		"vertices_submitted",
+		"primitives_submitted",
+		"clipping_input_primitives",
+		"clipping_output_primitives",
+		"fragment_shader_invocations"
+	};
+
+	const char* const g_ViewNames[DebugViews::VIEW_COUNT] =
+	{
+		"shaded",
+		"overdraw",
+		"light_count",
+		"triangle_density"
+	};
+
+	// function keys selecting each view
+	const int g_ViewKeys[DebugViews::VIEW_COUNT] = { GLFW_KEY_F1, GLFW_KEY_F2, GLFW_KEY_F3, GLFW_KEY_F4 };
+
+	DebugViews::DEBUG_VIEW g_View = DebugViews::VIEW_SHADED;
+	bool g_bStatisticsEnabled = false;
+	bool g_bInitialized = false;
+
+	DEBUG_PROGRAM g_ViewPrograms[DebugViews::VIEW_COUNT];
+	GLuint g_ResolveProgram = 0;
+	GLint g_LightCountLocation = -1;
+	GLint g_LightPositionsLocation = -1;
+	GLint g_ViewportSizeLocation = -1;
+	GLint g_ValuesLocation = -1;
+	GLint g_ScaleLocation = -1;
+	GLuint g_EmptyVAO = 0;
+
+	// offscreen target holding one float value per pixel
+	GLuint g_Framebuffer = 0;
+	GLuint g_ValueTexture = 0;
+	GLuint g_DepthBuffer = 0;
+	int g_TargetWidth = 0;
+	int g_TargetHeight = 0;
+
+	// two sets of queries, so a frame's results are read one
+	// frame later without waiting for the GPU
+	bool g_bStatisticsSupported = false;
+	GLuint g_Queries[2][DebugViews::STAT_COUNT];
+	bool g_bQueriesIssued[2] = { false, false };
+	int g_QuerySet = 0;
+	bool g_bMeasuring = false;
+	uint64_t g_LastStatistics[DebugViews::STAT_COUNT];
+	uint64_t g_TotalStatistics[DebugViews::STAT_COUNT];
+	unsigned long g_MeasuredFrames = 0;
+
+	// key states of the last poll, for acting on presses only
+	bool g_bKeyDown[DebugViews::VIEW_COUNT + 1];
+	// file to export the next frame to
+	std::string g_ExportFile;
+	unsigned int g_ExportCount = 0;
+
+	// compile one shader stage, printing the log on failure
+	GLuint CompileShader(GLenum stage, const char* source)
+	{
+		GLuint shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			char log[1024];
+			glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+			std::cout << "ERROR: Debug view shader failed to compile: " << log << std::endl;
+		}
+
+		return(shader);
+	}
+
+	// link a program from its stages, the geometry stage is optional
+	GLuint LinkProgram(const char* vertexSource, const char* geometrySource, const char* fragmentSource)
+	{
+		GLuint program = glCreateProgram();
+		GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+		GLuint geometryShader = 0;
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		if (NULL != geometrySource)
+		{
+			geometryShader = CompileShader(GL_GEOMETRY_SHADER, geometrySource);
+			glAttachShader(program, geometryShader);
+		}
+		glLinkProgram(program);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			char log[1024];
+			glGetProgramInfoLog(program, sizeof(log), NULL, log);
+			std::cout << "ERROR: Debug view program failed to link: " << log << std::endl;
+		}
+
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		if (0 != geometryShader)
+		{
+			glDeleteShader(geometryShader);
+		}
+
+		return(program);
+	}
+
+	// build a geometry program and look up its matrix uniforms
+	DEBUG_PROGRAM CreateGeometryProgram(const char* geometrySource, const char* fragmentSource)
+	{
+		DEBUG_PROGRAM program;
+		program.program = LinkProgram(g_GeometryVertexShader, geometrySource, fragmentSource);
+		program.model = glGetUniformLocation(program.program, "model");
+		program.view = glGetUniformLocation(program.program, "view");
+		program.projection = glGetUniformLocation(program.program, "projection");
+		return(program);
+	}
+
+	// create the programs and queries on first use
+	void Initialize()
+	{
+		g_ViewPrograms[DebugViews::VIEW_OVERDRAW] = CreateGeometryProgram(NULL, g_OverdrawFragmentShader);
+		g_ViewPrograms[DebugViews::VIEW_LIGHT_COUNT] = CreateGeometryProgram(NULL, g_LightCountFragmentShader);
+		g_ViewPrograms[DebugViews::VIEW_TRIANGLE_DENSITY] = CreateGeometryProgram(g_DensityGeometryShader, g_DensityFragmentShader);
+		g_LightCountLocation = glGetUniformLocation(g_ViewPrograms[DebugViews::VIEW_LIGHT_COUNT].program, "lightCount");
+		g_LightPositionsLocation = glGetUniformLocation(g_ViewPrograms[DebugViews::VIEW_LIGHT_COUNT].program, "lightPositions");
+		g_ViewportSizeLocation = glGetUniformLocation(g_ViewPrograms[DebugViews::VIEW_TRIANGLE_DENSITY].program, "viewportSize");
+
+		g_ResolveProgram = LinkProgram(g_ResolveVertexShader, NULL, g_ResolveFragmentShader);
+		g_ValuesLocation = glGetUniformLocation(g_ResolveProgram, "values");
+		g_ScaleLocation = glGetUniformLocation(g_ResolveProgram, "scale");
+		glGenVertexArrays(1, &g_EmptyVAO);
+
+		g_bStatisticsSupported = (GLEW_VERSION_4_6 || GLEW_ARB_pipeline_statistics_query);
+		if (g_bStatisticsSupported == true)
+		{
+			glGenQueries(DebugViews::STAT_COUNT, g_Queries[0]);
+			glGenQueries(DebugViews::STAT_COUNT, g_Queries[1]);
+		}
+		else
+		{
+			std::cout << "WARNING: Pipeline statistics queries are not supported" << std::endl;
+		}
+
+		g_bInitialized = true;
+	}
+
+	// size the offscreen target to the viewport
+	void UpdateTarget(int width, int height)
+	{
+		if ((0 != g_Framebuffer) && (width == g_TargetWidth) && (height == g_TargetHeight))
+		{
+			return;
+		}
+
+		if (0 == g_Framebuffer)
+		{
+			glGenFramebuffers(1, &g_Framebuffer);
+			glGenTextures(1, &g_ValueTexture);
+			glGenRenderbuffers(1, &g_DepthBuffer);
+		}
+
+		glActiveTexture(GL_TEXTURE0 + VALUE_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D, g_ValueTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glActiveTexture(GL_TEXTURE0);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, g_DepthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, g_Framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_ValueTexture, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, g_DepthBuffer);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "ERROR: Debug view framebuffer is incomplete" << std::endl;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		g_TargetWidth = width;
+		g_TargetHeight = height;
+	}
+
+	// read the results of a set of queries into the statistics
+	void ReadQueries(int set)
+	{
+		for (int i = 0; i < DebugViews::STAT_COUNT; i++)
+		{
+			GLuint64 result = 0;
+			glGetQueryObjectui64v(g_Queries[set][i], GL_QUERY_RESULT, &result);
+			g_LastStatistics[i] = result;
+			g_TotalStatistics[i] += result;
+		}
+		g_MeasuredFrames++;
+		g_bQueriesIssued[set] = false;
+	}
+
+	// write the exported frame and its statistics
+	void ExportFrame(int width, int height)
+	{
+		ImageIO::RGB_IMAGE image;
+		if ((ImageIO::CaptureFramebuffer(width, height, image) == false) ||
+			(ImageIO::WritePPM(g_ExportFile, image) == false))
+		{
+			std::cout << "Could not export debug view:" << g_ExportFile << std::endl;
+		}
+		else
+		{
+			std::cout << "INFO: Exported the " << g_ViewNames[g_View] << " view to " << g_ExportFile << std::endl;
+			DebugViews::PrintStatistics(stdout);
+		}
+		g_ExportFile.clear();
+	}
+}
+
+/***********************************************************
+ *  SetView()
+ ***********************************************************/
+void DebugViews::SetView(DEBUG_VIEW view)
+{
+	if ((view >= 0) && (view < VIEW_COUNT))
+	{
+		g_View = view;
+	}
+}
+
+/***********************************************************
+ *  GetView()
+ ***********************************************************/
+DebugViews::DEBUG_VIEW DebugViews::GetView()
+{
+	return(g_View);
+}
+
+/***********************************************************
+ *  EnableStatistics()
+ ***********************************************************/
+void DebugViews::EnableStatistics(bool bEnable)
+{
+	g_bStatisticsEnabled = bEnable;
+}
+
+/***********************************************************
+ *  ProcessKeys()
+ *
+ *  This method is used for selecting a view when one of the
+ *  keys F1 to F4 is pressed, and requesting an export of the
+ *  next frame when F12 is pressed.
+ ***********************************************************/
+void DebugViews::ProcessKeys(GLFWwindow* pWindow)
+{
+	for (int i = 0; i <= VIEW_COUNT; i++)
+	{
+		int key = (i < VIEW_COUNT) ? g_ViewKeys[i] : GLFW_KEY_F12;
+		bool bDown = (glfwGetKey(pWindow, key) == GLFW_PRESS);
+		if ((bDown == true) && (g_bKeyDown[i] == false))
+		{
+			if (i < VIEW_COUNT)
+			{
+				g_View = (DEBUG_VIEW)i;
+				std::cout << "INFO: Debug view " << g_ViewNames[i] << std::endl;
+			}
+			else
+			{
+				std::string filename = "debug_" + std::string(g_ViewNames[g_View]) + "_" + std::to_string(g_ExportCount++) + ".ppm";
+				RequestExport(filename.c_str());
+			}
+		}
+		g_bKeyDown[i] = bDown;
+	}
+}
+
+/***********************************************************
+ *  RequestExport()
+ ***********************************************************/
+void DebugViews::RequestExport(const char* filename)
+{
+	g_ExportFile = filename;
+}
+
+/***********************************************************
+ *  BeginStatistics()
+ *
+ *  This method is used for starting the pipeline statistics
+ *  queries of the shaded pass, when a debug view is shown or
+ *  the statistics are enabled.
+ ***********************************************************/
+void DebugViews::BeginStatistics()
+{
+	if ((g_View == VIEW_SHADED) && (g_bStatisticsEnabled == false))
+	{
+		return;
+	}
+	if (g_bInitialized == false)
+	{
+		Initialize();
+	}
+	if (g_bStatisticsSupported == false)
+	{
+		return;
+	}
+
+	// the set is reused every other frame, its last results
+	// are collected first
+	g_QuerySet = 1 - g_QuerySet;
+	if (g_bQueriesIssued[g_QuerySet] == true)
+	{
+		ReadQueries(g_QuerySet);
+	}
+
+	for (int i = 0; i < STAT_COUNT; i++)
+	{
+		glBeginQuery(g_StatisticTargets[i], g_Queries[g_QuerySet][i]);
+	}
+	g_bMeasuring = true;
+}
+
+/***********************************************************
+ *  EndStatistics()
+ ***********************************************************/
+void DebugViews::EndStatistics()
+{
+	if (g_bMeasuring == false)
+	{
+		return;
+	}
+
+	for (int i = 0; i < STAT_COUNT; i++)
+	{
+		glEndQuery(g_StatisticTargets[i]);
+	}
+	g_bQueriesIssued[g_QuerySet] = true;
+	g_bMeasuring = false;
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for drawing the selected view over
+ *  the shaded frame.  The geometry of the frame packet is
+ *  rasterized into a float target with the view's program,
+ *  then mapped to a heatmap in the back buffer.  The OpenGL
+ *  state the scene relies on is restored afterwards.
+ ***********************************************************/
+void DebugViews::Render(SceneManager* pSceneManager, ViewManager* pViewManager)
+{
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	if (g_View == VIEW_SHADED)
+	{
+		if (g_ExportFile.empty() == false)
+		{
+			ExportFrame(viewport[2], viewport[3]);
+		}
+		return;
+	}
+
+	ProfileZone zone("DebugViews");
+
+	if (g_bInitialized == false)
+	{
+		Initialize();
+	}
+	UpdateTarget(viewport[2], viewport[3]);
+
+	GLint previousProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+	// rasterize the values of the view
+	const DEBUG_PROGRAM& program = g_ViewPrograms[g_View];
+	glBindFramebuffer(GL_FRAMEBUFFER, g_Framebuffer);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glUseProgram(program.program);
+	glUniformMatrix4fv(program.view, 1, GL_FALSE, glm::value_ptr(pViewManager->GetViewMatrix()));
+	glUniformMatrix4fv(program.projection, 1, GL_FALSE, glm::value_ptr(pViewManager->GetProjectionMatrix()));
+
+	float scale = DENSITY_SCALE;
+	if (g_View == VIEW_OVERDRAW)
+	{
+		// every fragment counts, hidden or not
+		glDisable(GL_DEPTH_TEST);
+		glBlendFunc(GL_ONE, GL_ONE);
+		scale = OVERDRAW_SCALE;
+	}
+	else
+	{
+		glDisable(GL_BLEND);
+	}
+
+	if (g_View == VIEW_LIGHT_COUNT)
+	{
+		const std::vector<SceneManager::LIGHT_SOURCE>& lights = pSceneManager->GetLightSources();
+		glm::vec3 positions[MAX_LIGHTS];
+		int lightCount = 0;
+		for (; (lightCount < (int)lights.size()) && (lightCount < MAX_LIGHTS); lightCount++)
+		{
+			positions[lightCount] = lights[lightCount].position;
+		}
+		glUniform1i(g_LightCountLocation, lightCount);
+		glUniform3fv(g_LightPositionsLocation, MAX_LIGHTS, glm::value_ptr(positions[0]));
+		scale = (float)std::max(lightCount, 1);
+	}
+	else if (g_View == VIEW_TRIANGLE_DENSITY)
+	{
+		glUniform2f(g_ViewportSizeLocation, (float)viewport[2], (float)viewport[3]);
+	}
+
+	pSceneManager->DrawFramePacketGeometry(program.model);
+
+	// map the values to colors in the back buffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+	glUseProgram(g_ResolveProgram);
+	glActiveTexture(GL_TEXTURE0 + VALUE_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, g_ValueTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glUniform1i(g_ValuesLocation, VALUE_TEXTURE_UNIT);
+	glUniform1f(g_ScaleLocation, scale);
+	glBindVertexArray(g_EmptyVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+
+	if (g_ExportFile.empty() == false)
+	{
+		ExportFrame(viewport[2], viewport[3]);
+	}
+
+	// restore the state set up by the view manager and scene
+	glUseProgram(previousProgram);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+/***********************************************************
+ *  Destroy()
+ ***********************************************************/
+void DebugViews::Destroy()
+{
+	if (g_bInitialized == false)
+	{
+		return;
+	}
+
+	for (int i = 0; i < VIEW_COUNT; i++)
+	{
+		if (0 != g_ViewPrograms[i].program)
+		{
+			glDeleteProgram(g_ViewPrograms[i].program);
+			g_ViewPrograms[i].program = 0;
+		}
+	}
+	glDeleteProgram(g_ResolveProgram);
+	glDeleteVertexArrays(1, &g_EmptyVAO);
+	if (0 != g_Framebuffer)
+	{
+		glDeleteFramebuffers(1, &g_Framebuffer);
+		glDeleteTextures(1, &g_ValueTexture);
+		glDeleteRenderbuffers(1, &g_DepthBuffer);
+		g_Framebuffer = 0;
+	}
+	if (g_bStatisticsSupported == true)
+	{
+		glDeleteQueries(STAT_COUNT, g_Queries[0]);
+		glDeleteQueries(STAT_COUNT, g_Queries[1]);
+	}
+	g_bInitialized = false;
+}
+
+/***********************************************************
+ *  GetViewName()
+ ***********************************************************/
+const char* DebugViews::GetViewName(DEBUG_VIEW view)
+{
+	if ((view < 0) || (view >= VIEW_COUNT))
+	{
+		return("unknown");
+	}
+	return(g_ViewNames[view]);
+}
+
+/***********************************************************
+ *  FindView()
+ ***********************************************************/
+bool DebugViews::FindView(const char* name, DEBUG_VIEW& view)
+{
+	for (int i = 0; i < VIEW_COUNT; i++)
+	{
+		if (strcmp(name, g_ViewNames[i]) == 0)
+		{
+			view = (DEBUG_VIEW)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetLastStatistic()
+ ***********************************************************/
+uint64_t DebugViews::GetLastStatistic(PIPELINE_STATISTIC statistic)
+{
+	return(g_LastStatistics[statistic]);
+}
+
+/***********************************************************
+ *  GetTotalStatistic()
+ ***********************************************************/
+uint64_t DebugViews::GetTotalStatistic(PIPELINE_STATISTIC statistic)
+{
+	return(g_TotalStatistics[statistic]);
+}
+
+/***********************************************************
+ *  PrintStatistics()
+ *
+ *  This method is used for printing the statistics of the
+ *  last measured frame with the totals over all of them.
+ ***********************************************************/
+void DebugViews::PrintStatistics(FILE* output)
+{
+	if (g_MeasuredFrames == 0)
+	{
+		return;
+	}
+
+	fprintf(output, "Pipeline statistics of the shaded pass, %lu frames:\n", g_MeasuredFrames);
+	for (int i = 0; i < STAT_COUNT; i++)
+	{
+		fprintf(output, "  %-28s %12llu last frame %16llu total\n",
+			g_StatisticNames[i],
+			(unsigned long long)g_LastStatistics[i],
+			(unsigned long long)g_TotalStatistics[i]);
+	}
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the statistics as the
+ *  members of an enclosing JSON object.
+ ***********************************************************/
+void DebugViews::WriteJSON(FILE* output, const char* indent)
+{
+	fprintf(output, "%s\"frames\": %lu,\n", indent, g_MeasuredFrames);
+	fprintf(output, "%s\"last_frame\": {", indent);
+	for (int i = 0; i < STAT_COUNT; i++)
+	{
+		fprintf(output, "%s \"%s\": %llu", (i > 0) ? "," : "", g_StatisticNames[i], (unsigned long long)g_LastStatistics[i]);
+	}
+	fprintf(output, " },\n");
+	fprintf(output, "%s\"total\": {", indent);
+	for (int i = 0; i < STAT_COUNT; i++)
+	{
+		fprintf(output, "%s \"%s\": %llu", (i > 0) ? "," : "", g_StatisticNames[i], (unsigned long long)g_TotalStatistics[i]);
+	}
+	fprintf(output, " }\n");
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// linear allocator for the transient data of a single frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena(size_t bytesPerFrame, int bufferCount)
+{
+	m_capacity = bytesPerFrame;
+	m_currentBuffer = 0;
+	m_offset = 0;
+	m_highWater = 0;
+	m_overflowCount = 0;
+	m_overflowBytes = 0;
+
+	bufferCount = std::max(bufferCount, 1);
+	for (int i = 0; i < bufferCount; i++)
+	{
+		m_buffers.push_back(static_cast<unsigned char*>(malloc(m_capacity)));
+		m_bufferBytes.push_back((NULL != m_buffers.back()) ? m_capacity : 0);
+	}
+	m_overflow.resize(bufferCount);
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+	for (size_t i = 0; i < m_buffers.size(); i++)
+	{
+		for (void* block : m_overflow[i])
+		{
+			free(block);
+		}
+		free(m_buffers[i]);
+	}
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for bumping the offset of the current
+ *  buffer.  A request that does not fit is served from the
+ *  heap and counted, so the capacity can be raised.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+	unsigned char* buffer = m_buffers[m_currentBuffer];
+	uintptr_t start = ((uintptr_t)(buffer + m_offset) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	size_t end = (size_t)(start - (uintptr_t)buffer) + bytes;
+
+	if ((NULL != buffer) && (end <= m_bufferBytes[m_currentBuffer]))
+	{
+		m_offset = end;
+		m_highWater = std::max(m_highWater, m_offset);
+		return((void*)start);
+	}
+
+	// malloc memory is aligned for every fundamental type
+	void* block = malloc(std::max<size_t>(bytes, 1));
+	if (NULL == block)
+	{
+		throw std::bad_alloc();
+	}
+	m_overflow[m_currentBuffer].push_back(block);
+	m_overflowCount++;
+	m_overflowBytes += bytes;
+	return(block);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a new frame in the next
+ *  buffer, freeing whatever the frame that last used that
+ *  buffer allocated.  When the frame that ended did not fit,
+ *  the capacity is raised to all the bytes it asked for, at
+ *  least doubling, and the buffer is grown to it now that
+ *  nothing in it is in use.
+ ***********************************************************/
+void FrameArena::BeginFrame()
+{
+	if (m_overflowBytes > 0)
+	{
+		m_capacity = std::max(m_capacity * 2, m_offset + m_overflowBytes);
+		m_overflowBytes = 0;
+	}
+
+	m_currentBuffer = (m_currentBuffer + 1) % (int)m_buffers.size();
+	m_offset = 0;
+
+	for (void* block : m_overflow[m_currentBuffer])
+	{
+		free(block);
+	}
+	m_overflow[m_currentBuffer].clear();
+
+	if (m_bufferBytes[m_currentBuffer] < m_capacity)
+	{
+		free(m_buffers[m_currentBuffer]);
+		m_buffers[m_currentBuffer] = static_cast<unsigned char*>(malloc(m_capacity));
+		m_bufferBytes[m_currentBuffer] = (NULL != m_buffers[m_currentBuffer]) ? m_capacity : 0;
+	}
+}
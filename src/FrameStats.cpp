@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// framestats.cpp
+// ============
+// per-frame statistics shown in the window title and written as JSON
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameStats.h"
+#include "MemoryTracker.h"
+#include "GLDebugLog.h"
+#include "DebugViews.h"
+#include "MetricsServer.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// seconds between refreshes of the overlay
+	const double OVERLAY_INTERVAL = 0.5;
+
+	const double BYTES_PER_MB = 1024.0 * 1024.0;
+}
+
+/***********************************************************
+ *  FrameStats()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameStats::FrameStats()
+{
+	m_pWindow = NULL;
+	m_baseTitle = "";
+	m_overlayText[0] = '\0';
+	m_frameCount = 0;
+	m_totalFrameMs = 0.0;
+	m_lastFrameMs = 0.0f;
+	m_maxFrameMs = 0.0f;
+	m_lastDrawCalls = 0;
+	m_arenaHighWater = 0;
+	m_arenaCapacity = 0;
+	m_arenaOverflows = 0;
+	m_intervalFrames = 0;
+	m_intervalFrameMs = 0.0;
+	m_intervalStart = 0.0;
+}
+
+/***********************************************************
+ *  SetOverlayWindow()
+ ***********************************************************/
+void FrameStats::SetOverlayWindow(GLFWwindow* pWindow, const char* baseTitle)
+{
+	m_pWindow = pWindow;
+	m_baseTitle = baseTitle;
+	m_intervalStart = glfwGetTime();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for adding the measurements of a
+ *  completed frame and refreshing the overlay when its
+ *  interval has passed.
+ ***********************************************************/
+void FrameStats::EndFrame(float frameMs, int drawCalls)
+{
+	m_frameCount++;
+	m_totalFrameMs += frameMs;
+	m_maxFrameMs = std::max(m_maxFrameMs, frameMs);
+	m_lastDrawCalls = drawCalls;
+
+	m_intervalFrames++;
+	m_intervalFrameMs += frameMs;
+
+	m_lastFrameMs = frameMs;
+
+	double now = glfwGetTime();
+	if (now - m_intervalStart >= OVERLAY_INTERVAL)
+	{
+		UpdateOverlay();
+		m_intervalFrames = 0;
+		m_intervalFrameMs = 0.0;
+		m_intervalStart = now;
+	}
+}
+
+/***********************************************************
+ *  UpdateOverlay()
+ *
+ *  This method is used for showing the average frame time,
+ *  the draw calls and the tracked memory in the window title.
+ ***********************************************************/
+void FrameStats::UpdateOverlay()
+{
+	if ((NULL == m_pWindow) || (m_intervalFrames == 0))
+	{
+		return;
+	}
+
+	double averageMs = m_intervalFrameMs / m_intervalFrames;
+
+	snprintf(
+		m_overlayText,
+		sizeof(m_overlayText),
+		"%s | %.2f ms (%.0f fps) | %d draws | GPU %.1f MB | CPU %.1f MB",
+		m_baseTitle,
+		averageMs,
+		(averageMs > 0.0) ? 1000.0 / averageMs : 0.0,
+		m_lastDrawCalls,
+		MemoryTracker::GetGPUBytes() / BYTES_PER_MB,
+		MemoryTracker::GetCPUBytes() / BYTES_PER_MB);
+
+	glfwSetWindowTitle(m_pWindow, m_overlayText);
+}
+
+/***********************************************************
+ *  SetArenaUsage()
+ *
+ *  This method is used for keeping the usage of the per-frame
+ *  arena, so the report shows whether its capacity fits the
+ *  frame.
+ ***********************************************************/
+void FrameStats::SetArenaUsage(size_t highWater, size_t capacity, size_t overflows)
+{
+	m_arenaHighWater = highWater;
+	m_arenaCapacity = capacity;
+	m_arenaOverflows = overflows;
+}
+
+/***********************************************************
+ *  PublishMetrics()
+ *
+ *  This method is used for copying the totals and the memory
+ *  in use into the snapshot served by the metrics server.
+ ***********************************************************/
+void FrameStats::PublishMetrics() const
+{
+	if (MetricsServer::IsRunning() == false)
+	{
+		return;
+	}
+
+	MetricsServer::FRAME_METRICS metrics;
+	metrics.frames = m_frameCount;
+	metrics.frameSecondsSum = m_totalFrameMs / 1000.0;
+	metrics.frameSeconds = m_lastFrameMs / 1000.0;
+	metrics.maxFrameSeconds = m_maxFrameMs / 1000.0;
+	metrics.drawCalls = (uint64_t)m_lastDrawCalls;
+	for (int i = 0; i < MemoryTracker::MEMORY_CATEGORY_COUNT; i++)
+	{
+		metrics.memoryBytes[i] = MemoryTracker::GetCategoryBytes((MemoryTracker::MEMORY_CATEGORY)i);
+	}
+	metrics.arenaHighWaterBytes = m_arenaHighWater;
+	metrics.arenaOverflows = m_arenaOverflows;
+	metrics.glDebugMessages = GLDebugLog::GetTotalCount();
+	MetricsServer::Publish(metrics);
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the frame totals and the
+ *  memory report to a JSON file, with the driver messages.
+ ***********************************************************/
+bool FrameStats::WriteJSON(const char* filename) const
+{
+	FILE* file = fopen(filename, "w");
+	if (NULL == file)
+	{
+		std::cout << "Could not write stats report:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"frames\": %lu,\n", m_frameCount);
+	fprintf(file, "  \"mean_frame_ms\": %.4f,\n", (m_frameCount > 0) ? m_totalFrameMs / m_frameCount : 0.0);
+	fprintf(file, "  \"max_frame_ms\": %.4f,\n", m_maxFrameMs);
+	fprintf(file, "  \"draw_calls\": %d,\n", m_lastDrawCalls);
+	fprintf(file, "  \"frame_arena\": {\n");
+	fprintf(file, "    \"high_water_bytes\": %zu,\n", m_arenaHighWater);
+	fprintf(file, "    \"capacity_bytes\": %zu,\n", m_arenaCapacity);
+	fprintf(file, "    \"overflow_allocations\": %zu\n", m_arenaOverflows);
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"memory\": {\n");
+	MemoryTracker::WriteJSON(file, "    ");
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"gl_debug\": {\n");
+	GLDebugLog::WriteJSON(file, "    ");
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"pipeline_statistics\": {\n");
+	DebugViews::WriteJSON(file, "    ");
+	fprintf(file, "  }\n");
+	fprintf(file, "}\n");
+	fclose(file);
+
+	return(true);
+}
@@ -0,0 +1,275 @@
+///////////////////////////////////////////////////////////////////////////////
+// gldebuglog.cpp
+// ============
+// capture the driver's KHR_debug messages and attribute them to zones
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLDebugLog.h"
+#include "ProfileZone.h"
+
+#include <GL/glew.h>
+
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+// declaration of global variables
+namespace
+{
+	// distinct messages kept, later new ones are only counted
+	const int MAX_MESSAGES = 128;
+	// characters kept of the first occurrence of a message
+	const int MAX_MESSAGE_TEXT = 256;
+
+	struct DEBUG_MESSAGE
+	{
+		GLenum source;
+		GLenum type;
+		GLuint id;
+		GLenum severity;
+		unsigned long count;
+		// where the message was first seen
+		const char* firstZone;
+		unsigned long firstFrame;
+		char text[MAX_MESSAGE_TEXT];
+	};
+
+	// the callback runs inside the frame, so the table is fixed
+	// to keep it from allocating
+	std::mutex g_Mutex;
+	DEBUG_MESSAGE g_Messages[MAX_MESSAGES];
+	int g_MessageCount = 0;
+	unsigned long g_TotalCount = 0;
+	unsigned long g_DroppedCount = 0;
+	unsigned long g_Frame = 0;
+
+	const char* GetSourceName(GLenum source)
+	{
+		switch (source)
+		{
+		case GL_DEBUG_SOURCE_API: return("api");
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return("window_system");
+		case GL_DEBUG_SOURCE_SHADER_COMPILER: return("shader_compiler");
+		case GL_DEBUG_SOURCE_THIRD_PARTY: return("third_party");
+		case GL_DEBUG_SOURCE_APPLICATION: return("application");
+		default: return("other");
+		}
+	}
+
+	const char* GetTypeName(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_DEBUG_TYPE_ERROR: return("error");
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return("deprecated");
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return("undefined");
+		case GL_DEBUG_TYPE_PORTABILITY: return("portability");
+		case GL_DEBUG_TYPE_PERFORMANCE: return("performance");
+		case GL_DEBUG_TYPE_MARKER: return("marker");
+		default: return("other");
+		}
+	}
+
+	const char* GetSeverityName(GLenum severity)
+	{
+		switch (severity)
+		{
+		case GL_DEBUG_SEVERITY_HIGH: return("high");
+		case GL_DEBUG_SEVERITY_MEDIUM: return("medium");
+		case GL_DEBUG_SEVERITY_LOW: return("low");
+		default: return("notification");
+		}
+	}
+
+	// write a message text as a JSON string
+	void WriteJSONString(FILE* output, const char* text)
+	{
+		fputc('"', output);
+		for (const char* c = text; *c != '\0'; c++)
+		{
+			if ((*c == '"') || (*c == '\\'))
+			{
+				fputc('\\', output);
+				fputc(*c, output);
+			}
+			else if ((unsigned char)*c < 0x20)
+			{
+				fputc(' ', output);
+			}
+			else
+			{
+				fputc(*c, output);
+			}
+		}
+		fputc('"', output);
+	}
+
+	// called by the driver for every debug message
+	void GLAPIENTRY OnDebugMessage(
+		GLenum source,
+		GLenum type,
+		GLuint id,
+		GLenum severity,
+		GLsizei length,
+		const GLchar* message,
+		const void* userParam)
+	{
+		std::lock_guard<std::mutex> lock(g_Mutex);
+		g_TotalCount++;
+
+		for (int i = 0; i < g_MessageCount; i++)
+		{
+			if ((g_Messages[i].id == id) && (g_Messages[i].source == source) && (g_Messages[i].type == type))
+			{
+				g_Messages[i].count++;
+				return;
+			}
+		}
+
+		if (g_MessageCount >= MAX_MESSAGES)
+		{
+			g_DroppedCount++;
+			return;
+		}
+
+		DEBUG_MESSAGE& entry = g_Messages[g_MessageCount++];
+		entry.source = source;
+		entry.type = type;
+		entry.id = id;
+		entry.severity = severity;
+		entry.count = 1;
+		entry.firstZone = ProfileZone::GetCurrent();
+		entry.firstFrame = g_Frame;
+		strncpy(entry.text, message, MAX_MESSAGE_TEXT - 1);
+		entry.text[MAX_MESSAGE_TEXT - 1] = '\0';
+
+		// the first occurrence of anything but a notification is
+		// worth seeing right away
+		if (severity != GL_DEBUG_SEVERITY_NOTIFICATION)
+		{
+			std::cout << "GL " << GetTypeName(type) << " (" << GetSeverityName(severity) << ") id " << id
+				<< " in " << entry.firstZone << ", frame " << entry.firstFrame << ": " << entry.text << std::endl;
+		}
+	}
+}
+
+/***********************************************************
+ *  Install()
+ *
+ *  This method is used for enabling the debug output of the
+ *  current context and installing the message callback.  The
+ *  output is made synchronous so every message arrives on the
+ *  thread, and in the zone, that caused it.
+ ***********************************************************/
+bool GLDebugLog::Install()
+{
+	if ((GLEW_VERSION_4_3 == false) && (GLEW_KHR_debug == false))
+	{
+		std::cout << "WARNING: KHR_debug is not supported, driver messages are not captured" << std::endl;
+		return(false);
+	}
+
+	GLint flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	if ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) == 0)
+	{
+		std::cout << "WARNING: Not a debug context, the driver may report few messages" << std::endl;
+	}
+
+	glEnable(GL_DEBUG_OUTPUT);
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	glDebugMessageCallback(OnDebugMessage, NULL);
+	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+
+	return(true);
+}
+
+/***********************************************************
+ *  NextFrame()
+ ***********************************************************/
+void GLDebugLog::NextFrame()
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	g_Frame++;
+}
+
+/***********************************************************
+ *  GetMessageCount()
+ ***********************************************************/
+size_t GLDebugLog::GetMessageCount()
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(g_MessageCount);
+}
+
+/***********************************************************
+ *  GetTotalCount()
+ ***********************************************************/
+unsigned long GLDebugLog::GetTotalCount()
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(g_TotalCount);
+}
+
+/***********************************************************
+ *  PrintReport()
+ *
+ *  This method is used for printing every distinct message
+ *  with its count and where it was first seen.
+ ***********************************************************/
+void GLDebugLog::PrintReport(FILE* output)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	fprintf(output, "GL debug messages: %lu (%d distinct)\n", g_TotalCount, g_MessageCount);
+	for (int i = 0; i < g_MessageCount; i++)
+	{
+		const DEBUG_MESSAGE& entry = g_Messages[i];
+		fprintf(output, "  %6lu x %s %s %s id %u, first in %s at frame %lu: %s\n",
+			entry.count,
+			GetSourceName(entry.source),
+			GetTypeName(entry.type),
+			GetSeverityName(entry.severity),
+			entry.id,
+			entry.firstZone,
+			entry.firstFrame,
+			entry.text);
+	}
+	if (g_DroppedCount > 0)
+	{
+		fprintf(output, "  %lu messages beyond the first %d distinct ones were not kept\n", g_DroppedCount, MAX_MESSAGES);
+	}
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the message counts as the
+ *  members of an enclosing JSON object.
+ ***********************************************************/
+void GLDebugLog::WriteJSON(FILE* output, const char* indent)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	fprintf(output, "%s\"total\": %lu,\n", indent, g_TotalCount);
+	fprintf(output, "%s\"dropped\": %lu,\n", indent, g_DroppedCount);
+	fprintf(output, "%s\"messages\": [", indent);
+	for (int i = 0; i < g_MessageCount; i++)
+	{
+		const DEBUG_MESSAGE& entry = g_Messages[i];
+		fprintf(output, "%s\n%s  { \"source\": \"%s\", \"type\": \"%s\", \"severity\": \"%s\", \"id\": %u, \"count\": %lu, \"first_zone\": \"%s\", \"first_frame\": %lu, \"text\": ",
+			(i > 0) ? "," : "",
+			indent,
+			GetSourceName(entry.source),
+			GetTypeName(entry.type),
+			GetSeverityName(entry.severity),
+			entry.id,
+			entry.count,
+			entry.firstZone,
+			entry.firstFrame);
+		WriteJSONString(output, entry.text);
+		fprintf(output, " }");
+	}
+	fprintf(output, "\n%s]\n", indent);
+}
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+// glhooks.cpp
+// ============
+// observe the OpenGL calls made through the GLEW function pointers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLHooks.h"
+#include "MemoryTracker.h"
+
+#include <GL/glew.h>
+
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	// the GLEW entry points that were replaced by the hooks
+	PFNGLBUFFERDATAPROC g_RealBufferData = NULL;
+	PFNGLBUFFERSTORAGEPROC g_RealBufferStorage = NULL;
+	PFNGLDELETEBUFFERSPROC g_RealDeleteBuffers = NULL;
+
+	// tag given to the resources created by the hooked calls
+	std::string g_ResourceTag = "untagged";
+
+	// memory category of a buffer bound to the target
+	MemoryTracker::MEMORY_CATEGORY CategoryForTarget(GLenum target)
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER:
+		case GL_ELEMENT_ARRAY_BUFFER:
+			return(MemoryTracker::MEMORY_MESH_BUFFER);
+		case GL_UNIFORM_BUFFER:
+			return(MemoryTracker::MEMORY_UNIFORM_BUFFER);
+		case GL_SHADER_STORAGE_BUFFER:
+			return(MemoryTracker::MEMORY_STORAGE_BUFFER);
+		default:
+			return(MemoryTracker::MEMORY_OTHER_BUFFER);
+		}
+	}
+
+	// binding query of the buffer target, zero when unknown
+	GLenum BindingForTarget(GLenum target)
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER: return(GL_ARRAY_BUFFER_BINDING);
+		case GL_ELEMENT_ARRAY_BUFFER: return(GL_ELEMENT_ARRAY_BUFFER_BINDING);
+		case GL_UNIFORM_BUFFER: return(GL_UNIFORM_BUFFER_BINDING);
+		case GL_SHADER_STORAGE_BUFFER: return(GL_SHADER_STORAGE_BUFFER_BINDING);
+		case GL_DRAW_INDIRECT_BUFFER: return(GL_DRAW_INDIRECT_BUFFER_BINDING);
+		case GL_COPY_READ_BUFFER: return(GL_COPY_READ_BUFFER_BINDING);
+		case GL_COPY_WRITE_BUFFER: return(GL_COPY_WRITE_BUFFER_BINDING);
+		case GL_PIXEL_PACK_BUFFER: return(GL_PIXEL_PACK_BUFFER_BINDING);
+		case GL_PIXEL_UNPACK_BUFFER: return(GL_PIXEL_UNPACK_BUFFER_BINDING);
+		default: return(0);
+		}
+	}
+
+	// record the size of the buffer bound to the target
+	void RegisterBoundBuffer(GLenum target, GLsizeiptr size)
+	{
+		GLenum binding = BindingForTarget(target);
+		GLint buffer = 0;
+
+		if (binding != 0)
+		{
+			glGetIntegerv(binding, &buffer);
+		}
+		if (buffer != 0)
+		{
+			// every buffer category shares one id space, so the
+			// record of a re-specified buffer is found under the
+			// category it was first given
+			for (int i = 0; i < MemoryTracker::MEMORY_CPU; i++)
+			{
+				MemoryTracker::Release((MemoryTracker::MEMORY_CATEGORY)i, (uint64_t)buffer);
+			}
+			MemoryTracker::Register(
+				CategoryForTarget(target),
+				(uint64_t)buffer,
+				g_ResourceTag,
+				"buffer " + std::to_string(buffer),
+				(size_t)size);
+		}
+	}
+
+	void GLAPIENTRY HookBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		g_RealBufferData(target, size, data, usage);
+		RegisterBoundBuffer(target, size);
+	}
+
+	void GLAPIENTRY HookBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+	{
+		g_RealBufferStorage(target, size, data, flags);
+		RegisterBoundBuffer(target, size);
+	}
+
+	void GLAPIENTRY HookDeleteBuffers(GLsizei count, const GLuint* buffers)
+	{
+		for (GLsizei i = 0; i < count; i++)
+		{
+			for (int category = 0; category < MemoryTracker::MEMORY_CPU; category++)
+			{
+				MemoryTracker::Release((MemoryTracker::MEMORY_CATEGORY)category, buffers[i]);
+			}
+		}
+		g_RealDeleteBuffers(count, buffers);
+	}
+}
+
+/***********************************************************
+ *  Install()
+ *
+ *  This method is used for replacing the GLEW entry points
+ *  with the hooks.  GLEW resolves every post-1.1 function
+ *  through a global pointer, so the replacement applies to
+ *  all code using GLEW without it being rebuilt.
+ ***********************************************************/
+void GLHooks::Install()
+{
+	if ((NULL != __glewBufferData) && (NULL == g_RealBufferData))
+	{
+		g_RealBufferData = __glewBufferData;
+		__glewBufferData = HookBufferData;
+	}
+	if ((NULL != __glewBufferStorage) && (NULL == g_RealBufferStorage))
+	{
+		g_RealBufferStorage = __glewBufferStorage;
+		__glewBufferStorage = HookBufferStorage;
+	}
+	if ((NULL != __glewDeleteBuffers) && (NULL == g_RealDeleteBuffers))
+	{
+		g_RealDeleteBuffers = __glewDeleteBuffers;
+		__glewDeleteBuffers = HookDeleteBuffers;
+	}
+}
+
+/***********************************************************
+ *  SetResourceTag()
+ ***********************************************************/
+void GLHooks::SetResourceTag(const char* tag)
+{
+	g_ResourceTag = (NULL != tag) ? tag : "untagged";
+}
@@ -0,0 +1,746 @@
+///////////////////////////////////////////////////////////////////////////////
+// gltrace.cpp
+// ============
+// record the OpenGL command stream into a binary trace for replaying
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLTrace.h"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// the OpenGL 1.1 functions can only be recorded by interposing
+// the symbols of libGL, which puts every call of every build
+// through an indirection, so recording is only compiled into
+// Linux builds that define WORKSPACE_GL_TRACE
+#if defined(WORKSPACE_GL_TRACE) && defined(__linux__)
+#define GL_TRACE_RECORDING
+#include <dlfcn.h>
+#endif
+
+// replace a GLEW entry point with the hook of the same name
+#define INSTALL_TRACE_HOOK(name) \
+	if ((NULL != __glew##name) && (NULL == g_Real##name)) \
+	{ \
+		g_Real##name = __glew##name; \
+		__glew##name = Trace##name; \
+	}
+
+// write a record made of 32-bit fields only
+#define TRACE_RECORD(opcode, ...) \
+	if (g_bRecording == true) \
+	{ \
+		const uint32_t fields[] = { __VA_ARGS__ }; \
+		WriteRecord(opcode, fields, sizeof(fields) / sizeof(fields[0]), NULL, 0); \
+	}
+
+// declaration of global variables
+namespace
+{
+	// trace file buffer, large enough to keep writes out of the frame
+	const size_t FILE_BUFFER_BYTES = 4 * 1024 * 1024;
+
+	FILE* g_File = NULL;
+	bool g_bRecording = false;
+	// recording was on when PauseRecording() was called
+	bool g_bPaused = false;
+	unsigned int g_FrameCount = 0;
+	unsigned int g_FrameIndex = 0;
+
+#ifdef GL_TRACE_RECORDING
+	// row alignment of client pixel data, for sizing texture uploads
+	GLint g_UnpackAlignment = 4;
+
+	// the GLEW entry points that were replaced by the hooks
+	decltype(__glewGenBuffers) g_RealGenBuffers = NULL;
+	decltype(__glewDeleteBuffers) g_RealDeleteBuffers = NULL;
+	decltype(__glewBindBuffer) g_RealBindBuffer = NULL;
+	decltype(__glewBufferData) g_RealBufferData = NULL;
+	decltype(__glewBufferSubData) g_RealBufferSubData = NULL;
+	decltype(__glewGenVertexArrays) g_RealGenVertexArrays = NULL;
+	decltype(__glewDeleteVertexArrays) g_RealDeleteVertexArrays = NULL;
+	decltype(__glewBindVertexArray) g_RealBindVertexArray = NULL;
+	decltype(__glewVertexAttribPointer) g_RealVertexAttribPointer = NULL;
+	decltype(__glewEnableVertexAttribArray) g_RealEnableVertexAttribArray = NULL;
+	decltype(__glewDisableVertexAttribArray) g_RealDisableVertexAttribArray = NULL;
+	decltype(__glewCreateShader) g_RealCreateShader = NULL;
+	decltype(__glewShaderSource) g_RealShaderSource = NULL;
+	decltype(__glewCompileShader) g_RealCompileShader = NULL;
+	decltype(__glewDeleteShader) g_RealDeleteShader = NULL;
+	decltype(__glewCreateProgram) g_RealCreateProgram = NULL;
+	decltype(__glewAttachShader) g_RealAttachShader = NULL;
+	decltype(__glewLinkProgram) g_RealLinkProgram = NULL;
+	decltype(__glewUseProgram) g_RealUseProgram = NULL;
+	decltype(__glewDeleteProgram) g_RealDeleteProgram = NULL;
+	decltype(__glewGetUniformLocation) g_RealGetUniformLocation = NULL;
+	decltype(__glewUniform1i) g_RealUniform1i = NULL;
+	decltype(__glewUniform1f) g_RealUniform1f = NULL;
+	decltype(__glewUniform2f) g_RealUniform2f = NULL;
+	decltype(__glewUniform3f) g_RealUniform3f = NULL;
+	decltype(__glewUniform4f) g_RealUniform4f = NULL;
+	decltype(__glewUniform1iv) g_RealUniform1iv = NULL;
+	decltype(__glewUniform1fv) g_RealUniform1fv = NULL;
+	decltype(__glewUniform2fv) g_RealUniform2fv = NULL;
+	decltype(__glewUniform3fv) g_RealUniform3fv = NULL;
+	decltype(__glewUniform4fv) g_RealUniform4fv = NULL;
+	decltype(__glewUniformMatrix4fv) g_RealUniformMatrix4fv = NULL;
+	decltype(__glewActiveTexture) g_RealActiveTexture = NULL;
+	decltype(__glewGenerateMipmap) g_RealGenerateMipmap = NULL;
+#endif
+
+	// write one record to the trace file
+	void WriteRecord(
+		GLTrace::OPCODE opcode,
+		const uint32_t* fields,
+		size_t fieldCount,
+		const void* data,
+		size_t dataBytes)
+	{
+		uint8_t header[2] = { (uint8_t)opcode, (uint8_t)fieldCount };
+		uint32_t size = (uint32_t)dataBytes;
+
+		fwrite(header, 1, sizeof(header), g_File);
+		fwrite(&size, sizeof(size), 1, g_File);
+		fwrite(fields, sizeof(uint32_t), fieldCount, g_File);
+		if ((NULL != data) && (dataBytes > 0))
+		{
+			fwrite(data, 1, dataBytes, g_File);
+		}
+	}
+
+#ifdef GL_TRACE_RECORDING
+	// split 64-bit values and floats into record fields
+	uint32_t Low(uint64_t value) { return((uint32_t)(value & 0xFFFFFFFFu)); }
+	uint32_t High(uint64_t value) { return((uint32_t)(value >> 32)); }
+	uint32_t FloatBits(float value)
+	{
+		uint32_t bits = 0;
+		memcpy(&bits, &value, sizeof(bits));
+		return(bits);
+	}
+
+	// write a glUniform call with its values
+	void RecordUniform(
+		GLTrace::UNIFORM_FUNCTION function,
+		GLint location,
+		GLsizei count,
+		GLboolean transpose,
+		const void* values,
+		size_t valueBytes)
+	{
+		if (g_bRecording == false)
+		{
+			return;
+		}
+		const uint32_t fields[] = { (uint32_t)function, (uint32_t)location, (uint32_t)count, (uint32_t)transpose };
+		WriteRecord(GLTrace::TRACE_UNIFORM, fields, 4, values, valueBytes);
+	}
+
+	// bytes of client pixel data read by a texture upload
+	size_t ImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+	{
+		size_t components = 4;
+		switch (format)
+		{
+		case GL_RED:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+			components = 1;
+			break;
+		case GL_RG:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+			components = 3;
+			break;
+		default:
+			break;
+		}
+
+		size_t componentBytes = 1;
+		switch (type)
+		{
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_HALF_FLOAT:
+			componentBytes = 2;
+			break;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+			componentBytes = 4;
+			break;
+		default:
+			break;
+		}
+
+		if ((width <= 0) || (height <= 0))
+		{
+			return(0);
+		}
+
+		// every row but the last is padded to the unpack alignment
+		size_t rowBytes = (size_t)width * components * componentBytes;
+		size_t alignment = (size_t)g_UnpackAlignment;
+		size_t paddedRowBytes = (rowBytes + alignment - 1) / alignment * alignment;
+		return(paddedRowBytes * (height - 1) + rowBytes);
+	}
+
+	void GLAPIENTRY TraceGenBuffers(GLsizei count, GLuint* buffers)
+	{
+		g_RealGenBuffers(count, buffers);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { (uint32_t)count };
+			WriteRecord(GLTrace::TRACE_GEN_BUFFERS, fields, 1, buffers, count * sizeof(GLuint));
+		}
+	}
+
+	void GLAPIENTRY TraceDeleteBuffers(GLsizei count, const GLuint* buffers)
+	{
+		g_RealDeleteBuffers(count, buffers);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { (uint32_t)count };
+			WriteRecord(GLTrace::TRACE_DELETE_BUFFERS, fields, 1, buffers, count * sizeof(GLuint));
+		}
+	}
+
+	void GLAPIENTRY TraceBindBuffer(GLenum target, GLuint buffer)
+	{
+		g_RealBindBuffer(target, buffer);
+		TRACE_RECORD(GLTrace::TRACE_BIND_BUFFER, target, buffer);
+	}
+
+	void GLAPIENTRY TraceBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+	{
+		g_RealBufferData(target, size, data, usage);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { target, usage, Low(size), High(size), (uint32_t)(NULL != data) };
+			WriteRecord(GLTrace::TRACE_BUFFER_DATA, fields, 5, data, (NULL != data) ? (size_t)size : 0);
+		}
+	}
+
+	void GLAPIENTRY TraceBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+	{
+		g_RealBufferSubData(target, offset, size, data);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { target, Low(offset), High(offset) };
+			WriteRecord(GLTrace::TRACE_BUFFER_SUB_DATA, fields, 3, data, (size_t)size);
+		}
+	}
+
+	void GLAPIENTRY TraceGenVertexArrays(GLsizei count, GLuint* arrays)
+	{
+		g_RealGenVertexArrays(count, arrays);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { (uint32_t)count };
+			WriteRecord(GLTrace::TRACE_GEN_VERTEX_ARRAYS, fields, 1, arrays, count * sizeof(GLuint));
+		}
+	}
+
+	void GLAPIENTRY TraceDeleteVertexArrays(GLsizei count, const GLuint* arrays)
+	{
+		g_RealDeleteVertexArrays(count, arrays);
+		if (g_bRecording == true)
+		{
+			const uint32_t fields[] = { (uint32_t)count };
+			WriteRecord(GLTrace::TRACE_DELETE_VERTEX_ARRAYS, fields, 1, arrays, count * sizeof(GLuint));
+		}
+	}
+
+	void GLAPIENTRY TraceBindVertexArray(GLuint array)
+	{
+		g_RealBindVertexArray(array);
+		TRACE_RECORD(GLTrace::TRACE_BIND_VERTEX_ARRAY, array);
+	}
+
+	void GLAPIENTRY TraceVertexAttribPointer(
+		GLuint index,
+		GLint size,
+		GLenum type,
+		GLboolean normalized,
+		GLsizei stride,
+		const void* pointer)
+	{
+		g_RealVertexAttribPointer(index, size, type, normalized, stride, pointer);
+		// a buffer is bound in the core profile, so the pointer is an offset
+		uint64_t offset = (uint64_t)(uintptr_t)pointer;
+		TRACE_RECORD(GLTrace::TRACE_VERTEX_ATTRIB_POINTER,
+			index, (uint32_t)size, type, (uint32_t)normalized, (uint32_t)stride, Low(offset), High(offset));
+	}
+
+	void GLAPIENTRY TraceEnableVertexAttribArray(GLuint index)
+	{
+		g_RealEnableVertexAttribArray(index);
+		TRACE_RECORD(GLTrace::TRACE_ENABLE_VERTEX_ATTRIB_ARRAY, index);
+	}
+
+	void GLAPIENTRY TraceDisableVertexAttribArray(GLuint index)
+	{
+		g_RealDisableVertexAttribArray(index);
+		TRACE_RECORD(GLTrace::TRACE_DISABLE_VERTEX_ATTRIB_ARRAY, index);
+	}
+
+	GLuint GLAPIENTRY TraceCreateShader(GLenum type)
+	{
+		GLuint shader = g_RealCreateShader(type);
+		TRACE_RECORD(GLTrace::TRACE_CREATE_SHADER, type, shader);
+		return(shader);
+	}
+
+	void GLAPIENTRY TraceShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+	{
+		g_RealShaderSource(shader, count, strings, lengths);
+		if (g_bRecording == true)
+		{
+			// the pieces are joined, shaders are only set up at load time
+			std::string source;
+			for (GLsizei i = 0; i < count; i++)
+			{
+				if ((NULL != lengths) && (lengths[i] >= 0))
+				{
+					source.append(strings[i], lengths[i]);
+				}
+				else
+				{
+					source.append(strings[i]);
+				}
+			}
+			const uint32_t fields[] = { shader };
+			WriteRecord(GLTrace::TRACE_SHADER_SOURCE, fields, 1, source.data(), source.size());
+		}
+	}
+
+	void GLAPIENTRY TraceCompileShader(GLuint shader)
+	{
+		g_RealCompileShader(shader);
+		TRACE_RECORD(GLTrace::TRACE_COMPILE_SHADER, shader);
+	}
+
+	void GLAPIENTRY TraceDeleteShader(GLuint shader)
+	{
+		g_RealDeleteShader(shader);
+		TRACE_RECORD(GLTrace::TRACE_DELETE_SHADER, shader);
+	}
+
+	GLuint GLAPIENTRY TraceCreateProgram()
+	{
+		GLuint program = g_RealCreateProgram();
+		TRACE_RECORD(GLTrace::TRACE_CREATE_PROGRAM, program);
+		return(program);
+	}
+
+	void GLAPIENTRY TraceAttachShader(GLuint program, GLuint shader)
+	{
+		g_RealAttachShader(program, shader);
+		TRACE_RECORD(GLTrace::TRACE_ATTACH_SHADER, program, shader);
+	}
+
+	void GLAPIENTRY TraceLinkProgram(GLuint program)
+	{
+		g_RealLinkProgram(program);
+		TRACE_RECORD(GLTrace::TRACE_LINK_PROGRAM, program);
+	}
+
+	void GLAPIENTRY TraceUseProgram(GLuint program)
+	{
+		g_RealUseProgram(program);
+		TRACE_RECORD(GLTrace::TRACE_USE_PROGRAM, program);
+	}
+
+	void GLAPIENTRY TraceDeleteProgram(GLuint program)
+	{
+		g_RealDeleteProgram(program);
+		TRACE_RECORD(GLTrace::TRACE_DELETE_PROGRAM, program);
+	}
+
+	GLint GLAPIENTRY TraceGetUniformLocation(GLuint program, const GLchar* name)
+	{
+		GLint location = g_RealGetUniformLocation(program, name);
+		if (g_bRecording == true)
+		{
+			// the replayer maps the recorded location to its own
+			const uint32_t fields[] = { program, (uint32_t)location };
+			WriteRecord(GLTrace::TRACE_GET_UNIFORM_LOCATION, fields, 2, name, strlen(name));
+		}
+		return(location);
+	}
+
+	void GLAPIENTRY TraceUniform1i(GLint location, GLint v0)
+	{
+		g_RealUniform1i(location, v0);
+		RecordUniform(GLTrace::UNIFORM_1I, location, 1, GL_FALSE, &v0, sizeof(v0));
+	}
+
+	void GLAPIENTRY TraceUniform1f(GLint location, GLfloat v0)
+	{
+		g_RealUniform1f(location, v0);
+		RecordUniform(GLTrace::UNIFORM_1F, location, 1, GL_FALSE, &v0, sizeof(v0));
+	}
+
+	void GLAPIENTRY TraceUniform2f(GLint location, GLfloat v0, GLfloat v1)
+	{
+		g_RealUniform2f(location, v0, v1);
+		const GLfloat values[] = { v0, v1 };
+		RecordUniform(GLTrace::UNIFORM_2F, location, 1, GL_FALSE, values, sizeof(values));
+	}
+
+	void GLAPIENTRY TraceUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+	{
+		g_RealUniform3f(location, v0, v1, v2);
+		const GLfloat values[] = { v0, v1, v2 };
+		RecordUniform(GLTrace::UNIFORM_3F, location, 1, GL_FALSE, values, sizeof(values));
+	}
+
+	void GLAPIENTRY TraceUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+	{
+		g_RealUniform4f(location, v0, v1, v2, v3);
+		const GLfloat values[] = { v0, v1, v2, v3 };
+		RecordUniform(GLTrace::UNIFORM_4F, location, 1, GL_FALSE, values, sizeof(values));
+	}
+
+	void GLAPIENTRY TraceUniform1iv(GLint location, GLsizei count, const GLint* value)
+	{
+		g_RealUniform1iv(location, count, value);
+		RecordUniform(GLTrace::UNIFORM_1IV, location, count, GL_FALSE, value, count * sizeof(GLint));
+	}
+
+	void GLAPIENTRY TraceUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		g_RealUniform1fv(location, count, value);
+		RecordUniform(GLTrace::UNIFORM_1FV, location, count, GL_FALSE, value, count * sizeof(GLfloat));
+	}
+
+	void GLAPIENTRY TraceUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		g_RealUniform2fv(location, count, value);
+		RecordUniform(GLTrace::UNIFORM_2FV, location, count, GL_FALSE, value, count * 2 * sizeof(GLfloat));
+	}
+
+	void GLAPIENTRY TraceUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		g_RealUniform3fv(location, count, value);
+		RecordUniform(GLTrace::UNIFORM_3FV, location, count, GL_FALSE, value, count * 3 * sizeof(GLfloat));
+	}
+
+	void GLAPIENTRY TraceUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+	{
+		g_RealUniform4fv(location, count, value);
+		RecordUniform(GLTrace::UNIFORM_4FV, location, count, GL_FALSE, value, count * 4 * sizeof(GLfloat));
+	}
+
+	void GLAPIENTRY TraceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		g_RealUniformMatrix4fv(location, count, transpose, value);
+		RecordUniform(GLTrace::UNIFORM_MATRIX_4FV, location, count, transpose, value, count * 16 * sizeof(GLfloat));
+	}
+
+	void GLAPIENTRY TraceActiveTexture(GLenum texture)
+	{
+		g_RealActiveTexture(texture);
+		TRACE_RECORD(GLTrace::TRACE_ACTIVE_TEXTURE, texture);
+	}
+
+	void GLAPIENTRY TraceGenerateMipmap(GLenum target)
+	{
+		g_RealGenerateMipmap(target);
+		TRACE_RECORD(GLTrace::TRACE_GENERATE_MIPMAP, target);
+	}
+#endif
+}
+
+/***********************************************************
+ *  StartRecording()
+ *
+ *  This method is used for opening the trace file and
+ *  wrapping the GLEW entry points.  The OpenGL 1.1 functions
+ *  are not reached through GLEW, so they are recorded by
+ *  interposing their symbols, which is only done in Linux
+ *  builds with WORKSPACE_GL_TRACE defined.
+ ***********************************************************/
+bool GLTrace::StartRecording(const char* filename, unsigned int frameCount)
+{
+#ifndef GL_TRACE_RECORDING
+	std::cout << "ERROR: GL traces can only be recorded by Linux builds with WORKSPACE_GL_TRACE defined" << std::endl;
+	return(false);
+#else
+	g_File = fopen(filename, "wb");
+	if (NULL == g_File)
+	{
+		std::cout << "Could not write GL trace:" << filename << std::endl;
+		return(false);
+	}
+	setvbuf(g_File, NULL, _IOFBF, FILE_BUFFER_BYTES);
+
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	TRACE_HEADER header;
+	memcpy(header.magic, "WSGT", 4);
+	header.version = VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.width = viewport[2];
+	header.height = viewport[3];
+	fwrite(&header, sizeof(header), 1, g_File);
+
+	INSTALL_TRACE_HOOK(GenBuffers);
+	INSTALL_TRACE_HOOK(DeleteBuffers);
+	INSTALL_TRACE_HOOK(BindBuffer);
+	INSTALL_TRACE_HOOK(BufferData);
+	INSTALL_TRACE_HOOK(BufferSubData);
+	INSTALL_TRACE_HOOK(GenVertexArrays);
+	INSTALL_TRACE_HOOK(DeleteVertexArrays);
+	INSTALL_TRACE_HOOK(BindVertexArray);
+	INSTALL_TRACE_HOOK(VertexAttribPointer);
+	INSTALL_TRACE_HOOK(EnableVertexAttribArray);
+	INSTALL_TRACE_HOOK(DisableVertexAttribArray);
+	INSTALL_TRACE_HOOK(CreateShader);
+	INSTALL_TRACE_HOOK(ShaderSource);
+	INSTALL_TRACE_HOOK(CompileShader);
+	INSTALL_TRACE_HOOK(DeleteShader);
+	INSTALL_TRACE_HOOK(CreateProgram);
+	INSTALL_TRACE_HOOK(AttachShader);
+	INSTALL_TRACE_HOOK(LinkProgram);
+	INSTALL_TRACE_HOOK(UseProgram);
+	INSTALL_TRACE_HOOK(DeleteProgram);
+	INSTALL_TRACE_HOOK(GetUniformLocation);
+	INSTALL_TRACE_HOOK(Uniform1i);
+	INSTALL_TRACE_HOOK(Uniform1f);
+	INSTALL_TRACE_HOOK(Uniform2f);
+	INSTALL_TRACE_HOOK(Uniform3f);
+	INSTALL_TRACE_HOOK(Uniform4f);
+	INSTALL_TRACE_HOOK(Uniform1iv);
+	INSTALL_TRACE_HOOK(Uniform1fv);
+	INSTALL_TRACE_HOOK(Uniform2fv);
+	INSTALL_TRACE_HOOK(Uniform3fv);
+	INSTALL_TRACE_HOOK(Uniform4fv);
+	INSTALL_TRACE_HOOK(UniformMatrix4fv);
+	INSTALL_TRACE_HOOK(ActiveTexture);
+	INSTALL_TRACE_HOOK(GenerateMipmap);
+
+	// the state set before recording is part of the trace
+	TRACE_RECORD(TRACE_VIEWPORT, (uint32_t)viewport[0], (uint32_t)viewport[1], (uint32_t)viewport[2], (uint32_t)viewport[3]);
+
+	g_FrameCount = frameCount;
+	g_FrameIndex = 0;
+	g_bRecording = true;
+
+	return(true);
+#endif
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for marking the end of a frame in the
+ *  trace.  The calls before the first mark are the setup of
+ *  the trace, which the replayer runs once.
+ ***********************************************************/
+void GLTrace::EndFrame()
+{
+	if (g_bRecording == false)
+	{
+		return;
+	}
+
+	TRACE_RECORD(TRACE_FRAME_END, g_FrameIndex);
+	g_FrameIndex++;
+
+	if (g_FrameIndex >= g_FrameCount)
+	{
+		StopRecording();
+		std::cout << "INFO: Recorded " << g_FrameIndex << " frames into the GL trace" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  StopRecording()
+ ***********************************************************/
+void GLTrace::StopRecording()
+{
+	g_bRecording = false;
+	if (NULL != g_File)
+	{
+		fclose(g_File);
+		g_File = NULL;
+	}
+}
+
+/***********************************************************
+ *  PauseRecording()
+ *
+ *  This method is used for leaving the calls that follow out
+ *  of the trace, until ResumeRecording().  They must not
+ *  create anything the recorded frames use.
+ ***********************************************************/
+void GLTrace::PauseRecording()
+{
+	g_bPaused = g_bRecording;
+	g_bRecording = false;
+}
+
+/***********************************************************
+ *  ResumeRecording()
+ ***********************************************************/
+void GLTrace::ResumeRecording()
+{
+	g_bRecording = (g_bPaused == true) && (NULL != g_File);
+	g_bPaused = false;
+}
+
+/***********************************************************
+ *  IsRecording()
+ ***********************************************************/
+bool GLTrace::IsRecording()
+{
+	return(g_bRecording);
+}
+
+#ifdef GL_TRACE_RECORDING
+// The OpenGL 1.1 entry points are exported by libGL and called
+// directly rather than through GLEW.  Defining them here makes
+// the calls of the application, such as the mesh draws, resolve
+// to these wrappers, which forward to the next definition.
+
+// look up the libGL definition of the wrapped function once
+#define REAL_GL_FUNCTION(name) \
+	static decltype(&name) real = (decltype(&name))dlsym(RTLD_NEXT, #name)
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+	REAL_GL_FUNCTION(glGenTextures);
+	real(n, textures);
+	if (g_bRecording == true)
+	{
+		const uint32_t fields[] = { (uint32_t)n };
+		WriteRecord(GLTrace::TRACE_GEN_TEXTURES, fields, 1, textures, n * sizeof(GLuint));
+	}
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	REAL_GL_FUNCTION(glDeleteTextures);
+	real(n, textures);
+	if (g_bRecording == true)
+	{
+		const uint32_t fields[] = { (uint32_t)n };
+		WriteRecord(GLTrace::TRACE_DELETE_TEXTURES, fields, 1, textures, n * sizeof(GLuint));
+	}
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+	REAL_GL_FUNCTION(glBindTexture);
+	real(target, texture);
+	TRACE_RECORD(GLTrace::TRACE_BIND_TEXTURE, target, texture);
+}
+
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	REAL_GL_FUNCTION(glTexParameteri);
+	real(target, pname, param);
+	TRACE_RECORD(GLTrace::TRACE_TEX_PARAMETER_I, target, pname, (uint32_t)param);
+}
+
+void GLAPIENTRY glTexImage2D(
+	GLenum target,
+	GLint level,
+	GLint internalformat,
+	GLsizei width,
+	GLsizei height,
+	GLint border,
+	GLenum format,
+	GLenum type,
+	const void* pixels)
+{
+	REAL_GL_FUNCTION(glTexImage2D);
+	real(target, level, internalformat, width, height, border, format, type, pixels);
+	if (g_bRecording == true)
+	{
+		const uint32_t fields[] = { target, (uint32_t)level, (uint32_t)internalformat,
+			(uint32_t)width, (uint32_t)height, (uint32_t)border, format, type, (uint32_t)g_UnpackAlignment };
+		size_t bytes = (NULL != pixels) ? ImageBytes(width, height, format, type) : 0;
+		WriteRecord(GLTrace::TRACE_TEX_IMAGE_2D, fields, 9, pixels, bytes);
+	}
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+	REAL_GL_FUNCTION(glPixelStorei);
+	real(pname, param);
+	if (pname == GL_UNPACK_ALIGNMENT)
+	{
+		g_UnpackAlignment = param;
+	}
+	TRACE_RECORD(GLTrace::TRACE_PIXEL_STORE_I, pname, (uint32_t)param);
+}
+
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	REAL_GL_FUNCTION(glDrawArrays);
+	real(mode, first, count);
+	TRACE_RECORD(GLTrace::TRACE_DRAW_ARRAYS, mode, (uint32_t)first, (uint32_t)count);
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	REAL_GL_FUNCTION(glDrawElements);
+	real(mode, count, type, indices);
+	// an element buffer is bound in the core profile, so the
+	// indices pointer is an offset
+	uint64_t offset = (uint64_t)(uintptr_t)indices;
+	TRACE_RECORD(GLTrace::TRACE_DRAW_ELEMENTS, mode, (uint32_t)count, type, Low(offset), High(offset));
+}
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+	REAL_GL_FUNCTION(glEnable);
+	real(cap);
+	TRACE_RECORD(GLTrace::TRACE_ENABLE, cap);
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+	REAL_GL_FUNCTION(glDisable);
+	real(cap);
+	TRACE_RECORD(GLTrace::TRACE_DISABLE, cap);
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	REAL_GL_FUNCTION(glBlendFunc);
+	real(sfactor, dfactor);
+	TRACE_RECORD(GLTrace::TRACE_BLEND_FUNC, sfactor, dfactor);
+}
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+	REAL_GL_FUNCTION(glClear);
+	real(mask);
+	TRACE_RECORD(GLTrace::TRACE_CLEAR, mask);
+}
+
+void GLAPIENTRY glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	REAL_GL_FUNCTION(glClearColor);
+	real(red, green, blue, alpha);
+	TRACE_RECORD(GLTrace::TRACE_CLEAR_COLOR, FloatBits(red), FloatBits(green), FloatBits(blue), FloatBits(alpha));
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	REAL_GL_FUNCTION(glViewport);
+	real(x, y, width, height);
+	TRACE_RECORD(GLTrace::TRACE_VIEWPORT, (uint32_t)x, (uint32_t)y, (uint32_t)width, (uint32_t)height);
+}
+#endif
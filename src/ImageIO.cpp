@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// imageio.cpp
+// ============
+// capture the rendered frame and read or write it as a raw RGB image
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageIO.h"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/***********************************************************
+ *  CaptureFramebuffer()
+ *
+ *  This method is used for reading the pixels of the current
+ *  read framebuffer.  OpenGL returns the bottom row first, so
+ *  the rows are flipped to match the PPM layout.
+ ***********************************************************/
+bool ImageIO::CaptureFramebuffer(int width, int height, RGB_IMAGE& image)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+
+	const size_t rowBytes = (size_t)width * 3;
+	std::vector<unsigned char> flipped(rowBytes * height);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, flipped.data());
+
+	image.width = width;
+	image.height = height;
+	image.pixels.resize(rowBytes * height);
+	for (int row = 0; row < height; row++)
+	{
+		memcpy(
+			&image.pixels[row * rowBytes],
+			&flipped[(height - 1 - row) * rowBytes],
+			rowBytes);
+	}
+
+	return(glGetError() == GL_NO_ERROR);
+}
+
+/***********************************************************
+ *  WritePPM()
+ *
+ *  This method is used for writing an RGB image to a binary
+ *  (P6) PPM file.
+ ***********************************************************/
+bool ImageIO::WritePPM(const std::string& filename, const RGB_IMAGE& image)
+{
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write image:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "P6\n%d %d\n255\n", image.width, image.height);
+	size_t written = fwrite(image.pixels.data(), 1, image.pixels.size(), file);
+	fclose(file);
+
+	return(written == image.pixels.size());
+}
+
+/***********************************************************
+ *  ReadPPM()
+ *
+ *  This method is used for reading a binary (P6) PPM file
+ *  with 8 bits per channel into an RGB image.
+ ***********************************************************/
+bool ImageIO::ReadPPM(const std::string& filename, RGB_IMAGE& image)
+{
+	FILE* file = fopen(filename.c_str(), "rb");
+	if (NULL == file)
+	{
+		return(false);
+	}
+
+	char magic[3] = { 0 };
+	int maxValue = 0;
+	bool bReturn = false;
+
+	if ((fscanf(file, "%2s %d %d %d", magic, &image.width, &image.height, &maxValue) == 4) &&
+		(strcmp(magic, "P6") == 0) &&
+		(maxValue == 255) &&
+		(image.width > 0) && (image.height > 0))
+	{
+		// a single whitespace character separates the header from the pixels
+		fgetc(file);
+
+		image.pixels.resize((size_t)image.width * image.height * 3);
+		bReturn = (fread(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size());
+	}
+	fclose(file);
+
+	if (bReturn == false)
+	{
+		std::cout << "Could not read image:" << filename << std::endl;
+	}
+
+	return(bReturn);
+}
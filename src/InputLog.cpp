@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputlog.cpp
+// ============
+// record and replay the per-frame camera input as a compact binary log
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputLog.h"
+
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// file layout: magic, version, frame count, then the frames
+	// in host byte order
+	const char g_LogMagic[4] = { 'W', 'S', 'I', 'N' };
+	const uint32_t g_LogVersion = 1;
+	const long g_FrameCountOffset = 8;
+
+	// flags byte that follows the key state of each frame
+	const uint8_t FRAME_HAS_MOUSE = 1 << 0;
+	const uint8_t FRAME_HAS_SCROLL = 1 << 1;
+}
+
+/***********************************************************
+ *  InputLog()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputLog::InputLog()
+{
+	m_pFile = NULL;
+	m_bWriting = false;
+	m_frameCount = 0;
+	m_framesRead = 0;
+}
+
+/***********************************************************
+ *  ~InputLog()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InputLog::~InputLog()
+{
+	Close();
+}
+
+/***********************************************************
+ *  OpenForWrite()
+ *
+ *  This method is used for creating a new input log and
+ *  writing its header.
+ ***********************************************************/
+bool InputLog::OpenForWrite(const char* filename)
+{
+	Close();
+
+	m_pFile = fopen(filename, "wb");
+	if (NULL == m_pFile)
+	{
+		std::cout << "Could not create input log:" << filename << std::endl;
+		return(false);
+	}
+
+	m_bWriting = true;
+	m_frameCount = 0;
+
+	fwrite(g_LogMagic, 1, sizeof(g_LogMagic), m_pFile);
+	fwrite(&g_LogVersion, sizeof(g_LogVersion), 1, m_pFile);
+	fwrite(&m_frameCount, sizeof(m_frameCount), 1, m_pFile);
+
+	return(true);
+}
+
+/***********************************************************
+ *  OpenForRead()
+ *
+ *  This method is used for opening an input log and checking
+ *  its header.
+ ***********************************************************/
+bool InputLog::OpenForRead(const char* filename)
+{
+	Close();
+
+	m_pFile = fopen(filename, "rb");
+	if (NULL == m_pFile)
+	{
+		std::cout << "Could not open input log:" << filename << std::endl;
+		return(false);
+	}
+
+	char magic[4] = { 0 };
+	uint32_t version = 0;
+
+	m_bWriting = false;
+	m_framesRead = 0;
+
+	if ((fread(magic, 1, sizeof(magic), m_pFile) != sizeof(magic)) ||
+		(memcmp(magic, g_LogMagic, sizeof(magic)) != 0) ||
+		(fread(&version, sizeof(version), 1, m_pFile) != 1) ||
+		(version != g_LogVersion) ||
+		(fread(&m_frameCount, sizeof(m_frameCount), 1, m_pFile) != 1))
+	{
+		std::cout << "Not a supported input log:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteFrame()
+ *
+ *  This method is used for appending one frame of input.
+ ***********************************************************/
+bool InputLog::WriteFrame(const INPUT_FRAME& frame)
+{
+	if (IsWriting() == false)
+	{
+		return(false);
+	}
+
+	uint8_t flags = 0;
+	if ((frame.mouseOffsetX != 0.0f) || (frame.mouseOffsetY != 0.0f))
+	{
+		flags |= FRAME_HAS_MOUSE;
+	}
+	if (frame.scrollOffset != 0.0f)
+	{
+		flags |= FRAME_HAS_SCROLL;
+	}
+
+	fwrite(&frame.deltaTime, sizeof(frame.deltaTime), 1, m_pFile);
+	fwrite(&frame.keys, sizeof(frame.keys), 1, m_pFile);
+	fwrite(&flags, sizeof(flags), 1, m_pFile);
+	if (flags & FRAME_HAS_MOUSE)
+	{
+		fwrite(&frame.mouseOffsetX, sizeof(frame.mouseOffsetX), 1, m_pFile);
+		fwrite(&frame.mouseOffsetY, sizeof(frame.mouseOffsetY), 1, m_pFile);
+	}
+	if (flags & FRAME_HAS_SCROLL)
+	{
+		fwrite(&frame.scrollOffset, sizeof(frame.scrollOffset), 1, m_pFile);
+	}
+
+	m_frameCount++;
+
+	return(ferror(m_pFile) == 0);
+}
+
+/***********************************************************
+ *  ReadFrame()
+ *
+ *  This method is used for reading the next frame of input.
+ ***********************************************************/
+bool InputLog::ReadFrame(INPUT_FRAME& frame)
+{
+	if ((IsReading() == false) || (m_framesRead >= m_frameCount))
+	{
+		return(false);
+	}
+
+	uint8_t flags = 0;
+
+	frame.mouseOffsetX = 0.0f;
+	frame.mouseOffsetY = 0.0f;
+	frame.scrollOffset = 0.0f;
+
+	if ((fread(&frame.deltaTime, sizeof(frame.deltaTime), 1, m_pFile) != 1) ||
+		(fread(&frame.keys, sizeof(frame.keys), 1, m_pFile) != 1) ||
+		(fread(&flags, sizeof(flags), 1, m_pFile) != 1))
+	{
+		return(false);
+	}
+	if ((flags & FRAME_HAS_MOUSE) &&
+		((fread(&frame.mouseOffsetX, sizeof(frame.mouseOffsetX), 1, m_pFile) != 1) ||
+		(fread(&frame.mouseOffsetY, sizeof(frame.mouseOffsetY), 1, m_pFile) != 1)))
+	{
+		return(false);
+	}
+	if ((flags & FRAME_HAS_SCROLL) &&
+		(fread(&frame.scrollOffset, sizeof(frame.scrollOffset), 1, m_pFile) != 1))
+	{
+		return(false);
+	}
+
+	m_framesRead++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for closing the log.  A log being
+ *  written gets its final frame count stored in the header.
+ ***********************************************************/
+void InputLog::Close()
+{
+	if (NULL == m_pFile)
+	{
+		return;
+	}
+
+	if (m_bWriting == true)
+	{
+		fseek(m_pFile, g_FrameCountOffset, SEEK_SET);
+		fwrite(&m_frameCount, sizeof(m_frameCount), 1, m_pFile);
+	}
+
+	fclose(m_pFile);
+	m_pFile = NULL;
+}
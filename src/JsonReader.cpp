@@ -0,0 +1,429 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonreader.cpp
+// ============
+// parse JSON text, such as the reports the application writes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JsonReader.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// nesting deeper than this is rejected instead of
+	// exhausting the stack
+	const int MAX_DEPTH = 256;
+
+	// recursive descent parser over the text
+	class Parser
+	{
+	public:
+		Parser(const std::string& text) : m_text(text), m_offset(0), m_line(1) {}
+
+		bool ParseDocument(JsonReader::JSON_VALUE& value, std::string& error)
+		{
+			if ((ParseValue(value, 0) == true) && (SkipSpace(), m_offset == m_text.size()))
+			{
+				return(true);
+			}
+			if (m_error.empty() == true)
+			{
+				m_error = "unexpected text after the value";
+			}
+			error = "line " + std::to_string(m_line) + ": " + m_error;
+			return(false);
+		}
+
+	private:
+		const std::string& m_text;
+		size_t m_offset;
+		int m_line;
+		std::string m_error;
+
+		bool Fail(const char* message)
+		{
+			if (m_error.empty() == true)
+			{
+				m_error = message;
+			}
+			return(false);
+		}
+
+		void SkipSpace()
+		{
+			while (m_offset < m_text.size())
+			{
+				char c = m_text[m_offset];
+				if (c == '\n')
+				{
+					m_line++;
+				}
+				else if ((c != ' ') && (c != '\t') && (c != '\r'))
+				{
+					return;
+				}
+				m_offset++;
+			}
+		}
+
+		bool Match(const char* word)
+		{
+			size_t length = strlen(word);
+			if (m_text.compare(m_offset, length, word) != 0)
+			{
+				return(false);
+			}
+			m_offset += length;
+			return(true);
+		}
+
+		bool ParseValue(JsonReader::JSON_VALUE& value, int depth)
+		{
+			if (depth > MAX_DEPTH)
+			{
+				return(Fail("nesting too deep"));
+			}
+
+			SkipSpace();
+			if (m_offset >= m_text.size())
+			{
+				return(Fail("unexpected end of text"));
+			}
+
+			char c = m_text[m_offset];
+			if (c == '{')
+			{
+				return(ParseObject(value, depth));
+			}
+			if (c == '[')
+			{
+				return(ParseArray(value, depth));
+			}
+			if (c == '"')
+			{
+				value.type = JsonReader::JSON_STRING;
+				return(ParseString(value.text));
+			}
+			if (Match("true") == true)
+			{
+				value.type = JsonReader::JSON_BOOL;
+				value.bValue = true;
+				return(true);
+			}
+			if (Match("false") == true)
+			{
+				value.type = JsonReader::JSON_BOOL;
+				value.bValue = false;
+				return(true);
+			}
+			if (Match("null") == true)
+			{
+				value.type = JsonReader::JSON_NULL;
+				return(true);
+			}
+			return(ParseNumber(value));
+		}
+
+		bool ParseObject(JsonReader::JSON_VALUE& value, int depth)
+		{
+			value.type = JsonReader::JSON_OBJECT;
+			m_offset++;
+
+			SkipSpace();
+			if ((m_offset < m_text.size()) && (m_text[m_offset] == '}'))
+			{
+				m_offset++;
+				return(true);
+			}
+
+			while (true)
+			{
+				SkipSpace();
+				if ((m_offset >= m_text.size()) || (m_text[m_offset] != '"'))
+				{
+					return(Fail("expected a member name"));
+				}
+				value.members.emplace_back();
+				if (ParseString(value.members.back().first) == false)
+				{
+					return(false);
+				}
+
+				SkipSpace();
+				if ((m_offset >= m_text.size()) || (m_text[m_offset] != ':'))
+				{
+					return(Fail("expected ':' after the member name"));
+				}
+				m_offset++;
+
+				if (ParseValue(value.members.back().second, depth + 1) == false)
+				{
+					return(false);
+				}
+
+				SkipSpace();
+				if (m_offset >= m_text.size())
+				{
+					return(Fail("unterminated object"));
+				}
+				if (m_text[m_offset] == '}')
+				{
+					m_offset++;
+					return(true);
+				}
+				if (m_text[m_offset] != ',')
+				{
+					return(Fail("expected ',' or '}' in the object"));
+				}
+				m_offset++;
+			}
+		}
+
+		bool ParseArray(JsonReader::JSON_VALUE& value, int depth)
+		{
+			value.type = JsonReader::JSON_ARRAY;
+			m_offset++;
+
+			SkipSpace();
+			if ((m_offset < m_text.size()) && (m_text[m_offset] == ']'))
+			{
+				m_offset++;
+				return(true);
+			}
+
+			while (true)
+			{
+				value.elements.emplace_back();
+				if (ParseValue(value.elements.back(), depth + 1) == false)
+				{
+					return(false);
+				}
+
+				SkipSpace();
+				if (m_offset >= m_text.size())
+				{
+					return(Fail("unterminated array"));
+				}
+				if (m_text[m_offset] == ']')
+				{
+					m_offset++;
+					return(true);
+				}
+				if (m_text[m_offset] != ',')
+				{
+					return(Fail("expected ',' or ']' in the array"));
+				}
+				m_offset++;
+			}
+		}
+
+		// append a code point as UTF-8
+		void AppendUTF8(std::string& text, unsigned int codePoint)
+		{
+			if (codePoint < 0x80)
+			{
+				text += (char)codePoint;
+			}
+			else if (codePoint < 0x800)
+			{
+				text += (char)(0xC0 | (codePoint >> 6));
+				text += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				text += (char)(0xE0 | (codePoint >> 12));
+				text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				text += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				text += (char)(0xF0 | (codePoint >> 18));
+				text += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+				text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				text += (char)(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		bool ParseHex4(unsigned int& value)
+		{
+			if (m_offset + 4 > m_text.size())
+			{
+				return(Fail("truncated \\u escape"));
+			}
+			value = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				char c = m_text[m_offset++];
+				value <<= 4;
+				if ((c >= '0') && (c <= '9')) value |= (unsigned int)(c - '0');
+				else if ((c >= 'a') && (c <= 'f')) value |= (unsigned int)(c - 'a' + 10);
+				else if ((c >= 'A') && (c <= 'F')) value |= (unsigned int)(c - 'A' + 10);
+				else return(Fail("invalid \\u escape"));
+			}
+			return(true);
+		}
+
+		bool ParseString(std::string& text)
+		{
+			m_offset++;
+			while (m_offset < m_text.size())
+			{
+				char c = m_text[m_offset++];
+				if (c == '"')
+				{
+					return(true);
+				}
+				if ((unsigned char)c < 0x20)
+				{
+					return(Fail("control character in a string"));
+				}
+				if (c != '\\')
+				{
+					text += c;
+					continue;
+				}
+
+				if (m_offset >= m_text.size())
+				{
+					break;
+				}
+				c = m_text[m_offset++];
+				switch (c)
+				{
+				case '"': text += '"'; break;
+				case '\\': text += '\\'; break;
+				case '/': text += '/'; break;
+				case 'b': text += '\b'; break;
+				case 'f': text += '\f'; break;
+				case 'n': text += '\n'; break;
+				case 'r': text += '\r'; break;
+				case 't': text += '\t'; break;
+				case 'u':
+				{
+					unsigned int codePoint = 0;
+					if (ParseHex4(codePoint) == false)
+					{
+						return(false);
+					}
+					// a surrogate pair makes one code point
+					if ((codePoint >= 0xD800) && (codePoint < 0xDC00) &&
+						(m_text.compare(m_offset, 2, "\\u") == 0))
+					{
+						m_offset += 2;
+						unsigned int low = 0;
+						if (ParseHex4(low) == false)
+						{
+							return(false);
+						}
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUTF8(text, codePoint);
+					break;
+				}
+				default:
+					return(Fail("invalid escape in a string"));
+				}
+			}
+			return(Fail("unterminated string"));
+		}
+
+		bool ParseNumber(JsonReader::JSON_VALUE& value)
+		{
+			const char* start = m_text.c_str() + m_offset;
+			char* end = NULL;
+			double number = strtod(start, &end);
+			if ((end == start) || ((*start != '-') && ((*start < '0') || (*start > '9'))))
+			{
+				return(Fail("unexpected character"));
+			}
+			value.type = JsonReader::JSON_NUMBER;
+			value.number = number;
+			m_offset += end - start;
+			return(true);
+		}
+	};
+}
+
+/***********************************************************
+ *  Parse()
+ *
+ *  This method is used for parsing JSON text into a value.
+ *  On failure the error holds the line and the reason.
+ ***********************************************************/
+bool JsonReader::Parse(const std::string& text, JSON_VALUE& value, std::string& error)
+{
+	value = JSON_VALUE();
+	Parser parser(text);
+	return(parser.ParseDocument(value, error));
+}
+
+/***********************************************************
+ *  ReadFile()
+ ***********************************************************/
+bool JsonReader::ReadFile(const std::string& filename, JSON_VALUE& value, std::string& error)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		error = "could not read " + filename;
+		return(false);
+	}
+
+	std::stringstream text;
+	text << file.rdbuf();
+	if (Parse(text.str(), value, error) == false)
+	{
+		error = filename + ", " + error;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Find()
+ ***********************************************************/
+const JsonReader::JSON_VALUE* JsonReader::Find(const JSON_VALUE& object, const char* name)
+{
+	for (const auto& member : object.members)
+	{
+		if (member.first == name)
+		{
+			return(&member.second);
+		}
+	}
+
+	return(NULL);
+}
+
+/***********************************************************
+ *  GetNumber()
+ ***********************************************************/
+double JsonReader::GetNumber(const JSON_VALUE& object, const char* name, double defaultValue)
+{
+	const JSON_VALUE* value = Find(object, name);
+	return(((NULL != value) && (value->type == JSON_NUMBER)) ? value->number : defaultValue);
+}
+
+/***********************************************************
+ *  GetString()
+ ***********************************************************/
+std::string JsonReader::GetString(const JSON_VALUE& object, const char* name, const std::string& defaultValue)
+{
+	const JSON_VALUE* value = Find(object, name);
+	return(((NULL != value) && (value->type == JSON_STRING)) ? value->text : defaultValue);
+}
+
+/***********************************************************
+ *  GetBool()
+ ***********************************************************/
+bool JsonReader::GetBool(const JSON_VALUE& object, const char* name, bool bDefault)
+{
+	const JSON_VALUE* value = Find(object, name);
+	return(((NULL != value) && (value->type == JSON_BOOL)) ? value->bValue : bDefault);
+}
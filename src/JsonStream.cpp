@@ -0,0 +1,529 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonstream.cpp
+// ============
+// read JSON text one value at a time, without building a tree
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JsonStream.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// declaration of global variables
+namespace
+{
+	// nesting deeper than this is rejected instead of
+	// exhausting the stack while skipping
+	const size_t MAX_DEPTH = 256;
+
+	// append a code point as UTF-8
+	void AppendUTF8(std::string& text, unsigned int codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			text += (char)codePoint;
+		}
+		else if (codePoint < 0x800)
+		{
+			text += (char)(0xC0 | (codePoint >> 6));
+			text += (char)(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000)
+		{
+			text += (char)(0xE0 | (codePoint >> 12));
+			text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+			text += (char)(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			text += (char)(0xF0 | (codePoint >> 18));
+			text += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+			text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+			text += (char)(0x80 | (codePoint & 0x3F));
+		}
+	}
+}
+
+/***********************************************************
+ *  JsonStream()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JsonStream::JsonStream()
+{
+	m_offset = 0;
+	m_line = 1;
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for reading a whole file into memory
+ *  and starting to walk it from the beginning.
+ ***********************************************************/
+bool JsonStream::Open(const std::string& filename)
+{
+	FILE* file = fopen(filename.c_str(), "rb");
+	if (NULL == file)
+	{
+		m_error = "could not read " + filename;
+		return(false);
+	}
+
+	std::string text;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (size > 0)
+	{
+		text.resize(size);
+		text.resize(fread(&text[0], 1, size, file));
+	}
+	fclose(file);
+
+	SetText(text);
+	return(true);
+}
+
+/***********************************************************
+ *  SetText()
+ ***********************************************************/
+void JsonStream::SetText(const std::string& text)
+{
+	m_text = text;
+	m_offset = 0;
+	m_line = 1;
+	m_error.clear();
+	m_bFirst.clear();
+}
+
+/***********************************************************
+ *  SkipSpace()
+ ***********************************************************/
+void JsonStream::SkipSpace()
+{
+	while (m_offset < m_text.size())
+	{
+		char c = m_text[m_offset];
+		if (c == '\n')
+		{
+			m_line++;
+		}
+		else if ((c != ' ') && (c != '\t') && (c != '\r'))
+		{
+			return;
+		}
+		m_offset++;
+	}
+}
+
+/***********************************************************
+ *  Fail()
+ *
+ *  This method is used for stopping the reader with the first
+ *  error, every later call then fails.
+ ***********************************************************/
+bool JsonStream::Fail(const std::string& message)
+{
+	if (m_error.empty() == true)
+	{
+		m_error = "line " + std::to_string(m_line) + ": " + message;
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  Expect()
+ ***********************************************************/
+bool JsonStream::Expect(char c, const char* message)
+{
+	if (HasError() == true)
+	{
+		return(false);
+	}
+	SkipSpace();
+	if ((m_offset >= m_text.size()) || (m_text[m_offset] != c))
+	{
+		return(Fail(message));
+	}
+	m_offset++;
+	return(true);
+}
+
+/***********************************************************
+ *  BeginObject()
+ ***********************************************************/
+bool JsonStream::BeginObject()
+{
+	if (m_bFirst.size() >= MAX_DEPTH)
+	{
+		return(Fail("nesting too deep"));
+	}
+	if (Expect('{', "expected an object") == false)
+	{
+		return(false);
+	}
+	m_bFirst.push_back(true);
+	return(true);
+}
+
+/***********************************************************
+ *  NextMember()
+ *
+ *  This method is used for stepping to the next member of the
+ *  object, reading its name and the colon after it.  At the
+ *  closing brace the object is left and false is returned,
+ *  which is also the case on an error.
+ ***********************************************************/
+bool JsonStream::NextMember(std::string& name)
+{
+	if ((HasError() == true) || (m_bFirst.empty() == true))
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	if ((m_offset < m_text.size()) && (m_text[m_offset] == '}'))
+	{
+		m_offset++;
+		m_bFirst.pop_back();
+		return(false);
+	}
+	if ((m_bFirst.back() == false) && (Expect(',', "expected ',' or '}' in the object") == false))
+	{
+		return(false);
+	}
+	m_bFirst.back() = false;
+
+	SkipSpace();
+	if ((m_offset >= m_text.size()) || (m_text[m_offset] != '"'))
+	{
+		return(Fail("expected a member name"));
+	}
+	name.clear();
+	return((ReadString(name) == true) && (Expect(':', "expected ':' after the member name") == true));
+}
+
+/***********************************************************
+ *  BeginArray()
+ ***********************************************************/
+bool JsonStream::BeginArray()
+{
+	if (m_bFirst.size() >= MAX_DEPTH)
+	{
+		return(Fail("nesting too deep"));
+	}
+	if (Expect('[', "expected an array") == false)
+	{
+		return(false);
+	}
+	m_bFirst.push_back(true);
+	return(true);
+}
+
+/***********************************************************
+ *  NextElement()
+ *
+ *  This method is used for stepping to the next element of
+ *  the array.  At the closing bracket the array is left and
+ *  false is returned, which is also the case on an error.
+ ***********************************************************/
+bool JsonStream::NextElement()
+{
+	if ((HasError() == true) || (m_bFirst.empty() == true))
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	if ((m_offset < m_text.size()) && (m_text[m_offset] == ']'))
+	{
+		m_offset++;
+		m_bFirst.pop_back();
+		return(false);
+	}
+	if ((m_bFirst.back() == false) && (Expect(',', "expected ',' or ']' in the array") == false))
+	{
+		return(false);
+	}
+	m_bFirst.back() = false;
+	return(true);
+}
+
+/***********************************************************
+ *  ReadHex4()
+ ***********************************************************/
+bool JsonStream::ReadHex4(unsigned int& value)
+{
+	if (m_offset + 4 > m_text.size())
+	{
+		return(Fail("truncated \\u escape"));
+	}
+	value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		char c = m_text[m_offset++];
+		value <<= 4;
+		if ((c >= '0') && (c <= '9')) value |= (unsigned int)(c - '0');
+		else if ((c >= 'a') && (c <= 'f')) value |= (unsigned int)(c - 'a' + 10);
+		else if ((c >= 'A') && (c <= 'F')) value |= (unsigned int)(c - 'A' + 10);
+		else return(Fail("invalid \\u escape"));
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  ReadString()
+ *
+ *  This method is used for reading a string value, with its
+ *  escapes decoded.  The text is replaced, so a string kept
+ *  by the caller is reused without allocating.
+ ***********************************************************/
+bool JsonStream::ReadString(std::string& text)
+{
+	if (Expect('"', "expected a string") == false)
+	{
+		return(false);
+	}
+
+	text.clear();
+	while (m_offset < m_text.size())
+	{
+		char c = m_text[m_offset++];
+		if (c == '"')
+		{
+			return(true);
+		}
+		if ((unsigned char)c < 0x20)
+		{
+			return(Fail("control character in a string"));
+		}
+		if (c != '\\')
+		{
+			text += c;
+			continue;
+		}
+
+		if (m_offset >= m_text.size())
+		{
+			break;
+		}
+		c = m_text[m_offset++];
+		switch (c)
+		{
+		case '"': text += '"'; break;
+		case '\\': text += '\\'; break;
+		case '/': text += '/'; break;
+		case 'b': text += '\b'; break;
+		case 'f': text += '\f'; break;
+		case 'n': text += '\n'; break;
+		case 'r': text += '\r'; break;
+		case 't': text += '\t'; break;
+		case 'u':
+		{
+			unsigned int codePoint = 0;
+			if (ReadHex4(codePoint) == false)
+			{
+				return(false);
+			}
+			// a surrogate pair makes one code point
+			if ((codePoint >= 0xD800) && (codePoint < 0xDC00) &&
+				(m_text.compare(m_offset, 2, "\\u") == 0))
+			{
+				m_offset += 2;
+				unsigned int low = 0;
+				if (ReadHex4(low) == false)
+				{
+					return(false);
+				}
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+			AppendUTF8(text, codePoint);
+			break;
+		}
+		default:
+			return(Fail("invalid escape in a string"));
+		}
+	}
+	return(Fail("unterminated string"));
+}
+
+/***********************************************************
+ *  ReadNumber()
+ ***********************************************************/
+bool JsonStream::ReadNumber(double& number)
+{
+	if (HasError() == true)
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	const char* start = m_text.c_str() + m_offset;
+	char* end = NULL;
+	number = strtod(start, &end);
+	if ((end == start) || ((*start != '-') && ((*start < '0') || (*start > '9'))))
+	{
+		return(Fail("expected a number"));
+	}
+	m_offset += end - start;
+	return(true);
+}
+
+/***********************************************************
+ *  ReadFloat()
+ ***********************************************************/
+bool JsonStream::ReadFloat(float& number)
+{
+	double value = 0.0;
+	if (ReadNumber(value) == false)
+	{
+		return(false);
+	}
+	number = (float)value;
+	return(true);
+}
+
+/***********************************************************
+ *  ReadBool()
+ ***********************************************************/
+bool JsonStream::ReadBool(bool& bValue)
+{
+	if (HasError() == true)
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	if (m_text.compare(m_offset, 4, "true") == 0)
+	{
+		m_offset += 4;
+		bValue = true;
+		return(true);
+	}
+	if (m_text.compare(m_offset, 5, "false") == 0)
+	{
+		m_offset += 5;
+		bValue = false;
+		return(true);
+	}
+	return(Fail("expected true or false"));
+}
+
+/***********************************************************
+ *  ReadNull()
+ ***********************************************************/
+bool JsonStream::ReadNull()
+{
+	if (HasError() == true)
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	if (m_text.compare(m_offset, 4, "null") == 0)
+	{
+		m_offset += 4;
+		return(true);
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  ReadFloats()
+ *
+ *  This method is used for reading an array of exactly the
+ *  given number of numbers, such as a vector or a color.
+ ***********************************************************/
+bool JsonStream::ReadFloats(float* values, int count)
+{
+	if (BeginArray() == false)
+	{
+		return(false);
+	}
+
+	int read = 0;
+	while (NextElement() == true)
+	{
+		if (read >= count)
+		{
+			return(Fail("too many numbers in the array, expected " + std::to_string(count)));
+		}
+		if (ReadFloat(values[read++]) == false)
+		{
+			return(false);
+		}
+	}
+	if ((HasError() == false) && (read != count))
+	{
+		return(Fail("too few numbers in the array, expected " + std::to_string(count)));
+	}
+	return(HasError() == false);
+}
+
+/***********************************************************
+ *  SkipValue()
+ *
+ *  This method is used for stepping over a value the caller
+ *  does not use, such as a member added by a newer version.
+ ***********************************************************/
+bool JsonStream::SkipValue()
+{
+	if (HasError() == true)
+	{
+		return(false);
+	}
+
+	SkipSpace();
+	if (m_offset >= m_text.size())
+	{
+		return(Fail("unexpected end of text"));
+	}
+
+	char c = m_text[m_offset];
+	if (c == '{')
+	{
+		std::string name;
+		BeginObject();
+		while (NextMember(name) == true)
+		{
+			SkipValue();
+		}
+		return(HasError() == false);
+	}
+	if (c == '[')
+	{
+		BeginArray();
+		while (NextElement() == true)
+		{
+			SkipValue();
+		}
+		return(HasError() == false);
+	}
+	if (c == '"')
+	{
+		std::string text;
+		return(ReadString(text));
+	}
+	if ((c == 't') || (c == 'f'))
+	{
+		bool bValue = false;
+		return(ReadBool(bValue));
+	}
+	if (ReadNull() == true)
+	{
+		return(true);
+	}
+	double number = 0.0;
+	return(ReadNumber(number));
+}
+
+/***********************************************************
+ *  IsAtEnd()
+ ***********************************************************/
+bool JsonStream::IsAtEnd()
+{
+	SkipSpace();
+	return(m_offset >= m_text.size());
+}
@@ -1,177 +1,867 @@
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // command line parsing
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "RegressionHarness.h"
+#include "BenchmarkReport.h"
+#include "FrameStats.h"
+#include "MemoryTracker.h"
+#include "GLHooks.h"
+#include "StartupProfiler.h"
+#include "AllocationProfiler.h"
+#include "ProfileZone.h"
+#include "SubmissionTuner.h"
+#include "GLDebugLog.h"
+#include "DebugViews.h"
+#include "DebugDraw.h"
+#include "GLTrace.h"
+#include "MetricsServer.h"
+#include "SceneWatcher.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+	// exit code of a regression run that passed its budgets but
+	// has golden images to bootstrap, the code test runners
+	// report as skipped
+	const int EXIT_GOLDEN_MISSING = 77;
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// frame time, draw call and memory statistics
+	FrameStats g_FrameStats;
+	// edits of the scene file, applied between frames
+	SceneWatcher g_SceneWatcher;
+
+	// command line options
+	struct LAUNCH_OPTIONS
+	{
+		// render the regression poses instead of running interactively
+		bool bRegression = false;
+		// directory holding the golden images for the regression poses
+		std::string goldenDir = "regression";
+		// rewrite the golden images instead of comparing against them
+		bool bUpdateGolden = false;
+		// render into a hidden window
+		bool bHeadless = false;
+		// input log to record the camera input into
+		const char* recordFile = NULL;
+		// input log to drive the camera from, benchmarking each frame
+		const char* replayFile = NULL;
+		// JSON report for the replay benchmark
+		const char* benchmarkFile = NULL;
+		// JSON report of the frame and memory statistics at exit
+		const char* statsFile = NULL;
+		// print the startup phases once the first frame is presented
+		bool bStartupReport = false;
+		// JSON report of the startup phases
+		const char* startupFile = NULL;
+		// print the zones of steady-state frames that allocate
+		bool bAllocationReport = false;
+		// submission strategy chosen by hand instead of calibrated
+		bool bSubmitOverride = false;
+		SceneManager::SUBMIT_STRATEGY submitStrategy = SceneManager::SUBMIT_CHANGED_STATE;
+		// calibrate even when a strategy is cached for the renderer
+		bool bRecalibrate = false;
+		// cache of the calibrated strategy per renderer
+		const char* submitCacheFile = "submission_cache.txt";
+		// create a debug context and capture the driver's messages
+		bool bGLDebug = false;
+		// debug view shown from the start, and where to export it
+		DebugViews::DEBUG_VIEW debugView = DebugViews::VIEW_SHADED;
+		const char* debugExportFile = NULL;
+		// measure the shaded pass with pipeline statistics queries
+		bool bPipelineStatistics = false;
+		// GL trace to record, with the number of frames it holds
+		const char* traceFile = NULL;
+		unsigned int traceFrames = 100;
+		// debug draw categories shown from the start
+		bool bDebugDraw[DebugDraw::CATEGORY_COUNT] = {};
+		// size of the display window, zero keeps the default
+		int windowWidth = 0;
+		int windowHeight = 0;
+		// passes the scene is rendered with
+		SceneManager::RENDER_MODE renderMode = SceneManager::RENDER_FORWARD;
+		// port or unix:<path> to serve live metrics on
+		const char* metricsAddress = NULL;
+		// scene description file to load
+		const char* sceneFile = "scenes/office.json";
+		// compare the baked scene with the scene file and exit
+		bool bVerifyBaked = false;
+		// apply edits of the scene file while running
+		bool bWatchScene = false;
+		// stream the sectors of a compiled scene within a budget of
+		// this many MiB, and the load radius, zero for the default
+		unsigned int streamBudgetMiB = 0;
+		float streamRadius = 0.0f;
+		// edge of the grid cells static objects are merged by,
+		// zero merges them regardless of where they are
+		float staticChunkSize = 8.0f;
+		// scenes shown in turn after the scene file, preloaded in
+		// the background, and the seconds each one is shown
+		std::vector<const char*> cycleScenes;
+		float sceneCycleSeconds = 30.0f;
+	};
+	LAUNCH_OPTIONS g_Options;
+
+	// scene being shown and its position in the cycle, with the
+	// time it was switched to, and the next scene's index in the
+	// scene manager, -1 until its preload is started
+	const char* g_ShownScene = NULL;
+	size_t g_CyclePosition = 0;
+	double g_SceneShownTime = 0.0;
+	int g_NextScene = -1;
+	// scene switched away from, unloaded in the frame after the
+	// switch unless it is shown next, -1 when there is none
+	int g_LeftScene = -1;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+bool ParseCommandLine(int argc, char* argv[]);
+void RenderFrame();
+void ReportStartup();
+void CycleScenes();
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	int exitCode = EXIT_SUCCESS;
+
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the check needs no window, the scene file is only read
+	if (g_Options.bVerifyBaked == true)
+	{
+		return(SceneManager::VerifyBakedScene(g_Options.sceneFile) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// the golden images are rendered with the software rasterizer
+	if (g_Options.bRegression == true)
+	{
+		RegressionHarness::UseSoftwareRenderer();
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	StartupProfiler::BeginPhase("glfw init");
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	StartupProfiler::EndPhase();
+
+	// the regression run renders into a hidden window
+	if ((g_Options.bRegression == true) || (g_Options.bHeadless == true))
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
+	if (g_Options.bGLDebug == true)
+	{
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager);
+
+	// try to create the main display window
+	if (g_Options.windowWidth > 0)
+	{
+		g_ViewManager->SetWindowSize(g_Options.windowWidth, g_Options.windowHeight);
+	}
+	StartupProfiler::BeginPhase("window creation");
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	StartupProfiler::EndPhase();
+
+	// if GLEW fails initialization, then terminate the application
+	StartupProfiler::BeginPhase("glew init");
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	StartupProfiler::EndPhase();
+
+	// account for the buffers created from here on
+	GLHooks::Install();
+	if (g_Options.bGLDebug == true)
+	{
+		GLDebugLog::Install();
+	}
+	// the trace starts before the shaders and scene are loaded,
+	// so their uploads can be replayed
+	if ((NULL != g_Options.traceFile) &&
+		(GLTrace::StartRecording(g_Options.traceFile, g_Options.traceFrames) == false))
+	{
+		return(EXIT_FAILURE);
+	}
+	MemoryTracker::InstallDumpSignal();
+	if ((NULL != g_Options.metricsAddress) &&
+		(MetricsServer::Start(g_Options.metricsAddress) == false))
+	{
+		return(EXIT_FAILURE);
+	}
+	g_FrameStats.SetOverlayWindow(g_Window, WINDOW_TITLE);
+
+	// load the shader code from the external GLSL files
+	StartupProfiler::BeginPhase("shader loading");
+	g_ShaderManager->LoadShaders(
+		"../../Utilities/shaders/vertexShader.glsl",
+		"../../Utilities/shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+	StartupProfiler::EndPhase();
+
+	// try to create a new scene manager object and prepare the 3D scene
+	StartupProfiler::BeginPhase("scene preparation");
+	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager->SetStreaming((size_t)g_Options.streamBudgetMiB * 1024 * 1024, g_Options.streamRadius);
+	g_SceneManager->SetStaticChunkSize(g_Options.staticChunkSize);
+	if (g_SceneManager->PrepareScene(g_Options.sceneFile) == false)
+	{
+		exitCode = EXIT_FAILURE;
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	g_SceneManager->SetRenderMode(g_Options.renderMode);
+	StartupProfiler::EndPhase();
+
+	// edits of the scene file are applied while running, not
+	// during the regression run
+	if ((g_Options.bWatchScene == true) && (g_Options.bRegression == false) && (exitCode == EXIT_SUCCESS))
+	{
+		g_SceneWatcher.Start(g_Options.sceneFile);
+	}
+	g_ShownScene = g_Options.sceneFile;
+	g_SceneShownTime = glfwGetTime();
+
+	// render the fixed regression poses and report the failures
+	if ((g_Options.bRegression == true) && (exitCode == EXIT_SUCCESS))
+	{
+		RegressionHarness harness(g_Window, g_ViewManager, g_SceneManager, &RenderFrame);
+		if (harness.Run(g_Options.goldenDir, g_Options.bUpdateGolden) > 0)
+		{
+			exitCode = EXIT_FAILURE;
+		}
+		else if (harness.GetMissingGoldenCount() > 0)
+		{
+			// the golden images are rendered once per checkout, on
+			// the software rasterizer the comparisons run on
+			std::cout << "SKIP: " << harness.GetMissingGoldenCount() << " golden images missing, bootstrap them with --regression "
+				<< g_Options.goldenDir << " --update-golden" << std::endl;
+			exitCode = EXIT_GOLDEN_MISSING;
+		}
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+
+	// choose how the draws are submitted on this renderer, the
+	// regression run keeps the default for repeatable budgets
+	if (g_Options.bSubmitOverride == true)
+	{
+		g_SceneManager->SetSubmitStrategy(g_Options.submitStrategy);
+	}
+	else if (g_Options.bRegression == false)
+	{
+		StartupProfiler::BeginPhase("submission tuning");
+		SubmissionTuner tuner(g_SceneManager, g_ViewManager);
+		tuner.SelectStrategy(g_Options.submitCacheFile, g_Options.bRecalibrate);
+		StartupProfiler::EndPhase();
+	}
+
+	for (int i = 0; i < DebugDraw::CATEGORY_COUNT; i++)
+	{
+		DebugDraw::SetCategory((DebugDraw::DEBUG_CATEGORY)i, g_Options.bDebugDraw[i]);
+	}
+	DebugViews::SetView(g_Options.debugView);
+	DebugViews::EnableStatistics(g_Options.bPipelineStatistics);
+	if (NULL != g_Options.debugExportFile)
+	{
+		DebugViews::RequestExport(g_Options.debugExportFile);
+	}
+
+	// record or replay the camera input
+	if ((NULL != g_Options.recordFile) &&
+		(g_ViewManager->StartRecording(g_Options.recordFile) == false))
+	{
+		exitCode = EXIT_FAILURE;
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+
+	BenchmarkReport benchmark;
+	std::string workload;
+	if (NULL != g_Options.replayFile)
+	{
+		if (g_ViewManager->StartReplay(g_Options.replayFile) == false)
+		{
+			exitCode = EXIT_FAILURE;
+			glfwSetWindowShouldClose(g_Window, true);
+		}
+
+		// a replay runs as fast as possible for benchmarking
+		glfwSwapInterval(0);
+		benchmark.SetRenderer((const char*)glGetString(GL_RENDERER));
+		workload = g_Options.replayFile;
+		workload = workload.substr(workload.find_last_of("/\\") + 1);
+		benchmark.ReserveFrames(workload, g_ViewManager->GetReplayFrameCount());
+	}
+
+	// frames after the first few are expected not to allocate
+	const unsigned long steadyStateFrame = 3;
+	unsigned long frameNumber = 0;
+	int allocationReports = 0;
+
+	StartupProfiler::BeginPhase("first frame");
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		double frameStart = glfwGetTime();
+		AllocationProfiler::BeginFrame();
+		GLDebugLog::NextFrame();
+
+		// apply an edited scene file before the frame is recorded
+		if (g_SceneWatcher.HasChanged() == true)
+		{
+			ProfileZone zone("SceneReload");
+			g_SceneManager->ReloadSceneFile(g_ShownScene);
+		}
+		CycleScenes();
+
+		// render the 3D scene into the back buffer
+		RenderFrame();
+
+		// Flips the the back buffer with the front buffer every frame.
+		{
+			ProfileZone zone("SwapBuffers");
+			glfwSwapBuffers(g_Window);
+		}
+		GLTrace::EndFrame();
+
+		if (StartupProfiler::IsFirstFrameMarked() == false)
+		{
+			ReportStartup();
+		}
+
+		float frameMs = (float)((glfwGetTime() - frameStart) * 1000.0);
+		{
+			ProfileZone zone("FrameStats");
+			g_FrameStats.EndFrame(frameMs, g_SceneManager->GetDrawCallCount());
+			g_FrameStats.SetArenaUsage(
+				g_SceneManager->GetFrameArena().GetHighWater(),
+				g_SceneManager->GetFrameArena().GetCapacity(),
+				g_SceneManager->GetFrameArena().GetOverflowCount());
+			g_FrameStats.PublishMetrics();
+			MemoryTracker::PollDumpSignal();
+		}
+
+		// the frame after the last replayed one has no input
+		if ((NULL != g_Options.replayFile) && (g_ViewManager->IsReplayFinished() == false))
+		{
+			benchmark.AddFrame(
+				workload,
+				frameMs,
+				g_SceneManager->GetDrawCallCount());
+		}
+
+		// query the latest GLFW events
+		{
+			ProfileZone zone("PollEvents");
+			glfwPollEvents();
+			DebugViews::ProcessKeys(g_Window);
+			DebugDraw::ProcessKeys(g_Window);
+		}
+
+		// report the steady-state frames that touched the heap,
+		// the first few of them only to keep the output readable
+		unsigned int allocations = AllocationProfiler::EndFrame();
+		if ((g_Options.bAllocationReport == true) &&
+			(++frameNumber > steadyStateFrame) &&
+			(allocations > 0) &&
+			(allocationReports < 10))
+		{
+			fprintf(stdout, "Frame %lu: ", frameNumber);
+			AllocationProfiler::PrintFrameReport(stdout);
+			allocationReports++;
+		}
+	}
+
+	if (NULL != g_Options.replayFile)
+	{
+		benchmark.PrintSummary();
+		if ((NULL != g_Options.benchmarkFile) &&
+			(benchmark.WriteJSON(g_Options.benchmarkFile) == false))
+		{
+			exitCode = EXIT_FAILURE;
+		}
+	}
+
+	if ((NULL != g_Options.statsFile) &&
+		(g_FrameStats.WriteJSON(g_Options.statsFile) == false))
+	{
+		exitCode = EXIT_FAILURE;
+	}
+	if (g_Options.bGLDebug == true)
+	{
+		GLDebugLog::PrintReport(stdout);
+	}
+	DebugViews::PrintStatistics(stdout);
+	DebugViews::Destroy();
+	if (DebugDraw::GetDroppedVertices() > 0)
+	{
+		std::cout << "WARNING: Debug draw dropped " << DebugDraw::GetDroppedVertices() << " vertices of full frames" << std::endl;
+	}
+	DebugDraw::Destroy();
+	GLTrace::StopRecording();
+	MetricsServer::Stop();
+	g_SceneWatcher.Stop();
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+
+	// Terminates the program
+	exit(exitCode); 
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the launch options.
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--regression") == 0)
+		{
+			g_Options.bRegression = true;
+			// an optional golden image directory follows
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				g_Options.goldenDir = argv[++i];
+			}
+		}
+		else if (strcmp(argv[i], "--update-golden") == 0)
+		{
+			g_Options.bUpdateGolden = true;
+		}
+		else if (strcmp(argv[i], "--headless") == 0)
+		{
+			g_Options.bHeadless = true;
+		}
+		else if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc))
+		{
+			g_Options.recordFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+		{
+			g_Options.replayFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--bench-json") == 0) && (i + 1 < argc))
+		{
+			g_Options.benchmarkFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--stats-json") == 0) && (i + 1 < argc))
+		{
+			g_Options.statsFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--startup-report") == 0)
+		{
+			g_Options.bStartupReport = true;
+		}
+		else if ((strcmp(argv[i], "--startup-json") == 0) && (i + 1 < argc))
+		{
+			g_Options.startupFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--alloc-report") == 0)
+		{
+			g_Options.bAllocationReport = true;
+			if (AllocationProfiler::IsAvailable() == false)
+			{
+				std::cerr << "WARNING: build with WORKSPACE_ALLOCATION_PROFILER to count allocations" << std::endl;
+			}
+		}
+		else if (strcmp(argv[i], "--gl-debug") == 0)
+		{
+			g_Options.bGLDebug = true;
+		}
+		else if ((strcmp(argv[i], "--debug-view") == 0) && (i + 1 < argc))
+		{
+			i++;
+			if (DebugViews::FindView(argv[i], g_Options.debugView) == false)
+			{
+				std::cerr << "Unknown debug view: " << argv[i] << " (shaded, overdraw, light_count or triangle_density)" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--debug-export") == 0) && (i + 1 < argc))
+		{
+			g_Options.debugExportFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--debug-draw") == 0) && (i + 1 < argc))
+		{
+			// a comma separated list of categories
+			std::string categories = argv[++i];
+			size_t start = 0;
+			while (start <= categories.size())
+			{
+				size_t end = categories.find(',', start);
+				if (end == std::string::npos)
+				{
+					end = categories.size();
+				}
+				std::string name = categories.substr(start, end - start);
+				DebugDraw::DEBUG_CATEGORY category;
+				if (DebugDraw::FindCategory(name.c_str(), category) == false)
+				{
+					std::cerr << "Unknown debug draw category: " << name << " (bounds, frustum, lights or user)" << std::endl;
+					return(false);
+				}
+				g_Options.bDebugDraw[category] = true;
+				start = end + 1;
+			}
+		}
+		else if (strcmp(argv[i], "--pipeline-stats") == 0)
+		{
+			g_Options.bPipelineStatistics = true;
+		}
+		else if ((strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+		{
+			g_Options.traceFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--trace-frames") == 0) && (i + 1 < argc))
+		{
+			g_Options.traceFrames = (unsigned int)std::max(atoi(argv[++i]), 2);
+		}
+		else if ((strcmp(argv[i], "--resolution") == 0) && (i + 1 < argc))
+		{
+			i++;
+			if ((sscanf(argv[i], "%dx%d", &g_Options.windowWidth, &g_Options.windowHeight) != 2) ||
+				(g_Options.windowWidth <= 0) || (g_Options.windowHeight <= 0))
+			{
+				std::cerr << "Invalid resolution: " << argv[i] << " (<width>x<height>)" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--render-mode") == 0) && (i + 1 < argc))
+		{
+			i++;
+			if (SceneManager::FindRenderMode(argv[i], g_Options.renderMode) == false)
+			{
+				std::cerr << "Unknown render mode: " << argv[i] << " (forward or depth_prepass)" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--metrics") == 0) && (i + 1 < argc))
+		{
+			g_Options.metricsAddress = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && (i + 1 < argc))
+		{
+			g_Options.sceneFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--verify-baked") == 0)
+		{
+			g_Options.bVerifyBaked = true;
+		}
+		else if (strcmp(argv[i], "--watch-scene") == 0)
+		{
+			g_Options.bWatchScene = true;
+		}
+		else if ((strcmp(argv[i], "--stream-budget") == 0) && (i + 1 < argc))
+		{
+			g_Options.streamBudgetMiB = (unsigned int)std::max(atoi(argv[++i]), 1);
+		}
+		else if ((strcmp(argv[i], "--stream-radius") == 0) && (i + 1 < argc))
+		{
+			g_Options.streamRadius = (float)std::max(atof(argv[++i]), 0.0);
+		}
+		else if ((strcmp(argv[i], "--static-chunk") == 0) && (i + 1 < argc))
+		{
+			g_Options.staticChunkSize = (float)std::max(atof(argv[++i]), 0.0);
+		}
+		else if ((strcmp(argv[i], "--next-scene") == 0) && (i + 1 < argc))
+		{
+			g_Options.cycleScenes.push_back(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--scene-cycle") == 0) && (i + 1 < argc))
+		{
+			g_Options.sceneCycleSeconds = (float)std::max(atof(argv[++i]), 1.0);
+		}
+		else if ((strcmp(argv[i], "--submit") == 0) && (i + 1 < argc))
+		{
+			i++;
+			if (strcmp(argv[i], "auto") == 0)
+			{
+				g_Options.bSubmitOverride = false;
+			}
+			else if (SceneManager::FindSubmitStrategy(argv[i], g_Options.submitStrategy) == true)
+			{
+				g_Options.bSubmitOverride = true;
+			}
+			else
+			{
+				std::cerr << "Unknown submission strategy: " << argv[i] << " (changed, full, filtered or auto)" << std::endl;
+				return(false);
+			}
+		}
+		else if (strcmp(argv[i], "--recalibrate") == 0)
+		{
+			g_Options.bRecalibrate = true;
+		}
+		else if ((strcmp(argv[i], "--submit-cache") == 0) && (i + 1 < argc))
+		{
+			g_Options.submitCacheFile = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << std::endl;
+			std::cerr << "Usage: " << argv[0]
+				<< " [--regression [golden dir]] [--update-golden]"
+				<< " [--headless] [--record <log>] [--replay <log> [--bench-json <file>]]"
+				<< " [--stats-json <file>] [--startup-report] [--startup-json <file>]"
+				<< " [--alloc-report] [--submit <strategy|auto>] [--recalibrate]"
+				<< " [--submit-cache <file>] [--gl-debug]"
+				<< " [--debug-view <view>] [--debug-export <file>] [--pipeline-stats]"
+				<< " [--debug-draw <categories>]"
+				<< " [--trace <file> [--trace-frames <count>]]"
+				<< " [--metrics <port|unix:path>] [--scene <file>] [--verify-baked] [--watch-scene]"
+				<< " [--stream-budget <MiB> [--stream-radius <distance>]] [--static-chunk <size>]"
+				<< " [--next-scene <file>]... [--scene-cycle <seconds>]"
+				<< " [--resolution <width>x<height>] [--render-mode <mode>]" << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	ReportStartup()
+ *
+ *  This function is used to end the startup profile once the
+ *  first frame has been presented, and to report it.
+ ***********************************************************/
+void ReportStartup()
+{
+	StartupProfiler::MarkFirstFrame();
+	std::cout << "INFO: First frame presented " << StartupProfiler::GetTimeToFirstFrame() << " ms after start" << std::endl;
+
+	if (g_Options.bStartupReport == true)
+	{
+		StartupProfiler::PrintReport(stdout);
+	}
+	if (NULL != g_Options.startupFile)
+	{
+		StartupProfiler::WriteJSON(g_Options.startupFile);
+	}
+}
+
+/***********************************************************
+ *	CycleScenes()
+ *
+ *  This function is used to show the scene file and the next
+ *  scenes in turn.  The scene after the shown one is preloaded
+ *  in the background, and switched to between frames once its
+ *  time is up and it is ready, so a switch does not stall the
+ *  frame.  A scene that fails to load is skipped this round.
+ *  Only the shown scene and the next one stay resident: the
+ *  scene switched away from is unloaded in the frame after
+ *  the switch, so the switch frame only swaps them.
+ ***********************************************************/
+void CycleScenes()
+{
+	if (g_Options.cycleScenes.empty() == true)
+	{
+		return;
+	}
+
+	g_SceneManager->UpdatePreloading();
+
+	size_t nextPosition = (g_CyclePosition + 1) % (g_Options.cycleScenes.size() + 1);
+	const char* nextFile = (0 == nextPosition) ? g_Options.sceneFile : g_Options.cycleScenes[nextPosition - 1];
+	if (g_LeftScene >= 0)
+	{
+		// with two scenes the one left is the next one, and it
+		// is kept rather than read again
+		if (strcmp(g_SceneManager->GetSceneFilename(g_LeftScene), nextFile) == 0)
+		{
+			g_NextScene = g_LeftScene;
+		}
+		else
+		{
+			g_SceneManager->UnloadScene(g_LeftScene);
+		}
+		g_LeftScene = -1;
+		return;
+	}
+	if (g_NextScene < 0)
+	{
+		// only one scene is preloaded at a time, so this fails
+		// when the loaded scene cannot have others next to it
+		g_NextScene = g_SceneManager->PreloadScene(nextFile);
+		if (g_NextScene < 0)
+		{
+			g_Options.cycleScenes.clear();
+		}
+		return;
+	}
+	if (g_SceneManager->HasSceneFailed(g_NextScene) == true)
+	{
+		g_CyclePosition = nextPosition;
+		g_NextScene = -1;
+		return;
+	}
+
+	int shownScene = g_SceneManager->GetActiveScene();
+	if ((glfwGetTime() - g_SceneShownTime >= g_Options.sceneCycleSeconds) &&
+		(g_SceneManager->SwitchScene(g_NextScene) == true))
+	{
+		g_LeftScene = shownScene;
+		g_ShownScene = nextFile;
+		g_CyclePosition = nextPosition;
+		g_SceneShownTime = glfwGetTime();
+		g_NextScene = -1;
+		if (g_SceneWatcher.IsWatching() == true)
+		{
+			g_SceneWatcher.Start(g_ShownScene);
+		}
+	}
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to render one frame of the 3D scene
+ *  into the back buffer.
+ ***********************************************************/
+void RenderFrame()
+{
+	ProfileZone zone("RenderFrame");
+
+	// Enable z-depth
+	glEnable(GL_DEPTH_TEST);
+
+	// Clear the frame and z buffers
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// convert from 3D object space to 2D view
+	g_ViewManager->PrepareSceneView();
+	g_SceneManager->SetViewMatrices(g_ViewManager->GetViewMatrix(), g_ViewManager->GetProjectionMatrix());
+	g_SceneManager->UpdateStreaming(g_ViewManager->GetCameraPosition(), g_ViewManager->GetCameraVelocity());
+
+	// refresh the 3D scene, measuring the shaded pass when asked
+	DebugViews::BeginStatistics();
+	g_SceneManager->RenderScene();
+	DebugViews::EndStatistics();
+
+	// draw the selected debug view over the shaded frame
+	DebugViews::Render(g_SceneManager, g_ViewManager);
+
+	// draw the enabled debug shapes with one draw
+	DebugDraw::AddSceneShapes(g_SceneManager, g_ViewManager);
+	DebugDraw::Flush(g_ViewManager);
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+///////////////////////////////////////////////////////////////////////////////
+// memorytracker.cpp
+// ============
+// account for the CPU and GPU memory held by every scene resource
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <map>
+#include <mutex>
+#include <utility>
+
+// declaration of global variables
+namespace
+{
+	struct MEMORY_RECORD
+	{
+		std::string tag;
+		std::string detail;
+		size_t bytes;
+	};
+
+	struct MEMORY_TOTAL
+	{
+		size_t bytes = 0;
+		size_t highWater = 0;
+		size_t resources = 0;
+	};
+
+	// records are keyed by category and resource id
+	typedef std::pair<int, uint64_t> RECORD_KEY;
+
+	std::mutex g_Mutex;
+	std::map<RECORD_KEY, MEMORY_RECORD> g_Records;
+	MEMORY_TOTAL g_CategoryTotals[MemoryTracker::MEMORY_CATEGORY_COUNT];
+	std::map<std::string, MEMORY_TOTAL> g_TagTotals;
+	size_t g_GPUHighWater = 0;
+
+	// set from the signal handler, read on the render thread
+	std::atomic<bool> g_bDumpRequested(false);
+
+	const char* const g_CategoryNames[MemoryTracker::MEMORY_CATEGORY_COUNT] =
+	{
+		"texture",
+		"mesh_buffer",
+		"uniform_buffer",
+		"storage_buffer",
+		"other_buffer",
+		"cpu"
+	};
+
+	// add bytes to, or remove bytes from, a total
+	void Account(MEMORY_TOTAL& total, size_t bytes, bool bAdd)
+	{
+		if (bAdd == true)
+		{
+			total.bytes += bytes;
+			total.resources++;
+			total.highWater = std::max(total.highWater, total.bytes);
+		}
+		else
+		{
+			total.bytes -= std::min(total.bytes, bytes);
+			total.resources -= std::min<size_t>(total.resources, 1);
+		}
+	}
+
+	// current bytes of the GPU categories, the mutex must be held
+	size_t SumGPUBytes()
+	{
+		size_t bytes = 0;
+		for (int i = 0; i < MemoryTracker::MEMORY_CATEGORY_COUNT; i++)
+		{
+			if (i != MemoryTracker::MEMORY_CPU)
+			{
+				bytes += g_CategoryTotals[i].bytes;
+			}
+		}
+		return(bytes);
+	}
+
+	// remove a record from the totals, the mutex must be held
+	void EraseRecord(std::map<RECORD_KEY, MEMORY_RECORD>::iterator record)
+	{
+		Account(g_CategoryTotals[record->first.first], record->second.bytes, false);
+		Account(g_TagTotals[record->second.tag], record->second.bytes, false);
+		g_Records.erase(record);
+	}
+
+	void OnDumpSignal(int signal)
+	{
+		g_bDumpRequested = true;
+	}
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for recording the byte size of a
+ *  resource.  Registering an id again, as when a buffer is
+ *  re-specified, replaces the earlier record.
+ ***********************************************************/
+void MemoryTracker::Register(
+	MEMORY_CATEGORY category,
+	uint64_t resourceID,
+	const std::string& tag,
+	const std::string& detail,
+	size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	RECORD_KEY key(category, resourceID);
+	auto existing = g_Records.find(key);
+	if (existing != g_Records.end())
+	{
+		EraseRecord(existing);
+	}
+
+	MEMORY_RECORD& record = g_Records[key];
+	record.tag = tag;
+	record.detail = detail;
+	record.bytes = bytes;
+
+	Account(g_CategoryTotals[category], bytes, true);
+	Account(g_TagTotals[tag], bytes, true);
+	g_GPUHighWater = std::max(g_GPUHighWater, SumGPUBytes());
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for removing the record of a freed
+ *  resource.  Unknown ids are ignored.
+ ***********************************************************/
+void MemoryTracker::Release(MEMORY_CATEGORY category, uint64_t resourceID)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	auto existing = g_Records.find(RECORD_KEY(category, resourceID));
+	if (existing != g_Records.end())
+	{
+		EraseRecord(existing);
+	}
+}
+
+/***********************************************************
+ *  GetCategoryBytes()
+ ***********************************************************/
+size_t MemoryTracker::GetCategoryBytes(MEMORY_CATEGORY category)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(g_CategoryTotals[category].bytes);
+}
+
+/***********************************************************
+ *  GetCategoryHighWater()
+ ***********************************************************/
+size_t MemoryTracker::GetCategoryHighWater(MEMORY_CATEGORY category)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(g_CategoryTotals[category].highWater);
+}
+
+/***********************************************************
+ *  GetGPUBytes()
+ ***********************************************************/
+size_t MemoryTracker::GetGPUBytes()
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(SumGPUBytes());
+}
+
+/***********************************************************
+ *  GetCPUBytes()
+ ***********************************************************/
+size_t MemoryTracker::GetCPUBytes()
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return(g_CategoryTotals[MEMORY_CPU].bytes);
+}
+
+/***********************************************************
+ *  GetCategoryName()
+ ***********************************************************/
+const char* MemoryTracker::GetCategoryName(MEMORY_CATEGORY category)
+{
+	if ((category < 0) || (category >= MEMORY_CATEGORY_COUNT))
+	{
+		return("unknown");
+	}
+	return(g_CategoryNames[category]);
+}
+
+/***********************************************************
+ *  PrintReport()
+ *
+ *  This method is used for printing the current bytes, the
+ *  high-water mark and the number of resources of every
+ *  category and every asset tag.
+ ***********************************************************/
+void MemoryTracker::PrintReport(FILE* output)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	fprintf(output, "Memory by category (bytes / high-water / resources):\n");
+	for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+	{
+		fprintf(output, "  %-16s %12zu %12zu %6zu\n",
+			g_CategoryNames[i],
+			g_CategoryTotals[i].bytes,
+			g_CategoryTotals[i].highWater,
+			g_CategoryTotals[i].resources);
+	}
+	fprintf(output, "  %-16s %12zu %12zu\n", "gpu_total", SumGPUBytes(), g_GPUHighWater);
+
+	fprintf(output, "Memory by tag (bytes / high-water / resources):\n");
+	for (const auto& tag : g_TagTotals)
+	{
+		fprintf(output, "  %-16s %12zu %12zu %6zu\n",
+			tag.first.c_str(),
+			tag.second.bytes,
+			tag.second.highWater,
+			tag.second.resources);
+	}
+	fflush(output);
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the memory totals as the
+ *  members of an enclosing JSON object.  Tags are expected to
+ *  be plain asset names that need no escaping.
+ ***********************************************************/
+void MemoryTracker::WriteJSON(FILE* output, const char* indent)
+{
+	std::lock_guard<std::mutex> lock(g_Mutex);
+
+	fprintf(output, "%s\"gpu_bytes\": %zu,\n", indent, SumGPUBytes());
+	fprintf(output, "%s\"gpu_high_water\": %zu,\n", indent, g_GPUHighWater);
+
+	fprintf(output, "%s\"categories\": {", indent);
+	for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+	{
+		fprintf(output, "%s\n%s  \"%s\": { \"bytes\": %zu, \"high_water\": %zu, \"resources\": %zu }",
+			(i > 0) ? "," : "",
+			indent,
+			g_CategoryNames[i],
+			g_CategoryTotals[i].bytes,
+			g_CategoryTotals[i].highWater,
+			g_CategoryTotals[i].resources);
+	}
+	fprintf(output, "\n%s},\n", indent);
+
+	fprintf(output, "%s\"tags\": {", indent);
+	bool bFirst = true;
+	for (const auto& tag : g_TagTotals)
+	{
+		fprintf(output, "%s\n%s  \"%s\": { \"bytes\": %zu, \"high_water\": %zu, \"resources\": %zu }",
+			bFirst ? "" : ",",
+			indent,
+			tag.first.c_str(),
+			tag.second.bytes,
+			tag.second.highWater,
+			tag.second.resources);
+		bFirst = false;
+	}
+	fprintf(output, "\n%s}\n", indent);
+}
+
+/***********************************************************
+ *  InstallDumpSignal()
+ *
+ *  This method is used for installing the signal handler that
+ *  requests a memory report.  The handler only sets a flag;
+ *  the report is printed by PollDumpSignal() on the render
+ *  thread.
+ ***********************************************************/
+void MemoryTracker::InstallDumpSignal()
+{
+#if defined(SIGUSR1)
+	signal(SIGUSR1, OnDumpSignal);
+#elif defined(SIGBREAK)
+	signal(SIGBREAK, OnDumpSignal);
+#endif
+}
+
+/***********************************************************
+ *  PollDumpSignal()
+ ***********************************************************/
+void MemoryTracker::PollDumpSignal()
+{
+	if (g_bDumpRequested.exchange(false) == true)
+	{
+		PrintReport(stdout);
+	}
+}
@@ -0,0 +1,452 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.cpp
+// ============
+// reorder indexed triangle meshes for the GPU and measure them
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimizer.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	// the cache that Forsyth's scores model, larger than the
+	// simulated one so vertices about to leave still count
+	const int SCORE_CACHE_SIZE = 32;
+	const float CACHE_DECAY_POWER = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.0f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	// vertex fetch cache, 16KB in lines of bytes
+	const size_t FETCH_LINE_BYTES = 64;
+	const size_t FETCH_CACHE_LINES = 256;
+
+	const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	// score of a vertex by its place in the cache and the number
+	// of its triangles still to be emitted; the vertices of the
+	// last triangle score a little less, so strips do not turn
+	// back on themselves, and vertices with few triangles left
+	// are boosted to finish them off
+	float GetVertexScore(int cachePosition, uint32_t remaining)
+	{
+		if (remaining == 0)
+		{
+			return(-1.0f);
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				const float scale = 1.0f / (float)(SCORE_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (float)(cachePosition - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+		score += VALENCE_BOOST_SCALE * std::pow((float)remaining, -VALENCE_BOOST_POWER);
+		return(score);
+	}
+
+	glm::vec3 GetPosition(const float* pPositions, size_t stride, uint32_t vertex)
+	{
+		const float* pPosition = pPositions + (size_t)vertex * stride;
+		return(glm::vec3(pPosition[0], pPosition[1], pPosition[2]));
+	}
+
+	// FNV-1a hash of the bytes of a vertex
+	uint64_t HashBytes(const unsigned char* pBytes, size_t count)
+	{
+		uint64_t hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < count; i++)
+		{
+			hash = (hash ^ pBytes[i]) * 1099511628211ULL;
+		}
+		return(hash);
+	}
+}
+
+/***********************************************************
+ *  WeldVertices()
+ *
+ *  This method is used for merging the vertices that were
+ *  generated more than once, such as the shared edges of
+ *  faces that are built one at a time.  Vertices are only
+ *  merged when all of their bytes are equal, so seams where
+ *  the normals or texture coordinates differ are kept.
+ ***********************************************************/
+size_t MeshOptimizer::WeldVertices(
+	std::vector<uint32_t>& indices,
+	std::vector<uint32_t>& vertexOrder,
+	const void* pVertices,
+	size_t vertexCount,
+	size_t vertexBytes)
+{
+	const unsigned char* pBytes = (const unsigned char*)pVertices;
+	// the new vertices by the hash of their bytes
+	std::unordered_multimap<uint64_t, uint32_t> weldedByHash;
+	std::vector<uint32_t> remap(vertexCount, NO_TRIANGLE);
+	vertexOrder.clear();
+
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const unsigned char* pVertex = pBytes + v * vertexBytes;
+		const uint64_t hash = HashBytes(pVertex, vertexBytes);
+		auto range = weldedByHash.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (memcmp(pBytes + (size_t)vertexOrder[it->second] * vertexBytes, pVertex, vertexBytes) == 0)
+			{
+				remap[v] = it->second;
+				break;
+			}
+		}
+		if (NO_TRIANGLE == remap[v])
+		{
+			remap[v] = (uint32_t)vertexOrder.size();
+			weldedByHash.emplace(hash, remap[v]);
+			vertexOrder.push_back((uint32_t)v);
+		}
+	}
+
+	for (uint32_t& index : indices)
+	{
+		index = remap[index];
+	}
+	return(vertexOrder.size());
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This method is used for ordering the triangles with Tom
+ *  Forsyth's linear-speed algorithm.  Each step emits the
+ *  triangle whose vertices score highest, then rescores the
+ *  vertices in the modelled cache and their triangles, so
+ *  the next best triangle is found among those only.  When
+ *  none of them is left the first triangle not yet emitted
+ *  is taken.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// the triangles using each vertex, the ones still to be
+	// emitted first in each vertex's range
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t index : indices)
+	{
+		offsets[index + 1]++;
+	}
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] += offsets[v];
+	}
+	std::vector<uint32_t> vertexTriangles(indices.size());
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		const uint32_t vertex = indices[i];
+		vertexTriangles[offsets[vertex] + remaining[vertex]++] = (uint32_t)(i / 3);
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		vertexScores[v] = GetVertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<uint8_t> bEmitted(triangleCount, 0);
+	uint32_t best = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		if (triangleScores[t] > triangleScores[best])
+		{
+			best = (uint32_t)t;
+		}
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	size_t nextUnemitted = 0;
+
+	while (output.size() < indices.size())
+	{
+		if (NO_TRIANGLE == best)
+		{
+			while (bEmitted[nextUnemitted] != 0)
+			{
+				nextUnemitted++;
+			}
+			best = (uint32_t)nextUnemitted;
+		}
+
+		bEmitted[best] = 1;
+		const uint32_t* pTriangle = &indices[(size_t)best * 3];
+		newCache.assign(pTriangle, pTriangle + 3);
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t vertex = pTriangle[k];
+			output.push_back(vertex);
+
+			// move the triangle out of the vertex's active range
+			uint32_t* pFirst = &vertexTriangles[offsets[vertex]];
+			uint32_t* pLast = pFirst + remaining[vertex] - 1;
+			*std::find(pFirst, pLast + 1, best) = *pLast;
+			*pLast = best;
+			remaining[vertex]--;
+		}
+		for (uint32_t vertex : cache)
+		{
+			if ((vertex != pTriangle[0]) && (vertex != pTriangle[1]) && (vertex != pTriangle[2]))
+			{
+				newCache.push_back(vertex);
+			}
+		}
+
+		// rescore the cached vertices, including the ones pushed
+		// out, then the triangles they still have
+		for (size_t i = 0; i < newCache.size(); i++)
+		{
+			const uint32_t vertex = newCache[i];
+			cachePositions[vertex] = (i < SCORE_CACHE_SIZE) ? (int)i : -1;
+			vertexScores[vertex] = GetVertexScore(cachePositions[vertex], remaining[vertex]);
+		}
+
+		best = NO_TRIANGLE;
+		float bestScore = -1.0f;
+		for (uint32_t vertex : newCache)
+		{
+			for (uint32_t i = 0; i < remaining[vertex]; i++)
+			{
+				const uint32_t t = vertexTriangles[offsets[vertex] + i];
+				triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				if (triangleScores[t] > bestScore)
+				{
+					bestScore = triangleScores[t];
+					best = t;
+				}
+			}
+		}
+
+		if (newCache.size() > SCORE_CACHE_SIZE)
+		{
+			newCache.resize(SCORE_CACHE_SIZE);
+		}
+		cache.swap(newCache);
+	}
+
+	indices.swap(output);
+}
+
+/***********************************************************
+ *  OptimizeOverdraw()
+ *
+ *  This method is used for splitting the triangle order into
+ *  clusters, each starting where a triangle misses the cache
+ *  on all three vertices, so moving a cluster costs little
+ *  reuse.  The clusters are sorted by how far their centroid
+ *  lies out along their average normal from the centroid of
+ *  the mesh, outermost first, so on a shape seen from outside
+ *  the near surfaces tend to be drawn before what they hide.
+ *  The new order is only kept when its ACMR stays within the
+ *  threshold factor of the old one.
+ ***********************************************************/
+void MeshOptimizer::OptimizeOverdraw(
+	std::vector<uint32_t>& indices,
+	const float* pPositions,
+	size_t stride,
+	size_t vertexCount,
+	float threshold)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// the cache is simulated with the time each vertex entered
+	std::vector<uint32_t> clusterStarts;
+	std::vector<uint32_t> entered(vertexCount, 0);
+	uint32_t time = CACHE_SIZE + 1;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		int misses = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t vertex = indices[t * 3 + k];
+			if (time - entered[vertex] > CACHE_SIZE)
+			{
+				entered[vertex] = time++;
+				misses++;
+			}
+		}
+		if ((t == 0) || (misses == 3))
+		{
+			clusterStarts.push_back((uint32_t)t);
+		}
+	}
+	const size_t clusterCount = clusterStarts.size();
+	clusterStarts.push_back((uint32_t)triangleCount);
+	if (clusterCount < 2)
+	{
+		return;
+	}
+
+	// area weighted centroids and normals of the clusters
+	std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+	std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+	std::vector<float> areas(clusterCount, 0.0f);
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+		{
+			const glm::vec3 a = GetPosition(pPositions, stride, indices[t * 3]);
+			const glm::vec3 b = GetPosition(pPositions, stride, indices[t * 3 + 1]);
+			const glm::vec3 d = GetPosition(pPositions, stride, indices[t * 3 + 2]);
+			const glm::vec3 normal = glm::cross(b - a, d - a);
+			const float area = glm::length(normal);
+			centroids[c] += (a + b + d) * (area / 3.0f);
+			normals[c] += normal;
+			areas[c] += area;
+		}
+		meshCentroid += centroids[c];
+		meshArea += areas[c];
+	}
+	if (meshArea <= 0.0f)
+	{
+		return;
+	}
+	meshCentroid = meshCentroid / meshArea;
+
+	std::vector<float> sortKeys(clusterCount, 0.0f);
+	std::vector<size_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		const float normalLength = glm::length(normals[c]);
+		if ((areas[c] > 0.0f) && (normalLength > 0.0f))
+		{
+			sortKeys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, normals[c] / normalLength);
+		}
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[&sortKeys](size_t a, size_t b) { return(sortKeys[a] > sortKeys[b]); });
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (size_t c : order)
+	{
+		sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+	}
+
+	if (AnalyzeVertexCache(sorted, vertexCount).ACMR <= AnalyzeVertexCache(indices, vertexCount).ACMR * threshold)
+	{
+		indices.swap(sorted);
+	}
+}
+
+/***********************************************************
+ *  AnalyzeVertexCache()
+ ***********************************************************/
+MeshOptimizer::CACHE_STATISTICS MeshOptimizer::AnalyzeVertexCache(
+	const std::vector<uint32_t>& indices,
+	size_t vertexCount,
+	unsigned int cacheSize)
+{
+	CACHE_STATISTICS statistics = {};
+	std::vector<uint32_t> entered(vertexCount, 0);
+	std::vector<uint8_t> bUsed(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	size_t misses = 0;
+	size_t usedVertices = 0;
+
+	for (uint32_t index : indices)
+	{
+		if (time - entered[index] > cacheSize)
+		{
+			entered[index] = time++;
+			misses++;
+		}
+		if (0 == bUsed[index])
+		{
+			bUsed[index] = 1;
+			usedVertices++;
+		}
+	}
+
+	if (indices.empty() == false)
+	{
+		statistics.ACMR = (float)misses / (float)(indices.size() / 3);
+		statistics.ATVR = (float)misses / (float)usedVertices;
+	}
+	return(statistics);
+}
+
+/***********************************************************
+ *  AnalyzeVertexFetch()
+ *
+ *  This method is used for counting the bytes read by the
+ *  vertex fetches, as whole lines through a small FIFO cache
+ *  of lines, against the bytes of the vertices used.
+ ***********************************************************/
+MeshOptimizer::FETCH_STATISTICS MeshOptimizer::AnalyzeVertexFetch(
+	const std::vector<uint32_t>& indices,
+	size_t vertexCount,
+	size_t vertexBytes)
+{
+	FETCH_STATISTICS statistics = {};
+	std::unordered_map<size_t, size_t> lineEntered;
+	std::vector<uint8_t> bUsed(vertexCount, 0);
+	size_t time = FETCH_CACHE_LINES + 1;
+	size_t usedVertices = 0;
+
+	for (uint32_t index : indices)
+	{
+		const size_t firstLine = (index * vertexBytes) / FETCH_LINE_BYTES;
+		const size_t lastLine = (index * vertexBytes + vertexBytes - 1) / FETCH_LINE_BYTES;
+		for (size_t line = firstLine; line <= lastLine; line++)
+		{
+			auto found = lineEntered.find(line);
+			if ((found == lineEntered.end()) || (time - found->second > FETCH_CACHE_LINES))
+			{
+				lineEntered[line] = time++;
+				statistics.bytesFetched += FETCH_LINE_BYTES;
+			}
+		}
+		if (0 == bUsed[index])
+		{
+			bUsed[index] = 1;
+			usedVertices++;
+		}
+	}
+
+	if (usedVertices > 0)
+	{
+		statistics.overfetch = (float)statistics.bytesFetched / (float)(usedVertices * vertexBytes);
+	}
+	return(statistics);
+}
@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+// metricsserver.cpp
+// ============
+// serve the frame statistics as Prometheus text from a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MetricsServer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	const size_t SNAPSHOT_WORDS = sizeof(MetricsServer::FRAME_METRICS) / sizeof(uint64_t);
+	static_assert(sizeof(MetricsServer::FRAME_METRICS) % sizeof(uint64_t) == 0,
+		"FRAME_METRICS must only hold 8-byte fields");
+
+	// sequence lock around the snapshot, odd while it is written;
+	// the render thread is the only writer
+	std::atomic<uint64_t> g_Sequence(0);
+	std::atomic<uint64_t> g_Snapshot[SNAPSHOT_WORDS];
+
+	std::atomic<bool> g_bRunning(false);
+	std::atomic<bool> g_bStopRequested(false);
+	std::thread g_Thread;
+	int g_ListenSocket = -1;
+	// path of the Unix domain socket, removed when stopping
+	std::string g_SocketPath;
+
+	// milliseconds the server waits between checks for Stop()
+	const int POLL_INTERVAL_MS = 250;
+	// longest request read from a client
+	const size_t MAX_REQUEST = 2048;
+
+	const char* const METRIC_PREFIX = "workspace_";
+
+	// copy the latest snapshot, retrying while it is being written
+	void ReadSnapshot(MetricsServer::FRAME_METRICS& metrics)
+	{
+		uint64_t words[SNAPSHOT_WORDS];
+		for (;;)
+		{
+			uint64_t before = g_Sequence.load(std::memory_order_acquire);
+			if ((before & 1) == 0)
+			{
+				for (size_t i = 0; i < SNAPSHOT_WORDS; i++)
+				{
+					words[i] = g_Snapshot[i].load(std::memory_order_relaxed);
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (g_Sequence.load(std::memory_order_relaxed) == before)
+				{
+					break;
+				}
+			}
+			std::this_thread::yield();
+		}
+		memcpy(&metrics, words, sizeof(metrics));
+	}
+
+	// output text in a fixed buffer, the server thread does not
+	// allocate so it never shows in the allocation profile
+	struct TEXT_BUFFER
+	{
+		char text[8192];
+		size_t length;
+	};
+
+	void Append(TEXT_BUFFER& buffer, const char* format, ...)
+	{
+		if (buffer.length >= sizeof(buffer.text))
+		{
+			return;
+		}
+		va_list arguments;
+		va_start(arguments, format);
+		int written = vsnprintf(buffer.text + buffer.length, sizeof(buffer.text) - buffer.length, format, arguments);
+		va_end(arguments);
+		if (written > 0)
+		{
+			buffer.length = std::min(buffer.length + (size_t)written, sizeof(buffer.text) - 1);
+		}
+	}
+
+	void AppendMetric(TEXT_BUFFER& buffer, const char* name, const char* type, const char* help)
+	{
+		Append(buffer, "# HELP %s%s %s\n# TYPE %s%s %s\n", METRIC_PREFIX, name, help, METRIC_PREFIX, name, type);
+	}
+
+	void AppendValue(TEXT_BUFFER& buffer, const char* name, const char* labels, double value)
+	{
+		Append(buffer, "%s%s%s %.17g\n", METRIC_PREFIX, name, labels, value);
+	}
+
+	// the body of a scrape in the Prometheus text format
+	void FormatMetrics(const MetricsServer::FRAME_METRICS& metrics, TEXT_BUFFER& buffer)
+	{
+		buffer.length = 0;
+		buffer.text[0] = '\0';
+
+		AppendMetric(buffer, "frames_total", "counter", "Frames presented since start.");
+		AppendValue(buffer, "frames_total", "", (double)metrics.frames);
+		AppendMetric(buffer, "frame_seconds_sum", "counter", "Total time of all frames presented.");
+		AppendValue(buffer, "frame_seconds_sum", "", metrics.frameSecondsSum);
+		AppendMetric(buffer, "frame_seconds", "gauge", "Time of the latest frame.");
+		AppendValue(buffer, "frame_seconds", "", metrics.frameSeconds);
+		AppendMetric(buffer, "frame_seconds_max", "gauge", "Longest frame since start.");
+		AppendValue(buffer, "frame_seconds_max", "", metrics.maxFrameSeconds);
+		AppendMetric(buffer, "draw_calls", "gauge", "Draw calls of the latest frame.");
+		AppendValue(buffer, "draw_calls", "", (double)metrics.drawCalls);
+
+		AppendMetric(buffer, "memory_bytes", "gauge", "Tracked memory by category.");
+		for (int i = 0; i < MemoryTracker::MEMORY_CATEGORY_COUNT; i++)
+		{
+			char labels[64];
+			snprintf(labels, sizeof(labels), "{category=\"%s\"}",
+				MemoryTracker::GetCategoryName((MemoryTracker::MEMORY_CATEGORY)i));
+			AppendValue(buffer, "memory_bytes", labels, (double)metrics.memoryBytes[i]);
+		}
+
+		AppendMetric(buffer, "frame_arena_high_water_bytes", "gauge", "Peak use of the per-frame arena.");
+		AppendValue(buffer, "frame_arena_high_water_bytes", "", (double)metrics.arenaHighWaterBytes);
+		AppendMetric(buffer, "frame_arena_overflows_total", "counter", "Allocations that did not fit the per-frame arena.");
+		AppendValue(buffer, "frame_arena_overflows_total", "", (double)metrics.arenaOverflows);
+		AppendMetric(buffer, "gl_debug_messages_total", "counter", "Driver debug messages received.");
+		AppendValue(buffer, "gl_debug_messages_total", "", (double)metrics.glDebugMessages);
+	}
+
+#ifndef _WIN32
+	void SendAll(int client, const char* data, size_t size)
+	{
+		size_t sent = 0;
+		while (sent < size)
+		{
+			ssize_t result = send(client, data + sent, size - sent, MSG_NOSIGNAL);
+			if (result <= 0)
+			{
+				return;
+			}
+			sent += (size_t)result;
+		}
+	}
+
+	// answer one HTTP request and close the connection
+	void ServeClient(int client)
+	{
+		timeval timeout = { 1, 0 };
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+		// only the request line matters, the rest is drained
+		char request[MAX_REQUEST + 1];
+		size_t length = 0;
+		while (length < MAX_REQUEST)
+		{
+			ssize_t received = recv(client, request + length, MAX_REQUEST - length, 0);
+			if (received <= 0)
+			{
+				break;
+			}
+			length += (size_t)received;
+			request[length] = '\0';
+			if (strstr(request, "\r\n\r\n") != NULL)
+			{
+				break;
+			}
+		}
+		request[length] = '\0';
+
+		static TEXT_BUFFER body;
+		char header[160];
+		int headerLength = 0;
+		if ((strncmp(request, "GET /metrics ", 13) == 0) || (strncmp(request, "GET / ", 6) == 0))
+		{
+			MetricsServer::FRAME_METRICS metrics;
+			ReadSnapshot(metrics);
+			FormatMetrics(metrics, body);
+			headerLength = snprintf(header, sizeof(header),
+				"HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+				"Content-Length: %zu\r\nConnection: close\r\n\r\n", body.length);
+		}
+		else
+		{
+			body.length = 0;
+			headerLength = snprintf(header, sizeof(header),
+				"HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+		}
+		SendAll(client, header, (size_t)headerLength);
+		SendAll(client, body.text, body.length);
+		close(client);
+	}
+
+	// the server thread, wakes up regularly to check for Stop()
+	void ServerLoop()
+	{
+		while (g_bStopRequested.load() == false)
+		{
+			pollfd listener = { g_ListenSocket, POLLIN, 0 };
+			if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0)
+			{
+				continue;
+			}
+			int client = accept(g_ListenSocket, NULL, NULL);
+			if (client >= 0)
+			{
+				ServeClient(client);
+			}
+		}
+	}
+
+	int OpenUnixSocket(const char* path)
+	{
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		if (strlen(path) >= sizeof(address.sun_path))
+		{
+			std::cerr << "Could not start metrics server: socket path too long:" << path << std::endl;
+			return(-1);
+		}
+		address.sun_family = AF_UNIX;
+		strcpy(address.sun_path, path);
+
+		int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listener < 0)
+		{
+			return(-1);
+		}
+		// a socket left behind by an earlier run blocks the bind
+		unlink(path);
+		if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0)
+		{
+			close(listener);
+			return(-1);
+		}
+		g_SocketPath = path;
+		return(listener);
+	}
+
+	int OpenLocalPort(int port)
+	{
+		sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons((uint16_t)port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		int listener = socket(AF_INET, SOCK_STREAM, 0);
+		if (listener < 0)
+		{
+			return(-1);
+		}
+		int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0)
+		{
+			close(listener);
+			return(-1);
+		}
+		return(listener);
+	}
+#endif
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for opening the listening socket and
+ *  starting the server thread.  The address is a port number
+ *  bound to the loopback interface, or "unix:" followed by the
+ *  path of a Unix domain socket.
+ ***********************************************************/
+bool MetricsServer::Start(const char* address)
+{
+	if (g_bRunning.load() == true)
+	{
+		return(true);
+	}
+
+#ifdef _WIN32
+	std::cerr << "Could not start metrics server: only supported on POSIX systems" << std::endl;
+	return(false);
+#else
+	if (strncmp(address, "unix:", 5) == 0)
+	{
+		g_ListenSocket = OpenUnixSocket(address + 5);
+	}
+	else
+	{
+		int port = atoi(address);
+		if ((port <= 0) || (port > 65535))
+		{
+			std::cerr << "Could not start metrics server: invalid port:" << address << std::endl;
+			return(false);
+		}
+		g_ListenSocket = OpenLocalPort(port);
+	}
+
+	if ((g_ListenSocket < 0) || (listen(g_ListenSocket, 8) != 0))
+	{
+		std::cerr << "Could not start metrics server:" << address << " (" << strerror(errno) << ")" << std::endl;
+		if (g_ListenSocket >= 0)
+		{
+			close(g_ListenSocket);
+			g_ListenSocket = -1;
+		}
+		return(false);
+	}
+
+	// serve zeros until the first frame is published
+	FRAME_METRICS empty;
+	memset(&empty, 0, sizeof(empty));
+	Publish(empty);
+
+	g_bStopRequested = false;
+	g_Thread = std::thread(ServerLoop);
+	g_bRunning = true;
+	std::cout << "INFO: Serving metrics on " << address << std::endl;
+	return(true);
+#endif
+}
+
+/***********************************************************
+ *  Stop()
+ ***********************************************************/
+void MetricsServer::Stop()
+{
+	if (g_bRunning.load() == false)
+	{
+		return;
+	}
+
+	g_bStopRequested = true;
+	g_Thread.join();
+	g_bRunning = false;
+
+#ifndef _WIN32
+	close(g_ListenSocket);
+	g_ListenSocket = -1;
+	if (g_SocketPath.empty() == false)
+	{
+		unlink(g_SocketPath.c_str());
+		g_SocketPath.clear();
+	}
+#endif
+}
+
+/***********************************************************
+ *  IsRunning()
+ ***********************************************************/
+bool MetricsServer::IsRunning()
+{
+	return(g_bRunning.load(std::memory_order_relaxed));
+}
+
+/***********************************************************
+ *  Publish()
+ *
+ *  This method is used for replacing the snapshot served to
+ *  scrapes.  It is called from the render thread only; the
+ *  sequence is odd while the words are written, so a reader
+ *  that overlaps the write retries instead of waiting.
+ ***********************************************************/
+void MetricsServer::Publish(const FRAME_METRICS& metrics)
+{
+	uint64_t words[SNAPSHOT_WORDS];
+	memcpy(words, &metrics, sizeof(metrics));
+
+	uint64_t sequence = g_Sequence.load(std::memory_order_relaxed);
+	g_Sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < SNAPSHOT_WORDS; i++)
+	{
+		g_Snapshot[i].store(words[i], std::memory_order_relaxed);
+	}
+	g_Sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+// objectstore.cpp
+// ============
+// hold the objects of a scene as chunks of component arrays
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ObjectStore.h"
+#include "SceneFile.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  ObjectStore()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ObjectStore::ObjectStore()
+{
+	m_count = 0;
+}
+
+/***********************************************************
+ *  ~ObjectStore()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ObjectStore::~ObjectStore()
+{
+	for (CHUNK* pChunk : m_chunks)
+	{
+		delete pChunk;
+	}
+	m_chunks.clear();
+}
+
+/***********************************************************
+ *  GetChunkObjectCount()
+ ***********************************************************/
+uint32_t ObjectStore::GetChunkObjectCount(uint32_t chunk) const
+{
+	return(std::min(CHUNK_OBJECTS, m_count - chunk * CHUNK_OBJECTS));
+}
+
+/***********************************************************
+ *  Clear()
+ ***********************************************************/
+void ObjectStore::Clear()
+{
+	m_count = 0;
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding an object after the last
+ *  one, taking a new chunk when the last chunk is full.  A
+ *  new object is visible until the next Cull().
+ ***********************************************************/
+void ObjectStore::Add(const SceneManager::DRAW_COMMAND& draw)
+{
+	if (m_count == m_chunks.size() * CHUNK_OBJECTS)
+	{
+		m_chunks.push_back(new CHUNK());
+	}
+
+	uint32_t index = m_count++;
+	SetDraw(index, draw);
+	m_chunks[index / CHUNK_OBJECTS]->visible[index % CHUNK_OBJECTS] = 1;
+}
+
+/***********************************************************
+ *  Remove()
+ *
+ *  This method is used for removing an object by moving the
+ *  components of the last object into its place.
+ ***********************************************************/
+void ObjectStore::Remove(uint32_t index)
+{
+	uint32_t last = m_count - 1;
+	if (index != last)
+	{
+		CHUNK& to = *m_chunks[index / CHUNK_OBJECTS];
+		const CHUNK& from = *m_chunks[last / CHUNK_OBJECTS];
+		uint32_t i = index % CHUNK_OBJECTS;
+		uint32_t j = last % CHUNK_OBJECTS;
+
+		to.transforms[i] = from.transforms[j];
+		to.boundsMinX[i] = from.boundsMinX[j];
+		to.boundsMinY[i] = from.boundsMinY[j];
+		to.boundsMinZ[i] = from.boundsMinZ[j];
+		to.boundsMaxX[i] = from.boundsMaxX[j];
+		to.boundsMaxY[i] = from.boundsMaxY[j];
+		to.boundsMaxZ[i] = from.boundsMaxZ[j];
+		to.colors[i] = from.colors[j];
+		to.UVscales[i] = from.UVscales[j];
+		to.materialIDs[i] = from.materialIDs[j];
+		to.textureSlots[i] = from.textureSlots[j];
+		to.meshes[i] = from.meshes[j];
+		to.flags[i] = from.flags[j];
+		to.visible[i] = from.visible[j];
+	}
+	m_count--;
+}
+
+/***********************************************************
+ *  GetDraw()
+ ***********************************************************/
+SceneManager::DRAW_COMMAND ObjectStore::GetDraw(uint32_t index) const
+{
+	const CHUNK& chunk = *m_chunks[index / CHUNK_OBJECTS];
+	uint32_t i = index % CHUNK_OBJECTS;
+
+	SceneManager::DRAW_COMMAND draw = SceneManager::DRAW_COMMAND();
+	draw.model = chunk.transforms[i];
+	draw.color = chunk.colors[i];
+	draw.UVscale = chunk.UVscales[i];
+	draw.mesh = (SceneManager::MESH_TYPE)chunk.meshes[i];
+	draw.textureSlot = chunk.textureSlots[i];
+	draw.materialIndex = chunk.materialIDs[i];
+	draw.bUseTexture = ((chunk.flags[i] & FLAG_TEXTURED) != 0);
+	draw.stateBits = 0;
+	return(draw);
+}
+
+/***********************************************************
+ *  SetDraw()
+ ***********************************************************/
+void ObjectStore::SetDraw(uint32_t index, const SceneManager::DRAW_COMMAND& draw)
+{
+	CHUNK& chunk = *m_chunks[index / CHUNK_OBJECTS];
+	uint32_t i = index % CHUNK_OBJECTS;
+
+	chunk.transforms[i] = draw.model;
+	chunk.colors[i] = draw.color;
+	chunk.UVscales[i] = draw.UVscale;
+	chunk.meshes[i] = (uint8_t)draw.mesh;
+	chunk.textureSlots[i] = draw.textureSlot;
+	chunk.materialIDs[i] = draw.materialIndex;
+	chunk.flags[i] = (draw.bUseTexture == true) ? FLAG_TEXTURED : 0;
+	UpdateBounds(chunk, i);
+}
+
+/***********************************************************
+ *  SetTransform()
+ ***********************************************************/
+void ObjectStore::SetTransform(uint32_t index, const glm::mat4& model)
+{
+	CHUNK& chunk = *m_chunks[index / CHUNK_OBJECTS];
+	chunk.transforms[index % CHUNK_OBJECTS] = model;
+	UpdateBounds(chunk, index % CHUNK_OBJECTS);
+}
+
+/***********************************************************
+ *  SetMaterial()
+ ***********************************************************/
+void ObjectStore::SetMaterial(uint32_t index, int materialIndex)
+{
+	m_chunks[index / CHUNK_OBJECTS]->materialIDs[index % CHUNK_OBJECTS] = materialIndex;
+}
+
+/***********************************************************
+ *  SetTexture()
+ ***********************************************************/
+void ObjectStore::SetTexture(uint32_t index, int textureSlot)
+{
+	CHUNK& chunk = *m_chunks[index / CHUNK_OBJECTS];
+	uint32_t i = index % CHUNK_OBJECTS;
+
+	if (textureSlot < 0)
+	{
+		chunk.flags[i] &= ~FLAG_TEXTURED;
+	}
+	else
+	{
+		chunk.textureSlots[i] = textureSlot;
+		chunk.flags[i] |= FLAG_TEXTURED;
+	}
+}
+
+/***********************************************************
+ *  UpdateBounds()
+ ***********************************************************/
+void ObjectStore::UpdateBounds(CHUNK& chunk, uint32_t object)
+{
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	SceneFile::GetWorldBounds(
+		(SceneManager::MESH_TYPE)chunk.meshes[object],
+		chunk.transforms[object],
+		boundsMin,
+		boundsMax);
+
+	chunk.boundsMinX[object] = boundsMin.x;
+	chunk.boundsMinY[object] = boundsMin.y;
+	chunk.boundsMinZ[object] = boundsMin.z;
+	chunk.boundsMaxX[object] = boundsMax.x;
+	chunk.boundsMaxY[object] = boundsMax.y;
+	chunk.boundsMaxZ[object] = boundsMax.z;
+}
+
+/***********************************************************
+ *  GetFrustumPlanes()
+ *
+ *  This method is used for getting the planes of a frustum
+ *  from the rows of its matrix, unnormalized, so a point is
+ *  inside when its distance to each plane is not negative.
+ ***********************************************************/
+void ObjectStore::GetFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		glm::vec4 row(viewProjection[0][axis], viewProjection[1][axis], viewProjection[2][axis], viewProjection[3][axis]);
+		glm::vec4 wRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+		planes[axis * 2] = wRow + row;
+		planes[axis * 2 + 1] = wRow - row;
+	}
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for marking the objects whose world
+ *  boxes are at least partly inside the frustum.  For each
+ *  plane the box corner furthest along its normal is tested,
+ *  picked by the signs of the normal once per plane, so the
+ *  loop over a chunk's objects is straight arithmetic on its
+ *  box arrays.
+ ***********************************************************/
+uint32_t ObjectStore::Cull(const glm::mat4& viewProjection)
+{
+	glm::vec4 planes[6];
+	GetFrustumPlanes(viewProjection, planes);
+
+	uint32_t visibleCount = 0;
+	for (uint32_t chunkIndex = 0; chunkIndex < GetChunkCount(); chunkIndex++)
+	{
+		CHUNK& chunk = *m_chunks[chunkIndex];
+		const uint32_t objectCount = GetChunkObjectCount(chunkIndex);
+
+		for (uint32_t i = 0; i < objectCount; i++)
+		{
+			chunk.visible[i] = 1;
+		}
+		for (const glm::vec4& plane : planes)
+		{
+			const float* pX = (plane.x >= 0.0f) ? chunk.boundsMaxX : chunk.boundsMinX;
+			const float* pY = (plane.y >= 0.0f) ? chunk.boundsMaxY : chunk.boundsMinY;
+			const float* pZ = (plane.z >= 0.0f) ? chunk.boundsMaxZ : chunk.boundsMinZ;
+			for (uint32_t i = 0; i < objectCount; i++)
+			{
+				float distance = plane.x * pX[i] + plane.y * pY[i] + plane.z * pZ[i] + plane.w;
+				chunk.visible[i] &= (uint8_t)(distance >= 0.0f);
+			}
+		}
+		for (uint32_t i = 0; i < objectCount; i++)
+		{
+			visibleCount += chunk.visible[i];
+		}
+	}
+
+	return(visibleCount);
+}
@@ -0,0 +1,195 @@
+///////////////////////////////////////////////////////////////////////////////
+// prefabstore.cpp
+// ============
+// hold the prefabs of a scene and the instances placing them
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrefabStore.h"
+#include "ObjectStore.h"
+#include "SceneFile.h"
+
+/***********************************************************
+ *  PrefabStore()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PrefabStore::PrefabStore()
+{
+	m_visibleDraws = 0;
+}
+
+/***********************************************************
+ *  GetBytes()
+ ***********************************************************/
+size_t PrefabStore::GetBytes() const
+{
+	return(m_prefabs.capacity() * sizeof(PREFAB) +
+		m_parts.capacity() * sizeof(SceneManager::DRAW_COMMAND) +
+		m_roots.capacity() * sizeof(glm::mat4) +
+		m_instancePrefabs.capacity() * sizeof(uint32_t) +
+		m_boundsMinX.capacity() * sizeof(float) * 6 +
+		m_visible.capacity() +
+		m_visibleInstances.capacity() * sizeof(uint32_t));
+}
+
+/***********************************************************
+ *  GetDrawCount()
+ ***********************************************************/
+uint32_t PrefabStore::GetDrawCount() const
+{
+	uint32_t drawCount = 0;
+	for (uint32_t prefab : m_instancePrefabs)
+	{
+		drawCount += m_prefabs[prefab].partCount;
+	}
+	return(drawCount);
+}
+
+/***********************************************************
+ *  Clear()
+ ***********************************************************/
+void PrefabStore::Clear()
+{
+	m_prefabs.clear();
+	m_parts.clear();
+	m_roots.clear();
+	m_instancePrefabs.clear();
+	m_boundsMinX.clear();
+	m_boundsMinY.clear();
+	m_boundsMinZ.clear();
+	m_boundsMaxX.clear();
+	m_boundsMaxY.clear();
+	m_boundsMaxZ.clear();
+	m_visible.clear();
+	m_visibleInstances.clear();
+	m_visibleDraws = 0;
+}
+
+/***********************************************************
+ *  AddPrefab()
+ *
+ *  This method is used for adding a prefab.  Its box is the
+ *  one around the model space boxes of its parts, which each
+ *  instance only has to transform by its root.  A prefab
+ *  with an id already used replaces it for the instances
+ *  added after.
+ ***********************************************************/
+void PrefabStore::AddPrefab(const std::string& id, const std::vector<SceneManager::DRAW_COMMAND>& parts)
+{
+	PREFAB prefab;
+	prefab.id = id;
+	prefab.firstPart = (uint32_t)m_parts.size();
+	prefab.partCount = (uint32_t)parts.size();
+	prefab.boundsMin = glm::vec3(0.0f);
+	prefab.boundsMax = glm::vec3(0.0f);
+	prefab.firstVisible = 0;
+	prefab.visibleCount = 0;
+
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		glm::vec3 partMin;
+		glm::vec3 partMax;
+		SceneFile::GetWorldBounds(parts[i].mesh, parts[i].model, partMin, partMax);
+		prefab.boundsMin = (i == 0) ? partMin : glm::min(prefab.boundsMin, partMin);
+		prefab.boundsMax = (i == 0) ? partMax : glm::max(prefab.boundsMax, partMax);
+		m_parts.push_back(parts[i]);
+	}
+
+	m_prefabs.push_back(prefab);
+}
+
+/***********************************************************
+ *  AddInstance()
+ ***********************************************************/
+bool PrefabStore::AddInstance(const std::string& prefab, const glm::mat4& root)
+{
+	// the last prefab with the id is the one in effect
+	uint32_t index = (uint32_t)m_prefabs.size();
+	while ((index > 0) && (m_prefabs[index - 1].id != prefab))
+	{
+		index--;
+	}
+	if (index == 0)
+	{
+		return(false);
+	}
+	index--;
+
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	SceneFile::GetBoxWorldBounds(m_prefabs[index].boundsMin, m_prefabs[index].boundsMax, root, boundsMin, boundsMax);
+
+	m_roots.push_back(root);
+	m_instancePrefabs.push_back(index);
+	m_boundsMinX.push_back(boundsMin.x);
+	m_boundsMinY.push_back(boundsMin.y);
+	m_boundsMinZ.push_back(boundsMin.z);
+	m_boundsMaxX.push_back(boundsMax.x);
+	m_boundsMaxY.push_back(boundsMax.y);
+	m_boundsMaxZ.push_back(boundsMax.z);
+	m_visible.push_back(1);
+	return(true);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing the instance boxes against
+ *  the frustum as ObjectStore::Cull() tests object boxes, then
+ *  listing the visible instances grouped by prefab with a
+ *  counting pass, keeping their order within a prefab.
+ ***********************************************************/
+uint32_t PrefabStore::Cull(const glm::mat4& viewProjection)
+{
+	glm::vec4 planes[6];
+	ObjectStore::GetFrustumPlanes(viewProjection, planes);
+
+	const uint32_t instanceCount = GetInstanceCount();
+	for (uint32_t i = 0; i < instanceCount; i++)
+	{
+		m_visible[i] = 1;
+	}
+	for (const glm::vec4& plane : planes)
+	{
+		const float* pX = (plane.x >= 0.0f) ? m_boundsMaxX.data() : m_boundsMinX.data();
+		const float* pY = (plane.y >= 0.0f) ? m_boundsMaxY.data() : m_boundsMinY.data();
+		const float* pZ = (plane.z >= 0.0f) ? m_boundsMaxZ.data() : m_boundsMinZ.data();
+		for (uint32_t i = 0; i < instanceCount; i++)
+		{
+			float distance = plane.x * pX[i] + plane.y * pY[i] + plane.z * pZ[i] + plane.w;
+			m_visible[i] &= (uint8_t)(distance >= 0.0f);
+		}
+	}
+
+	for (PREFAB& prefab : m_prefabs)
+	{
+		prefab.visibleCount = 0;
+	}
+	for (uint32_t i = 0; i < instanceCount; i++)
+	{
+		m_prefabs[m_instancePrefabs[i]].visibleCount += m_visible[i];
+	}
+
+	uint32_t visibleCount = 0;
+	m_visibleDraws = 0;
+	for (PREFAB& prefab : m_prefabs)
+	{
+		prefab.firstVisible = visibleCount;
+		visibleCount += prefab.visibleCount;
+		m_visibleDraws += prefab.visibleCount * prefab.partCount;
+		prefab.visibleCount = 0;
+	}
+
+	m_visibleInstances.resize(visibleCount);
+	for (uint32_t i = 0; i < instanceCount; i++)
+	{
+		if (0 != m_visible[i])
+		{
+			PREFAB& prefab = m_prefabs[m_instancePrefabs[i]];
+			m_visibleInstances[prefab.firstVisible + prefab.visibleCount++] = i;
+		}
+	}
+
+	return(visibleCount);
+}
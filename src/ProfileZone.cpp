@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////
+// profilezone.cpp
+// ============
+// name the code that is currently running, for attributing costs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ProfileZone.h"
+
+// declaration of global variables
+namespace
+{
+	// innermost zone of each thread
+	thread_local const char* g_CurrentZone = "untracked";
+}
+
+/***********************************************************
+ *  ProfileZone()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ProfileZone::ProfileZone(const char* name)
+{
+	m_previous = g_CurrentZone;
+	g_CurrentZone = name;
+}
+
+/***********************************************************
+ *  ~ProfileZone()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ProfileZone::~ProfileZone()
+{
+	g_CurrentZone = m_previous;
+}
+
+/***********************************************************
+ *  GetCurrent()
+ ***********************************************************/
+const char* ProfileZone::GetCurrent()
+{
+	return(g_CurrentZone);
+}
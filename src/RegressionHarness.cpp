@@ -0,0 +1,458 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionharness.cpp
+// ============
+// render fixed camera poses and compare them against golden images
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RegressionHarness.h"
+#include "AllocationProfiler.h"
+#include "SceneBinary.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// frames rendered before timing starts, to let the driver
+	// finish any lazy shader compilation and texture uploads
+	const int WARMUP_FRAMES = 3;
+	// frames timed for each pose
+	const int TIMED_FRAMES = 30;
+	// size of the square SSIM window, and its step
+	const int SSIM_WINDOW = 8;
+	const int SSIM_STEP = 4;
+
+	// camera poses covering the desk from the front, close up,
+	// from the left and with the orthographic projection
+	const RegressionHarness::REGRESSION_POSE g_Poses[] =
+	{
+		{ "default", glm::vec3(0.0f, 5.0f, -90.0f), glm::vec3(0.0f, -0.5f, 2.0f), 80.0f, false, 0.98f, 40.0f, 0 },
+		{ "desk_close", glm::vec3(0.0f, -2.0f, -55.0f), glm::vec3(0.0f, -0.3f, 1.0f), 60.0f, false, 0.98f, 40.0f, 0 },
+		{ "left_angle", glm::vec3(-30.0f, 0.0f, -60.0f), glm::vec3(0.6f, -0.35f, 0.7f), 70.0f, false, 0.98f, 40.0f, 0 },
+		{ "ortho_front", glm::vec3(0.0f, -15.0f, -80.0f), glm::vec3(0.0f, 0.0f, 1.0f), 80.0f, true, 0.98f, 40.0f, 0 },
+	};
+
+	// scene whose objects are checked against the settings the
+	// original hand-written scene code drew them with
+	const char* BASELINE_SCENE = "scenes/office.json";
+
+	struct BASELINE_OBJECT
+	{
+		const char* id;
+		// texture tag, NULL for an object drawn with its color
+		const char* texture;
+		const char* material;
+	};
+
+	// the texture and material of every office object as the
+	// original scene code set them, the books without a texture
+	// keeping the material of the book end before them
+	const BASELINE_OBJECT g_BaselineObjects[] =
+	{
+		{ "floor", "Wood", "Wood" },
+		{ "handle_mug", "White", "Metal" },
+		{ "lip_mug", "White", "Metal" },
+		{ "monitor_stand", "Metal", "Metal" },
+		{ "mug", "White", "Metal" },
+		{ "middle_dish", "White", "Metal" },
+		{ "left_monitor_leg", "Metal", "Metal" },
+		{ "right_monitor_leg", "Metal", "Metal" },
+		{ "bottom_dish", "White", "Metal" },
+		{ "mouse", "White", "Plastic" },
+		{ "player", "White", "Plastic" },
+		{ "right_book_end", "Wood", "Wood" },
+		{ "5th_left_book_end", "Wood", "Wood" },
+		{ "4th_left_book_end", "Wood", "Wood" },
+		{ "3rd_left_book_end", "Wood", "Wood" },
+		{ "2nd_left_book_end", "Wood", "Wood" },
+		{ "1st_left_book_end", "Wood", "Wood" },
+		{ "right_standing_book", NULL, "Wood" },
+		{ "left_standing_book", NULL, "Wood" },
+		{ "back_right_book", NULL, "Wood" },
+		{ "monitor", "Magazine Cover", "Plastic" },
+		{ "keyboard", "White", "Plastic" },
+		{ "desktop", "Wood", "Wood" },
+		{ "drawer_compartment", "Wood", "Wood" },
+		{ "physical_drawer_bottom", "Wood", "Wood" },
+		{ "magazine_drawer", "Magazine Cover", "Paper" },
+		{ "left_pen_drawer", "White", "Plastic" },
+		{ "right_pen_drawer", "White", "Plastic" },
+		{ "right_side_drawer", "Wood", "Wood" },
+		{ "left_side_drawer", "Wood", "Wood" },
+		{ "drawer_track", "Metal", "Metal" },
+		{ "drawer_front", "Wood", "Wood" },
+		{ "back_right_leg_desk", "Black Metal", "Metal" },
+		{ "middle_back_right_leg_desk", "Black Metal", "Metal" },
+		{ "front_right_leg_desk", "Black Metal", "Metal" },
+		{ "middle_left_leg_desk", "Black Metal", "Metal" },
+		{ "front_middle_left_leg_desk", "Black Metal", "Metal" },
+		{ "back_left_leg_desk", "Black Metal", "Metal" },
+		{ "top_front_cross_beam", "Black Metal", "Metal" },
+		{ "bottom_left_leg_cross_beam", "Black Metal", "Metal" },
+		{ "bottom_right_leg_cross_beam", "Black Metal", "Metal" },
+		{ "far_back_right_bottom_leg_cross_beam", "Black Metal", "Metal" },
+		{ "second_bottom_left_leg_cross_beam", "Black Metal", "Metal" },
+		{ "computer", "White", "Metal" },
+	};
+}
+
+/***********************************************************
+ *  RegressionHarness()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RegressionHarness::RegressionHarness(
+	GLFWwindow* pWindow,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	void (*renderFrame)())
+{
+	m_pWindow = pWindow;
+	m_pViewManager = pViewManager;
+	m_pSceneManager = pSceneManager;
+	m_renderFrame = renderFrame;
+	m_missingGoldens = 0;
+}
+
+/***********************************************************
+ *  UseSoftwareRenderer()
+ *
+ *  This method is used for selecting the Mesa llvmpipe
+ *  rasterizer.  It must be called before GLFW is initialized.
+ ***********************************************************/
+void RegressionHarness::UseSoftwareRenderer()
+{
+#ifndef _WIN32
+	setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+	setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+#endif
+}
+
+/***********************************************************
+ *  RenderPose()
+ *
+ *  This method is used for rendering the scene from the pose
+ *  and returning the median time of the timed frames, with
+ *  glFinish() making the GPU work part of each sample.  The
+ *  allocation report of the worst allocating frame is printed.
+ ***********************************************************/
+float RegressionHarness::RenderPose(const REGRESSION_POSE& pose, unsigned int& maxAllocations)
+{
+	std::vector<float> frameTimes;
+	frameTimes.reserve(TIMED_FRAMES);
+	maxAllocations = 0;
+
+	for (int frame = 0; frame < WARMUP_FRAMES + TIMED_FRAMES; frame++)
+	{
+		m_pViewManager->SetCameraPose(
+			pose.position,
+			pose.front,
+			pose.zoom,
+			pose.bOrthographic);
+
+		double startTime = glfwGetTime();
+		AllocationProfiler::BeginFrame();
+		m_renderFrame();
+		unsigned int allocations = AllocationProfiler::EndFrame();
+		glFinish();
+		double endTime = glfwGetTime();
+
+		if (frame >= WARMUP_FRAMES)
+		{
+			frameTimes.push_back((float)((endTime - startTime) * 1000.0));
+			if (allocations > maxAllocations)
+			{
+				maxAllocations = allocations;
+				AllocationProfiler::PrintFrameReport(stdout);
+			}
+		}
+
+		// keep the last frame in the back buffer for the capture
+		if (frame < WARMUP_FRAMES + TIMED_FRAMES - 1)
+		{
+			glfwSwapBuffers(m_pWindow);
+			glfwPollEvents();
+		}
+	}
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	return(frameTimes[frameTimes.size() / 2]);
+}
+
+/***********************************************************
+ *  ComputeSSIM()
+ *
+ *  This method is used for comparing two images with the
+ *  structural similarity index on their luma, averaged over
+ *  overlapping windows.  Identical images score 1.0.
+ ***********************************************************/
+float RegressionHarness::ComputeSSIM(
+	const ImageIO::RGB_IMAGE& imageA,
+	const ImageIO::RGB_IMAGE& imageB)
+{
+	if ((imageA.width != imageB.width) || (imageA.height != imageB.height))
+	{
+		return(0.0f);
+	}
+
+	const int width = imageA.width;
+	const int height = imageA.height;
+
+	// convert both images to Rec. 601 luma
+	std::vector<float> lumaA((size_t)width * height);
+	std::vector<float> lumaB((size_t)width * height);
+	for (size_t i = 0; i < lumaA.size(); i++)
+	{
+		const unsigned char* a = &imageA.pixels[i * 3];
+		const unsigned char* b = &imageB.pixels[i * 3];
+		lumaA[i] = 0.299f * a[0] + 0.587f * a[1] + 0.114f * a[2];
+		lumaB[i] = 0.299f * b[0] + 0.587f * b[1] + 0.114f * b[2];
+	}
+
+	// stabilizing constants for 8 bit data
+	const double C1 = (0.01 * 255.0) * (0.01 * 255.0);
+	const double C2 = (0.03 * 255.0) * (0.03 * 255.0);
+	const double windowPixels = SSIM_WINDOW * SSIM_WINDOW;
+
+	double totalSSIM = 0.0;
+	int windowCount = 0;
+
+	for (int y = 0; y + SSIM_WINDOW <= height; y += SSIM_STEP)
+	{
+		for (int x = 0; x + SSIM_WINDOW <= width; x += SSIM_STEP)
+		{
+			double sumA = 0.0, sumB = 0.0;
+			double sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+
+			for (int wy = 0; wy < SSIM_WINDOW; wy++)
+			{
+				const size_t row = (size_t)(y + wy) * width + x;
+				for (int wx = 0; wx < SSIM_WINDOW; wx++)
+				{
+					double a = lumaA[row + wx];
+					double b = lumaB[row + wx];
+					sumA += a;
+					sumB += b;
+					sumAA += a * a;
+					sumBB += b * b;
+					sumAB += a * b;
+				}
+			}
+
+			double meanA = sumA / windowPixels;
+			double meanB = sumB / windowPixels;
+			double varA = sumAA / windowPixels - meanA * meanA;
+			double varB = sumBB / windowPixels - meanB * meanB;
+			double covariance = sumAB / windowPixels - meanA * meanB;
+
+			totalSSIM +=
+				((2.0 * meanA * meanB + C1) * (2.0 * covariance + C2)) /
+				((meanA * meanA + meanB * meanB + C1) * (varA + varB + C2));
+			windowCount++;
+		}
+	}
+
+	if (windowCount == 0)
+	{
+		return(0.0f);
+	}
+
+	return((float)(totalSSIM / windowCount));
+}
+
+/***********************************************************
+ *  CheckBaselineScene()
+ *
+ *  This method is used for compiling the baseline scene file
+ *  as the loaders resolve it, in file order with the objects
+ *  without a texture or material keeping the ones of the
+ *  object before them, and comparing every object's texture
+ *  and material with the original scene code.  It returns the
+ *  number of objects that differ or are missing.
+ ***********************************************************/
+int RegressionHarness::CheckBaselineScene(const char* filename)
+{
+	SceneBinary::SCENE_SOURCE source;
+	SceneBinary::COMPILED_SCENE compiled;
+	std::string error;
+
+	if ((SceneBinary::ReadSource(filename, source, error) == false) ||
+		(SceneBinary::Compile(source, compiled, error) == false))
+	{
+		std::cout << "FAIL: baseline scene " << filename << ", " << error << std::endl;
+		return(1);
+	}
+
+	std::unordered_map<std::string, size_t> objectIndices;
+	for (size_t i = 0; i < compiled.objectIDs.size(); i++)
+	{
+		objectIndices.emplace(&compiled.strings[compiled.objectIDs[i]], i);
+	}
+
+	int failures = 0;
+	for (const BASELINE_OBJECT& baseline : g_BaselineObjects)
+	{
+		auto found = objectIndices.find(baseline.id);
+		if (found == objectIndices.end())
+		{
+			std::cout << "FAIL: baseline object " << baseline.id << " is missing from " << filename << std::endl;
+			failures++;
+			continue;
+		}
+
+		const int32_t textureID = compiled.textureIDs[found->second];
+		const int32_t materialID = compiled.materialIDs[found->second];
+		const char* texture = (textureID < 0) ? NULL : &compiled.strings[compiled.textures[textureID].tag];
+		const char* material = (materialID < 0) ? "none" : &compiled.strings[compiled.materials[materialID].tag];
+		const bool bSameTexture = (NULL == texture) ? (NULL == baseline.texture) :
+			((NULL != baseline.texture) && (strcmp(texture, baseline.texture) == 0));
+		if ((bSameTexture == false) || (strcmp(material, baseline.material) != 0))
+		{
+			std::cout << "FAIL: baseline object " << baseline.id << " resolves to texture " << ((NULL == texture) ? "none" : texture)
+				<< " and material " << material << ", the original drew it with texture "
+				<< ((NULL == baseline.texture) ? "none" : baseline.texture) << " and material " << baseline.material << std::endl;
+			failures++;
+		}
+	}
+
+	if (failures == 0)
+	{
+		std::cout << "PASS: baseline scene " << filename << " (" << (sizeof(g_BaselineObjects) / sizeof(g_BaselineObjects[0])) << " objects)" << std::endl;
+	}
+
+	return(failures);
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for rendering every regression pose,
+ *  checking its image against the golden image in goldenDir
+ *  and its frame time and draw calls against the budgets.
+ *  No pose may issue more draws than the loaded scene has,
+ *  twice that with the depth pre-pass, so a change that draws
+ *  anything twice fails whatever the scene.  The office
+ *  scene's textures and materials are checked against the
+ *  original scene code first.  With
+ *  bUpdateGolden set, the golden images are rewritten instead
+ *  of compared.
+ ***********************************************************/
+int RegressionHarness::Run(const std::string& goldenDir, bool bUpdateGolden)
+{
+	int failures = 0;
+	int width = 0;
+	int height = 0;
+	m_missingGoldens = 0;
+
+	const char* renderer = (const char*)glGetString(GL_RENDERER);
+	if (NULL == renderer)
+	{
+		renderer = "unknown";
+	}
+	std::cout << "INFO: Regression renderer: " << renderer << std::endl;
+	if (strstr(renderer, "llvmpipe") == NULL)
+	{
+		std::cout << "WARNING: golden images are rendered with llvmpipe, results may differ" << std::endl;
+	}
+
+	int maxDrawCalls = (int)m_pSceneManager->GetSceneDrawCount();
+	if (m_pSceneManager->GetRenderMode() == SceneManager::RENDER_DEPTH_PREPASS)
+	{
+		maxDrawCalls *= 2;
+	}
+
+	failures += CheckBaselineScene(BASELINE_SCENE);
+
+	glfwGetFramebufferSize(m_pWindow, &width, &height);
+
+	if (AllocationProfiler::IsAvailable() == false)
+	{
+		std::cout << "INFO: allocation budgets are only checked in WORKSPACE_ALLOCATION_PROFILER builds" << std::endl;
+	}
+
+	for (const REGRESSION_POSE& pose : g_Poses)
+	{
+		unsigned int allocations = 0;
+		float frameMs = RenderPose(pose, allocations);
+		int drawCalls = m_pSceneManager->GetDrawCallCount();
+
+		ImageIO::RGB_IMAGE rendered;
+		glReadBuffer(GL_BACK);
+		if (ImageIO::CaptureFramebuffer(width, height, rendered) == false)
+		{
+			std::cout << "FAIL: " << pose.name << " could not read back the frame" << std::endl;
+			failures++;
+			continue;
+		}
+
+		std::string goldenFile = goldenDir + "/" + pose.name + ".ppm";
+		bool bPassed = true;
+
+		if (bUpdateGolden == true)
+		{
+			if (ImageIO::WritePPM(goldenFile, rendered) == false)
+			{
+				bPassed = false;
+			}
+			std::cout << "INFO: " << pose.name << " golden image written to " << goldenFile << std::endl;
+		}
+		else
+		{
+			// without a golden image there is nothing to compare,
+			// which is not an image mismatch, the budgets are
+			// still checked
+			ImageIO::RGB_IMAGE golden;
+			if (ImageIO::ReadPPM(goldenFile, golden) == false)
+			{
+				std::cout << "MISSING: " << pose.name << " has no golden image " << goldenFile << std::endl;
+				m_missingGoldens++;
+			}
+			else
+			{
+				float ssim = ComputeSSIM(rendered, golden);
+				if (ssim < pose.minSSIM)
+				{
+					std::cout << "FAIL: " << pose.name << " SSIM " << ssim << " below " << pose.minSSIM << std::endl;
+					ImageIO::WritePPM(goldenDir + "/" + pose.name + ".actual.ppm", rendered);
+					bPassed = false;
+				}
+			}
+		}
+
+		if (frameMs > pose.maxFrameMs)
+		{
+			std::cout << "FAIL: " << pose.name << " frame time " << frameMs << " ms over budget " << pose.maxFrameMs << " ms" << std::endl;
+			bPassed = false;
+		}
+		if (drawCalls > maxDrawCalls)
+		{
+			std::cout << "FAIL: " << pose.name << " draw calls " << drawCalls << " over budget " << maxDrawCalls << std::endl;
+			bPassed = false;
+		}
+
+		// the steady-state frame must not touch the heap, which
+		// can only be checked in an allocation profiler build
+		if ((AllocationProfiler::IsAvailable() == true) && (allocations > pose.maxAllocations))
+		{
+			std::cout << "FAIL: " << pose.name << " heap allocations per frame " << allocations << " over budget " << pose.maxAllocations << std::endl;
+			bPassed = false;
+		}
+
+		if (bPassed == true)
+		{
+			std::cout << "PASS: " << pose.name << " (" << frameMs << " ms, " << drawCalls << " draws)" << std::endl;
+		}
+		else
+		{
+			failures++;
+		}
+	}
+
+	return(failures);
+}
@@ -0,0 +1,817 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebinary.cpp
+// ============
+// write compiled binary scenes and map them for use in place
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBinary.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	const char g_Magic[4] = { 'S', 'C', 'N', 'B' };
+	// sections start on cache line boundaries
+	const uint64_t SECTION_ALIGNMENT = 64;
+
+	// what the elements of each section are counted by
+	enum SECTION_COUNT_BY
+	{
+		COUNT_BY_OBJECTS,
+		COUNT_BY_TEXTURES,
+		COUNT_BY_MATERIALS,
+		COUNT_BY_LIGHTS,
+		COUNT_BY_SECTORS,
+		COUNT_BY_SECTOR_TEXTURES,
+		COUNT_BY_STRING_BYTES
+	};
+
+	struct SECTION_LAYOUT
+	{
+		size_t elementBytes;
+		SECTION_COUNT_BY countBy;
+	};
+
+	// in the order of SceneBinary::SECTION
+	const SECTION_LAYOUT g_SectionLayouts[SceneBinary::SECTION_COUNT] =
+	{
+		{ sizeof(glm::mat4), COUNT_BY_OBJECTS },
+		{ sizeof(glm::vec3), COUNT_BY_OBJECTS },
+		{ sizeof(glm::vec3), COUNT_BY_OBJECTS },
+		{ sizeof(glm::vec4), COUNT_BY_OBJECTS },
+		{ sizeof(glm::vec2), COUNT_BY_OBJECTS },
+		{ sizeof(uint32_t), COUNT_BY_OBJECTS },
+		{ sizeof(int32_t), COUNT_BY_OBJECTS },
+		{ sizeof(int32_t), COUNT_BY_OBJECTS },
+		{ sizeof(int32_t), COUNT_BY_OBJECTS },
+		{ sizeof(uint32_t), COUNT_BY_OBJECTS },
+		{ sizeof(uint32_t), COUNT_BY_OBJECTS },
+		{ sizeof(SceneBinary::BINARY_TEXTURE), COUNT_BY_TEXTURES },
+		{ sizeof(SceneBinary::BINARY_MATERIAL), COUNT_BY_MATERIALS },
+		{ sizeof(SceneBinary::BINARY_LIGHT), COUNT_BY_LIGHTS },
+		{ sizeof(SceneBinary::BINARY_SECTOR), COUNT_BY_SECTORS },
+		{ sizeof(uint32_t), COUNT_BY_SECTOR_TEXTURES },
+		{ 1, COUNT_BY_STRING_BYTES }
+	};
+
+	// get the byte size of a section from the header's counts
+	uint64_t GetSectionBytes(const SceneBinary::BINARY_HEADER& header, int section)
+	{
+		uint64_t count = 0;
+		switch (g_SectionLayouts[section].countBy)
+		{
+		case COUNT_BY_OBJECTS: count = header.objectCount; break;
+		case COUNT_BY_TEXTURES: count = header.textureCount; break;
+		case COUNT_BY_MATERIALS: count = header.materialCount; break;
+		case COUNT_BY_LIGHTS: count = header.lightCount; break;
+		case COUNT_BY_SECTORS: count = header.sectorCount; break;
+		case COUNT_BY_SECTOR_TEXTURES: count = header.sectorTextureCount; break;
+		default: count = header.stringBytes; break;
+		}
+		return(count * g_SectionLayouts[section].elementBytes);
+	}
+
+	// the string table being built, equal strings are stored once
+	class StringTable
+	{
+	public:
+		StringTable() { m_bytes.push_back('\0'); }
+
+		uint32_t Add(const std::string& text)
+		{
+			if (text.empty() == true)
+			{
+				return(0);
+			}
+			auto found = m_offsets.find(text);
+			if (found != m_offsets.end())
+			{
+				return(found->second);
+			}
+			uint32_t offset = (uint32_t)m_bytes.size();
+			m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+			m_bytes.push_back('\0');
+			m_offsets[text] = offset;
+			return(offset);
+		}
+
+		const std::vector<char>& GetBytes() const { return(m_bytes); }
+
+	private:
+		std::vector<char> m_bytes;
+		std::unordered_map<std::string, uint32_t> m_offsets;
+	};
+
+	void CopyVec3(float* values, const glm::vec3& vector)
+	{
+		values[0] = vector.x;
+		values[1] = vector.y;
+		values[2] = vector.z;
+	}
+
+	// grid cell of a world space box, by the cell of its center
+	struct SECTOR_CELL
+	{
+		int x;
+		int y;
+		int z;
+
+		bool operator<(const SECTOR_CELL& other) const
+		{
+			if (x != other.x)
+			{
+				return(x < other.x);
+			}
+			if (y != other.y)
+			{
+				return(y < other.y);
+			}
+			return(z < other.z);
+		}
+		bool operator!=(const SECTOR_CELL& other) const
+		{
+			return((x != other.x) || (y != other.y) || (z != other.z));
+		}
+	};
+
+	SECTOR_CELL GetSectorCell(const glm::vec3& boundsMin, const glm::vec3& boundsMax, float sectorSize)
+	{
+		SECTOR_CELL cell = {};
+		if (sectorSize > 0.0f)
+		{
+			glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+			cell.x = (int)std::floor(center.x / sectorSize);
+			cell.y = (int)std::floor(center.y / sectorSize);
+			cell.z = (int)std::floor(center.z / sectorSize);
+		}
+		return(cell);
+	}
+
+	// list the objects to compile with their model matrices and
+	// ids, in file order, and the parts of each prefab instance
+	// last
+	bool ExpandObjects(
+		const SceneBinary::SCENE_SOURCE& source,
+		std::vector<const SceneFile::SCENE_OBJECT*>& objects,
+		std::vector<glm::mat4>& models,
+		std::vector<std::string>& objectIDs,
+		std::string& error)
+	{
+		for (const SceneFile::SCENE_OBJECT& object : source.objects)
+		{
+			objects.push_back(&object);
+			models.push_back(SceneFile::GetModelMatrix(object));
+			objectIDs.push_back(object.id);
+		}
+		for (const SceneFile::SCENE_OBJECT& instance : source.instances)
+		{
+			auto prefab = std::find_if(source.prefabs.begin(), source.prefabs.end(),
+				[&instance](const SceneFile::SCENE_PREFAB& candidate) { return(candidate.id == instance.prefab); });
+			if (prefab == source.prefabs.end())
+			{
+				error = "object \"" + instance.id + "\" uses unknown prefab \"" + instance.prefab + "\"";
+				return(false);
+			}
+
+			const glm::mat4 root = SceneFile::GetModelMatrix(instance);
+			for (const SceneFile::SCENE_OBJECT& part : prefab->parts)
+			{
+				objects.push_back(&part);
+				models.push_back(root * SceneFile::GetModelMatrix(part));
+				objectIDs.push_back(instance.id + "/" + part.id);
+			}
+		}
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  SceneBinary()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBinary::SceneBinary()
+{
+	m_pData = NULL;
+	m_dataBytes = 0;
+	m_pHeader = NULL;
+#ifdef _WIN32
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#endif
+}
+
+/***********************************************************
+ *  ~SceneBinary()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneBinary::~SceneBinary()
+{
+	Close();
+}
+
+/***********************************************************
+ *  ReadSource()
+ *
+ *  This method is used for reading the entries of a scene
+ *  description file into the lists the compiler works on.
+ ***********************************************************/
+bool SceneBinary::ReadSource(const char* filename, SCENE_SOURCE& source, std::string& error)
+{
+	SceneFile sceneFile;
+	SceneFile::SCENE_ENTRY entry;
+
+	if (sceneFile.Open(filename) == false)
+	{
+		error = sceneFile.GetError();
+		return(false);
+	}
+
+	while (sceneFile.Next(entry) == true)
+	{
+		switch (entry.type)
+		{
+		case SceneFile::ENTRY_TEXTURE:
+			source.textures.push_back(entry.texture);
+			break;
+		case SceneFile::ENTRY_MATERIAL:
+			source.materials.push_back(entry.material);
+			break;
+		case SceneFile::ENTRY_LIGHT:
+			source.lights.push_back(entry.light);
+			break;
+		case SceneFile::ENTRY_PREFAB:
+			source.prefabs.push_back(entry.prefab);
+			break;
+		case SceneFile::ENTRY_OBJECT:
+			if (entry.object.prefab.empty() == false)
+			{
+				source.instances.push_back(entry.object);
+			}
+			else
+			{
+				source.objects.push_back(entry.object);
+			}
+			break;
+		}
+	}
+
+	if (sceneFile.HasError() == true)
+	{
+		error = sceneFile.GetError();
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for compiling a scene into its arrays.
+ *  The texture and material tags of the objects are resolved
+ *  to indices, and the model matrices, world bounds and state
+ *  bits are computed, so the renderer does none of this work
+ *  at load.  With a sector size the objects are grouped by
+ *  the grid cell their box is centered in.  Static objects
+ *  are compiled as the others, in file order, they are
+ *  already drawn from precomputed arrays.  The parts of the
+ *  prefab instances follow the objects, as objects of their
+ *  own whose ids are the instance's and the part's.
+ ***********************************************************/
+bool SceneBinary::Compile(const SCENE_SOURCE& source, COMPILED_SCENE& compiled, std::string& error, float sectorSize)
+{
+	std::vector<const SceneFile::SCENE_OBJECT*> objects;
+	std::vector<glm::mat4> models;
+	std::vector<std::string> objectIDs;
+	if (ExpandObjects(source, objects, models, objectIDs, error) == false)
+	{
+		return(false);
+	}
+
+	const size_t objectCount = objects.size();
+	StringTable strings;
+	std::unordered_map<std::string, int32_t> textureIndices;
+	std::unordered_map<std::string, int32_t> materialIndices;
+
+	compiled.textures.resize(source.textures.size());
+	for (size_t i = 0; i < source.textures.size(); i++)
+	{
+		compiled.textures[i].tag = strings.Add(source.textures[i].tag);
+		compiled.textures[i].path = strings.Add(source.textures[i].path);
+		textureIndices.emplace(source.textures[i].tag, (int32_t)i);
+	}
+
+	compiled.materials.resize(source.materials.size());
+	for (size_t i = 0; i < source.materials.size(); i++)
+	{
+		const SceneManager::OBJECT_MATERIAL& material = source.materials[i];
+		BINARY_MATERIAL& compiledMaterial = compiled.materials[i];
+		CopyVec3(compiledMaterial.ambientColor, material.ambientColor);
+		compiledMaterial.ambientStrength = material.ambientStrength;
+		CopyVec3(compiledMaterial.diffuseColor, material.diffuseColor);
+		CopyVec3(compiledMaterial.specularColor, material.specularColor);
+		compiledMaterial.shininess = material.shininess;
+		compiledMaterial.tag = strings.Add(material.tag);
+		materialIndices.emplace(material.tag, (int32_t)i);
+	}
+
+	compiled.lights.resize(source.lights.size());
+	for (size_t i = 0; i < source.lights.size(); i++)
+	{
+		const SceneManager::LIGHT_SOURCE& light = source.lights[i];
+		BINARY_LIGHT& compiledLight = compiled.lights[i];
+		CopyVec3(compiledLight.position, light.position);
+		CopyVec3(compiledLight.ambientColor, light.ambientColor);
+		CopyVec3(compiledLight.diffuseColor, light.diffuseColor);
+		CopyVec3(compiledLight.specularColor, light.specularColor);
+		compiledLight.focalStrength = light.focalStrength;
+		compiledLight.specularIntensity = light.specularIntensity;
+		compiledLight.radius = light.radius;
+	}
+
+	compiled.transforms.resize(objectCount);
+	compiled.boundsMin.resize(objectCount);
+	compiled.boundsMax.resize(objectCount);
+	compiled.colors.resize(objectCount);
+	compiled.UVscales.resize(objectCount);
+	compiled.meshes.resize(objectCount);
+	compiled.materialIDs.resize(objectCount);
+	compiled.textureIDs.resize(objectCount);
+	// prefab parts are stored with their instance's root applied,
+	// so every object is a root
+	compiled.parents.assign(objectCount, -1);
+	compiled.stateBits.resize(objectCount);
+	compiled.objectIDs.resize(objectCount);
+	compiled.sectors.clear();
+	compiled.sectorTextures.clear();
+	compiled.sectorSize = std::max(sectorSize, 0.0f);
+
+	// the objects are sorted by the grid cell of their world box,
+	// keeping the file order within a cell, so each sector is a
+	// contiguous range; without a sector size every object is in
+	// the same cell and the order is the file's
+	std::vector<glm::vec3> worldMin(objectCount);
+	std::vector<glm::vec3> worldMax(objectCount);
+	std::vector<SECTOR_CELL> cells(objectCount);
+	std::vector<size_t> order(objectCount);
+	for (size_t i = 0; i < objectCount; i++)
+	{
+		SceneFile::GetWorldBounds(objects[i]->mesh, models[i], worldMin[i], worldMax[i]);
+		cells[i] = GetSectorCell(worldMin[i], worldMax[i], compiled.sectorSize);
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[&cells](size_t a, size_t b) { return(cells[a] < cells[b]); });
+
+	SceneManager::DRAW_COMMAND previous = SceneManager::DRAW_COMMAND();
+	std::vector<bool> bSectorUsesTexture(source.textures.size(), false);
+	for (size_t k = 0; k < objectCount; k++)
+	{
+		const size_t i = order[k];
+		const SceneFile::SCENE_OBJECT& object = *objects[i];
+
+		// a sector starts where the cell changes, and its first
+		// draw sends its settings as the first draw of a frame
+		const bool bSectorStart = (k == 0) || (cells[i] != cells[order[k - 1]]);
+		if (bSectorStart == true)
+		{
+			BINARY_SECTOR sector = {};
+			sector.firstObject = (uint32_t)k;
+			sector.firstTexture = (uint32_t)compiled.sectorTextures.size();
+			compiled.sectors.push_back(sector);
+			bSectorUsesTexture.assign(source.textures.size(), false);
+		}
+		BINARY_SECTOR& sector = compiled.sectors.back();
+
+		// the draw is built as the scene file loader would build
+		// it, with texture indices standing in for the slots
+		SceneManager::DRAW_COMMAND command = SceneManager::DRAW_COMMAND();
+		command.model = models[i];
+		command.color = object.color;
+		command.UVscale = object.UVscale;
+		command.mesh = object.mesh;
+		command.textureSlot = (bSectorStart == false) ? previous.textureSlot : 0;
+		command.bUseTexture = false;
+		command.materialIndex = (bSectorStart == false) ? previous.materialIndex : -1;
+
+		compiled.textureIDs[k] = -1;
+		if (object.texture.empty() == false)
+		{
+			auto found = textureIndices.find(object.texture);
+			if (found == textureIndices.end())
+			{
+				error = "object \"" + objectIDs[i] + "\" uses unknown texture \"" + object.texture + "\"";
+				return(false);
+			}
+			compiled.textureIDs[k] = found->second;
+			command.textureSlot = found->second;
+			command.bUseTexture = true;
+			if (bSectorUsesTexture[found->second] == false)
+			{
+				bSectorUsesTexture[found->second] = true;
+				compiled.sectorTextures.push_back((uint32_t)found->second);
+				sector.textureCount++;
+			}
+		}
+		if (object.material.empty() == false)
+		{
+			auto found = materialIndices.find(object.material);
+			if (found == materialIndices.end())
+			{
+				error = "object \"" + objectIDs[i] + "\" uses unknown material \"" + object.material + "\"";
+				return(false);
+			}
+			command.materialIndex = found->second;
+		}
+		command.stateBits = SceneFile::GetStateBits((bSectorStart == false) ? &previous : NULL, command);
+
+		compiled.transforms[k] = command.model;
+		compiled.boundsMin[k] = worldMin[i];
+		compiled.boundsMax[k] = worldMax[i];
+		compiled.colors[k] = object.color;
+		compiled.UVscales[k] = object.UVscale;
+		compiled.meshes[k] = (uint32_t)object.mesh;
+		compiled.materialIDs[k] = command.materialIndex;
+		compiled.stateBits[k] = command.stateBits;
+		compiled.objectIDs[k] = strings.Add(objectIDs[i]);
+		previous = command;
+
+		// grow the sector's box and sum its colors for the proxy
+		glm::vec3 sectorMin = (sector.objectCount == 0) ? compiled.boundsMin[k] :
+			glm::min(glm::make_vec3(sector.boundsMin), compiled.boundsMin[k]);
+		glm::vec3 sectorMax = (sector.objectCount == 0) ? compiled.boundsMax[k] :
+			glm::max(glm::make_vec3(sector.boundsMax), compiled.boundsMax[k]);
+		CopyVec3(sector.boundsMin, sectorMin);
+		CopyVec3(sector.boundsMax, sectorMax);
+		for (int c = 0; c < 4; c++)
+		{
+			sector.proxyColor[c] += object.color[c];
+		}
+		sector.objectCount++;
+	}
+
+	for (BINARY_SECTOR& sector : compiled.sectors)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			sector.proxyColor[c] /= (float)sector.objectCount;
+		}
+	}
+
+	compiled.strings = strings.GetBytes();
+	return(true);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for compiling a scene and writing it
+ *  as a binary file, with each array in its own section.
+ ***********************************************************/
+bool SceneBinary::Write(const char* filename, const SCENE_SOURCE& source, std::string& error, float sectorSize)
+{
+	COMPILED_SCENE compiled;
+	if (Compile(source, compiled, error, sectorSize) == false)
+	{
+		return(false);
+	}
+
+	BINARY_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, g_Magic, sizeof(header.magic));
+	header.version = VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.objectCount = (uint32_t)compiled.transforms.size();
+	header.textureCount = (uint32_t)compiled.textures.size();
+	header.materialCount = (uint32_t)compiled.materials.size();
+	header.lightCount = (uint32_t)compiled.lights.size();
+	header.stringBytes = (uint32_t)compiled.strings.size();
+	header.sectorCount = (uint32_t)compiled.sectors.size();
+	header.sectorTextureCount = (uint32_t)compiled.sectorTextures.size();
+	header.sectorSize = compiled.sectorSize;
+
+	const void* sectionData[SECTION_COUNT] =
+	{
+		compiled.transforms.data(), compiled.boundsMin.data(), compiled.boundsMax.data(),
+		compiled.colors.data(), compiled.UVscales.data(), compiled.meshes.data(),
+		compiled.materialIDs.data(), compiled.textureIDs.data(), compiled.parents.data(),
+		compiled.stateBits.data(), compiled.objectIDs.data(), compiled.textures.data(),
+		compiled.materials.data(), compiled.lights.data(), compiled.sectors.data(),
+		compiled.sectorTextures.data(), compiled.strings.data()
+	};
+
+	uint64_t offset = sizeof(BINARY_HEADER);
+	for (int section = 0; section < SECTION_COUNT; section++)
+	{
+		offset = (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+		header.sectionOffsets[section] = offset;
+		offset += GetSectionBytes(header, section);
+	}
+	header.fileBytes = offset;
+
+	FILE* file = fopen(filename, "wb");
+	if (NULL == file)
+	{
+		error = std::string("could not write ") + filename;
+		return(false);
+	}
+
+	static const char padding[SECTION_ALIGNMENT] = {};
+	bool bWritten = (fwrite(&header, sizeof(header), 1, file) == 1);
+	uint64_t written = sizeof(header);
+	for (int section = 0; (section < SECTION_COUNT) && (bWritten == true); section++)
+	{
+		size_t paddingBytes = (size_t)(header.sectionOffsets[section] - written);
+		size_t sectionBytes = (size_t)GetSectionBytes(header, section);
+		bWritten = (fwrite(padding, 1, paddingBytes, file) == paddingBytes) &&
+			(fwrite(sectionData[section], 1, sectionBytes, file) == sectionBytes);
+		written += paddingBytes + sectionBytes;
+	}
+	bWritten = (fclose(file) == 0) && (bWritten == true);
+
+	if (bWritten == false)
+	{
+		error = std::string("could not write ") + filename;
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  IsBinaryScene()
+ ***********************************************************/
+bool SceneBinary::IsBinaryScene(const char* filename)
+{
+	char magic[sizeof(g_Magic)] = {};
+
+	FILE* file = fopen(filename, "rb");
+	if (NULL == file)
+	{
+		return(false);
+	}
+	size_t read = fread(magic, 1, sizeof(magic), file);
+	fclose(file);
+
+	return((read == sizeof(magic)) && (memcmp(magic, g_Magic, sizeof(magic)) == 0));
+}
+
+/***********************************************************
+ *  ReadSection()
+ *
+ *  This method is used for reading a range of elements of one
+ *  section from a compiled scene opened as a file, for the
+ *  streaming threads that read sectors without the mapping.
+ *  The range is expected to have been checked against the
+ *  header.
+ ***********************************************************/
+bool SceneBinary::ReadSection(
+	FILE* file,
+	const BINARY_HEADER& header,
+	SECTION section,
+	uint32_t first,
+	uint32_t count,
+	void* pDestination)
+{
+	const size_t elementBytes = g_SectionLayouts[section].elementBytes;
+	const uint64_t offset = header.sectionOffsets[section] + (uint64_t)first * elementBytes;
+
+	if (count == 0)
+	{
+		return(true);
+	}
+#ifdef _WIN32
+	if (_fseeki64(file, (long long)offset, SEEK_SET) != 0)
+#else
+	if (fseeko(file, (off_t)offset, SEEK_SET) != 0)
+#endif
+	{
+		return(false);
+	}
+	return(fread(pDestination, elementBytes, count, file) == count);
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a compiled scene read-only
+ *  into memory.  Only the header is checked here, the pages
+ *  of the arrays are read in when the renderer first uses
+ *  them.
+ ***********************************************************/
+bool SceneBinary::Open(const char* filename)
+{
+	Close();
+	m_error.clear();
+
+#ifdef _WIN32
+	m_fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	LARGE_INTEGER size;
+	if ((m_fileHandle == INVALID_HANDLE_VALUE) || (GetFileSizeEx(m_fileHandle, &size) == FALSE))
+	{
+		m_error = std::string("could not open ") + filename;
+		Close();
+		return(false);
+	}
+	m_dataBytes = (uint64_t)size.QuadPart;
+	if (m_dataBytes >= sizeof(BINARY_HEADER))
+	{
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (NULL != m_mappingHandle)
+		{
+			m_pData = (const unsigned char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		}
+	}
+#else
+	int fd = open(filename, O_RDONLY);
+	struct stat status;
+	if ((fd < 0) || (fstat(fd, &status) != 0))
+	{
+		m_error = std::string("could not open ") + filename;
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return(false);
+	}
+	m_dataBytes = (uint64_t)status.st_size;
+	if (m_dataBytes >= sizeof(BINARY_HEADER))
+	{
+		void* pMapped = mmap(NULL, (size_t)m_dataBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (pMapped != MAP_FAILED)
+		{
+			m_pData = (const unsigned char*)pMapped;
+		}
+	}
+	// the mapping stays valid once the file is closed
+	close(fd);
+#endif
+
+	if (NULL == m_pData)
+	{
+		m_error = std::string("could not map ") + filename;
+		Close();
+		return(false);
+	}
+
+	m_pHeader = (const BINARY_HEADER*)m_pData;
+	if (CheckHeader() == false)
+	{
+		Close();
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  CheckHeader()
+ *
+ *  This method is used for checking that the header belongs
+ *  to a compiled scene of this version and byte order, and
+ *  that every section lies aligned inside the file.
+ ***********************************************************/
+bool SceneBinary::CheckHeader()
+{
+	if (memcmp(m_pHeader->magic, g_Magic, sizeof(g_Magic)) != 0)
+	{
+		m_error = "not a compiled scene";
+		return(false);
+	}
+	if (m_pHeader->version != VERSION)
+	{
+		m_error = "compiled scene version " + std::to_string(m_pHeader->version) +
+			", expected " + std::to_string(VERSION) + ", recompile the scene";
+		return(false);
+	}
+	if (m_pHeader->byteOrder != BYTE_ORDER_MARK)
+	{
+		m_error = "compiled scene has a different byte order";
+		return(false);
+	}
+	if (m_pHeader->fileBytes != m_dataBytes)
+	{
+		m_error = "compiled scene is truncated";
+		return(false);
+	}
+
+	for (int section = 0; section < SECTION_COUNT; section++)
+	{
+		uint64_t offset = m_pHeader->sectionOffsets[section];
+		uint64_t bytes = GetSectionBytes(*m_pHeader, section);
+		if ((offset % SECTION_ALIGNMENT != 0) || (offset > m_dataBytes) || (bytes > m_dataBytes - offset))
+		{
+			m_error = "compiled scene section " + std::to_string(section) + " is out of range";
+			return(false);
+		}
+	}
+
+	// every sector's ranges lie inside the object and texture
+	// sections, so streaming reads need no further checks
+	const BINARY_SECTOR* pSectors = GetSectors();
+	const uint32_t* pSectorTextures = GetSectorTextures();
+	for (uint32_t i = 0; i < m_pHeader->sectorCount; i++)
+	{
+		if (((uint64_t)pSectors[i].firstObject + pSectors[i].objectCount > m_pHeader->objectCount) ||
+			((uint64_t)pSectors[i].firstTexture + pSectors[i].textureCount > m_pHeader->sectorTextureCount))
+		{
+			m_error = "compiled scene sector " + std::to_string(i) + " is out of range";
+			return(false);
+		}
+	}
+	for (uint32_t i = 0; i < m_pHeader->sectorTextureCount; i++)
+	{
+		if (pSectorTextures[i] >= m_pHeader->textureCount)
+		{
+			m_error = "compiled scene sector texture " + std::to_string(i) + " is out of range";
+			return(false);
+		}
+	}
+
+	// every string offset then ends inside the table
+	if ((m_pHeader->stringBytes == 0) ||
+		(GetSection(SECTION_STRINGS)[m_pHeader->stringBytes - 1] != '\0'))
+	{
+		m_error = "compiled scene string table is not terminated";
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ ***********************************************************/
+void SceneBinary::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = NULL;
+	}
+	if (m_fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, (size_t)m_dataBytes);
+	}
+#endif
+	m_pData = NULL;
+	m_dataBytes = 0;
+	m_pHeader = NULL;
+}
+
+/***********************************************************
+ *  GetObjectArrays()
+ ***********************************************************/
+SceneManager::OBJECT_ARRAYS SceneBinary::GetObjectArrays() const
+{
+	SceneManager::OBJECT_ARRAYS arrays;
+	arrays.count = GetObjectCount();
+	arrays.pTransforms = GetTransforms();
+	arrays.pColors = GetColors();
+	arrays.pUVScales = GetUVScales();
+	arrays.pMeshes = GetMeshes();
+	arrays.pMaterialIDs = GetMaterialIDs();
+	arrays.pTextureIDs = GetTextureIDs();
+	arrays.pStateBits = GetStateBits();
+	return(arrays);
+}
+
+/***********************************************************
+ *  GetString()
+ ***********************************************************/
+const char* SceneBinary::GetString(uint32_t offset) const
+{
+	if (offset >= m_pHeader->stringBytes)
+	{
+		return("");
+	}
+	return((const char*)GetSection(SECTION_STRINGS) + offset);
+}
@@ -0,0 +1,507 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// read the textures, materials, lights and objects of a scene file
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "SceneBake.h"
+
+#include <cstring>
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_bStarted = false;
+	m_section = SECTION_NONE;
+}
+
+/***********************************************************
+ *  Open()
+ ***********************************************************/
+bool SceneFile::Open(const std::string& filename)
+{
+	m_bStarted = false;
+	m_section = SECTION_NONE;
+	return(m_json.Open(filename));
+}
+
+/***********************************************************
+ *  SetText()
+ ***********************************************************/
+void SceneFile::SetText(const std::string& text)
+{
+	m_bStarted = false;
+	m_section = SECTION_NONE;
+	m_json.SetText(text);
+}
+
+/***********************************************************
+ *  Next()
+ *
+ *  This method is used for reading the next entry of the
+ *  file.  Between sections the top-level object is walked to
+ *  the next array with a known name, inside a section one
+ *  element is read and returned.
+ ***********************************************************/
+bool SceneFile::Next(SCENE_ENTRY& entry)
+{
+	if (m_bStarted == false)
+	{
+		if (m_json.BeginObject() == false)
+		{
+			return(false);
+		}
+		m_bStarted = true;
+	}
+
+	while (m_json.HasError() == false)
+	{
+		if (m_section == SECTION_NONE)
+		{
+			if (m_json.NextMember(m_name) == false)
+			{
+				// the top-level object is done
+				if ((m_json.HasError() == false) && (m_json.IsAtEnd() == false))
+				{
+					m_json.Fail("text after the scene object");
+				}
+				return(false);
+			}
+
+			if (m_name == "textures") m_section = SECTION_TEXTURES;
+			else if (m_name == "materials") m_section = SECTION_MATERIALS;
+			else if (m_name == "lights") m_section = SECTION_LIGHTS;
+			else if (m_name == "prefabs") m_section = SECTION_PREFABS;
+			else if (m_name == "objects") m_section = SECTION_OBJECTS;
+			else m_section = SECTION_UNKNOWN;
+
+			if (m_section == SECTION_UNKNOWN)
+			{
+				m_json.SkipValue();
+				m_section = SECTION_NONE;
+			}
+			else
+			{
+				m_json.BeginArray();
+			}
+			continue;
+		}
+
+		if (m_json.NextElement() == false)
+		{
+			m_section = SECTION_NONE;
+			continue;
+		}
+
+		switch (m_section)
+		{
+		case SECTION_TEXTURES:
+			entry.type = ENTRY_TEXTURE;
+			return(ReadTexture(entry.texture));
+		case SECTION_MATERIALS:
+			entry.type = ENTRY_MATERIAL;
+			return(ReadMaterial(entry.material));
+		case SECTION_LIGHTS:
+			entry.type = ENTRY_LIGHT;
+			return(ReadLight(entry.light));
+		case SECTION_PREFABS:
+			entry.type = ENTRY_PREFAB;
+			return(ReadPrefab(entry.prefab));
+		default:
+			entry.type = ENTRY_OBJECT;
+			return(ReadObject(entry.object));
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  ReadVec3()
+ ***********************************************************/
+bool SceneFile::ReadVec3(glm::vec3& value)
+{
+	return(m_json.ReadFloats(&value.x, 3));
+}
+
+/***********************************************************
+ *  ReadTexture()
+ ***********************************************************/
+bool SceneFile::ReadTexture(SCENE_TEXTURE& texture)
+{
+	texture.tag.clear();
+	texture.path.clear();
+
+	m_json.BeginObject();
+	while (m_json.NextMember(m_name) == true)
+	{
+		if (m_name == "tag") m_json.ReadString(texture.tag);
+		else if (m_name == "path") m_json.ReadString(texture.path);
+		else m_json.SkipValue();
+	}
+
+	if ((m_json.HasError() == false) && (texture.path.empty() == true))
+	{
+		return(m_json.Fail("texture \"" + texture.tag + "\" has no path"));
+	}
+	return(m_json.HasError() == false);
+}
+
+/***********************************************************
+ *  ReadMaterial()
+ ***********************************************************/
+bool SceneFile::ReadMaterial(SceneManager::OBJECT_MATERIAL& material)
+{
+	material.ambientStrength = 0.0f;
+	material.ambientColor = glm::vec3(0.0f);
+	material.diffuseColor = glm::vec3(0.0f);
+	material.specularColor = glm::vec3(0.0f);
+	material.shininess = 1.0f;
+	material.tag.clear();
+
+	m_json.BeginObject();
+	while (m_json.NextMember(m_name) == true)
+	{
+		if (m_name == "tag") m_json.ReadString(material.tag);
+		else if (m_name == "ambientColor") ReadVec3(material.ambientColor);
+		else if (m_name == "ambientStrength") m_json.ReadFloat(material.ambientStrength);
+		else if (m_name == "diffuseColor") ReadVec3(material.diffuseColor);
+		else if (m_name == "specularColor") ReadVec3(material.specularColor);
+		else if (m_name == "shininess") m_json.ReadFloat(material.shininess);
+		else m_json.SkipValue();
+	}
+	return(m_json.HasError() == false);
+}
+
+/***********************************************************
+ *  ReadLight()
+ ***********************************************************/
+bool SceneFile::ReadLight(SceneManager::LIGHT_SOURCE& light)
+{
+	light.position = glm::vec3(0.0f);
+	light.ambientColor = glm::vec3(0.0f);
+	light.diffuseColor = glm::vec3(0.0f);
+	light.specularColor = glm::vec3(0.0f);
+	light.focalStrength = 1.0f;
+	light.specularIntensity = 0.0f;
+	light.radius = 10.0f;
+
+	m_json.BeginObject();
+	while (m_json.NextMember(m_name) == true)
+	{
+		if (m_name == "position") ReadVec3(light.position);
+		else if (m_name == "ambientColor") ReadVec3(light.ambientColor);
+		else if (m_name == "diffuseColor") ReadVec3(light.diffuseColor);
+		else if (m_name == "specularColor") ReadVec3(light.specularColor);
+		else if (m_name == "focalStrength") m_json.ReadFloat(light.focalStrength);
+		else if (m_name == "specularIntensity") m_json.ReadFloat(light.specularIntensity);
+		else if (m_name == "radius") m_json.ReadFloat(light.radius);
+		else m_json.SkipValue();
+	}
+	return(m_json.HasError() == false);
+}
+
+/***********************************************************
+ *  ReadPrefab()
+ *
+ *  This method is used for reading a prefab and its parts,
+ *  which are read as objects.  The part array is reused by
+ *  the entry, so its strings keep their buffers.
+ ***********************************************************/
+bool SceneFile::ReadPrefab(SCENE_PREFAB& prefab)
+{
+	size_t partCount = 0;
+	prefab.id.clear();
+
+	m_json.BeginObject();
+	while (m_json.NextMember(m_name) == true)
+	{
+		if (m_name == "id") m_json.ReadString(prefab.id);
+		else if (m_name == "parts")
+		{
+			m_json.BeginArray();
+			while ((m_json.HasError() == false) && (m_json.NextElement() == true))
+			{
+				if (partCount == prefab.parts.size())
+				{
+					prefab.parts.push_back(SCENE_OBJECT());
+				}
+				if (ReadObject(prefab.parts[partCount]) == true)
+				{
+					partCount++;
+				}
+			}
+		}
+		else m_json.SkipValue();
+	}
+	prefab.parts.resize(partCount);
+
+	if (m_json.HasError() == true)
+	{
+		return(false);
+	}
+	if (prefab.parts.empty() == true)
+	{
+		return(m_json.Fail("prefab \"" + prefab.id + "\" has no parts"));
+	}
+	for (const SCENE_OBJECT& part : prefab.parts)
+	{
+		if (part.prefab.empty() == false)
+		{
+			return(m_json.Fail("part \"" + part.id + "\" of prefab \"" + prefab.id + "\" is a prefab"));
+		}
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  ReadObject()
+ ***********************************************************/
+bool SceneFile::ReadObject(SCENE_OBJECT& object)
+{
+	object.id.clear();
+	object.prefab.clear();
+	object.mesh = SceneManager::MESH_COUNT;
+	object.scale = glm::vec3(1.0f);
+	object.rotation = glm::vec3(0.0f);
+	object.position = glm::vec3(0.0f);
+	object.color = glm::vec4(1.0f);
+	object.UVscale = glm::vec2(1.0f);
+	object.texture.clear();
+	object.material.clear();
+	object.bStatic = false;
+
+	m_json.BeginObject();
+	while (m_json.NextMember(m_name) == true)
+	{
+		if (m_name == "id") m_json.ReadString(object.id);
+		else if (m_name == "prefab") m_json.ReadString(object.prefab);
+		else if (m_name == "mesh")
+		{
+			std::string meshName;
+			if ((m_json.ReadString(meshName) == true) &&
+				(FindMeshType(meshName.c_str(), object.mesh) == false))
+			{
+				m_json.Fail("unknown mesh \"" + meshName + "\"");
+			}
+		}
+		else if (m_name == "scale") ReadVec3(object.scale);
+		else if (m_name == "rotation") ReadVec3(object.rotation);
+		else if (m_name == "position") ReadVec3(object.position);
+		else if (m_name == "color") m_json.ReadFloats(&object.color.x, 4);
+		else if (m_name == "UVscale") m_json.ReadFloats(&object.UVscale.x, 2);
+		else if (m_name == "texture") m_json.ReadString(object.texture);
+		else if (m_name == "material") m_json.ReadString(object.material);
+		else if (m_name == "static") m_json.ReadBool(object.bStatic);
+		else m_json.SkipValue();
+	}
+
+	if ((m_json.HasError() == false) && (object.mesh == SceneManager::MESH_COUNT) && (object.prefab.empty() == true))
+	{
+		return(m_json.Fail("object \"" + object.id + "\" has no mesh"));
+	}
+	return(m_json.HasError() == false);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the box around a basic
+ *  shape mesh, as the shape meshes build it before the model
+ *  transform is applied.
+ ***********************************************************/
+void SceneFile::GetMeshBounds(SceneManager::MESH_TYPE mesh, glm::vec3& boundsMin, glm::vec3& boundsMax)
+{
+	switch (mesh)
+	{
+	case SceneManager::MESH_PLANE:
+		// a unit square on the XZ plane
+		boundsMin = glm::vec3(-1.0f, 0.0f, -1.0f);
+		boundsMax = glm::vec3(1.0f, 0.0f, 1.0f);
+		break;
+	case SceneManager::MESH_BOX:
+		boundsMin = glm::vec3(-0.5f, -0.5f, -0.5f);
+		boundsMax = glm::vec3(0.5f, 0.5f, 0.5f);
+		break;
+	case SceneManager::MESH_CYLINDER:
+		// unit radius, standing on the origin
+		boundsMin = glm::vec3(-1.0f, 0.0f, -1.0f);
+		boundsMax = glm::vec3(1.0f, 1.0f, 1.0f);
+		break;
+	case SceneManager::MESH_TORUS:
+		// unit ring in the XY plane with the default tube thickness
+		boundsMin = glm::vec3(-1.1f, -1.1f, -0.1f);
+		boundsMax = glm::vec3(1.1f, 1.1f, 0.1f);
+		break;
+	default:
+		boundsMin = glm::vec3(0.0f);
+		boundsMax = glm::vec3(0.0f);
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetWorldBounds()
+ *
+ *  This method is used for getting the world space box
+ *  around a basic shape mesh drawn with a model matrix, from
+ *  the eight corners of its model space box.
+ ***********************************************************/
+void SceneFile::GetWorldBounds(
+	SceneManager::MESH_TYPE mesh,
+	const glm::mat4& model,
+	glm::vec3& boundsMin,
+	glm::vec3& boundsMax)
+{
+	glm::vec3 meshMin;
+	glm::vec3 meshMax;
+	GetMeshBounds(mesh, meshMin, meshMax);
+	GetBoxWorldBounds(meshMin, meshMax, model, boundsMin, boundsMax);
+}
+
+/***********************************************************
+ *  GetBoxWorldBounds()
+ ***********************************************************/
+void SceneFile::GetBoxWorldBounds(
+	const glm::vec3& localMin,
+	const glm::vec3& localMax,
+	const glm::mat4& model,
+	glm::vec3& boundsMin,
+	glm::vec3& boundsMax)
+{
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 point(
+			(corner & 1) ? localMax.x : localMin.x,
+			(corner & 2) ? localMax.y : localMin.y,
+			(corner & 4) ? localMax.z : localMin.z);
+		glm::vec3 world = glm::vec3(model * glm::vec4(point, 1.0f));
+		boundsMin = (corner == 0) ? world : glm::min(boundsMin, world);
+		boundsMax = (corner == 0) ? world : glm::max(boundsMax, world);
+	}
+}
+
+/***********************************************************
+ *  GetMeshName()
+ *
+ *  This method is used for getting the name of a basic shape
+ *  mesh, as used in scene files.
+ ***********************************************************/
+const char* SceneFile::GetMeshName(SceneManager::MESH_TYPE mesh)
+{
+	switch (mesh)
+	{
+	case SceneManager::MESH_PLANE:
+		return("plane");
+	case SceneManager::MESH_BOX:
+		return("box");
+	case SceneManager::MESH_CYLINDER:
+		return("cylinder");
+	case SceneManager::MESH_TORUS:
+		return("torus");
+	default:
+		return("unknown");
+	}
+}
+
+/***********************************************************
+ *  FindMeshType()
+ *
+ *  This method is used for getting the basic shape mesh with
+ *  the passed in name.
+ ***********************************************************/
+bool SceneFile::FindMeshType(const char* name, SceneManager::MESH_TYPE& mesh)
+{
+	for (int i = 0; i < SceneManager::MESH_COUNT; i++)
+	{
+		if (strcmp(name, GetMeshName((SceneManager::MESH_TYPE)i)) == 0)
+		{
+			mesh = (SceneManager::MESH_TYPE)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetModelMatrix()
+ *
+ *  This method is used for getting the model matrix of an
+ *  object, built as the original scene code built it:
+ *  scaled, rotated about X, Y and Z, then translated.  The
+ *  math is the constexpr math of baked scenes, run here at
+ *  load, so baked and loaded scenes have equal matrices.
+ ***********************************************************/
+glm::mat4 SceneFile::GetModelMatrix(const SCENE_OBJECT& object)
+{
+	SceneBake::MATRIX matrix = SceneBake::GetModelMatrix(
+		object.scale.x, object.scale.y, object.scale.z,
+		object.rotation.x, object.rotation.y, object.rotation.z,
+		object.position.x, object.position.y, object.position.z);
+
+	glm::mat4 model;
+	memcpy(&model[0][0], matrix.values, sizeof(matrix.values));
+	return(model);
+}
+
+/***********************************************************
+ *  IsStaticObject()
+ ***********************************************************/
+bool SceneFile::IsStaticObject(const SCENE_OBJECT& object)
+{
+	return((object.bStatic == true) && (object.prefab.empty() == true) &&
+		((object.texture.empty() == false) || (object.color.a >= 1.0f)));
+}
+
+/***********************************************************
+ *  GetStateBits()
+ *
+ *  This method is used for getting the shader settings a draw
+ *  has to send after the one before it, which are the ones
+ *  the setters would have changed.  The first draw sends all
+ *  the settings it uses.
+ ***********************************************************/
+unsigned int SceneFile::GetStateBits(
+	const SceneManager::DRAW_COMMAND* pPrevious,
+	const SceneManager::DRAW_COMMAND& command)
+{
+	unsigned int stateBits = 0;
+
+	if (NULL == pPrevious)
+	{
+		stateBits = (command.bUseTexture ? SceneManager::DRAW_STATE_TEXTURE : SceneManager::DRAW_STATE_COLOR) |
+			SceneManager::DRAW_STATE_UVSCALE;
+		if (command.materialIndex >= 0)
+		{
+			stateBits |= SceneManager::DRAW_STATE_MATERIAL;
+		}
+		return(stateBits);
+	}
+
+	if ((command.bUseTexture == true) &&
+		((pPrevious->bUseTexture == false) || (pPrevious->textureSlot != command.textureSlot)))
+	{
+		stateBits |= SceneManager::DRAW_STATE_TEXTURE;
+	}
+	if ((command.bUseTexture == false) &&
+		((pPrevious->bUseTexture == true) || (pPrevious->color != command.color)))
+	{
+		stateBits |= SceneManager::DRAW_STATE_COLOR;
+	}
+	if (pPrevious->materialIndex != command.materialIndex)
+	{
+		stateBits |= SceneManager::DRAW_STATE_MATERIAL;
+	}
+	if (pPrevious->UVscale != command.UVscale)
+	{
+		stateBits |= SceneManager::DRAW_STATE_UVSCALE;
+	}
+	return(stateBits);
+}
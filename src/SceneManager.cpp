@@ -1,1810 +1,2883 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	// create the shape meshes object
-	m_basicMeshes = new ShapeMeshes();
-
-	// initialize the texture collection
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	//loads in the textures
-	bReturn = CreateGLTexture("C:/Users/NFigu/Pictures/dfc59b634fc228887ca8668526b24100.jpg", "Wood");
-	bReturn = CreateGLTexture("C:/Users/NFigu/Pictures/images.jpg", "Metal");
-	bReturn = CreateGLTexture("C:/Users/NFigu/Pictures/download.jpg", "Magazine Cover");
-	bReturn = CreateGLTexture("C:/Users/NFigu/Pictures/d7i46lm-d44c1ab4-227d-4009-9114-e549c1420d21.jpg", "Black Metal");
-	bReturn = CreateGLTexture("C:/Users/NFigu/Pictures/images (1).jpg", "White");
-
-	//Binds the loaded textures to memory slots
-	BindGLTextures();
-}
-
-void SceneManager::DefineObjectMaterials()
-{
-	OBJECT_MATERIAL paperMaterial;
-	paperMaterial.ambientColor = glm::vec3(0.8f, 0.8f, 0.8f);
-	paperMaterial.ambientStrength = 0.2f;
-	paperMaterial.diffuseColor = glm::vec3(0.9f, 0.9f, 0.9f);
-	paperMaterial.specularColor = glm::vec3(0.05f, 0.05f, 0.05f);
-	paperMaterial.shininess = 10.0f;
-	paperMaterial.tag = "Paper";
-
-	m_objectMaterials.push_back(paperMaterial);
-
-	
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.2f, 0.1f, 0.1f);
-	woodMaterial.ambientStrength = 0.3f;
-	woodMaterial.diffuseColor = glm::vec3(0.6f, 0.4f, 0.2f);
-	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.shininess = 25.0f;
-	woodMaterial.tag = "Wood";
-
-
-	m_objectMaterials.push_back(woodMaterial);
-
-	OBJECT_MATERIAL plasticMaterial;
-	plasticMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	plasticMaterial.ambientStrength = 0.1f;
-	plasticMaterial.diffuseColor = glm::vec3(0.7f, 0.7f, 0.7f);
-	plasticMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	plasticMaterial.shininess = 30;
-	plasticMaterial.tag = "Plastic";
-
-	m_objectMaterials.push_back(plasticMaterial);
-
-	OBJECT_MATERIAL metalMaterial;
-	metalMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	metalMaterial.ambientStrength = 0.1f;
-	metalMaterial.diffuseColor = glm::vec3(0.7f, 0.7f, 0.7f);
-	metalMaterial.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
-	metalMaterial.shininess = 80.0f;
-	metalMaterial.tag = "Metal";
-
-	m_objectMaterials.push_back(metalMaterial);
-
-}
-
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting, if no light sources have
-	// been added then the display window will be black - to use the 
-	// default OpenGL lighting then comment out the following line
-
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	m_pShaderManager->setVec3Value("lightSources[0].position", -3.0f, 4.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.7f, 0.7f, 0.6f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 15.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.1f);
-
-	m_pShaderManager->setVec3Value("lightSources[1].position", 3.0f, 4.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.7f, 0.7f, 0.6f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 15.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.1f);
-
-	m_pShaderManager->setVec3Value("lightSources[2].position", 0.0f, 3.0f, 20.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 12.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.1f);
-
-}
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	LoadSceneTextures();
-	DefineObjectMaterials();
-	SetupSceneLights();
-	
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	//Draw the plane for the scene
-	/******************************************************************/
-	// set the XYZ scale for the plane
-	scaleXYZ = glm::vec3(85.0f, 1.0f, 200.0f);
-
-	// set the XYZ rotation for the plane
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the plane
-	positionXYZ = glm::vec3(0.0f, -32.0f, -200.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Wood");
-	SetShaderTexture("Wood");
-
-	// draw the plane for the scene
-	m_basicMeshes->DrawPlaneMesh();
-	
-	//draw the torus for the handle of the mug
-	/****************************************************************/
-
-	// set the XYZ scale for the handle
-	scaleXYZ = glm::vec3(0.35f, 0.35f, 0.4f);
-
-	// set the XYZ rotation for the handle
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the handle
-	positionXYZ = glm::vec3(-11.3f, -8.85f, -33.4f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the keyboard with transformation values
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-
-	//draw the torus for the lip of the mug
-	/****************************************************************/
-
-	// set the XYZ scale for the mug
-	scaleXYZ = glm::vec3(0.55f, 0.55f, 0.4f);
-
-	// set the XYZ rotation for the mug
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mug
-	positionXYZ = glm::vec3(-10.5f, -8.4f, -33.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the torus with transformation values
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the monitor stand
-	/****************************************************************/
-
-	// set the XYZ scale for the monitor stand
-	scaleXYZ = glm::vec3(0.25f, 2.3f, 0.25f);
-
-	// set the XYZ rotation for the monitor stand
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the monitor stand
-	positionXYZ = glm::vec3(7.7f, -9.6f, -30.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("Metal");
-
-	// draw the monitor stand with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the mug
-	/****************************************************************/
-
-	// set the XYZ scale for the dish
-	scaleXYZ = glm::vec3(0.6f, 1.0f, 0.6f);
-
-	// set the XYZ rotation for the dish
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the dish
-	positionXYZ = glm::vec3(-10.5f, -9.4f, -33.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the keyboard with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the torus for the middle of the dish
-	/****************************************************************/
-
-	// set the XYZ scale for the dish
-	scaleXYZ = glm::vec3(0.75f, 0.75f, 0.3f);
-
-	// set the XYZ rotation for the dish
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the dish
-	positionXYZ = glm::vec3(-10.5f, -9.38f, -33.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the dish with transformation values
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the left monitor leg
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(2.2f, 0.3f, 0.2f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -125.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(8.9f, -9.6f, -31.8f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the right monitor leg
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(2.2f, 0.3f, 0.2f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 3.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(5.7f, -9.6f, -29.9f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the torus for the bottom of the dish
-	/****************************************************************/
-
-	// set the XYZ scale for the dish
-	scaleXYZ = glm::vec3(0.6f, 0.6f, 0.4f);
-
-	// set the XYZ rotation for the dish
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the dish
-	positionXYZ = glm::vec3(-10.5f, -9.5f, -33.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the dish with transformation values
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the mouse
-	/****************************************************************/
-
-	// set the XYZ scale for the mouse
-	scaleXYZ = glm::vec3(0.65f, 0.75f, 0.65f);
-
-	// set the XYZ rotation for the mouse
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the mouse
-	positionXYZ = glm::vec3(-3.0f, -9.4f, -38.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Plastic");
-	SetShaderTexture("White");
-
-	// draw the keyboard with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the box for the player
-	/****************************************************************/
-
-	// set the XYZ scale for the player
-	scaleXYZ = glm::vec3(3.15f, 2.5f, 2.65f);
-
-	// set the XYZ rotation for the player
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the player
-	positionXYZ = glm::vec3(-4.3f, -8.5f, -23.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("White");
-	SetShaderMaterial("Plastic");
-
-	// draw the player with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the right book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(2.6f, 1.0f, 1.5f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(18.14f, -7.8f, -36.48f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the 5th left book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(3.0f, 1.0f, 1.5f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(20.0f, -7.4f, -37.6f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the 4th left book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(2.4f, 1.0f, 1.2f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(20.5f, -7.6f, -37.9f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the 3rd left book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(2.0f, 1.0f, 1.0f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(20.9f, -7.8f, -38.1f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the 2nd left book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(1.6f, 1.0f, 0.8f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(21.3f, -8.2f, -38.4f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the cylinder for the 1st left book end
-	/****************************************************************/
-
-	// set the XYZ scale for the book end
-	scaleXYZ = glm::vec3(1.2f, 1.0f, 0.6f);
-
-	// set the XYZ rotation for the book end
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book end
-	positionXYZ = glm::vec3(21.8f, -8.6f, -38.7f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	//draw the box for the right standing book
-	/****************************************************************/
-
-	// set the XYZ scale for the book
-	scaleXYZ = glm::vec3(6.5f, 1.0f, 3.5f);
-
-	// set the XYZ rotation for the book
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book
-	positionXYZ = glm::vec3(18.14f, -6.5f, -36.48f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1);
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the left standing book
-	/****************************************************************/
-
-	// set the XYZ scale for the book
-	scaleXYZ = glm::vec3(6.5f, 1.0f, 3.5f);
-
-	// set the XYZ rotation for the book
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the book
-	positionXYZ = glm::vec3(19.0f, -6.5f, -37.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.6706, 0.8588, 0.8902, 1);
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the back right book
-	/****************************************************************/
-
-	// set the XYZ scale for the book
-	scaleXYZ = glm::vec3(6.5f, 1.4f, 3.5f);
-
-	// set the XYZ rotation for the book
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the book
-	positionXYZ = glm::vec3(-4.0f, -9.5f, -23.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1);
-
-	// draw the book with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the monitor
-	/****************************************************************/
-
-	// set the XYZ scale for the monitor
-	scaleXYZ = glm::vec3(14.0f, 0.3f, 8.5f);
-
-	// set the XYZ rotation for the monitor
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -30.0f;
-
-	// set the XYZ position for the monitor
-	positionXYZ = glm::vec3(7.75f, -3.0f, -30.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Magazine Cover");
-	SetShaderMaterial("Plastic");
-
-	// draw the monitor with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the keyboard
-	/****************************************************************/
-
-	// set the XYZ scale for the keyboard
-	scaleXYZ = glm::vec3(7.0f, 0.3f, 3.0f);
-
-	// set the XYZ rotation for the keyboard
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the keyboard
-	positionXYZ = glm::vec3(2.0f, -9.5f, -41.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Plastic");
-	SetShaderTexture("White");
-
-	// draw the keyboard with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the desktop
-	/****************************************************************/
-
-	// set the XYZ scale for the desktop
-	scaleXYZ = glm::vec3(35.0f, 0.8f, 18.0f);
-
-	// set the XYZ rotation for the desktop
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(5.0f, -10.0f, -35.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the desktop with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the box for the drawer compartment
-	/****************************************************************/
-
-	// set the XYZ scale for the compartment
-	scaleXYZ = glm::vec3(10.0f, 4.5f, 14.3f);
-
-	// set the XYZ rotation for the compartment
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(14.5f, -12.0f, -40.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the compartment with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the physical drawer bottom
-	/****************************************************************/
-
-	// set the XYZ scale for the bottom
-	scaleXYZ = glm::vec3(3.8f, 1.0f, 4.0f);
-
-	// set the XYZ rotation for the bottom
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(10.1f, -14.2f, -48.95f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Wood");
-	SetShaderTexture("Wood");
-
-	// draw the bottom with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-
-
-	//draw the magazine in the drawer
-	/****************************************************************/
-
-	// set the XYZ scale for the magazine
-	scaleXYZ = glm::vec3(2.8f, 1.0f, 3.7f);
-
-	// set the XYZ rotation for the magazine
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(10.0f, -14.1f, -48.95f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Magazine Cover");
-	SetShaderMaterial("Paper");
-
-	// draw the magazine with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-
-
-	//draw the left pen in the drawer
-	/****************************************************************/
-
-	// set the XYZ scale for the pen
-	scaleXYZ = glm::vec3(0.2f, 3.0f, 0.2f);
-
-	// set the XYZ rotation for the pen
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -30.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(9.0f, -13.8f, -51.7f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("White");
-	SetShaderMaterial("Plastic");
-
-	// draw the pen with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-
-	//draw the right pen in the drawer
-	/****************************************************************/
-
-	// set the XYZ scale for the pen
-	scaleXYZ = glm::vec3(0.2f, 3.0f, 0.2f);
-
-	// set the XYZ rotation for the pen
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -65.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(7.1f, -13.8f, -50.7f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("White");
-	SetShaderMaterial("Plastic");
-
-	// draw the pen with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-
-	//draw the right side of the drawer
-	/****************************************************************/
-
-	// set the XYZ scale for the right side
-	scaleXYZ = glm::vec3(8.0f, 2.5f, 0.8f);
-
-	// set the XYZ rotation for the right side
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(6.75f, -13.0f, -47.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the right side with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the left side of the drawer
-	/****************************************************************/
-
-	// set the XYZ scale for the left side
-	scaleXYZ = glm::vec3(8.0f, 2.5f, 0.8f);
-
-	// set the XYZ rotation for the left side
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(13.0f, -13.0f, -51.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the left side with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the drawer track
-	/****************************************************************/
-
-	// set the XYZ scale for the track
-	scaleXYZ = glm::vec3(8.3f, 0.5f, 0.1f);
-
-	// set the XYZ rotation for the track
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(13.5f, -13.8f, -51.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the track with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the drawer front
-	/****************************************************************/
-
-	// set the XYZ scale for the front
-	scaleXYZ = glm::vec3(9.0f, 3.5f, 0.8f);
-
-	// set the XYZ rotation for the front
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the desktop
-	positionXYZ = glm::vec3(8.1f, -12.5f, -52.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Wood");
-	SetShaderMaterial("Wood");
-
-	// draw the front with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the back right leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(-5.0f, -20.99f, -22.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("Black Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the middle back right leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(3.0f, -20.99f, -26.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the front right leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(-12.0f, -20.99f, -34.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the middle left leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(19.5f, -20.99f, -42.8f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the front middle left leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(6.47f, -20.99f, -43.55f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the back left leg of the desk
-	/****************************************************************/
-
-	// set the XYZ scale for the leg
-	scaleXYZ = glm::vec3(1.0f, 22.0f, 1.0f);
-
-	// set the XYZ rotation for the leg
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the leg
-	positionXYZ = glm::vec3(13.0f, -20.99f, -32.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the leg with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the top front cross beam
-	/****************************************************************/
-
-	// set the XYZ scale for the beam
-	scaleXYZ = glm::vec3(1.0f, 21.0f, 1.0f);
-
-	// set the XYZ rotation for the beam
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the beam
-	positionXYZ = glm::vec3(-3.0f, -11.0f, -38.4f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the beam with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the bottom left leg cross beam
-	/****************************************************************/
-
-	// set the XYZ scale for the beam
-	scaleXYZ = glm::vec3(1.0f, 10.65f, 1.0f);
-
-	// set the XYZ rotation for the beam
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the beam
-	positionXYZ = glm::vec3(14.8f, -29.0f, -40.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the beam with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the bottom right leg cross beam
-	/****************************************************************/
-
-	// set the XYZ scale for the beam
-	scaleXYZ = glm::vec3(1.0f, 13.5f, 1.0f);
-
-	// set the XYZ rotation for the beam
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the beam
-	positionXYZ = glm::vec3(9.645f, -29.0f, -38.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the beam with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the far back right bottom leg cross beam
-	/****************************************************************/
-
-	// set the XYZ scale for the beam
-	scaleXYZ = glm::vec3(1.0f, 8.75f, 1.0f);
-
-	// set the XYZ rotation for the beam
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the beam
-	positionXYZ = glm::vec3(-0.75f, -29.0f, -24.25f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the beam with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-
-	//draw the second bottom left leg cross beam
-	/****************************************************************/
-
-	// set the XYZ scale for the beam
-	scaleXYZ = glm::vec3(1.0f, 13.9f, 1.0f);
-
-	// set the XYZ rotation for the beam
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the beam
-	positionXYZ = glm::vec3(-8.2f, -29.0f, -27.6f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("Black Metal");
-	SetShaderMaterial("Metal");
-
-	// draw the beam with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-
-	//draw the box for the computer
-	/****************************************************************/
-
-	// set the XYZ scale for the computer
-	scaleXYZ = glm::vec3(10.0f, 18.0f, 5.0f);
-
-	// set the XYZ rotation for the computer
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 120.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the computer
-	positionXYZ = glm::vec3(-4.7f, -29.0f, -30.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("Metal");
-	SetShaderTexture("White");
-
-	// draw the computer with transformation values
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-}
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "SceneFile.h"
+#include "SceneBinary.h"
+#include "SceneStreamer.h"
+#include "ScenePreloader.h"
+#include "ObjectStore.h"
+#include "PrefabStore.h"
+#include "StaticBatches.h"
+#include "ShapeGeometry.h"
+#ifdef SCENE_BAKED
+#include "BakedScene.h"
+#endif
+#include "MemoryTracker.h"
+#include "GLHooks.h"
+#include "StartupProfiler.h"
+#include "ProfileZone.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+
+	// starting per-frame arena size, which grows to the frames
+	// of larger scenes, rendering is not pipelined so one buffer
+	// is enough, and the draws recorded in a frame
+	const size_t g_FrameArenaBytes = 256 * 1024;
+	const size_t g_FramePacketReserve = 256;
+
+	// end of the free object slots
+	const uint32_t NO_OBJECT_SLOT = 0xFFFFFFFF;
+
+	// the position is computed the same way as in the scene's
+	// vertex shader, so the shaded pass finds equal depths
+	const char* const g_DepthVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 inVertexPosition;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+void main()
+{
+	gl_Position = projection * view * model * vec4(inVertexPosition, 1.0f);
+}
+)";
+
+	const char* const g_DepthFragmentShader = R"(
+#version 330 core
+void main()
+{
+}
+)";
+
+	// read a whole file into memory, charging the time to the
+	// startup I/O of the open phases
+	bool ReadFileBytes(const char* filename, std::vector<unsigned char>& data)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		FILE* file = fopen(filename, "rb");
+		if (NULL == file)
+		{
+			return(false);
+		}
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size > 0)
+		{
+			data.resize(size);
+			data.resize(fread(data.data(), 1, size, file));
+		}
+		fclose(file);
+
+		StartupProfiler::AddIOTime(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count());
+
+		return(!data.empty());
+	}
+
+	// build the draw of a scene file object before its tags are
+	// resolved; an untextured draw keeps the slot of the one
+	// before, so a full state submission never sends slot -1,
+	// and like the setters a draw without a material keeps the
+	// one in effect
+	SceneManager::DRAW_COMMAND MakeSceneDraw(
+		const SceneFile::SCENE_OBJECT& object,
+		const SceneManager::DRAW_COMMAND* pPrevious)
+	{
+		SceneManager::DRAW_COMMAND command = SceneManager::DRAW_COMMAND();
+		command.model = SceneFile::GetModelMatrix(object);
+		command.color = object.color;
+		command.UVscale = object.UVscale;
+		command.mesh = object.mesh;
+		command.textureSlot = (NULL != pPrevious) ? pPrevious->textureSlot : 0;
+		command.bUseTexture = false;
+		command.materialIndex = (NULL != pPrevious) ? pPrevious->materialIndex : -1;
+		return(command);
+	}
+
+	// compare the settings of two draws field by field, their
+	// padding is not reliably zeroed; the state bits are worked
+	// out when the draws are recorded
+	bool IsSameDraw(const SceneManager::DRAW_COMMAND& a, const SceneManager::DRAW_COMMAND& b)
+	{
+		return((a.model == b.model) &&
+			(a.color == b.color) &&
+			(a.UVscale == b.UVscale) &&
+			(a.mesh == b.mesh) &&
+			(a.textureSlot == b.textureSlot) &&
+			(a.materialIndex == b.materialIndex) &&
+			(a.bUseTexture == b.bUseTexture));
+	}
+
+	// compare two lights field by field
+	bool IsSameLight(const SceneManager::LIGHT_SOURCE& a, const SceneManager::LIGHT_SOURCE& b)
+	{
+		return((a.position == b.position) &&
+			(a.ambientColor == b.ambientColor) &&
+			(a.diffuseColor == b.diffuseColor) &&
+			(a.specularColor == b.specularColor) &&
+			(a.focalStrength == b.focalStrength) &&
+			(a.specularIntensity == b.specularIntensity) &&
+			(a.radius == b.radius));
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager* pShaderManager)
+	: m_frameArena(g_FrameArenaBytes, 1),
+	m_framePacket(FrameArena::Allocator<DRAW_COMMAND>(&m_frameArena))
+{
+	m_pShaderManager = pShaderManager;
+	// the shape meshes are uploaded by PrepareScene()
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		m_shapeMeshes[i] = SHAPE_MESH();
+	}
+
+	// initialize the texture collection
+	for (int i = 0; i < 16; i++)
+	{
+		m_textureIDs[i].tag = "/0";
+		m_textureIDs[i].ID = -1;
+	}
+	m_loadedTextures = 0;
+	m_drawCallCount = 0;
+	m_pSceneObjects = new ObjectStore();
+	m_pScenePrefabs = new PrefabStore();
+	m_pStaticBatches = new StaticBatches();
+	m_staticChunkSize = 8.0f;
+	m_pSceneBinary = NULL;
+	m_bSceneFullState = false;
+	m_pSceneStreamer = NULL;
+	m_streamBudgetBytes = 0;
+	m_streamRadius = 0.0f;
+	m_streamCameraPosition = glm::vec3(0.0f);
+	m_activeScene = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		m_textureReferences[i] = 0;
+	}
+	m_pScenePreloader = NULL;
+	m_preloadingScene = -1;
+	m_objectSlots.firstFree = NO_OBJECT_SLOT;
+	m_nextObjectGeneration = 1;
+	m_submitStrategy = SUBMIT_CHANGED_STATE;
+	m_renderMode = RENDER_FORWARD;
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_depthProgram = 0;
+	m_depthModelLocation = -1;
+	m_depthViewLocation = -1;
+	m_depthProjectionLocation = -1;
+
+	// the shader program is in use when the scene is created
+	FindShaderUniforms();
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	// the streaming threads read the mapped scene
+	delete m_pSceneStreamer;
+	m_pSceneStreamer = NULL;
+	delete m_pScenePreloader;
+	m_pScenePreloader = NULL;
+	DestroyGLTextures();
+	if (0 != m_depthProgram)
+	{
+		glDeleteProgram(m_depthProgram);
+		m_depthProgram = 0;
+	}
+	ReleaseSceneMemory(m_objectMaterials, m_pSceneObjects, m_pScenePrefabs, m_pStaticBatches);
+	delete m_pSceneObjects;
+	m_pSceneObjects = NULL;
+	delete m_pScenePrefabs;
+	m_pScenePrefabs = NULL;
+	delete m_pStaticBatches;
+	m_pStaticBatches = NULL;
+	for (RESIDENT_SCENE& scene : m_residentScenes)
+	{
+		// the entry of the drawn scene holds no stores
+		if ((scene.bReady == true) && (NULL != scene.pObjects))
+		{
+			ReleaseSceneMemory(scene.materials, scene.pObjects, scene.pPrefabs, scene.pStatic);
+		}
+		delete scene.pObjects;
+		scene.pObjects = NULL;
+		delete scene.pPrefabs;
+		scene.pPrefabs = NULL;
+		delete scene.pStatic;
+		scene.pStatic = NULL;
+	}
+	if (NULL != m_pSceneBinary)
+	{
+		MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)m_pSceneBinary);
+		delete m_pSceneBinary;
+		m_pSceneBinary = NULL;
+	}
+	m_pShaderManager = NULL;
+	DestroyShapeMeshes();
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL,
+ *  generating the mipmaps, and loading the read texture into
+ *  the next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+	GLuint textureID = 0;
+	unsigned char* image = NULL;
+	std::vector<unsigned char> fileData;
+
+	StartupProfiler::Scope textureScope("texture " + tag);
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	// read the image file separately from decoding it, so the
+	// startup report can tell disk time from decode time
+	if (ReadFileBytes(filename, fileData) == true)
+	{
+		StartupProfiler::Scope decodeScope("decode");
+
+		// try to parse the image data from the specified image file
+		image = stbi_load_from_memory(
+			fileData.data(),
+			(int)fileData.size(),
+			&width,
+			&height,
+			&colorChannels,
+			0);
+	}
+
+	// if the image was successfully read from the image file
+	if (image)
+	{
+		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
+
+		// account for the decoded pixels until they are freed
+		const uint64_t imageRecordID = (uint64_t)(uintptr_t)image;
+		MemoryTracker::Register(
+			MemoryTracker::MEMORY_CPU,
+			imageRecordID,
+			tag,
+			"decoded image",
+			(size_t)width * height * colorChannels);
+
+		StartupProfiler::BeginPhase("upload");
+		size_t textureBytes = 0;
+		textureID = UploadGLTexture(image, width, height, colorChannels, tag, textureBytes);
+		StartupProfiler::EndPhase();
+
+		// free the image data from local memory
+		MemoryTracker::Release(MemoryTracker::MEMORY_CPU, imageRecordID);
+		stbi_image_free(image);
+		if (0 == textureID)
+		{
+			return false;
+		}
+
+		// register the loaded texture and associate it with the special tag string
+		m_textureIDs[m_loadedTextures].ID = textureID;
+		m_textureIDs[m_loadedTextures].tag = tag;
+		m_loadedTextures++;
+
+		return true;
+	}
+
+	std::cout << "Could not load image:" << filename << std::endl;
+
+	// Error loading the image
+	return false;
+}
+
+/***********************************************************
+ *  UploadGLTexture()
+ *
+ *  This method is used for creating an OpenGL texture from
+ *  decoded image pixels, configuring the texture mapping
+ *  parameters and generating the mipmaps.  The bytes of the
+ *  mip chain are accounted under the tag and returned.
+ ***********************************************************/
+GLuint SceneManager::UploadGLTexture(
+	const unsigned char* image,
+	int width,
+	int height,
+	int colorChannels,
+	const std::string& tag,
+	size_t& bytes)
+{
+	GLuint textureID = 0;
+	bytes = 0;
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// if the loaded image is in RGB format
+	if (colorChannels == 3)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
+	// if the loaded image is in RGBA format - it supports transparency
+	else if (colorChannels == 4)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+	else
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		glDeleteTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return(0);
+	}
+
+	// generate the texture mipmaps for mapping textures to lower resolutions
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	// account for every level of the mip chain, at the nominal
+	// size of the internal format (drivers may pad RGB8 to 4 bytes)
+	const char* formatName = (colorChannels == 4) ? "GL_RGBA8" : "GL_RGB8";
+	int mipWidth = width;
+	int mipHeight = height;
+	for (int level = 0; ; level++)
+	{
+		MemoryTracker::Register(
+			MemoryTracker::MEMORY_TEXTURE,
+			((uint64_t)textureID << 8) | level,
+			tag,
+			std::string(formatName) + " mip " + std::to_string(level) + " " +
+				std::to_string(mipWidth) + "x" + std::to_string(mipHeight),
+			(size_t)mipWidth * mipHeight * colorChannels);
+		bytes += (size_t)mipWidth * mipHeight * colorChannels;
+
+		if ((mipWidth == 1) && (mipHeight == 1))
+		{
+			break;
+		}
+		mipWidth = std::max(mipWidth / 2, 1);
+		mipHeight = std::max(mipHeight / 2, 1);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+	return(textureID);
+}
+
+/***********************************************************
+ *  AddTextureToFreeSlot()
+ *
+ *  This method is used for uploading a texture decoded by the
+ *  streaming threads or the scene preloader into a free slot, the first one freed by
+ *  ReleaseTextureSlot() or the next unused one, and binding
+ *  it to its texture unit.
+ ***********************************************************/
+int SceneManager::AddTextureToFreeSlot(
+	const unsigned char* image,
+	int width,
+	int height,
+	int colorChannels,
+	const std::string& tag,
+	size_t& bytes)
+{
+	int slot = 0;
+	while ((slot < m_loadedTextures) && (0 != m_textureIDs[slot].ID))
+	{
+		slot++;
+	}
+	bytes = 0;
+	if (slot >= 16)
+	{
+		return(-1);
+	}
+
+	GLuint textureID = UploadGLTexture(image, width, height, colorChannels, tag, bytes);
+	if (0 == textureID)
+	{
+		return(-1);
+	}
+	m_textureIDs[slot].ID = textureID;
+	m_textureIDs[slot].tag = tag;
+	m_loadedTextures = std::max(m_loadedTextures, slot + 1);
+
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	return(slot);
+}
+
+/***********************************************************
+ *  ReleaseTextureSlot()
+ *
+ *  This method is used for freeing the texture of one slot.
+ *  The slot is left empty so the other textures keep theirs.
+ ***********************************************************/
+void SceneManager::ReleaseTextureSlot(int slot)
+{
+	if ((slot < 0) || (slot >= m_loadedTextures) || (0 == m_textureIDs[slot].ID))
+	{
+		return;
+	}
+
+	for (int level = 0; level < 32; level++)
+	{
+		MemoryTracker::Release(
+			MemoryTracker::MEMORY_TEXTURE,
+			((uint64_t)m_textureIDs[slot].ID << 8) | level);
+	}
+	glDeleteTextures(1, &m_textureIDs[slot].ID);
+	m_textureIDs[slot].ID = 0;
+	m_textureIDs[slot].tag = "/0";
+	while ((m_loadedTextures > 0) && (0 == m_textureIDs[m_loadedTextures - 1].ID))
+	{
+		m_loadedTextures--;
+	}
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the loaded textures to
+ *  OpenGL texture memory slots.  There are up to 16 slots.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// bind textures on corresponding texture units
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// release the records of the whole mip chain
+		for (int level = 0; level < 32; level++)
+		{
+			MemoryTracker::Release(
+				MemoryTracker::MEMORY_TEXTURE,
+				((uint64_t)m_textureIDs[i].ID << 8) | level);
+		}
+		glDeleteTextures(1, &m_textureIDs[i].ID);
+	}
+	m_loadedTextures = 0;
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const char* tag)
+{
+	int textureSlot = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureSlot = index;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the position in the defined
+ *  materials list of the material with the passed in tag, or
+ *  -1 when there is no such material.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const char* tag)
+{
+	int index = 0;
+	while (index < (int)m_objectMaterials.size())
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return(index);
+		}
+		index++;
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  FindShaderUniforms()
+ *
+ *  This method is used for looking up the locations of the
+ *  uniforms set for every draw and of the lights, once, in
+ *  the shader program that is in use.  The per-draw setters
+ *  and the lights then pass values straight to OpenGL without
+ *  building uniform name strings.
+ ***********************************************************/
+void SceneManager::FindShaderUniforms()
+{
+	GLint program = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+	m_uniforms.model = glGetUniformLocation(program, g_ModelName);
+	m_uniforms.objectColor = glGetUniformLocation(program, g_ColorValueName);
+	m_uniforms.objectTexture = glGetUniformLocation(program, g_TextureValueName);
+	m_uniforms.useTexture = glGetUniformLocation(program, g_UseTextureName);
+	m_uniforms.UVscale = glGetUniformLocation(program, "UVscale");
+	m_uniforms.ambientColor = glGetUniformLocation(program, "material.ambientColor");
+	m_uniforms.ambientStrength = glGetUniformLocation(program, "material.ambientStrength");
+	m_uniforms.diffuseColor = glGetUniformLocation(program, "material.diffuseColor");
+	m_uniforms.specularColor = glGetUniformLocation(program, "material.specularColor");
+	m_uniforms.shininess = glGetUniformLocation(program, "material.shininess");
+	m_uniforms.useLighting = glGetUniformLocation(program, g_UseLightingName);
+
+	char name[64];
+	for (int i = 0; i < MAX_SCENE_LIGHTS; i++)
+	{
+		LIGHT_UNIFORMS& light = m_uniforms.lights[i];
+		snprintf(name, sizeof(name), "lightSources[%d].position", i);
+		light.position = glGetUniformLocation(program, name);
+		snprintf(name, sizeof(name), "lightSources[%d].ambientColor", i);
+		light.ambientColor = glGetUniformLocation(program, name);
+		snprintf(name, sizeof(name), "lightSources[%d].diffuseColor", i);
+		light.diffuseColor = glGetUniformLocation(program, name);
+		snprintf(name, sizeof(name), "lightSources[%d].specularColor", i);
+		light.specularColor = glGetUniformLocation(program, name);
+		snprintf(name, sizeof(name), "lightSources[%d].focalStrength", i);
+		light.focalStrength = glGetUniformLocation(program, name);
+		snprintf(name, sizeof(name), "lightSources[%d].specularIntensity", i);
+		light.specularIntensity = glGetUniformLocation(program, name);
+	}
+}
+
+/***********************************************************
+ *  LoadShapeMesh()
+ *
+ *  This method is used for uploading the optimized triangles
+ *  of a basic shape into its own vertex array, with the
+ *  position, normal and texture coordinates in attributes 0
+ *  to 2 as the scene shader reads them.
+ ***********************************************************/
+void SceneManager::LoadShapeMesh(MESH_TYPE mesh)
+{
+	const ShapeGeometry::GEOMETRY& geometry = ShapeGeometry::GetMeshGeometry(mesh);
+	SHAPE_MESH& shape = m_shapeMeshes[mesh];
+	if (0 != shape.vertexArray)
+	{
+		return;
+	}
+
+	glGenVertexArrays(1, &shape.vertexArray);
+	glBindVertexArray(shape.vertexArray);
+	glGenBuffers(1, &shape.vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, shape.vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(geometry.vertices.size() * sizeof(ShapeGeometry::VERTEX)), geometry.vertices.data(), GL_STATIC_DRAW);
+	glGenBuffers(1, &shape.indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(geometry.indices.size() * sizeof(uint32_t)), geometry.indices.data(), GL_STATIC_DRAW);
+	shape.indexCount = (GLsizei)geometry.indices.size();
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, normal));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, UV));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  DestroyShapeMeshes()
+ ***********************************************************/
+void SceneManager::DestroyShapeMeshes()
+{
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		SHAPE_MESH& shape = m_shapeMeshes[i];
+		if (0 != shape.vertexArray)
+		{
+			glDeleteVertexArrays(1, &shape.vertexArray);
+			glDeleteBuffers(1, &shape.vertexBuffer);
+			glDeleteBuffers(1, &shape.indexBuffer);
+		}
+		shape = SHAPE_MESH();
+	}
+}
+
+/***********************************************************
+ *  SubmitFramePacket()
+ *
+ *  This method is used for sending the draws recorded during
+ *  the frame to OpenGL in the order they were recorded, with
+ *  their shader settings sent by the selected strategy.  All
+ *  strategies render the same image.
+ ***********************************************************/
+void SceneManager::SubmitFramePacket()
+{
+	ProfileZone zone("SubmitFramePacket");
+
+	if (m_renderMode == RENDER_DEPTH_PREPASS)
+	{
+		SubmitDepthPrepass();
+		// the shaded pass draws the fragments at the laid down depth
+		glDepthFunc(GL_LEQUAL);
+	}
+
+	const DRAW_COMMAND* pLastSent = NULL;
+	for (const DRAW_COMMAND& command : m_framePacket)
+	{
+		glUniformMatrix4fv(m_uniforms.model, 1, GL_FALSE, glm::value_ptr(command.model));
+
+		switch (m_submitStrategy)
+		{
+		case SUBMIT_FULL_STATE:
+			SubmitFullState(command);
+			break;
+		case SUBMIT_FILTERED_STATE:
+			SubmitFilteredState(command, pLastSent);
+			break;
+		default:
+			SubmitChangedState(command);
+			break;
+		}
+
+		if (DrawBasicMesh(command) == true)
+		{
+			m_drawCallCount++;
+		}
+	}
+
+	if (m_renderMode == RENDER_DEPTH_PREPASS)
+	{
+		glDepthFunc(GL_LESS);
+	}
+}
+
+/***********************************************************
+ *  CreateDepthProgram()
+ *
+ *  This method is used for building the depth-only program of
+ *  the pre-pass when the pre-pass is selected, so it is made
+ *  with the scene's other resources rather than in a frame.
+ ***********************************************************/
+void SceneManager::CreateDepthProgram()
+{
+	if (0 != m_depthProgram)
+	{
+		return;
+	}
+
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &g_DepthVertexShader, NULL);
+	glCompileShader(vertexShader);
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &g_DepthFragmentShader, NULL);
+	glCompileShader(fragmentShader);
+
+	m_depthProgram = glCreateProgram();
+	glAttachShader(m_depthProgram, vertexShader);
+	glAttachShader(m_depthProgram, fragmentShader);
+	glLinkProgram(m_depthProgram);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(m_depthProgram, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE)
+	{
+		std::cout << "ERROR: Depth pre-pass program failed to link" << std::endl;
+	}
+	m_depthModelLocation = glGetUniformLocation(m_depthProgram, g_ModelName);
+	m_depthViewLocation = glGetUniformLocation(m_depthProgram, "view");
+	m_depthProjectionLocation = glGetUniformLocation(m_depthProgram, "projection");
+}
+
+/***********************************************************
+ *  SubmitDepthPrepass()
+ *
+ *  This method is used for drawing the depth of the opaque
+ *  recorded draws with a program that shades nothing.  The
+ *  draws blended with a color alpha below one are left out,
+ *  so what is behind them is still shaded.
+ ***********************************************************/
+void SceneManager::SubmitDepthPrepass()
+{
+	ProfileZone zone("DepthPrepass");
+
+	GLint sceneProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &sceneProgram);
+
+	glUseProgram(m_depthProgram);
+	glUniformMatrix4fv(m_depthViewLocation, 1, GL_FALSE, glm::value_ptr(m_view));
+	glUniformMatrix4fv(m_depthProjectionLocation, 1, GL_FALSE, glm::value_ptr(m_projection));
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+	for (const DRAW_COMMAND& command : m_framePacket)
+	{
+		if ((command.bUseTexture == false) && (command.color.a < 1.0f))
+		{
+			continue;
+		}
+
+		glUniformMatrix4fv(m_depthModelLocation, 1, GL_FALSE, glm::value_ptr(command.model));
+		if (DrawBasicMesh(command) == true)
+		{
+			m_drawCallCount++;
+		}
+	}
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glUseProgram(sceneProgram);
+}
+
+/***********************************************************
+ *  DrawBasicMesh()
+ *
+ *  This method is used for drawing the mesh of a draw, one of
+ *  the loaded basic shape meshes or a static batch, returning
+ *  false for an unknown mesh.
+ ***********************************************************/
+bool SceneManager::DrawBasicMesh(const DRAW_COMMAND& command)
+{
+	switch (command.mesh)
+	{
+	case MESH_PLANE:
+	case MESH_BOX:
+	case MESH_CYLINDER:
+	case MESH_TORUS:
+		glBindVertexArray(m_shapeMeshes[command.mesh].vertexArray);
+		glDrawElements(GL_TRIANGLES, m_shapeMeshes[command.mesh].indexCount, GL_UNSIGNED_INT, NULL);
+		glBindVertexArray(0);
+		break;
+	case MESH_STATIC_BATCH:
+		m_pStaticBatches->Draw(command.batch);
+		break;
+	default:
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SubmitChangedState()
+ *
+ *  This method is used for sending the shader settings that
+ *  the setters changed before the draw, the same as when the
+ *  setters called OpenGL directly.
+ ***********************************************************/
+void SceneManager::SubmitChangedState(const DRAW_COMMAND& command)
+{
+	if (command.stateBits & (DRAW_STATE_COLOR | DRAW_STATE_TEXTURE))
+	{
+		glUniform1i(m_uniforms.useTexture, command.bUseTexture);
+	}
+	if (command.stateBits & DRAW_STATE_COLOR)
+	{
+		glUniform4fv(m_uniforms.objectColor, 1, glm::value_ptr(command.color));
+	}
+	if (command.stateBits & DRAW_STATE_TEXTURE)
+	{
+		glUniform1i(m_uniforms.objectTexture, command.textureSlot);
+	}
+	if (command.stateBits & DRAW_STATE_MATERIAL)
+	{
+		SubmitMaterial(command.materialIndex);
+	}
+	if (command.stateBits & DRAW_STATE_UVSCALE)
+	{
+		glUniform2fv(m_uniforms.UVscale, 1, glm::value_ptr(command.UVscale));
+	}
+}
+
+/***********************************************************
+ *  SubmitFullState()
+ *
+ *  This method is used for sending every shader setting of
+ *  the draw, whether or not it changed.
+ ***********************************************************/
+void SceneManager::SubmitFullState(const DRAW_COMMAND& command)
+{
+	glUniform1i(m_uniforms.useTexture, command.bUseTexture);
+	glUniform4fv(m_uniforms.objectColor, 1, glm::value_ptr(command.color));
+	glUniform1i(m_uniforms.objectTexture, command.textureSlot);
+	SubmitMaterial(command.materialIndex);
+	glUniform2fv(m_uniforms.UVscale, 1, glm::value_ptr(command.UVscale));
+}
+
+/***********************************************************
+ *  SubmitFilteredState()
+ *
+ *  This method is used for sending the shader settings of the
+ *  draw whose values differ from the ones sent for the last
+ *  draw, so repeated settings cost nothing.  The first draw
+ *  of the frame sends everything.
+ ***********************************************************/
+void SceneManager::SubmitFilteredState(const DRAW_COMMAND& command, const DRAW_COMMAND*& pLastSent)
+{
+	if (NULL == pLastSent)
+	{
+		SubmitFullState(command);
+		pLastSent = &command;
+		return;
+	}
+
+	if (command.bUseTexture != pLastSent->bUseTexture)
+	{
+		glUniform1i(m_uniforms.useTexture, command.bUseTexture);
+	}
+	if (command.color != pLastSent->color)
+	{
+		glUniform4fv(m_uniforms.objectColor, 1, glm::value_ptr(command.color));
+	}
+	if (command.textureSlot != pLastSent->textureSlot)
+	{
+		glUniform1i(m_uniforms.objectTexture, command.textureSlot);
+	}
+	if (command.materialIndex != pLastSent->materialIndex)
+	{
+		SubmitMaterial(command.materialIndex);
+	}
+	if (command.UVscale != pLastSent->UVscale)
+	{
+		glUniform2fv(m_uniforms.UVscale, 1, glm::value_ptr(command.UVscale));
+	}
+	pLastSent = &command;
+}
+
+/***********************************************************
+ *  SubmitMaterial()
+ *
+ *  This method is used for passing the values of a defined
+ *  material into the shader.
+ ***********************************************************/
+void SceneManager::SubmitMaterial(int materialIndex)
+{
+	if ((materialIndex < 0) || (materialIndex >= (int)m_objectMaterials.size()))
+	{
+		return;
+	}
+
+	const OBJECT_MATERIAL& material = m_objectMaterials[materialIndex];
+	glUniform3fv(m_uniforms.ambientColor, 1, glm::value_ptr(material.ambientColor));
+	glUniform1f(m_uniforms.ambientStrength, material.ambientStrength);
+	glUniform3fv(m_uniforms.diffuseColor, 1, glm::value_ptr(material.diffuseColor));
+	glUniform3fv(m_uniforms.specularColor, 1, glm::value_ptr(material.specularColor));
+	glUniform1f(m_uniforms.shininess, material.shininess);
+}
+
+/***********************************************************
+ *  DrawFramePacketGeometry()
+ *
+ *  This method is used for drawing the meshes of the last
+ *  recorded frame packet again with the program that is in
+ *  use, setting only the model matrix.  Debug views use it to
+ *  rasterize the scene's geometry with their own shaders.
+ ***********************************************************/
+void SceneManager::DrawFramePacketGeometry(GLint modelLocation)
+{
+	for (const DRAW_COMMAND& command : m_framePacket)
+	{
+		glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(command.model));
+		DrawBasicMesh(command);
+	}
+}
+
+/***********************************************************
+ *  GetSubmitStrategyName()
+ *
+ *  This method is used for getting the name of a submission
+ *  strategy, as used on the command line and in the cache.
+ ***********************************************************/
+const char* SceneManager::GetSubmitStrategyName(SUBMIT_STRATEGY strategy)
+{
+	switch (strategy)
+	{
+	case SUBMIT_CHANGED_STATE:
+		return("changed");
+	case SUBMIT_FULL_STATE:
+		return("full");
+	case SUBMIT_FILTERED_STATE:
+		return("filtered");
+	default:
+		return("unknown");
+	}
+}
+
+/***********************************************************
+ *  FindSubmitStrategy()
+ *
+ *  This method is used for getting the submission strategy
+ *  with the passed in name.
+ ***********************************************************/
+bool SceneManager::FindSubmitStrategy(const char* name, SUBMIT_STRATEGY& strategy)
+{
+	for (int i = 0; i < SUBMIT_STRATEGY_COUNT; i++)
+	{
+		if (strcmp(name, GetSubmitStrategyName((SUBMIT_STRATEGY)i)) == 0)
+		{
+			strategy = (SUBMIT_STRATEGY)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  SetRenderMode()
+ ***********************************************************/
+void SceneManager::SetRenderMode(RENDER_MODE mode)
+{
+	m_renderMode = mode;
+	if (m_renderMode == RENDER_DEPTH_PREPASS)
+	{
+		CreateDepthProgram();
+	}
+}
+
+/***********************************************************
+ *  GetRenderModeName()
+ *
+ *  This method is used for getting the name of a render mode,
+ *  as used on the command line and in benchmark reports.
+ ***********************************************************/
+const char* SceneManager::GetRenderModeName(RENDER_MODE mode)
+{
+	switch (mode)
+	{
+	case RENDER_FORWARD:
+		return("forward");
+	case RENDER_DEPTH_PREPASS:
+		return("depth_prepass");
+	default:
+		return("unknown");
+	}
+}
+
+/***********************************************************
+ *  FindRenderMode()
+ *
+ *  This method is used for getting the render mode with the
+ *  passed in name.
+ ***********************************************************/
+bool SceneManager::FindRenderMode(const char* name, RENDER_MODE& mode)
+{
+	for (int i = 0; i < RENDER_MODE_COUNT; i++)
+	{
+		if (strcmp(name, GetRenderModeName((RENDER_MODE)i)) == 0)
+		{
+			mode = (RENDER_MODE)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetSceneDrawCount()
+ *
+ *  This method is used for getting the draws a frame records
+ *  when nothing is culled: every baked or compiled object, a
+ *  proxy for each sector of a streamed scene on top, or the
+ *  static batches, objects and prefab parts of a scene file.
+ ***********************************************************/
+uint32_t SceneManager::GetSceneDrawCount() const
+{
+#ifdef SCENE_BAKED
+	return((uint32_t)g_BakedDrawCount);
+#else
+	if (NULL != m_pSceneBinary)
+	{
+		return(m_pSceneBinary->GetObjectCount() +
+			((NULL != m_pSceneStreamer) ? m_pSceneBinary->GetSectorCount() : 0));
+	}
+	return(m_pStaticBatches->GetBatchCount() + m_pSceneObjects->GetCount() + m_pScenePrefabs->GetDrawCount());
+#endif
+}
+
+/***********************************************************
+ *  SetViewMatrices()
+ ***********************************************************/
+void SceneManager::SetViewMatrices(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_view = view;
+	m_projection = projection;
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method is used for reading the scene description
+ *  file in one pass.  Textures are loaded and materials and
+ *  lights are added as they are read, and each object is
+ *  turned straight into its draw command in the retained
+ *  list that RenderScene() records every frame.  Materials
+ *  and textures have to come before the objects using them.
+ ***********************************************************/
+bool SceneManager::LoadSceneFile(const char* filename)
+{
+	SceneFile sceneFile;
+	SceneFile::SCENE_ENTRY entry;
+	std::unordered_set<std::string> objectIDs;
+	std::vector<DRAW_COMMAND> parts;
+	// the draw of the object before in file order, static or not
+	DRAW_COMMAND previous = DRAW_COMMAND();
+	bool bHasPrevious = false;
+
+	if (sceneFile.Open(filename) == false)
+	{
+		std::cout << "Could not read scene file:" << filename << std::endl;
+		return(false);
+	}
+
+	m_objectMaterials.clear();
+	m_lightSources.clear();
+	m_pSceneObjects->Clear();
+	m_sceneObjectIDs.clear();
+	m_pScenePrefabs->Clear();
+	m_pStaticBatches->Clear();
+
+	while (sceneFile.Next(entry) == true)
+	{
+		switch (entry.type)
+		{
+		case SceneFile::ENTRY_TEXTURE:
+			if (m_loadedTextures >= 16)
+			{
+				std::cout << "WARNING: no texture slot left for " << entry.texture.tag << std::endl;
+			}
+			else
+			{
+				CreateGLTexture(entry.texture.path.c_str(), entry.texture.tag);
+			}
+			break;
+
+		case SceneFile::ENTRY_MATERIAL:
+			m_objectMaterials.push_back(entry.material);
+			break;
+
+		case SceneFile::ENTRY_LIGHT:
+			m_lightSources.push_back(entry.light);
+			break;
+
+		case SceneFile::ENTRY_PREFAB:
+			// the parts are resolved like objects, each following
+			// the part before it
+			parts.clear();
+			for (const SceneFile::SCENE_OBJECT& part : entry.prefab.parts)
+			{
+				parts.push_back(MakeSceneDraw(part, parts.empty() ? NULL : &parts.back()));
+				ResolveSceneDraw(part.id, part.texture, part.material, m_objectMaterials, parts.back());
+			}
+			m_pScenePrefabs->AddPrefab(entry.prefab.id, parts);
+			break;
+
+		case SceneFile::ENTRY_OBJECT:
+		{
+			const SceneFile::SCENE_OBJECT& object = entry.object;
+
+			if (objectIDs.insert(object.id).second == false)
+			{
+				std::cout << "WARNING: scene object id " << object.id << " is used more than once" << std::endl;
+			}
+			if (object.prefab.empty() == false)
+			{
+				if (m_pScenePrefabs->AddInstance(object.prefab, SceneFile::GetModelMatrix(object)) == false)
+				{
+					std::cout << "WARNING: scene object " << object.id << " uses unknown prefab " << object.prefab << std::endl;
+				}
+				break;
+			}
+
+			// static objects keep their place in the file order,
+			// so the objects after them keep the same settings
+			DRAW_COMMAND command = MakeSceneDraw(object, (bHasPrevious == true) ? &previous : NULL);
+			ResolveSceneDraw(object.id, object.texture, object.material, m_objectMaterials, command);
+			previous = command;
+			bHasPrevious = true;
+			if (SceneFile::IsStaticObject(object) == true)
+			{
+				m_pStaticBatches->Add(command);
+				break;
+			}
+			m_pSceneObjects->Add(command);
+			m_sceneObjectIDs.push_back(object.id);
+			break;
+		}
+		}
+	}
+
+	if (sceneFile.HasError() == true)
+	{
+		std::cout << "ERROR: " << filename << ", " << sceneFile.GetError() << std::endl;
+		return(false);
+	}
+
+	// bind the loaded textures to their slots
+	BindGLTextures();
+	m_pStaticBatches->Build(m_staticChunkSize);
+	RegisterSceneMemory(m_objectMaterials, m_pSceneObjects, m_pScenePrefabs, m_pStaticBatches);
+	ResetObjectSlots(m_objectSlots, m_pSceneObjects->GetCount());
+
+	// the scene is the first resident one, and holds the
+	// textures it loaded
+	RESIDENT_SCENE scene;
+	scene.filename = filename;
+	scene.objectSlots.firstFree = NO_OBJECT_SLOT;
+	scene.pObjects = NULL;
+	scene.pPrefabs = NULL;
+	scene.pStatic = NULL;
+	scene.bReady = true;
+	scene.bFailed = false;
+	for (int slot = 0; slot < m_loadedTextures; slot++)
+	{
+		AddSceneTextureReference(scene, slot);
+	}
+	m_residentScenes.assign(1, scene);
+	m_activeScene = 0;
+
+	std::cout << "INFO: loaded " << m_pSceneObjects->GetCount() << " objects, "
+		<< m_pStaticBatches->GetObjectCount() << " static objects in "
+		<< m_pStaticBatches->GetBatchCount() << " batches, "
+		<< m_pScenePrefabs->GetInstanceCount() << " prefab instances, "
+		<< m_objectMaterials.size() << " materials and "
+		<< m_lightSources.size() << " lights from " << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ResolveSceneDraw()
+ *
+ *  This method is used for setting the texture slot and the
+ *  material of a scene object's draw from their tags.  The
+ *  material is looked up in the passed in list, which is the
+ *  scene's own.  Unknown tags are reported and left out.
+ ***********************************************************/
+void SceneManager::ResolveSceneDraw(
+	const std::string& id,
+	const std::string& texture,
+	const std::string& material,
+	const std::vector<OBJECT_MATERIAL>& materials,
+	DRAW_COMMAND& command)
+{
+	if (texture.empty() == false)
+	{
+		int slot = FindTextureSlot(texture.c_str());
+		if (slot < 0)
+		{
+			std::cout << "WARNING: scene object " << id << " uses unknown texture " << texture << std::endl;
+		}
+		else
+		{
+			command.textureSlot = slot;
+			command.bUseTexture = true;
+		}
+	}
+	if (material.empty() == false)
+	{
+		int materialIndex = 0;
+		while ((materialIndex < (int)materials.size()) && (materials[materialIndex].tag != material))
+		{
+			materialIndex++;
+		}
+		if (materialIndex >= (int)materials.size())
+		{
+			std::cout << "WARNING: scene object " << id << " uses unknown material " << material << std::endl;
+		}
+		else
+		{
+			command.materialIndex = materialIndex;
+		}
+	}
+}
+
+/***********************************************************
+ *  RegisterSceneMemory()
+ ***********************************************************/
+void SceneManager::RegisterSceneMemory(
+	const std::vector<OBJECT_MATERIAL>& materials,
+	const ObjectStore* pObjects,
+	const PrefabStore* pPrefabs,
+	const StaticBatches* pStatic)
+{
+	if (NULL != materials.data())
+	{
+		MemoryTracker::Register(
+			MemoryTracker::MEMORY_CPU,
+			(uint64_t)(uintptr_t)materials.data(),
+			"materials",
+			"object materials",
+			materials.capacity() * sizeof(OBJECT_MATERIAL));
+	}
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)pObjects,
+		"scene",
+		"scene object chunks",
+		pObjects->GetBytes());
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)pPrefabs,
+		"scene",
+		"scene prefabs and instances",
+		pPrefabs->GetBytes());
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)pStatic,
+		"scene",
+		"static batches",
+		pStatic->GetBytes());
+}
+
+/***********************************************************
+ *  ReleaseSceneMemory()
+ ***********************************************************/
+void SceneManager::ReleaseSceneMemory(
+	const std::vector<OBJECT_MATERIAL>& materials,
+	const ObjectStore* pObjects,
+	const PrefabStore* pPrefabs,
+	const StaticBatches* pStatic)
+{
+	if (NULL != materials.data())
+	{
+		MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)materials.data());
+	}
+	MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)pObjects);
+	MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)pPrefabs);
+	MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)pStatic);
+}
+
+/***********************************************************
+ *  ResetObjectSlots()
+ *
+ *  This method is used for giving each draw of a retained
+ *  list its own slot with a new generation, so the handles of
+ *  the list it replaced no longer match.  Slots beyond the
+ *  draws are put on the free list.
+ ***********************************************************/
+void SceneManager::ResetObjectSlots(OBJECT_SLOTS& objectSlots, size_t drawCount)
+{
+	objectSlots.slots.resize(std::max(objectSlots.slots.size(), drawCount));
+	objectSlots.drawSlots.resize(drawCount);
+	objectSlots.firstFree = NO_OBJECT_SLOT;
+
+	// the free list is built backwards so it hands out the
+	// lowest slots first
+	for (size_t i = objectSlots.slots.size(); i-- > 0; )
+	{
+		if (i < drawCount)
+		{
+			objectSlots.slots[i].index = (uint32_t)i;
+			objectSlots.slots[i].generation = m_nextObjectGeneration++;
+			objectSlots.drawSlots[i] = (uint32_t)i;
+		}
+		else
+		{
+			objectSlots.slots[i].index = objectSlots.firstFree;
+			objectSlots.slots[i].generation = 0;
+			objectSlots.firstFree = (uint32_t)i;
+		}
+	}
+}
+
+/***********************************************************
+ *  AllocateObjectSlot()
+ *
+ *  This method is used for taking a free slot, or a new one
+ *  when none is free, for the draw at the passed in index.
+ ***********************************************************/
+uint32_t SceneManager::AllocateObjectSlot(OBJECT_SLOTS& objectSlots, size_t drawIndex)
+{
+	uint32_t slot = objectSlots.firstFree;
+	if (NO_OBJECT_SLOT == slot)
+	{
+		slot = (uint32_t)objectSlots.slots.size();
+		objectSlots.slots.push_back(OBJECT_SLOT());
+	}
+	else
+	{
+		objectSlots.firstFree = objectSlots.slots[slot].index;
+	}
+
+	objectSlots.slots[slot].index = (uint32_t)drawIndex;
+	objectSlots.slots[slot].generation = m_nextObjectGeneration++;
+	return(slot);
+}
+
+/***********************************************************
+ *  FreeObjectSlot()
+ ***********************************************************/
+void SceneManager::FreeObjectSlot(OBJECT_SLOTS& objectSlots, uint32_t slot)
+{
+	objectSlots.slots[slot].index = objectSlots.firstFree;
+	objectSlots.slots[slot].generation = 0;
+	objectSlots.firstFree = slot;
+}
+
+/***********************************************************
+ *  FindObjectIndex()
+ ***********************************************************/
+bool SceneManager::FindObjectIndex(OBJECT_HANDLE object, uint32_t& index) const
+{
+	if (IsObjectValid(object) == false)
+	{
+		return(false);
+	}
+	index = m_objectSlots.slots[object.slot].index;
+	return(true);
+}
+
+/***********************************************************
+ *  IsObjectValid()
+ ***********************************************************/
+bool SceneManager::IsObjectValid(OBJECT_HANDLE object) const
+{
+	return((object.generation != 0) &&
+		(object.slot < m_objectSlots.slots.size()) &&
+		(m_objectSlots.slots[object.slot].generation == object.generation));
+}
+
+/***********************************************************
+ *  FindObject()
+ *
+ *  This method is used for getting the handle of an object
+ *  of the retained draw list by its id.  The ids are searched
+ *  in draw order, so handles are meant to be looked up once
+ *  and kept.  The handle is invalid when no object matches.
+ ***********************************************************/
+SceneManager::OBJECT_HANDLE SceneManager::FindObject(const char* id) const
+{
+	OBJECT_HANDLE object = { 0, 0 };
+	for (size_t i = 0; i < m_sceneObjectIDs.size(); i++)
+	{
+		if (m_sceneObjectIDs[i].compare(id) == 0)
+		{
+			object.slot = m_objectSlots.drawSlots[i];
+			object.generation = m_objectSlots.slots[object.slot].generation;
+			break;
+		}
+	}
+	return(object);
+}
+
+/***********************************************************
+ *  CreateObject()
+ *
+ *  This method is used for adding an object to the end of
+ *  the retained draw list.  Like a scene file object without
+ *  a texture or material it keeps the ones of the draw before
+ *  until they are set.  Compiled and baked scenes draw from
+ *  their tables and get no objects added.
+ ***********************************************************/
+SceneManager::OBJECT_HANDLE SceneManager::CreateObject(
+	const char* id,
+	MESH_TYPE mesh,
+	const glm::mat4& model,
+	const glm::vec4& color)
+{
+	OBJECT_HANDLE object = { 0, 0 };
+
+#ifdef SCENE_BAKED
+	std::cout << "WARNING: the scene is baked into this build, objects cannot be added" << std::endl;
+	return(object);
+#endif
+	if (NULL != m_pSceneBinary)
+	{
+		std::cout << "WARNING: the scene is compiled, objects cannot be added" << std::endl;
+		return(object);
+	}
+
+	const uint32_t index = m_pSceneObjects->GetCount();
+	DRAW_COMMAND previous = (index > 0) ? m_pSceneObjects->GetDraw(index - 1) : DRAW_COMMAND();
+	const DRAW_COMMAND* pPrevious = (index > 0) ? &previous : NULL;
+	DRAW_COMMAND draw = DRAW_COMMAND();
+	draw.model = model;
+	draw.color = color;
+	draw.UVscale = glm::vec2(1.0f, 1.0f);
+	draw.mesh = mesh;
+	draw.textureSlot = (NULL != pPrevious) ? pPrevious->textureSlot : 0;
+	draw.bUseTexture = false;
+	draw.materialIndex = (NULL != pPrevious) ? pPrevious->materialIndex : -1;
+
+	size_t bytes = m_pSceneObjects->GetBytes();
+	m_pSceneObjects->Add(draw);
+	m_sceneObjectIDs.push_back(id);
+	m_objectSlots.drawSlots.push_back(AllocateObjectSlot(m_objectSlots, index));
+	if (m_pSceneObjects->GetBytes() != bytes)
+	{
+		RegisterSceneMemory(m_objectMaterials, m_pSceneObjects, m_pScenePrefabs, m_pStaticBatches);
+	}
+
+	object.slot = m_objectSlots.drawSlots[index];
+	object.generation = m_objectSlots.slots[object.slot].generation;
+	return(object);
+}
+
+/***********************************************************
+ *  DestroyObject()
+ *
+ *  This method is used for removing an object from the
+ *  retained draw list.  The last draw is moved into its
+ *  place so the list stays packed, and the handle of the
+ *  moved object is pointed at its new position.  This changes
+ *  the draw order: the moved object keeps its own texture and
+ *  material, but it is drawn after a different draw, so the
+ *  settings sent before it change, and the object a later
+ *  CreateObject() takes its texture and material from is the
+ *  new last draw.  The order of the scene file is not kept.
+ ***********************************************************/
+bool SceneManager::DestroyObject(OBJECT_HANDLE object)
+{
+	if (IsObjectValid(object) == false)
+	{
+		return(false);
+	}
+
+	uint32_t index = m_objectSlots.slots[object.slot].index;
+	uint32_t last = m_pSceneObjects->GetCount() - 1;
+	m_pSceneObjects->Remove(index);
+	if (index != last)
+	{
+		m_sceneObjectIDs[index].swap(m_sceneObjectIDs[last]);
+		m_objectSlots.drawSlots[index] = m_objectSlots.drawSlots[last];
+		m_objectSlots.slots[m_objectSlots.drawSlots[index]].index = (uint32_t)index;
+	}
+	m_sceneObjectIDs.pop_back();
+	m_objectSlots.drawSlots.pop_back();
+	FreeObjectSlot(m_objectSlots, object.slot);
+	return(true);
+}
+
+/***********************************************************
+ *  SetObjectTransform()
+ ***********************************************************/
+bool SceneManager::SetObjectTransform(OBJECT_HANDLE object, const glm::mat4& model)
+{
+	uint32_t index = 0;
+	if (FindObjectIndex(object, index) == false)
+	{
+		return(false);
+	}
+
+	m_pSceneObjects->SetTransform(index, model);
+	return(true);
+}
+
+/***********************************************************
+ *  SetObjectMaterial()
+ *
+ *  This method is used for changing the material of an
+ *  object.  The tag is looked up among the scene's few
+ *  materials, an unknown one leaves the object as it was.
+ ***********************************************************/
+bool SceneManager::SetObjectMaterial(OBJECT_HANDLE object, const char* materialTag)
+{
+	uint32_t index = 0;
+	int materialIndex = FindMaterialIndex(materialTag);
+	if ((FindObjectIndex(object, index) == false) || (materialIndex < 0))
+	{
+		return(false);
+	}
+
+	m_pSceneObjects->SetMaterial(index, materialIndex);
+	return(true);
+}
+
+/***********************************************************
+ *  SetObjectTexture()
+ *
+ *  This method is used for changing the texture of an
+ *  object, or for drawing it with its color when the tag is
+ *  NULL.  An unknown tag leaves the object as it was.
+ ***********************************************************/
+bool SceneManager::SetObjectTexture(OBJECT_HANDLE object, const char* textureTag)
+{
+	uint32_t index = 0;
+	int slot = (NULL != textureTag) ? FindTextureSlot(textureTag) : -1;
+	if ((FindObjectIndex(object, index) == false) || ((NULL != textureTag) && (slot < 0)))
+	{
+		return(false);
+	}
+
+	m_pSceneObjects->SetTexture(index, slot);
+	return(true);
+}
+
+/***********************************************************
+ *  ReloadSceneFile()
+ *
+ *  This method is used for applying an edited scene file to
+ *  the loaded scene.  The objects are matched to the loaded
+ *  ones by id and only the changes are applied: draws whose
+ *  transform, material or other settings changed are patched
+ *  in place, and added or removed objects are put in or taken
+ *  out of the draw list.  Loaded textures and meshes stay
+ *  resident, only textures with new tags are loaded, and the
+ *  lights are only sent again when they changed.  A file with
+ *  errors leaves the scene as it was.
+ ***********************************************************/
+bool SceneManager::ReloadSceneFile(const char* filename)
+{
+	SceneBinary::SCENE_SOURCE source;
+	std::string error;
+
+	// baked and compiled scenes draw from their tables, there is
+	// no retained draw list to patch
+#ifdef SCENE_BAKED
+	std::cout << "WARNING: the scene is baked into this build and cannot be reloaded" << std::endl;
+	return(false);
+#endif
+	if (NULL != m_pSceneBinary)
+	{
+		std::cout << "WARNING: " << filename << " is a compiled scene and cannot be reloaded" << std::endl;
+		return(false);
+	}
+
+	if (SceneBinary::ReadSource(filename, source, error) == false)
+	{
+		std::cout << "ERROR: " << filename << ", " << error << ", the scene is left as it was" << std::endl;
+		return(false);
+	}
+
+	// textures are matched by tag, new ones take the next slots
+	int newTextures = 0;
+	for (const SceneFile::SCENE_TEXTURE& texture : source.textures)
+	{
+		if (FindTextureSlot(texture.tag.c_str()) >= 0)
+		{
+			continue;
+		}
+		if (m_loadedTextures >= 16)
+		{
+			std::cout << "WARNING: no texture slot left for " << texture.tag << std::endl;
+		}
+		else if (CreateGLTexture(texture.path.c_str(), texture.tag) == true)
+		{
+			AddSceneTextureReference(m_residentScenes[m_activeScene], m_loadedTextures - 1);
+			newTextures++;
+		}
+	}
+	if (newTextures > 0)
+	{
+		BindGLTextures();
+	}
+
+	// materials are matched by tag and updated in place, so the
+	// indices held by the draws stay valid; a new one can move
+	// the list, so its record is made again after
+	ReleaseSceneMemory(m_objectMaterials, m_pSceneObjects, m_pScenePrefabs, m_pStaticBatches);
+	int changedMaterials = 0;
+	for (const OBJECT_MATERIAL& material : source.materials)
+	{
+		int index = FindMaterialIndex(material.tag.c_str());
+		if (index < 0)
+		{
+			m_objectMaterials.push_back(material);
+			changedMaterials++;
+		}
+		else if ((m_objectMaterials[index].ambientColor != material.ambientColor) ||
+			(m_objectMaterials[index].ambientStrength != material.ambientStrength) ||
+			(m_objectMaterials[index].diffuseColor != material.diffuseColor) ||
+			(m_objectMaterials[index].specularColor != material.specularColor) ||
+			(m_objectMaterials[index].shininess != material.shininess))
+		{
+			m_objectMaterials[index] = material;
+			changedMaterials++;
+		}
+	}
+
+	bool bLightsChanged = (source.lights.size() != m_lightSources.size());
+	for (size_t i = 0; (i < source.lights.size()) && (bLightsChanged == false); i++)
+	{
+		bLightsChanged = (IsSameLight(source.lights[i], m_lightSources[i]) == false);
+	}
+	if (bLightsChanged == true)
+	{
+		m_lightSources = source.lights;
+		SetupSceneLights();
+	}
+
+	// the draws of the edited file, matched to the loaded ones
+	std::unordered_map<std::string, size_t> loadedIndices;
+	loadedIndices.reserve(m_sceneObjectIDs.size());
+	for (size_t i = 0; i < m_sceneObjectIDs.size(); i++)
+	{
+		loadedIndices.emplace(m_sceneObjectIDs[i], i);
+	}
+
+	std::vector<DRAW_COMMAND> draws;
+	std::vector<std::string> drawIDs;
+	std::vector<bool> bSeen(m_pSceneObjects->GetCount(), false);
+	// loaded draw each object matched, or none
+	std::vector<size_t> matches;
+	draws.reserve(source.objects.size());
+	drawIDs.reserve(source.objects.size());
+	matches.reserve(source.objects.size());
+	bool bSameOrder = true;
+	int movedObjects = 0;
+	int reassignedObjects = 0;
+	int otherChanges = 0;
+	int addedObjects = 0;
+	// the static objects are merged again, their batches hold no
+	// handles, but they keep their place in the file order so the
+	// objects after them keep the same settings
+	DRAW_COMMAND previous;
+	m_pStaticBatches->Clear();
+	for (size_t i = 0; i < source.objects.size(); i++)
+	{
+		const SceneFile::SCENE_OBJECT& object = source.objects[i];
+		DRAW_COMMAND draw = MakeSceneDraw(object, (i > 0) ? &previous : NULL);
+		ResolveSceneDraw(object.id, object.texture, object.material, m_objectMaterials, draw);
+		previous = draw;
+		if (SceneFile::IsStaticObject(object) == true)
+		{
+			m_pStaticBatches->Add(draw);
+			continue;
+		}
+		draws.push_back(draw);
+		drawIDs.push_back(object.id);
+
+		auto loaded = loadedIndices.find(object.id);
+		if ((loaded == loadedIndices.end()) || (bSeen[loaded->second] == true))
+		{
+			matches.push_back(SIZE_MAX);
+			addedObjects++;
+			bSameOrder = false;
+			continue;
+		}
+		bSeen[loaded->second] = true;
+		matches.push_back(loaded->second);
+		bSameOrder = bSameOrder && (loaded->second == (draws.size() - 1));
+
+		const DRAW_COMMAND current = m_pSceneObjects->GetDraw((uint32_t)loaded->second);
+		if (current.model != draw.model)
+		{
+			movedObjects++;
+		}
+		if (current.materialIndex != draw.materialIndex)
+		{
+			reassignedObjects++;
+		}
+		if ((current.color != draw.color) || (current.UVscale != draw.UVscale) ||
+			(current.mesh != draw.mesh) || (current.bUseTexture != draw.bUseTexture) ||
+			(current.textureSlot != draw.textureSlot))
+		{
+			otherChanges++;
+		}
+	}
+	m_pStaticBatches->Build(m_staticChunkSize);
+	int removedObjects = (int)std::count(bSeen.begin(), bSeen.end(), false);
+	bSameOrder = bSameOrder && (draws.size() == m_pSceneObjects->GetCount());
+
+	int patchedDraws = 0;
+	if (bSameOrder == true)
+	{
+		// the same objects in the same order, only the draws that
+		// differ are written
+		for (size_t i = 0; i < draws.size(); i++)
+		{
+			if (IsSameDraw(m_pSceneObjects->GetDraw((uint32_t)i), draws[i]) == false)
+			{
+				m_pSceneObjects->SetDraw((uint32_t)i, draws[i]);
+				patchedDraws++;
+			}
+		}
+	}
+	else
+	{
+		// the kept objects keep their handles at their new
+		// positions, the removed ones give theirs back
+		std::vector<uint32_t> drawSlots(draws.size(), NO_OBJECT_SLOT);
+		for (size_t i = 0; i < bSeen.size(); i++)
+		{
+			if (bSeen[i] == false)
+			{
+				FreeObjectSlot(m_objectSlots, m_objectSlots.drawSlots[i]);
+			}
+		}
+		for (size_t i = 0; i < draws.size(); i++)
+		{
+			if (SIZE_MAX != matches[i])
+			{
+				drawSlots[i] = m_objectSlots.drawSlots[matches[i]];
+				m_objectSlots.slots[drawSlots[i]].index = (uint32_t)i;
+			}
+		}
+		m_objectSlots.drawSlots.swap(drawSlots);
+		for (size_t i = 0; i < draws.size(); i++)
+		{
+			if (SIZE_MAX == matches[i])
+			{
+				m_objectSlots.drawSlots[i] = AllocateObjectSlot(m_objectSlots, i);
+			}
+		}
+
+		m_pSceneObjects->Clear();
+		for (const DRAW_COMMAND& draw : draws)
+		{
+			m_pSceneObjects->Add(draw);
+		}
+		m_sceneObjectIDs.swap(drawIDs);
+		patchedDraws = (int)m_pSceneObjects->GetCount();
+	}
+
+	// prefabs are few and their instances hold no handles, so
+	// they are built again from the file
+	std::vector<DRAW_COMMAND> parts;
+	m_pScenePrefabs->Clear();
+	for (const SceneFile::SCENE_PREFAB& prefab : source.prefabs)
+	{
+		parts.clear();
+		for (const SceneFile::SCENE_OBJECT& part : prefab.parts)
+		{
+			parts.push_back(MakeSceneDraw(part, parts.empty() ? NULL : &parts.back()));
+			ResolveSceneDraw(part.id, part.texture, part.material, m_objectMaterials, parts.back());
+		}
+		m_pScenePrefabs->AddPrefab(prefab.id, parts);
+	}
+	for (const SceneFile::SCENE_OBJECT& instance : source.instances)
+	{
+		if (m_pScenePrefabs->AddInstance(instance.prefab, SceneFile::GetModelMatrix(instance)) == false)
+		{
+			std::cout << "WARNING: scene object " << instance.id << " uses unknown prefab " << instance.prefab << std::endl;
+		}
+	}
+	RegisterSceneMemory(m_objectMaterials, m_pSceneObjects, m_pScenePrefabs, m_pStaticBatches);
+
+	std::cout << "INFO: reloaded " << filename << ": "
+		<< movedObjects << " moved, "
+		<< reassignedObjects << " material changes, "
+		<< otherChanges << " other changes, "
+		<< addedObjects << " added, "
+		<< removedObjects << " removed, "
+		<< newTextures << " new textures, "
+		<< changedMaterials << " materials changed, "
+		<< (bLightsChanged ? "lights changed" : "lights unchanged")
+		<< ", " << patchedDraws << " draws written, "
+		<< m_pScenePrefabs->GetInstanceCount() << " prefab instances, "
+		<< m_pStaticBatches->GetBatchCount() << " static batches" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddSceneTextureReference()
+ ***********************************************************/
+void SceneManager::AddSceneTextureReference(RESIDENT_SCENE& scene, int slot)
+{
+	if (std::find(scene.textureSlots.begin(), scene.textureSlots.end(), slot) == scene.textureSlots.end())
+	{
+		scene.textureSlots.push_back(slot);
+		m_textureReferences[slot]++;
+	}
+}
+
+/***********************************************************
+ *  PreloadScene()
+ *
+ *  This method is used for starting to read another scene
+ *  description file on a background thread while the loaded
+ *  scene is drawn.  The meshes and programs are shared by all
+ *  the resident scenes, and textures whose tags are resident
+ *  already are shared rather than loaded again.  A scene that
+ *  is resident or preloading is not read again, and one that
+ *  failed or was unloaded is read into its old entry.  Only
+ *  description files can be preloaded, next to a loaded
+ *  description file.
+ ***********************************************************/
+int SceneManager::PreloadScene(const char* sceneFile)
+{
+	int scene = -1;
+	for (size_t i = 0; i < m_residentScenes.size(); i++)
+	{
+		if (m_residentScenes[i].filename.compare(sceneFile) == 0)
+		{
+			if ((m_residentScenes[i].bReady == true) || ((int)i == m_preloadingScene))
+			{
+				return((int)i);
+			}
+			scene = (int)i;
+		}
+	}
+
+	if (m_residentScenes.empty() == true)
+	{
+		std::cout << "WARNING: only scenes loaded from description files can have other scenes preloaded" << std::endl;
+		return(-1);
+	}
+	if (SceneBinary::IsBinaryScene(sceneFile) == true)
+	{
+		std::cout << "WARNING: " << sceneFile << " is a compiled scene and cannot be preloaded" << std::endl;
+		return(-1);
+	}
+	if ((NULL != m_pScenePreloader) && (m_pScenePreloader->IsBusy() == true))
+	{
+		return(-1);
+	}
+	if (NULL == m_pScenePreloader)
+	{
+		m_pScenePreloader = new ScenePreloader();
+	}
+
+	std::vector<std::string> residentTags;
+	for (int slot = 0; slot < m_loadedTextures; slot++)
+	{
+		if (0 != m_textureIDs[slot].ID)
+		{
+			residentTags.push_back(m_textureIDs[slot].tag);
+		}
+	}
+
+	// the flip is a setting of the image loader, so it is set
+	// before the background thread decodes
+	stbi_set_flip_vertically_on_load(true);
+	m_pScenePreloader->Start(sceneFile, residentTags);
+
+	if (scene < 0)
+	{
+		RESIDENT_SCENE resident;
+		resident.filename = sceneFile;
+		resident.objectSlots.firstFree = NO_OBJECT_SLOT;
+		resident.pObjects = NULL;
+		resident.pPrefabs = NULL;
+		resident.pStatic = NULL;
+		m_residentScenes.push_back(resident);
+		scene = (int)m_residentScenes.size() - 1;
+	}
+	m_residentScenes[scene].bReady = false;
+	m_residentScenes[scene].bFailed = false;
+	m_preloadingScene = scene;
+
+	std::cout << "INFO: preloading " << sceneFile << " in the background" << std::endl;
+	return(scene);
+}
+
+/***********************************************************
+ *  UpdatePreloading()
+ *
+ *  This method is used for finishing the preloaded scene once
+ *  the background thread has read it.  One decoded texture is
+ *  uploaded a frame, so the uploads are spread over the frames,
+ *  and the scene is built in the frame after the last one.
+ ***********************************************************/
+void SceneManager::UpdatePreloading()
+{
+	if ((m_preloadingScene < 0) || (m_pScenePreloader->IsFinished() == false))
+	{
+		return;
+	}
+
+	ProfileZone zone("ScenePreload");
+
+	if (m_pScenePreloader->HasSucceeded() == false)
+	{
+		std::cout << "ERROR: " << m_pScenePreloader->GetFilename() << ", "
+			<< m_pScenePreloader->GetError() << ", the scene was not preloaded" << std::endl;
+		m_residentScenes[m_preloadingScene].bFailed = true;
+		m_preloadingScene = -1;
+		m_pScenePreloader->Reset();
+		return;
+	}
+
+	ScenePreloader::DECODED_IMAGE image;
+	if (m_pScenePreloader->TakeImage(image) == true)
+	{
+		if (FindTextureSlot(image.tag.c_str()) < 0)
+		{
+			size_t bytes = 0;
+			if (AddTextureToFreeSlot(image.pPixels, image.width, image.height, image.channels, image.tag, bytes) < 0)
+			{
+				std::cout << "WARNING: no texture slot left for " << image.tag << std::endl;
+			}
+		}
+		ScenePreloader::FreeImage(image);
+		return;
+	}
+
+	FinishPreloadedScene();
+}
+
+/***********************************************************
+ *  FinishPreloadedScene()
+ *
+ *  This method is used for building the preloaded scene from
+ *  the file the background thread read, the same way as the
+ *  scene file loader does.  Its textures are counted by the
+ *  slots they were uploaded to or already had; a texture that
+ *  was freed after the file was started is loaded here.
+ ***********************************************************/
+void SceneManager::FinishPreloadedScene()
+{
+	const SceneBinary::SCENE_SOURCE& source = m_pScenePreloader->GetSource();
+	RESIDENT_SCENE& scene = m_residentScenes[m_preloadingScene];
+	DRAW_COMMAND previous = DRAW_COMMAND();
+
+	bool bNewTextures = false;
+	for (const SceneFile::SCENE_TEXTURE& texture : source.textures)
+	{
+		int slot = FindTextureSlot(texture.tag.c_str());
+		if ((slot < 0) && (m_loadedTextures < 16) &&
+			(CreateGLTexture(texture.path.c_str(), texture.tag) == true))
+		{
+			slot = m_loadedTextures - 1;
+			bNewTextures = true;
+		}
+		if (slot >= 0)
+		{
+			AddSceneTextureReference(scene, slot);
+		}
+	}
+	if (bNewTextures == true)
+	{
+		BindGLTextures();
+	}
+
+	scene.materials = source.materials;
+	scene.lights = source.lights;
+	if (NULL == scene.pObjects)
+	{
+		scene.pObjects = new ObjectStore();
+	}
+	scene.pObjects->Clear();
+	scene.objectIDs.clear();
+	scene.objectIDs.reserve(source.objects.size());
+	if (NULL == scene.pStatic)
+	{
+		scene.pStatic = new StaticBatches();
+	}
+	scene.pStatic->Clear();
+	for (size_t i = 0; i < source.objects.size(); i++)
+	{
+		const SceneFile::SCENE_OBJECT& object = source.objects[i];
+		DRAW_COMMAND draw = MakeSceneDraw(object, (i > 0) ? &previous : NULL);
+		ResolveSceneDraw(object.id, object.texture, object.material, scene.materials, draw);
+		previous = draw;
+		if (SceneFile::IsStaticObject(object) == true)
+		{
+			scene.pStatic->Add(draw);
+			continue;
+		}
+		scene.pObjects->Add(draw);
+		scene.objectIDs.push_back(object.id);
+	}
+	ResetObjectSlots(scene.objectSlots, scene.pObjects->GetCount());
+
+	std::vector<DRAW_COMMAND> parts;
+	if (NULL == scene.pPrefabs)
+	{
+		scene.pPrefabs = new PrefabStore();
+	}
+	scene.pPrefabs->Clear();
+	for (const SceneFile::SCENE_PREFAB& prefab : source.prefabs)
+	{
+		parts.clear();
+		for (const SceneFile::SCENE_OBJECT& part : prefab.parts)
+		{
+			parts.push_back(MakeSceneDraw(part, parts.empty() ? NULL : &parts.back()));
+			ResolveSceneDraw(part.id, part.texture, part.material, scene.materials, parts.back());
+		}
+		scene.pPrefabs->AddPrefab(prefab.id, parts);
+	}
+	for (const SceneFile::SCENE_OBJECT& instance : source.instances)
+	{
+		if (scene.pPrefabs->AddInstance(instance.prefab, SceneFile::GetModelMatrix(instance)) == false)
+		{
+			std::cout << "WARNING: scene object " << instance.id << " uses unknown prefab " << instance.prefab << std::endl;
+		}
+	}
+
+	scene.pStatic->Build(m_staticChunkSize);
+	RegisterSceneMemory(scene.materials, scene.pObjects, scene.pPrefabs, scene.pStatic);
+	scene.bReady = true;
+
+	std::cout << "INFO: preloaded " << scene.pObjects->GetCount() << " objects, "
+		<< scene.pStatic->GetObjectCount() << " static objects in "
+		<< scene.pStatic->GetBatchCount() << " batches, "
+		<< scene.pPrefabs->GetInstanceCount() << " prefab instances, "
+		<< scene.materials.size() << " materials and "
+		<< scene.lights.size() << " lights from " << scene.filename << std::endl;
+
+	m_preloadingScene = -1;
+	m_pScenePreloader->Reset();
+}
+
+/***********************************************************
+ *  IsSceneReady()
+ ***********************************************************/
+bool SceneManager::IsSceneReady(int scene) const
+{
+	return((scene >= 0) && (scene < (int)m_residentScenes.size()) &&
+		(m_residentScenes[scene].bReady == true));
+}
+
+/***********************************************************
+ *  HasSceneFailed()
+ ***********************************************************/
+bool SceneManager::HasSceneFailed(int scene) const
+{
+	return((scene >= 0) && (scene < (int)m_residentScenes.size()) &&
+		(m_residentScenes[scene].bFailed == true));
+}
+
+/***********************************************************
+ *  SwitchScene()
+ *
+ *  This method is used for drawing another resident scene.
+ *  The draws, materials and lights of the scene being drawn
+ *  are swapped into its entry and the new scene's into their
+ *  place, so no draw is rebuilt, nothing is loaded and
+ *  nothing is allocated; only the lights are sent again.
+ ***********************************************************/
+bool SceneManager::SwitchScene(int scene)
+{
+	if (IsSceneReady(scene) == false)
+	{
+		return(false);
+	}
+	if (scene == m_activeScene)
+	{
+		return(true);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	RESIDENT_SCENE& current = m_residentScenes[m_activeScene];
+	current.materials.swap(m_objectMaterials);
+	current.lights.swap(m_lightSources);
+	std::swap(current.pObjects, m_pSceneObjects);
+	current.objectIDs.swap(m_sceneObjectIDs);
+	std::swap(current.pPrefabs, m_pScenePrefabs);
+	std::swap(current.pStatic, m_pStaticBatches);
+	std::swap(current.objectSlots, m_objectSlots);
+
+	RESIDENT_SCENE& next = m_residentScenes[scene];
+	next.materials.swap(m_objectMaterials);
+	next.lights.swap(m_lightSources);
+	std::swap(next.pObjects, m_pSceneObjects);
+	next.objectIDs.swap(m_sceneObjectIDs);
+	std::swap(next.pPrefabs, m_pScenePrefabs);
+	std::swap(next.pStatic, m_pStaticBatches);
+	std::swap(next.objectSlots, m_objectSlots);
+	m_activeScene = scene;
+
+	// the memory of both scenes was recorded when they were
+	// built, by their stores, so only the lights are sent
+	SetupSceneLights();
+
+	std::cout << "INFO: switched to " << next.filename << " in "
+		<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+		<< " ms" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  UnloadScene()
+ *
+ *  This method is used for freeing a resident scene that is
+ *  not drawn.  The textures no other resident scene uses give
+ *  up their slots.  The entry is kept, so the indices of the
+ *  other scenes stay valid, and preloading the file again
+ *  reuses it.
+ ***********************************************************/
+bool SceneManager::UnloadScene(int scene)
+{
+	if ((IsSceneReady(scene) == false) || (scene == m_activeScene))
+	{
+		return(false);
+	}
+
+	RESIDENT_SCENE& resident = m_residentScenes[scene];
+	ReleaseSceneMemory(resident.materials, resident.pObjects, resident.pPrefabs, resident.pStatic);
+	for (int slot : resident.textureSlots)
+	{
+		if (--m_textureReferences[slot] == 0)
+		{
+			ReleaseTextureSlot(slot);
+		}
+	}
+	resident.textureSlots.clear();
+	std::vector<OBJECT_MATERIAL>().swap(resident.materials);
+	std::vector<LIGHT_SOURCE>().swap(resident.lights);
+	delete resident.pObjects;
+	resident.pObjects = NULL;
+	std::vector<std::string>().swap(resident.objectIDs);
+	delete resident.pPrefabs;
+	resident.pPrefabs = NULL;
+	delete resident.pStatic;
+	resident.pStatic = NULL;
+	resident.objectSlots = OBJECT_SLOTS();
+	resident.objectSlots.firstFree = NO_OBJECT_SLOT;
+	resident.bReady = false;
+
+	return(true);
+}
+
+/***********************************************************
+ *  LoadSceneTexture()
+ *
+ *  This method is used for loading a texture of a compiled or
+ *  baked scene and keeping the slot its index maps to.  When
+ *  a texture is missing its objects are drawn with their
+ *  colors, and the precomputed state bits no longer hold.
+ ***********************************************************/
+void SceneManager::LoadSceneTexture(int index, const char* path, const char* tag)
+{
+	if ((m_loadedTextures < 16) && (CreateGLTexture(path, tag) == true))
+	{
+		m_sceneTextureSlots[index] = m_loadedTextures - 1;
+	}
+	else
+	{
+		std::cout << "WARNING: scene texture " << tag << " is drawn with its object colors" << std::endl;
+		m_bSceneFullState = true;
+	}
+}
+
+/***********************************************************
+ *  LoadSceneBinary()
+ *
+ *  This method is used for mapping a scene compiled by the
+ *  SceneCompiler tool.  Only its textures, materials and
+ *  lights are loaded, the object arrays are used where they
+ *  are mapped, so the load time does not grow with the
+ *  number of objects.  When streaming, the sectors and their
+ *  textures are left to the streaming threads.
+ ***********************************************************/
+bool SceneManager::LoadSceneBinary(const char* filename)
+{
+	if (NULL == m_pSceneBinary)
+	{
+		m_pSceneBinary = new SceneBinary();
+	}
+	if (m_pSceneBinary->Open(filename) == false)
+	{
+		std::cout << "ERROR: " << filename << ", " << m_pSceneBinary->GetError() << std::endl;
+		delete m_pSceneBinary;
+		m_pSceneBinary = NULL;
+		return(false);
+	}
+
+	m_objectMaterials.clear();
+	m_lightSources.clear();
+	m_pSceneObjects->Clear();
+	m_sceneObjectIDs.clear();
+	m_pScenePrefabs->Clear();
+	m_pStaticBatches->Clear();
+	m_sceneTextureSlots.assign(m_pSceneBinary->GetTextureCount(), -1);
+	m_bSceneFullState = false;
+
+	bool bStreaming = (m_streamBudgetBytes > 0);
+	if ((bStreaming == true) && (m_pSceneBinary->GetSectorCount() < 2))
+	{
+		std::cout << "WARNING: " << filename << " is a single sector, compile it with --sector-size to stream it" << std::endl;
+		bStreaming = false;
+	}
+
+	const SceneBinary::BINARY_TEXTURE* pTextures = m_pSceneBinary->GetTextures();
+	for (uint32_t i = 0; (i < m_pSceneBinary->GetTextureCount()) && (bStreaming == false); i++)
+	{
+		LoadSceneTexture(i,
+			m_pSceneBinary->GetString(pTextures[i].path),
+			m_pSceneBinary->GetString(pTextures[i].tag));
+	}
+
+	const SceneBinary::BINARY_MATERIAL* pMaterials = m_pSceneBinary->GetMaterials();
+	for (uint32_t i = 0; i < m_pSceneBinary->GetMaterialCount(); i++)
+	{
+		OBJECT_MATERIAL material;
+		material.ambientColor = glm::make_vec3(pMaterials[i].ambientColor);
+		material.ambientStrength = pMaterials[i].ambientStrength;
+		material.diffuseColor = glm::make_vec3(pMaterials[i].diffuseColor);
+		material.specularColor = glm::make_vec3(pMaterials[i].specularColor);
+		material.shininess = pMaterials[i].shininess;
+		material.tag = m_pSceneBinary->GetString(pMaterials[i].tag);
+		m_objectMaterials.push_back(material);
+	}
+
+	const SceneBinary::BINARY_LIGHT* pLights = m_pSceneBinary->GetLights();
+	for (uint32_t i = 0; i < m_pSceneBinary->GetLightCount(); i++)
+	{
+		LIGHT_SOURCE light;
+		light.position = glm::make_vec3(pLights[i].position);
+		light.ambientColor = glm::make_vec3(pLights[i].ambientColor);
+		light.diffuseColor = glm::make_vec3(pLights[i].diffuseColor);
+		light.specularColor = glm::make_vec3(pLights[i].specularColor);
+		light.focalStrength = pLights[i].focalStrength;
+		light.specularIntensity = pLights[i].specularIntensity;
+		light.radius = pLights[i].radius;
+		m_lightSources.push_back(light);
+	}
+
+	// bind the loaded textures to their slots
+	BindGLTextures();
+
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)&m_objectMaterials,
+		"materials",
+		"object materials",
+		m_objectMaterials.capacity() * sizeof(OBJECT_MATERIAL));
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)m_pSceneBinary,
+		"scene",
+		"mapped compiled scene",
+		m_pSceneBinary->GetFileBytes());
+
+	std::cout << "INFO: mapped " << m_pSceneBinary->GetObjectCount() << " objects, "
+		<< m_objectMaterials.size() << " materials and "
+		<< m_lightSources.size() << " lights from " << filename << std::endl;
+
+	if (bStreaming == true)
+	{
+		// by default a sector is loaded once the camera is within
+		// two sectors of it, and kept for another half sector
+		SceneStreamer::STREAM_SETTINGS settings;
+		settings.budgetBytes = m_streamBudgetBytes;
+		settings.loadRadius = (m_streamRadius > 0.0f) ? m_streamRadius : 2.0f * m_pSceneBinary->GetSectorSize();
+		settings.unloadMargin = 0.25f * settings.loadRadius;
+		settings.lookAheadSeconds = 1.0f;
+		settings.threadCount = 2;
+
+		m_pSceneStreamer = new SceneStreamer();
+		m_pSceneStreamer->Start(filename, m_pSceneBinary, settings);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  RecordObjectArrays()
+ *
+ *  This method is used for recording a draw for each object
+ *  of a compiled scene, straight from its arrays, either the
+ *  mapped ones or those of a streamed sector.  Indices are
+ *  checked here rather than at load, so a load does not have
+ *  to read every page of the file.
+ ***********************************************************/
+void SceneManager::RecordObjectArrays(const OBJECT_ARRAYS& arrays, bool bFullState)
+{
+	const uint32_t objectCount = arrays.count;
+	const glm::mat4* pTransforms = arrays.pTransforms;
+	const glm::vec4* pColors = arrays.pColors;
+	const glm::vec2* pUVScales = arrays.pUVScales;
+	const uint32_t* pMeshes = arrays.pMeshes;
+	const int32_t* pMaterialIDs = arrays.pMaterialIDs;
+	const int32_t* pTextureIDs = arrays.pTextureIDs;
+	const uint32_t* pStateBits = arrays.pStateBits;
+	const int textureCount = (int)m_sceneTextureSlots.size();
+	const int materialCount = (int)m_objectMaterials.size();
+
+	DRAW_COMMAND command = DRAW_COMMAND();
+	command.textureSlot = 0;
+	for (uint32_t i = 0; i < objectCount; i++)
+	{
+		int textureID = pTextureIDs[i];
+		int slot = ((textureID >= 0) && (textureID < textureCount)) ? m_sceneTextureSlots[textureID] : -1;
+
+		command.model = pTransforms[i];
+		command.color = pColors[i];
+		command.UVscale = pUVScales[i];
+		command.mesh = (pMeshes[i] < MESH_COUNT) ? (MESH_TYPE)pMeshes[i] : MESH_COUNT;
+		command.materialIndex = ((pMaterialIDs[i] >= 0) && (pMaterialIDs[i] < materialCount)) ? pMaterialIDs[i] : -1;
+		// an untextured draw keeps the slot of the one before
+		command.textureSlot = (slot >= 0) ? slot : command.textureSlot;
+		command.bUseTexture = (slot >= 0);
+		command.stateBits = (bFullState == true) ?
+			(DRAW_STATE_COLOR | DRAW_STATE_TEXTURE | DRAW_STATE_MATERIAL | DRAW_STATE_UVSCALE) :
+			pStateBits[i];
+		m_framePacket.push_back(command);
+	}
+}
+
+/***********************************************************
+ *  RecordSceneObjects()
+ *
+ *  This method is used for recording the objects of the
+ *  retained scene that the last Cull() left visible, chunk by
+ *  chunk.  Since culled objects are left out, the state bits
+ *  are worked out against the draw recorded before, which is
+ *  what the setters would have changed.
+ ***********************************************************/
+void SceneManager::RecordSceneObjects()
+{
+	DRAW_COMMAND command = DRAW_COMMAND();
+	for (uint32_t chunkIndex = 0; chunkIndex < m_pSceneObjects->GetChunkCount(); chunkIndex++)
+	{
+		const ObjectStore::CHUNK& chunk = m_pSceneObjects->GetChunk(chunkIndex);
+		const uint32_t objectCount = m_pSceneObjects->GetChunkObjectCount(chunkIndex);
+
+		for (uint32_t i = 0; i < objectCount; i++)
+		{
+			if (0 == chunk.visible[i])
+			{
+				continue;
+			}
+
+			command.model = chunk.transforms[i];
+			command.color = chunk.colors[i];
+			command.UVscale = chunk.UVscales[i];
+			command.mesh = (MESH_TYPE)chunk.meshes[i];
+			command.textureSlot = chunk.textureSlots[i];
+			command.materialIndex = chunk.materialIDs[i];
+			command.bUseTexture = ((chunk.flags[i] & ObjectStore::FLAG_TEXTURED) != 0);
+			command.stateBits = SceneFile::GetStateBits(
+				m_framePacket.empty() ? NULL : &m_framePacket.back(),
+				command);
+			m_framePacket.push_back(command);
+		}
+	}
+}
+
+/***********************************************************
+ *  RecordStaticBatches()
+ *
+ *  This method is used for recording the visible static
+ *  batches.  They are recorded first, so the large static
+ *  geometry lays down its depth before the objects.
+ ***********************************************************/
+void SceneManager::RecordStaticBatches()
+{
+	for (uint32_t batch = 0; batch < m_pStaticBatches->GetBatchCount(); batch++)
+	{
+		if (m_pStaticBatches->IsVisible(batch) == false)
+		{
+			continue;
+		}
+
+		DRAW_COMMAND command = m_pStaticBatches->GetBatch(batch).draw;
+		command.stateBits = SceneFile::GetStateBits(
+			m_framePacket.empty() ? NULL : &m_framePacket.back(),
+			command);
+		m_framePacket.push_back(command);
+	}
+}
+
+/***********************************************************
+ *  GetStaticBatchBounds()
+ ***********************************************************/
+void SceneManager::GetStaticBatchBounds(uint32_t batch, glm::vec3& boundsMin, glm::vec3& boundsMax) const
+{
+	boundsMin = m_pStaticBatches->GetBatch(batch).boundsMin;
+	boundsMax = m_pStaticBatches->GetBatch(batch).boundsMax;
+}
+
+/***********************************************************
+ *  RecordScenePrefabs()
+ *
+ *  This method is used for expanding the visible prefab
+ *  instances into draws of their parts.  The instances are
+ *  walked part by part, so the draws of one part follow each
+ *  other with the same mesh, texture and material, and their
+ *  state bits only ask for the model matrix.
+ ***********************************************************/
+void SceneManager::RecordScenePrefabs()
+{
+	const uint32_t* pVisible = m_pScenePrefabs->GetVisibleInstances();
+	for (uint32_t prefabIndex = 0; prefabIndex < m_pScenePrefabs->GetPrefabCount(); prefabIndex++)
+	{
+		const PrefabStore::PREFAB& prefab = m_pScenePrefabs->GetPrefab(prefabIndex);
+		for (uint32_t part = 0; (part < prefab.partCount) && (prefab.visibleCount > 0); part++)
+		{
+			DRAW_COMMAND command = m_pScenePrefabs->GetPart(prefab.firstPart + part);
+			const glm::mat4 partModel = command.model;
+			for (uint32_t i = 0; i < prefab.visibleCount; i++)
+			{
+				command.model = m_pScenePrefabs->GetRoot(pVisible[prefab.firstVisible + i]) * partModel;
+				command.stateBits = SceneFile::GetStateBits(
+					m_framePacket.empty() ? NULL : &m_framePacket.back(),
+					command);
+				m_framePacket.push_back(command);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  RecordStreamedScene()
+ *
+ *  This method is used for recording the draws of the sectors
+ *  that are resident.  Each sector's first draw sends its
+ *  settings, so any set of sectors can be drawn; a sector
+ *  still missing textures sends every setting, as its state
+ *  bits assume them.  A sector that is not resident is drawn
+ *  as a box of its bounds in the average color of its
+ *  objects, except the one the camera is in.
+ ***********************************************************/
+void SceneManager::RecordStreamedScene()
+{
+	const SceneBinary::BINARY_SECTOR* pSectors = m_pSceneBinary->GetSectors();
+
+	for (uint32_t i = 0; i < m_pSceneBinary->GetSectorCount(); i++)
+	{
+		if (m_pSceneStreamer->IsSectorResident(i) == true)
+		{
+			RecordObjectArrays(
+				m_pSceneStreamer->GetSectorObjects(i),
+				(m_bSceneFullState == true) || (m_pSceneStreamer->AreSectorTexturesResident(i) == false));
+			continue;
+		}
+
+		glm::vec3 boundsMin = glm::make_vec3(pSectors[i].boundsMin);
+		glm::vec3 boundsMax = glm::make_vec3(pSectors[i].boundsMax);
+		if (glm::clamp(m_streamCameraPosition, boundsMin, boundsMax) == m_streamCameraPosition)
+		{
+			continue;
+		}
+
+		DRAW_COMMAND proxy = DRAW_COMMAND();
+		proxy.model = glm::translate((boundsMin + boundsMax) * 0.5f) * glm::scale(boundsMax - boundsMin);
+		proxy.color = glm::make_vec4(pSectors[i].proxyColor);
+		proxy.UVscale = glm::vec2(1.0f, 1.0f);
+		proxy.mesh = MESH_BOX;
+		proxy.textureSlot = 0;
+		proxy.materialIndex = -1;
+		proxy.bUseTexture = false;
+		proxy.stateBits = DRAW_STATE_COLOR;
+		m_framePacket.push_back(proxy);
+	}
+}
+
+/***********************************************************
+ *  SetStreaming()
+ ***********************************************************/
+void SceneManager::SetStreaming(size_t budgetBytes, float radius)
+{
+	m_streamBudgetBytes = budgetBytes;
+	m_streamRadius = radius;
+}
+
+/***********************************************************
+ *  UpdateStreaming()
+ *
+ *  This method is used for moving the streamed sectors with
+ *  the camera, and for moving the streamed textures in and
+ *  out of the texture slots.  One decoded texture is uploaded
+ *  a frame, so the uploads are spread over the frames.
+ ***********************************************************/
+void SceneManager::UpdateStreaming(const glm::vec3& position, const glm::vec3& velocity)
+{
+	if (NULL == m_pSceneStreamer)
+	{
+		return;
+	}
+
+	m_streamCameraPosition = position;
+	m_pSceneStreamer->Update(position, velocity);
+
+	// textures no resident sector uses give up their slots
+	uint32_t textureID = 0;
+	while (m_pSceneStreamer->TakeReleasedTexture(textureID) == true)
+	{
+		ReleaseTextureSlot(m_sceneTextureSlots[textureID]);
+		m_sceneTextureSlots[textureID] = -1;
+	}
+
+	if (m_pSceneStreamer->HasDecodedTexture() == true)
+	{
+		ProfileZone zone("StreamedTextureUpload");
+
+		SceneStreamer::DECODED_TEXTURE texture;
+		m_pSceneStreamer->TakeDecodedTexture(texture);
+		size_t bytes = 0;
+		int slot = AddTextureToFreeSlot(
+			texture.pPixels,
+			texture.width,
+			texture.height,
+			texture.channels,
+			m_pSceneBinary->GetString(m_pSceneBinary->GetTextures()[texture.textureID].tag),
+			bytes);
+		SceneStreamer::FreeDecodedTexture(texture);
+
+		m_sceneTextureSlots[texture.textureID] = slot;
+		m_pSceneStreamer->SetTextureSlot(texture.textureID, slot, bytes);
+	}
+}
+
+#ifdef SCENE_BAKED
+/***********************************************************
+ *  LoadBakedScene()
+ *
+ *  This method is used for loading the textures, materials
+ *  and lights of the scene baked into the build.  The draws
+ *  and their model matrices were computed by the compiler.
+ ***********************************************************/
+bool SceneManager::LoadBakedScene()
+{
+	m_objectMaterials.clear();
+	m_lightSources.clear();
+	m_pSceneObjects->Clear();
+	m_sceneObjectIDs.clear();
+	m_pScenePrefabs->Clear();
+	m_pStaticBatches->Clear();
+	m_sceneTextureSlots.assign(g_BakedTextureCount, -1);
+	m_bSceneFullState = false;
+
+	for (int i = 0; i < g_BakedTextureCount; i++)
+	{
+		LoadSceneTexture(i, g_BakedTextures[i].path, g_BakedTextures[i].tag);
+	}
+
+	for (int i = 0; i < g_BakedMaterialCount; i++)
+	{
+		OBJECT_MATERIAL material;
+		material.ambientColor = glm::make_vec3(g_BakedMaterials[i].ambientColor);
+		material.ambientStrength = g_BakedMaterials[i].ambientStrength;
+		material.diffuseColor = glm::make_vec3(g_BakedMaterials[i].diffuseColor);
+		material.specularColor = glm::make_vec3(g_BakedMaterials[i].specularColor);
+		material.shininess = g_BakedMaterials[i].shininess;
+		material.tag = g_BakedMaterials[i].tag;
+		m_objectMaterials.push_back(material);
+	}
+
+	for (int i = 0; i < g_BakedLightCount; i++)
+	{
+		LIGHT_SOURCE light;
+		light.position = glm::make_vec3(g_BakedLights[i].position);
+		light.ambientColor = glm::make_vec3(g_BakedLights[i].ambientColor);
+		light.diffuseColor = glm::make_vec3(g_BakedLights[i].diffuseColor);
+		light.specularColor = glm::make_vec3(g_BakedLights[i].specularColor);
+		light.focalStrength = g_BakedLights[i].focalStrength;
+		light.specularIntensity = g_BakedLights[i].specularIntensity;
+		light.radius = g_BakedLights[i].radius;
+		m_lightSources.push_back(light);
+	}
+
+	for (int i = 0; i < g_BakedDrawCount; i++)
+	{
+		m_sceneObjectIDs.push_back(g_BakedDrawIDs[i]);
+	}
+
+	// bind the loaded textures to their slots
+	BindGLTextures();
+
+	MemoryTracker::Register(
+		MemoryTracker::MEMORY_CPU,
+		(uint64_t)(uintptr_t)&m_objectMaterials,
+		"materials",
+		"object materials",
+		m_objectMaterials.capacity() * sizeof(OBJECT_MATERIAL));
+
+	std::cout << "INFO: using the baked scene of " << g_BakedDrawCount << " objects" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  RecordBakedScene()
+ *
+ *  This method is used for recording the baked draws, copying
+ *  the model matrices the compiler computed.
+ ***********************************************************/
+void SceneManager::RecordBakedScene()
+{
+	DRAW_COMMAND command = DRAW_COMMAND();
+	command.textureSlot = 0;
+	for (int i = 0; i < g_BakedDrawCount; i++)
+	{
+		const SceneBake::BAKED_DRAW& draw = g_BakedDraws[i];
+		int slot = (draw.texture >= 0) ? m_sceneTextureSlots[draw.texture] : -1;
+
+		memcpy(&command.model[0][0], draw.model.values, sizeof(draw.model.values));
+		command.color = glm::vec4(draw.color[0], draw.color[1], draw.color[2], draw.color[3]);
+		command.UVscale = glm::vec2(draw.UVscale[0], draw.UVscale[1]);
+		command.mesh = (MESH_TYPE)draw.mesh;
+		command.materialIndex = draw.material;
+		// an untextured draw keeps the slot of the one before
+		command.textureSlot = (slot >= 0) ? slot : command.textureSlot;
+		command.bUseTexture = (slot >= 0);
+		command.stateBits = (m_bSceneFullState == true) ?
+			(DRAW_STATE_COLOR | DRAW_STATE_TEXTURE | DRAW_STATE_MATERIAL | DRAW_STATE_UVSCALE) :
+			draw.stateBits;
+		m_framePacket.push_back(command);
+	}
+}
+#endif
+
+/***********************************************************
+ *  VerifyBakedScene()
+ *
+ *  This method is used for checking the scene baked into the
+ *  build against the passed in scene file, compiled the way
+ *  the loader builds its draws.  The model matrices have to
+ *  be equal to the bit.
+ ***********************************************************/
+bool SceneManager::VerifyBakedScene(const char* sceneFile)
+{
+#ifdef SCENE_BAKED
+	SceneBinary::SCENE_SOURCE source;
+	SceneBinary::COMPILED_SCENE compiled;
+	std::string error;
+
+	if ((SceneBinary::ReadSource(sceneFile, source, error) == false) ||
+		(SceneBinary::Compile(source, compiled, error) == false))
+	{
+		std::cout << "ERROR: " << sceneFile << ", " << error << std::endl;
+		return(false);
+	}
+	if ((compiled.transforms.size() != (size_t)g_BakedDrawCount) ||
+		(compiled.textures.size() != (size_t)g_BakedTextureCount) ||
+		(compiled.materials.size() != (size_t)g_BakedMaterialCount) ||
+		(compiled.lights.size() != (size_t)g_BakedLightCount))
+	{
+		std::cout << "ERROR: the baked scene has different counts than " << sceneFile << std::endl;
+		return(false);
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < g_BakedDrawCount; i++)
+	{
+		const SceneBake::BAKED_DRAW& draw = g_BakedDraws[i];
+		bool bMatrix = (memcmp(&compiled.transforms[i][0][0], draw.model.values, sizeof(draw.model.values)) == 0);
+		bool bDraw =
+			(memcmp(&compiled.colors[i].x, draw.color, sizeof(draw.color)) == 0) &&
+			(memcmp(&compiled.UVscales[i].x, draw.UVscale, sizeof(draw.UVscale)) == 0) &&
+			(compiled.meshes[i] == (uint32_t)draw.mesh) &&
+			(compiled.textureIDs[i] == draw.texture) &&
+			(compiled.materialIDs[i] == draw.material) &&
+			(compiled.stateBits[i] == draw.stateBits);
+		if ((bMatrix == false) || (bDraw == false))
+		{
+			std::cout << "MISMATCH: " << g_BakedDrawIDs[i] << (bMatrix ? "" : " model matrix") << (bDraw ? "" : " draw settings") << std::endl;
+			mismatches++;
+		}
+	}
+
+	std::cout << "INFO: " << (g_BakedDrawCount - mismatches) << " of " << g_BakedDrawCount
+		<< " baked draws are identical to " << sceneFile << std::endl;
+	return(mismatches == 0);
+#else
+	std::cout << "ERROR: cannot verify " << sceneFile << ", this build has no baked scene (SCENE_BAKED)" << std::endl;
+	return(false);
+#endif
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to configure the light sources of
+ *  the 3D scene, read from the scene file, in the shaders.
+ *  There are up to 4 light sources, set through the uniform
+ *  locations looked up with the others, so switching scenes
+ *  sends them without building any names.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting, if no light sources have
+	// been added then the display window will be black - to use the 
+	// default OpenGL lighting then comment out the following line
+
+	glUniform1i(m_uniforms.useLighting, true);
+
+	// the lights past the scene's are turned off, so a scene
+	// with fewer lights than the one before it is not lit by
+	// the ones it left behind
+	const size_t lightCount = std::min(m_lightSources.size(), (size_t)MAX_SCENE_LIGHTS);
+	for (size_t i = 0; i < MAX_SCENE_LIGHTS; i++)
+	{
+		const LIGHT_UNIFORMS& uniforms = m_uniforms.lights[i];
+		if (i >= lightCount)
+		{
+			glUniform3f(uniforms.ambientColor, 0.0f, 0.0f, 0.0f);
+			glUniform3f(uniforms.diffuseColor, 0.0f, 0.0f, 0.0f);
+			glUniform3f(uniforms.specularColor, 0.0f, 0.0f, 0.0f);
+			continue;
+		}
+		const LIGHT_SOURCE& light = m_lightSources[i];
+		glUniform3fv(uniforms.position, 1, glm::value_ptr(light.position));
+		glUniform3fv(uniforms.ambientColor, 1, glm::value_ptr(light.ambientColor));
+		glUniform3fv(uniforms.diffuseColor, 1, glm::value_ptr(light.diffuseColor));
+		glUniform3fv(uniforms.specularColor, 1, glm::value_ptr(light.specularColor));
+		glUniform1f(uniforms.focalStrength, light.focalStrength);
+		glUniform1f(uniforms.specularIntensity, light.specularIntensity);
+	}
+}
+
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the scene file, its textures and the shapes in memory to
+ *  support the 3D scene rendering
+ ***********************************************************/
+bool SceneManager::PrepareScene(const char* sceneFile)
+{
+	// baked builds use the scene they were built with, compiled
+	// scenes are mapped, description files are read
+	StartupProfiler::BeginPhase("scene file");
+#ifdef SCENE_BAKED
+	bool bLoaded = LoadBakedScene();
+#else
+	bool bLoaded = (SceneBinary::IsBinaryScene(sceneFile) == true) ?
+		LoadSceneBinary(sceneFile) :
+		LoadSceneFile(sceneFile);
+#endif
+	StartupProfiler::EndPhase();
+	if (bLoaded == false)
+	{
+		return(false);
+	}
+
+	StartupProfiler::BeginPhase("lights");
+	SetupSceneLights();
+	StartupProfiler::EndPhase();
+	
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+
+	// the shapes are welded and reordered for the GPU before
+	// they are uploaded, the mesh buffers are accounted under
+	// the tag of each mesh
+	StartupProfiler::BeginPhase("meshes");
+	StartupProfiler::BeginPhase("mesh optimization");
+	ShapeGeometry::Prepare();
+	StartupProfiler::EndPhase();
+	StartupProfiler::BeginPhase("plane mesh");
+	GLHooks::SetResourceTag("plane mesh");
+	LoadShapeMesh(MESH_PLANE);
+	StartupProfiler::EndPhase();
+	StartupProfiler::BeginPhase("box mesh");
+	GLHooks::SetResourceTag("box mesh");
+	LoadShapeMesh(MESH_BOX);
+	StartupProfiler::EndPhase();
+	StartupProfiler::BeginPhase("cylinder mesh");
+	GLHooks::SetResourceTag("cylinder mesh");
+	LoadShapeMesh(MESH_CYLINDER);
+	StartupProfiler::EndPhase();
+	StartupProfiler::BeginPhase("torus mesh");
+	GLHooks::SetResourceTag("torus mesh");
+	LoadShapeMesh(MESH_TORUS);
+	StartupProfiler::EndPhase();
+	GLHooks::SetResourceTag(NULL);
+	StartupProfiler::EndPhase();
+
+	return(true);
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  recording the draws of the scene file's objects into the
+ *  frame packet and submitting it
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	ProfileZone zone("RenderScene");
+
+	// restart the draw count and the frame packet for this frame,
+	// the packet's memory from the last frame is reused
+	m_drawCallCount = 0;
+	m_frameArena.BeginFrame();
+	m_framePacket = FrameVector<DRAW_COMMAND>(FrameArena::Allocator<DRAW_COMMAND>(&m_frameArena));
+#ifdef SCENE_BAKED
+	// the baked draws need no transform math
+	m_framePacket.reserve(std::max(g_FramePacketReserve, (size_t)g_BakedDrawCount));
+	RecordBakedScene();
+#else
+	if (NULL != m_pSceneStreamer)
+	{
+		m_framePacket.reserve(g_FramePacketReserve);
+		RecordStreamedScene();
+	}
+	else if (NULL != m_pSceneBinary)
+	{
+		m_framePacket.reserve(std::max(g_FramePacketReserve, (size_t)m_pSceneBinary->GetObjectCount()));
+		RecordObjectArrays(m_pSceneBinary->GetObjectArrays(), m_bSceneFullState);
+	}
+	else
+	{
+		// only the static batches, objects and prefab instances in
+		// view are recorded
+		uint32_t visibleCount = 0;
+		{
+			ProfileZone cullZone("CullObjects");
+			visibleCount = m_pStaticBatches->Cull(m_projection * m_view);
+			visibleCount += m_pSceneObjects->Cull(m_projection * m_view);
+			m_pScenePrefabs->Cull(m_projection * m_view);
+		}
+		visibleCount += m_pScenePrefabs->GetVisibleDrawCount();
+		m_framePacket.reserve(std::max(g_FramePacketReserve, (size_t)visibleCount));
+		RecordStaticBatches();
+		RecordSceneObjects();
+		RecordScenePrefabs();
+	}
+#endif
+
+	SubmitFramePacket();
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenepreloader.cpp
+// ============
+// read the next scene description file on a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ScenePreloader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  ScenePreloader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ScenePreloader::ScenePreloader()
+	: m_bFinished(false)
+{
+	m_bSucceeded = false;
+	m_takenImages = 0;
+}
+
+/***********************************************************
+ *  ~ScenePreloader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ScenePreloader::~ScenePreloader()
+{
+	Reset();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used to start reading a scene file on the
+ *  background thread.  It fails while another file is read
+ *  or its results have not been reset.
+ ***********************************************************/
+bool ScenePreloader::Start(const char* filename, const std::vector<std::string>& residentTags)
+{
+	if (IsBusy() == true)
+	{
+		return(false);
+	}
+
+	m_filename = filename;
+	m_residentTags = residentTags;
+	m_bSucceeded = false;
+	m_error.clear();
+	m_takenImages = 0;
+	m_bFinished.store(false, std::memory_order_relaxed);
+	m_thread = std::thread(&ScenePreloader::ThreadMain, this);
+	return(true);
+}
+
+/***********************************************************
+ *  ThreadMain()
+ *
+ *  This method is run by the background thread.  It reads the
+ *  whole file first, then decodes the images of the textures
+ *  that are neither resident nor decoded already.
+ ***********************************************************/
+void ScenePreloader::ThreadMain()
+{
+	m_bSucceeded = SceneBinary::ReadSource(m_filename.c_str(), m_source, m_error);
+
+	for (size_t i = 0; (i < m_source.textures.size()) && (m_bSucceeded == true); i++)
+	{
+		const SceneFile::SCENE_TEXTURE& texture = m_source.textures[i];
+		if ((std::find(m_residentTags.begin(), m_residentTags.end(), texture.tag) != m_residentTags.end()) ||
+			(std::any_of(m_images.begin(), m_images.end(),
+				[&texture](const DECODED_IMAGE& image) { return(image.tag == texture.tag); }) == true))
+		{
+			continue;
+		}
+
+		// the flip is set once by the scene manager, a texture that
+		// fails here is left for the render thread to report
+		DECODED_IMAGE image;
+		image.tag = texture.tag;
+		image.pPixels = stbi_load(texture.path.c_str(), &image.width, &image.height, &image.channels, 0);
+		if ((NULL != image.pPixels) && (image.channels != 3) && (image.channels != 4))
+		{
+			FreeImage(image);
+		}
+		if (NULL != image.pPixels)
+		{
+			m_images.push_back(image);
+		}
+	}
+
+	m_bFinished.store(true, std::memory_order_release);
+}
+
+/***********************************************************
+ *  TakeImage()
+ *
+ *  This method is used to take the next decoded image of the
+ *  finished file.  The caller frees its pixels.
+ ***********************************************************/
+bool ScenePreloader::TakeImage(DECODED_IMAGE& image)
+{
+	if ((IsFinished() == false) || (m_takenImages >= m_images.size()))
+	{
+		return(false);
+	}
+
+	image = m_images[m_takenImages];
+	m_images[m_takenImages].pPixels = NULL;
+	m_takenImages++;
+	return(true);
+}
+
+/***********************************************************
+ *  FreeImage()
+ ***********************************************************/
+void ScenePreloader::FreeImage(DECODED_IMAGE& image)
+{
+	if (NULL != image.pPixels)
+	{
+		stbi_image_free(image.pPixels);
+		image.pPixels = NULL;
+	}
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used to wait for the background thread and
+ *  free what it read, including the images not taken.
+ ***********************************************************/
+void ScenePreloader::Reset()
+{
+	if (m_thread.joinable() == true)
+	{
+		m_thread.join();
+	}
+	for (DECODED_IMAGE& image : m_images)
+	{
+		FreeImage(image);
+	}
+	m_images.clear();
+	m_takenImages = 0;
+	m_source = SceneBinary::SCENE_SOURCE();
+	m_bFinished.store(false, std::memory_order_relaxed);
+}
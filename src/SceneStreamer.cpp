@@ -0,0 +1,659 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenestreamer.cpp
+// ============
+// load and unload the sectors of a compiled scene around the camera
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneStreamer.h"
+#include "MemoryTracker.h"
+#include "ProfileZone.h"
+
+#include "stb_image.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// bytes of one object in the arrays a sector is read into
+	const size_t OBJECT_BYTES =
+		sizeof(glm::mat4) + sizeof(glm::vec4) + sizeof(glm::vec2) +
+		sizeof(uint32_t) + sizeof(int32_t) + sizeof(int32_t) + sizeof(uint32_t);
+
+	// reads handed out per thread, so the queue follows the
+	// camera instead of holding sectors it has moved away from
+	const int REQUESTS_PER_THREAD = 2;
+
+	const double BYTES_PER_MIB = 1024.0 * 1024.0;
+}
+
+/***********************************************************
+ *  SceneStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneStreamer::SceneStreamer()
+{
+	m_pScene = NULL;
+	memset(&m_settings, 0, sizeof(m_settings));
+	m_inFlight = 0;
+	m_inFlightBytes = 0;
+	m_residentBytes = 0;
+	m_residentSectors = 0;
+	m_bTextureSlotsFull = false;
+	m_sectorLoads = 0;
+	m_sectorUnloads = 0;
+	m_discardedLoads = 0;
+	m_budgetDeferrals = 0;
+	m_peakResidentBytes = 0;
+	m_bStopping = false;
+}
+
+/***********************************************************
+ *  ~SceneStreamer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneStreamer::~SceneStreamer()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used to start streaming the sectors of the
+ *  passed in scene.  The scene stays mapped for its header
+ *  and tables, the sectors are read from the file by the
+ *  background threads.
+ ***********************************************************/
+bool SceneStreamer::Start(const char* filename, const SceneBinary* pScene, const STREAM_SETTINGS& settings)
+{
+	Stop();
+
+	m_filename = filename;
+	m_pScene = pScene;
+	m_settings = settings;
+	m_settings.threadCount = std::max(m_settings.threadCount, 1);
+
+	SECTOR_SLOT emptySector = {};
+	emptySector.state = SECTOR_UNLOADED;
+	m_sectors.assign(m_pScene->GetSectorCount(), emptySector);
+	m_sectorOrder.resize(m_sectors.size());
+	TEXTURE_SLOT emptyTexture = {};
+	emptyTexture.slot = -1;
+	m_textures.assign(m_pScene->GetTextureCount(), emptyTexture);
+
+	// sized for the worst case, so the frames do not allocate
+	const size_t maxInFlight = (size_t)m_settings.threadCount * REQUESTS_PER_THREAD + m_textures.size();
+	m_decodedTextures.reserve(m_textures.size());
+	m_releasedTextures.reserve(m_textures.size());
+	m_finished.reserve(maxInFlight);
+	m_taken.reserve(maxInFlight);
+
+	// the decoder setting is global, so it is made before the
+	// threads start and matches the textures loaded up front
+	stbi_set_flip_vertically_on_load(true);
+
+	m_bStopping = false;
+	for (int i = 0; i < m_settings.threadCount; i++)
+	{
+		m_threads.emplace_back(&SceneStreamer::ThreadMain, this);
+	}
+
+	std::cout << "INFO: streaming " << m_sectors.size() << " sectors of " << m_filename
+		<< " with " << m_settings.threadCount << " threads, a "
+		<< (double)m_settings.budgetBytes / BYTES_PER_MIB << " MiB budget and a "
+		<< m_settings.loadRadius << " load radius" << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ ***********************************************************/
+void SceneStreamer::Stop()
+{
+	if (m_threads.empty() == true)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_requests.clear();
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+	m_threads.clear();
+
+	// free the work finished after the last frame and what is held
+	for (REQUEST& request : m_finished)
+	{
+		delete request.pData;
+		FreeDecodedTexture(request.texture);
+	}
+	m_finished.clear();
+	for (DECODED_TEXTURE& texture : m_decodedTextures)
+	{
+		FreeDecodedTexture(texture);
+	}
+	m_decodedTextures.clear();
+	for (uint32_t i = 0; i < m_sectors.size(); i++)
+	{
+		if (NULL != m_sectors[i].pData)
+		{
+			MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)m_sectors[i].pData);
+			delete m_sectors[i].pData;
+		}
+	}
+
+	PrintReport(stdout);
+
+	m_sectors.clear();
+	m_textures.clear();
+	m_releasedTextures.clear();
+	m_inFlight = 0;
+	m_inFlightBytes = 0;
+	m_residentBytes = 0;
+	m_residentSectors = 0;
+	m_pScene = NULL;
+}
+
+/***********************************************************
+ *  ThreadMain()
+ *
+ *  This method is run by each background thread.  It takes
+ *  the oldest request, reads the sector or decodes the
+ *  texture without holding the lock, and hands the result
+ *  back for the next Update().
+ ***********************************************************/
+void SceneStreamer::ThreadMain()
+{
+	// the allocations of the reads are told apart from the frame's
+	ProfileZone zone("SceneStreamerThread");
+	// each thread reads through its own file handle
+	FILE* file = fopen(m_filename.c_str(), "rb");
+
+	for (;;)
+	{
+		REQUEST request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() { return((m_bStopping == true) || (m_requests.empty() == false)); });
+			if (m_bStopping == true)
+			{
+				break;
+			}
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		if (request.type == REQUEST_SECTOR)
+		{
+			request.pData = new SECTOR_DATA();
+			request.bSucceeded = (NULL != file) && (ReadSector(file, request.index, *request.pData) == true);
+		}
+		else
+		{
+			request.bSucceeded = DecodeTexture(request.index, request.texture);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_finished.push_back(request);
+	}
+
+	if (NULL != file)
+	{
+		fclose(file);
+	}
+}
+
+/***********************************************************
+ *  ReadSector()
+ *
+ *  This method is used to read the arrays of a sector's
+ *  object range.  The ranges were checked when the scene was
+ *  mapped.
+ ***********************************************************/
+bool SceneStreamer::ReadSector(FILE* file, uint32_t sector, SECTOR_DATA& data) const
+{
+	const SceneBinary::BINARY_HEADER& header = m_pScene->GetHeader();
+	const SceneBinary::BINARY_SECTOR& range = m_pScene->GetSectors()[sector];
+	const uint32_t first = range.firstObject;
+	const uint32_t count = range.objectCount;
+
+	data.transforms.resize(count);
+	data.colors.resize(count);
+	data.UVscales.resize(count);
+	data.meshes.resize(count);
+	data.materialIDs.resize(count);
+	data.textureIDs.resize(count);
+	data.stateBits.resize(count);
+	data.bytes = count * OBJECT_BYTES;
+
+	return((SceneBinary::ReadSection(file, header, SceneBinary::SECTION_TRANSFORMS, first, count, data.transforms.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_COLORS, first, count, data.colors.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_UV_SCALES, first, count, data.UVscales.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_MESHES, first, count, data.meshes.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_MATERIAL_IDS, first, count, data.materialIDs.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_TEXTURE_IDS, first, count, data.textureIDs.data()) == true) &&
+		(SceneBinary::ReadSection(file, header, SceneBinary::SECTION_STATE_BITS, first, count, data.stateBits.data()) == true));
+}
+
+/***********************************************************
+ *  DecodeTexture()
+ *
+ *  This method is used to read and decode the image file of a
+ *  texture.  Only three and four channel images can be used.
+ ***********************************************************/
+bool SceneStreamer::DecodeTexture(uint32_t textureID, DECODED_TEXTURE& texture) const
+{
+	const char* path = m_pScene->GetString(m_pScene->GetTextures()[textureID].path);
+
+	texture.textureID = textureID;
+	texture.pPixels = stbi_load(path, &texture.width, &texture.height, &texture.channels, 0);
+	if ((NULL != texture.pPixels) && (texture.channels != 3) && (texture.channels != 4))
+	{
+		FreeDecodedTexture(texture);
+	}
+	return(NULL != texture.pPixels);
+}
+
+/***********************************************************
+ *  FreeDecodedTexture()
+ ***********************************************************/
+void SceneStreamer::FreeDecodedTexture(DECODED_TEXTURE& texture)
+{
+	if (NULL != texture.pPixels)
+	{
+		stbi_image_free(texture.pPixels);
+		texture.pPixels = NULL;
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used to take the finished reads, drop the
+ *  sectors the camera has left, and hand out the reads of the
+ *  nearest wanted sectors.  The distance of a sector is the
+ *  smaller one to the camera and to where the camera will be
+ *  after the look-ahead time at its current velocity.
+ ***********************************************************/
+void SceneStreamer::Update(const glm::vec3& position, const glm::vec3& velocity)
+{
+	ProfileZone zone("SceneStreaming");
+
+	if (IsRunning() == false)
+	{
+		return;
+	}
+
+	TakeFinished();
+
+	const glm::vec3 ahead = position + velocity * m_settings.lookAheadSeconds;
+	const float keepRadius = m_settings.loadRadius + m_settings.unloadMargin;
+	for (uint32_t i = 0; i < m_sectors.size(); i++)
+	{
+		m_sectors[i].distance = std::min(GetSectorDistance(i, position), GetSectorDistance(i, ahead));
+		m_sectorOrder[i] = i;
+
+		// hysteresis, a sector is only dropped well outside the
+		// radius it was loaded in
+		if ((m_sectors[i].state == SECTOR_RESIDENT) && (m_sectors[i].distance > keepRadius))
+		{
+			UnloadSector(i);
+		}
+	}
+	std::sort(m_sectorOrder.begin(), m_sectorOrder.end(),
+		[this](uint32_t a, uint32_t b) { return(m_sectors[a].distance < m_sectors[b].distance); });
+
+	// hand out the nearest wanted sectors, making room in the
+	// budget by dropping the furthest resident ones
+	const int maxInFlight = m_settings.threadCount * REQUESTS_PER_THREAD;
+	size_t furthest = m_sectorOrder.size();
+	for (size_t k = 0; (k < m_sectorOrder.size()) && (m_inFlight < maxInFlight); k++)
+	{
+		const uint32_t sector = m_sectorOrder[k];
+		if (m_sectors[sector].distance > m_settings.loadRadius)
+		{
+			break;
+		}
+		if ((m_sectors[sector].state != SECTOR_UNLOADED) || (m_sectors[sector].bFailed == true))
+		{
+			continue;
+		}
+
+		const size_t bytes = GetSectorBytes(sector);
+		while ((m_residentBytes + m_inFlightBytes + bytes > m_settings.budgetBytes) && (furthest > k + 1))
+		{
+			furthest--;
+			if (m_sectors[m_sectorOrder[furthest]].state == SECTOR_RESIDENT)
+			{
+				UnloadSector(m_sectorOrder[furthest]);
+			}
+		}
+		if (m_residentBytes + m_inFlightBytes + bytes > m_settings.budgetBytes)
+		{
+			// the nearer sectors fill the budget, this one and
+			// the ones after it are drawn as proxies
+			m_budgetDeferrals++;
+			break;
+		}
+
+		m_sectors[sector].state = SECTOR_LOADING;
+		m_sectors[sector].generation++;
+		m_inFlightBytes += bytes;
+		Queue(REQUEST_SECTOR, sector, false);
+	}
+}
+
+/***********************************************************
+ *  TakeFinished()
+ *
+ *  This method is used to take the reads and decodes finished
+ *  since the last frame.  Sectors dropped while they were
+ *  read, and textures no longer used, are freed.
+ ***********************************************************/
+void SceneStreamer::TakeFinished()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_taken.swap(m_finished);
+	}
+
+	for (REQUEST& request : m_taken)
+	{
+		m_inFlight--;
+		if (request.type == REQUEST_SECTOR)
+		{
+			SECTOR_SLOT& sector = m_sectors[request.index];
+			m_inFlightBytes -= GetSectorBytes(request.index);
+			if ((sector.state != SECTOR_LOADING) || (sector.generation != request.generation) ||
+				(request.bSucceeded == false))
+			{
+				if (request.bSucceeded == false)
+				{
+					// left as a proxy, not read again every frame
+					std::cout << "WARNING: could not read sector " << request.index << " of " << m_filename << std::endl;
+					sector.bFailed = true;
+				}
+				m_discardedLoads++;
+				delete request.pData;
+				sector.state = (sector.state == SECTOR_LOADING) ? SECTOR_UNLOADED : sector.state;
+				continue;
+			}
+
+			sector.state = SECTOR_RESIDENT;
+			sector.pData = request.pData;
+			m_residentBytes += sector.pData->bytes;
+			m_residentSectors++;
+			m_sectorLoads++;
+			MemoryTracker::Register(
+				MemoryTracker::MEMORY_CPU,
+				(uint64_t)(uintptr_t)sector.pData,
+				"scene",
+				"streamed sector",
+				sector.pData->bytes);
+
+			const SceneBinary::BINARY_SECTOR& range = m_pScene->GetSectors()[request.index];
+			const uint32_t* pSectorTextures = m_pScene->GetSectorTextures();
+			for (uint32_t i = 0; i < range.textureCount; i++)
+			{
+				AddTextureReference(pSectorTextures[range.firstTexture + i]);
+			}
+		}
+		else
+		{
+			TEXTURE_SLOT& texture = m_textures[request.index];
+			if (request.bSucceeded == false)
+			{
+				// left untextured, not retried every frame
+				std::cout << "Could not load image:" << m_pScene->GetString(m_pScene->GetTextures()[request.index].path) << std::endl;
+				continue;
+			}
+			if (texture.references == 0)
+			{
+				texture.bDecoding = false;
+				FreeDecodedTexture(request.texture);
+				continue;
+			}
+			m_decodedTextures.push_back(request.texture);
+		}
+	}
+	m_taken.clear();
+
+	m_peakResidentBytes = std::max(m_peakResidentBytes, m_residentBytes);
+}
+
+/***********************************************************
+ *  Queue()
+ ***********************************************************/
+void SceneStreamer::Queue(REQUEST_TYPE type, uint32_t index, bool bUrgent)
+{
+	REQUEST request = {};
+	request.type = type;
+	request.index = index;
+	request.generation = (type == REQUEST_SECTOR) ? m_sectors[index].generation : 0;
+	m_inFlight++;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (bUrgent == true)
+		{
+			m_requests.push_front(request);
+		}
+		else
+		{
+			m_requests.push_back(request);
+		}
+	}
+	m_wake.notify_one();
+}
+
+/***********************************************************
+ *  UnloadSector()
+ ***********************************************************/
+void SceneStreamer::UnloadSector(uint32_t sector)
+{
+	SECTOR_SLOT& slot = m_sectors[sector];
+
+	MemoryTracker::Release(MemoryTracker::MEMORY_CPU, (uint64_t)(uintptr_t)slot.pData);
+	m_residentBytes -= slot.pData->bytes;
+	m_residentSectors--;
+	m_sectorUnloads++;
+	delete slot.pData;
+	slot.pData = NULL;
+	slot.state = SECTOR_UNLOADED;
+
+	const SceneBinary::BINARY_SECTOR& range = m_pScene->GetSectors()[sector];
+	const uint32_t* pSectorTextures = m_pScene->GetSectorTextures();
+	for (uint32_t i = 0; i < range.textureCount; i++)
+	{
+		ReleaseTextureReference(pSectorTextures[range.firstTexture + i]);
+	}
+}
+
+/***********************************************************
+ *  AddTextureReference()
+ *
+ *  This method is used to count a resident sector using a
+ *  texture.  The first user has it decoded ahead of the
+ *  sector reads, since a sector drawn without its textures
+ *  looks wrong.
+ ***********************************************************/
+void SceneStreamer::AddTextureReference(uint32_t textureID)
+{
+	TEXTURE_SLOT& texture = m_textures[textureID];
+	texture.references++;
+	if ((texture.slot < 0) && (texture.bDecoding == false) && (m_bTextureSlotsFull == false))
+	{
+		texture.bDecoding = true;
+		Queue(REQUEST_TEXTURE, textureID, true);
+	}
+}
+
+/***********************************************************
+ *  ReleaseTextureReference()
+ ***********************************************************/
+void SceneStreamer::ReleaseTextureReference(uint32_t textureID)
+{
+	TEXTURE_SLOT& texture = m_textures[textureID];
+	texture.references--;
+	if ((texture.references == 0) && (texture.slot >= 0))
+	{
+		m_releasedTextures.push_back(textureID);
+	}
+}
+
+/***********************************************************
+ *  TakeDecodedTexture()
+ ***********************************************************/
+void SceneStreamer::TakeDecodedTexture(DECODED_TEXTURE& texture)
+{
+	texture = m_decodedTextures.back();
+	m_decodedTextures.pop_back();
+}
+
+/***********************************************************
+ *  SetTextureSlot()
+ *
+ *  This method is used to record where an uploaded texture
+ *  went.  Without a free slot the texture waits until one is
+ *  released, and the sectors using it draw their colors.
+ ***********************************************************/
+void SceneStreamer::SetTextureSlot(uint32_t textureID, int slot, size_t bytes)
+{
+	TEXTURE_SLOT& texture = m_textures[textureID];
+	texture.bDecoding = false;
+	texture.slot = slot;
+	texture.bytes = (slot >= 0) ? bytes : 0;
+	m_residentBytes += texture.bytes;
+	m_bTextureSlotsFull = (slot < 0);
+
+	// the sectors using it were dropped while it waited
+	if ((texture.references == 0) && (slot >= 0))
+	{
+		m_releasedTextures.push_back(textureID);
+	}
+}
+
+/***********************************************************
+ *  TakeReleasedTexture()
+ *
+ *  This method is used to hand back a texture whose slot is
+ *  to be freed.  A texture used again before its release was
+ *  taken is kept.
+ ***********************************************************/
+bool SceneStreamer::TakeReleasedTexture(uint32_t& textureID)
+{
+	while (m_releasedTextures.empty() == false)
+	{
+		textureID = m_releasedTextures.back();
+		m_releasedTextures.pop_back();
+
+		TEXTURE_SLOT& texture = m_textures[textureID];
+		if ((texture.references == 0) && (texture.slot >= 0))
+		{
+			m_residentBytes -= texture.bytes;
+			texture.slot = -1;
+			texture.bytes = 0;
+			m_bTextureSlotsFull = false;
+			return(true);
+		}
+	}
+
+	// a texture still waiting for a slot gets another try
+	if (m_bTextureSlotsFull == false)
+	{
+		for (uint32_t i = 0; i < m_textures.size(); i++)
+		{
+			if ((m_textures[i].references > 0) && (m_textures[i].slot < 0) && (m_textures[i].bDecoding == false))
+			{
+				m_textures[i].bDecoding = true;
+				Queue(REQUEST_TEXTURE, i, true);
+				break;
+			}
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  AreSectorTexturesResident()
+ ***********************************************************/
+bool SceneStreamer::AreSectorTexturesResident(uint32_t sector) const
+{
+	const SceneBinary::BINARY_SECTOR& range = m_pScene->GetSectors()[sector];
+	const uint32_t* pSectorTextures = m_pScene->GetSectorTextures();
+	for (uint32_t i = 0; i < range.textureCount; i++)
+	{
+		if (m_textures[pSectorTextures[range.firstTexture + i]].slot < 0)
+		{
+			return(false);
+		}
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetSectorObjects()
+ ***********************************************************/
+SceneManager::OBJECT_ARRAYS SceneStreamer::GetSectorObjects(uint32_t sector) const
+{
+	const SECTOR_DATA& data = *m_sectors[sector].pData;
+
+	SceneManager::OBJECT_ARRAYS arrays;
+	arrays.count = (uint32_t)data.transforms.size();
+	arrays.pTransforms = data.transforms.data();
+	arrays.pColors = data.colors.data();
+	arrays.pUVScales = data.UVscales.data();
+	arrays.pMeshes = data.meshes.data();
+	arrays.pMaterialIDs = data.materialIDs.data();
+	arrays.pTextureIDs = data.textureIDs.data();
+	arrays.pStateBits = data.stateBits.data();
+	return(arrays);
+}
+
+/***********************************************************
+ *  GetSectorDistance()
+ ***********************************************************/
+float SceneStreamer::GetSectorDistance(uint32_t sector, const glm::vec3& point) const
+{
+	const SceneBinary::BINARY_SECTOR& range = m_pScene->GetSectors()[sector];
+	glm::vec3 boundsMin = glm::make_vec3(range.boundsMin);
+	glm::vec3 boundsMax = glm::make_vec3(range.boundsMax);
+	return(glm::length(point - glm::clamp(point, boundsMin, boundsMax)));
+}
+
+/***********************************************************
+ *  GetSectorBytes()
+ ***********************************************************/
+size_t SceneStreamer::GetSectorBytes(uint32_t sector) const
+{
+	return(m_pScene->GetSectors()[sector].objectCount * OBJECT_BYTES);
+}
+
+/***********************************************************
+ *  PrintReport()
+ ***********************************************************/
+void SceneStreamer::PrintReport(FILE* output) const
+{
+	fprintf(output, "Scene streaming: %llu sector loads, %llu unloads, %llu discarded reads, %llu budget deferrals\n",
+		(unsigned long long)m_sectorLoads,
+		(unsigned long long)m_sectorUnloads,
+		(unsigned long long)m_discardedLoads,
+		(unsigned long long)m_budgetDeferrals);
+	fprintf(output, "  peak resident %.2f MiB of a %.2f MiB budget\n",
+		(double)m_peakResidentBytes / BYTES_PER_MIB,
+		(double)m_settings.budgetBytes / BYTES_PER_MIB);
+}
@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenewatcher.cpp
+// ============
+// notice edits of the scene description file while the application runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneWatcher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// time the file has to be quiet before a change is reported
+	const std::chrono::milliseconds SETTLE_TIME(100);
+	// interval of the checks when the file is polled
+	const std::chrono::milliseconds POLL_INTERVAL(500);
+
+	// read the modification time and size of a file
+	bool ReadFileState(const char* filename, long long& modifiedTime, long long& fileSize)
+	{
+		struct stat state;
+		if (stat(filename, &state) != 0)
+		{
+			return(false);
+		}
+		modifiedTime = (long long)state.st_mtime;
+		fileSize = (long long)state.st_size;
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  SceneWatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneWatcher::SceneWatcher()
+{
+	m_bWatching = false;
+	m_notifyFD = -1;
+	m_watchFD = -1;
+	m_modifiedTime = 0;
+	m_fileSize = 0;
+	m_bPending = false;
+}
+
+/***********************************************************
+ *  ~SceneWatcher()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneWatcher::~SceneWatcher()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used to start watching the passed in file.
+ *  The directory is watched rather than the file, since a
+ *  save that replaces the file would end a watch on it.
+ ***********************************************************/
+bool SceneWatcher::Start(const char* filename)
+{
+	Stop();
+
+	m_filename = filename;
+	std::string directory = ".";
+	size_t separator = m_filename.find_last_of("/\\");
+	if (separator == std::string::npos)
+	{
+		m_baseName = m_filename;
+	}
+	else
+	{
+		directory = m_filename.substr(0, separator + 1);
+		m_baseName = m_filename.substr(separator + 1);
+	}
+
+#ifdef __linux__
+	m_notifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_notifyFD >= 0)
+	{
+		m_watchFD = inotify_add_watch(m_notifyFD, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (m_watchFD < 0)
+		{
+			std::cout << "WARNING: could not watch " << directory << " (" << strerror(errno) << "), polling " << m_filename << std::endl;
+			close(m_notifyFD);
+			m_notifyFD = -1;
+		}
+	}
+#endif
+
+	// without notifications the file is polled
+	if ((m_notifyFD < 0) &&
+		(ReadFileState(m_filename.c_str(), m_modifiedTime, m_fileSize) == false))
+	{
+		std::cout << "Could not watch " << m_filename << std::endl;
+		return(false);
+	}
+
+	m_nextPoll = std::chrono::steady_clock::now() + POLL_INTERVAL;
+	m_bPending = false;
+	m_bWatching = true;
+	std::cout << "INFO: watching " << m_filename << " for changes" << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ ***********************************************************/
+void SceneWatcher::Stop()
+{
+#ifdef __linux__
+	if (m_notifyFD >= 0)
+	{
+		// closing the descriptor removes its watch
+		close(m_notifyFD);
+	}
+#endif
+	m_notifyFD = -1;
+	m_watchFD = -1;
+	m_bPending = false;
+	m_bWatching = false;
+}
+
+/***********************************************************
+ *  PollChanges()
+ *
+ *  This method is used to drain the notifications, or to
+ *  check the file when polling, and tells whether the file
+ *  was written since the last check.
+ ***********************************************************/
+bool SceneWatcher::PollChanges()
+{
+	bool bChanged = false;
+
+#ifdef __linux__
+	if (m_notifyFD >= 0)
+	{
+		// the buffer is aligned for the events read into it
+		alignas(struct inotify_event) char buffer[4096];
+		ssize_t length = 0;
+		while ((length = read(m_notifyFD, buffer, sizeof(buffer))) > 0)
+		{
+			ssize_t offset = 0;
+			while (offset < length)
+			{
+				const struct inotify_event* pEvent = (const struct inotify_event*)(buffer + offset);
+				if ((pEvent->len > 0) && (m_baseName == pEvent->name))
+				{
+					bChanged = true;
+				}
+				offset += sizeof(struct inotify_event) + pEvent->len;
+			}
+		}
+		return(bChanged);
+	}
+#endif
+
+	auto now = std::chrono::steady_clock::now();
+	if (now < m_nextPoll)
+	{
+		return(false);
+	}
+	m_nextPoll = now + POLL_INTERVAL;
+
+	long long modifiedTime = 0;
+	long long fileSize = 0;
+	// a file missing in the middle of a save is checked again
+	if ((ReadFileState(m_filename.c_str(), modifiedTime, fileSize) == true) &&
+		((modifiedTime != m_modifiedTime) || (fileSize != m_fileSize)))
+	{
+		m_modifiedTime = modifiedTime;
+		m_fileSize = fileSize;
+		bChanged = true;
+	}
+	return(bChanged);
+}
+
+/***********************************************************
+ *  HasChanged()
+ *
+ *  This method is used to tell whether the file was changed
+ *  and has since been quiet long enough to be read.
+ ***********************************************************/
+bool SceneWatcher::HasChanged()
+{
+	if (m_bWatching == false)
+	{
+		return(false);
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if (PollChanges() == true)
+	{
+		m_bPending = true;
+		m_lastEvent = now;
+	}
+
+	if ((m_bPending == true) && (now - m_lastEvent >= SETTLE_TIME))
+	{
+		m_bPending = false;
+		return(true);
+	}
+	return(false);
+}
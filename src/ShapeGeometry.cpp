@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.cpp
+// ============
+// generate the primitive shapes as indexed triangles in model space
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+#include "SceneFile.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// segments the round shapes are generated with
+	const int CYLINDER_SLICES = 36;
+	const int TORUS_RING_SLICES = 36;
+	const int TORUS_TUBE_SLICES = 18;
+	// tube radius of the torus, the shape meshes' default
+	const float TORUS_TUBE_RADIUS = 0.1f;
+	const float TWO_PI = 6.28318531f;
+	// growth of the ACMR allowed to reduce overdraw
+	const float OVERDRAW_THRESHOLD = 1.05f;
+
+	ShapeGeometry::GEOMETRY g_Geometries[SceneManager::MESH_COUNT];
+	bool g_bBuilt = false;
+
+	uint32_t AddVertex(ShapeGeometry::GEOMETRY& geometry, const glm::vec3& position, const glm::vec3& normal, const glm::vec2& UV)
+	{
+		ShapeGeometry::VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.UV = UV;
+		geometry.vertices.push_back(vertex);
+		return((uint32_t)geometry.vertices.size() - 1);
+	}
+
+	// add a triangle wound counter-clockwise when seen from the
+	// side its vertex normals face
+	void AddTriangle(ShapeGeometry::GEOMETRY& geometry, uint32_t a, uint32_t b, uint32_t c)
+	{
+		const ShapeGeometry::VERTEX& va = geometry.vertices[a];
+		const ShapeGeometry::VERTEX& vb = geometry.vertices[b];
+		const ShapeGeometry::VERTEX& vc = geometry.vertices[c];
+		glm::vec3 faceNormal = glm::cross(vb.position - va.position, vc.position - va.position);
+		if (glm::dot(faceNormal, va.normal + vb.normal + vc.normal) < 0.0f)
+		{
+			std::swap(b, c);
+		}
+		geometry.indices.push_back(a);
+		geometry.indices.push_back(b);
+		geometry.indices.push_back(c);
+	}
+
+	void AddQuad(ShapeGeometry::GEOMETRY& geometry, uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+	{
+		AddTriangle(geometry, a, b, c);
+		AddTriangle(geometry, a, c, d);
+	}
+
+	// a unit square on the XZ plane, facing up
+	void BuildPlane(ShapeGeometry::GEOMETRY& geometry)
+	{
+		const glm::vec3 up(0.0f, 1.0f, 0.0f);
+		uint32_t a = AddVertex(geometry, glm::vec3(-1.0f, 0.0f, -1.0f), up, glm::vec2(0.0f, 1.0f));
+		uint32_t b = AddVertex(geometry, glm::vec3(1.0f, 0.0f, -1.0f), up, glm::vec2(1.0f, 1.0f));
+		uint32_t c = AddVertex(geometry, glm::vec3(1.0f, 0.0f, 1.0f), up, glm::vec2(1.0f, 0.0f));
+		uint32_t d = AddVertex(geometry, glm::vec3(-1.0f, 0.0f, 1.0f), up, glm::vec2(0.0f, 0.0f));
+		AddQuad(geometry, a, b, c, d);
+	}
+
+	// a unit cube around the origin, each face with its own
+	// vertices and the whole texture
+	void BuildBox(ShapeGeometry::GEOMETRY& geometry)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (int side = 0; side < 2; side++)
+			{
+				glm::vec3 normal(0.0f);
+				normal[axis] = (side == 0) ? -1.0f : 1.0f;
+				const int uAxis = (axis + 1) % 3;
+				const int vAxis = (axis + 2) % 3;
+
+				uint32_t corners[4];
+				for (int corner = 0; corner < 4; corner++)
+				{
+					const float u = ((corner == 1) || (corner == 2)) ? 1.0f : 0.0f;
+					const float v = (corner >= 2) ? 1.0f : 0.0f;
+					glm::vec3 position = normal * 0.5f;
+					position[uAxis] = u - 0.5f;
+					position[vAxis] = v - 0.5f;
+					corners[corner] = AddVertex(geometry, position, normal, glm::vec2(u, v));
+				}
+				AddQuad(geometry, corners[0], corners[1], corners[2], corners[3]);
+			}
+		}
+	}
+
+	// a cylinder of unit radius standing on the origin, one
+	// unit high, with both caps
+	void BuildCylinder(ShapeGeometry::GEOMETRY& geometry)
+	{
+		for (int i = 0; i < CYLINDER_SLICES; i++)
+		{
+			const float angle0 = TWO_PI * (float)i / (float)CYLINDER_SLICES;
+			const float angle1 = TWO_PI * (float)(i + 1) / (float)CYLINDER_SLICES;
+			const glm::vec3 normal0(std::cos(angle0), 0.0f, std::sin(angle0));
+			const glm::vec3 normal1(std::cos(angle1), 0.0f, std::sin(angle1));
+			const float u0 = (float)i / (float)CYLINDER_SLICES;
+			const float u1 = (float)(i + 1) / (float)CYLINDER_SLICES;
+
+			uint32_t a = AddVertex(geometry, normal0, normal0, glm::vec2(u0, 0.0f));
+			uint32_t b = AddVertex(geometry, normal1, normal1, glm::vec2(u1, 0.0f));
+			uint32_t c = AddVertex(geometry, normal1 + glm::vec3(0.0f, 1.0f, 0.0f), normal1, glm::vec2(u1, 1.0f));
+			uint32_t d = AddVertex(geometry, normal0 + glm::vec3(0.0f, 1.0f, 0.0f), normal0, glm::vec2(u0, 1.0f));
+			AddQuad(geometry, a, b, c, d);
+		}
+
+		for (int cap = 0; cap < 2; cap++)
+		{
+			const float height = (float)cap;
+			const glm::vec3 normal(0.0f, (cap == 0) ? -1.0f : 1.0f, 0.0f);
+			uint32_t center = AddVertex(geometry, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+			for (int i = 0; i < CYLINDER_SLICES; i++)
+			{
+				const float angle0 = TWO_PI * (float)i / (float)CYLINDER_SLICES;
+				const float angle1 = TWO_PI * (float)(i + 1) / (float)CYLINDER_SLICES;
+				const float x0 = std::cos(angle0);
+				const float z0 = std::sin(angle0);
+				const float x1 = std::cos(angle1);
+				const float z1 = std::sin(angle1);
+				uint32_t a = AddVertex(geometry, glm::vec3(x0, height, z0), normal, glm::vec2(0.5f + 0.5f * x0, 0.5f + 0.5f * z0));
+				uint32_t b = AddVertex(geometry, glm::vec3(x1, height, z1), normal, glm::vec2(0.5f + 0.5f * x1, 0.5f + 0.5f * z1));
+				AddTriangle(geometry, center, a, b);
+			}
+		}
+	}
+
+	// a ring of unit radius in the XY plane
+	void BuildTorus(ShapeGeometry::GEOMETRY& geometry)
+	{
+		const uint32_t first = (uint32_t)geometry.vertices.size();
+		for (int ring = 0; ring <= TORUS_RING_SLICES; ring++)
+		{
+			const float ringAngle = TWO_PI * (float)ring / (float)TORUS_RING_SLICES;
+			const glm::vec3 outward(std::cos(ringAngle), std::sin(ringAngle), 0.0f);
+			for (int tube = 0; tube <= TORUS_TUBE_SLICES; tube++)
+			{
+				const float tubeAngle = TWO_PI * (float)tube / (float)TORUS_TUBE_SLICES;
+				const glm::vec3 normal = outward * std::cos(tubeAngle) + glm::vec3(0.0f, 0.0f, std::sin(tubeAngle));
+				AddVertex(geometry, outward + normal * TORUS_TUBE_RADIUS, normal,
+					glm::vec2((float)ring / (float)TORUS_RING_SLICES, (float)tube / (float)TORUS_TUBE_SLICES));
+			}
+		}
+
+		const uint32_t rowVertices = TORUS_TUBE_SLICES + 1;
+		for (uint32_t ring = 0; ring < TORUS_RING_SLICES; ring++)
+		{
+			for (uint32_t tube = 0; tube < TORUS_TUBE_SLICES; tube++)
+			{
+				uint32_t a = first + ring * rowVertices + tube;
+				AddQuad(geometry, a, a + rowVertices, a + rowVertices + 1, a + 1);
+			}
+		}
+	}
+
+	// weld a generated shape and reorder it for the vertex cache
+	// and overdraw, reporting the simulated costs
+	void OptimizeGeometry(SceneManager::MESH_TYPE mesh, ShapeGeometry::GEOMETRY& geometry)
+	{
+		const size_t generatedCount = geometry.vertices.size();
+		const MeshOptimizer::CACHE_STATISTICS cacheBefore = MeshOptimizer::AnalyzeVertexCache(geometry.indices, generatedCount);
+		const MeshOptimizer::FETCH_STATISTICS fetchBefore = MeshOptimizer::AnalyzeVertexFetch(geometry.indices, generatedCount, sizeof(ShapeGeometry::VERTEX));
+
+		std::vector<uint32_t> vertexOrder;
+		const size_t vertexCount = MeshOptimizer::WeldVertices(geometry.indices, vertexOrder,
+			geometry.vertices.data(), generatedCount, sizeof(ShapeGeometry::VERTEX));
+		std::vector<ShapeGeometry::VERTEX> vertices(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			vertices[v] = geometry.vertices[vertexOrder[v]];
+		}
+		geometry.vertices.swap(vertices);
+
+		MeshOptimizer::OptimizeVertexCache(geometry.indices, vertexCount);
+		MeshOptimizer::OptimizeOverdraw(geometry.indices, &geometry.vertices[0].position.x,
+			sizeof(ShapeGeometry::VERTEX) / sizeof(float), vertexCount, OVERDRAW_THRESHOLD);
+
+		const MeshOptimizer::CACHE_STATISTICS cacheAfter = MeshOptimizer::AnalyzeVertexCache(geometry.indices, vertexCount);
+		const MeshOptimizer::FETCH_STATISTICS fetchAfter = MeshOptimizer::AnalyzeVertexFetch(geometry.indices, vertexCount, sizeof(ShapeGeometry::VERTEX));
+		std::cout << "INFO: " << SceneFile::GetMeshName(mesh) << " mesh vertices " << generatedCount << " -> " << vertexCount
+			<< ", ACMR " << cacheBefore.ACMR << " -> " << cacheAfter.ACMR
+			<< ", ATVR " << cacheBefore.ATVR << " -> " << cacheAfter.ATVR
+			<< ", vertex fetch " << fetchBefore.bytesFetched << " -> " << fetchAfter.bytesFetched << " bytes" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  Prepare()
+ *
+ *  This method is used for building every shape and
+ *  reordering it for the GPU, which prints the statistics
+ *  of each shape before and after.
+ ***********************************************************/
+void ShapeGeometry::Prepare()
+{
+	if (g_bBuilt == true)
+	{
+		return;
+	}
+
+	BuildPlane(g_Geometries[SceneManager::MESH_PLANE]);
+	BuildBox(g_Geometries[SceneManager::MESH_BOX]);
+	BuildCylinder(g_Geometries[SceneManager::MESH_CYLINDER]);
+	BuildTorus(g_Geometries[SceneManager::MESH_TORUS]);
+	for (int mesh = 0; mesh < SceneManager::MESH_COUNT; mesh++)
+	{
+		OptimizeGeometry((SceneManager::MESH_TYPE)mesh, g_Geometries[mesh]);
+	}
+	g_bBuilt = true;
+}
+
+/***********************************************************
+ *  GetMeshGeometry()
+ ***********************************************************/
+const ShapeGeometry::GEOMETRY& ShapeGeometry::GetMeshGeometry(SceneManager::MESH_TYPE mesh)
+{
+	Prepare();
+	return(g_Geometries[mesh]);
+}
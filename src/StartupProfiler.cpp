@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+// startupprofiler.cpp
+// ============
+// time every startup phase and asset up to the first presented frame
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StartupProfiler.h"
+
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	struct PHASE_RECORD
+	{
+		std::string name;
+		int depth;
+		double startMs;
+		double wallMs;
+		double cpuMs;
+		double ioMs;
+		// CPU clock at the start, while the phase is open
+		std::clock_t cpuStart;
+	};
+
+	// process start is taken at static initialization, which runs
+	// before main() and after only the dynamic loader
+	const std::chrono::steady_clock::time_point g_ProcessStart = std::chrono::steady_clock::now();
+
+	std::vector<PHASE_RECORD> g_Phases;
+	// indices of the open phases, innermost last
+	std::vector<size_t> g_OpenPhases;
+	double g_FirstFrameMs = -1.0;
+
+	// write a phase name, which can hold a scene file's texture
+	// tag, with the characters JSON needs escaped
+	void WriteJSONString(FILE* file, const std::string& text)
+	{
+		fputc('"', file);
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				fputc('\\', file);
+			}
+			fputc(((unsigned char)c < 0x20) ? ' ' : c, file);
+		}
+		fputc('"', file);
+	}
+
+	// milliseconds since process start
+	double ElapsedMs()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - g_ProcessStart).count());
+	}
+
+	// process CPU time between two std::clock() readings
+	double CPUMs(std::clock_t start, std::clock_t end)
+	{
+		return(1000.0 * (double)(end - start) / CLOCKS_PER_SEC);
+	}
+}
+
+/***********************************************************
+ *  BeginPhase()
+ *
+ *  This method is used for opening a phase.  Phases opened
+ *  after the first frame are ignored.
+ ***********************************************************/
+void StartupProfiler::BeginPhase(const std::string& name)
+{
+	if (IsFirstFrameMarked() == true)
+	{
+		return;
+	}
+
+	PHASE_RECORD phase;
+	phase.name = name;
+	phase.depth = (int)g_OpenPhases.size();
+	phase.startMs = ElapsedMs();
+	phase.wallMs = 0.0;
+	phase.cpuMs = 0.0;
+	phase.ioMs = 0.0;
+	phase.cpuStart = std::clock();
+
+	g_OpenPhases.push_back(g_Phases.size());
+	g_Phases.push_back(phase);
+}
+
+/***********************************************************
+ *  EndPhase()
+ ***********************************************************/
+void StartupProfiler::EndPhase()
+{
+	if (g_OpenPhases.empty())
+	{
+		return;
+	}
+
+	PHASE_RECORD& phase = g_Phases[g_OpenPhases.back()];
+	g_OpenPhases.pop_back();
+
+	phase.wallMs = ElapsedMs() - phase.startMs;
+	phase.cpuMs = CPUMs(phase.cpuStart, std::clock());
+}
+
+/***********************************************************
+ *  AddIOTime()
+ *
+ *  This method is used for charging time spent in file reads
+ *  to every open phase, so a loading phase includes the I/O
+ *  of its assets.
+ ***********************************************************/
+void StartupProfiler::AddIOTime(double milliseconds)
+{
+	for (size_t index : g_OpenPhases)
+	{
+		g_Phases[index].ioMs += milliseconds;
+	}
+}
+
+/***********************************************************
+ *  MarkFirstFrame()
+ *
+ *  This method is used for ending the profile once the first
+ *  frame has been presented.  Phases still open are closed.
+ ***********************************************************/
+void StartupProfiler::MarkFirstFrame()
+{
+	if (IsFirstFrameMarked() == true)
+	{
+		return;
+	}
+
+	while (!g_OpenPhases.empty())
+	{
+		EndPhase();
+	}
+	g_FirstFrameMs = ElapsedMs();
+}
+
+/***********************************************************
+ *  IsFirstFrameMarked()
+ ***********************************************************/
+bool StartupProfiler::IsFirstFrameMarked()
+{
+	return(g_FirstFrameMs >= 0.0);
+}
+
+/***********************************************************
+ *  GetTimeToFirstFrame()
+ ***********************************************************/
+double StartupProfiler::GetTimeToFirstFrame()
+{
+	return(g_FirstFrameMs);
+}
+
+/***********************************************************
+ *  PrintReport()
+ *
+ *  This method is used for printing every phase with its
+ *  start time and its wall, CPU and I/O time, indented by
+ *  nesting depth.
+ ***********************************************************/
+void StartupProfiler::PrintReport(FILE* output)
+{
+	fprintf(output, "Startup phases (ms)            start      wall       cpu        io\n");
+	for (const PHASE_RECORD& phase : g_Phases)
+	{
+		std::string label = std::string(phase.depth * 2, ' ') + phase.name;
+		fprintf(output, "  %-28s %8.2f  %8.2f  %8.2f  %8.2f\n",
+			label.c_str(),
+			phase.startMs,
+			phase.wallMs,
+			phase.cpuMs,
+			phase.ioMs);
+	}
+	fprintf(output, "  %-28s %8.2f\n", "first frame presented", g_FirstFrameMs);
+	fflush(output);
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing every phase as a flat list
+ *  with its nesting depth.
+ ***********************************************************/
+bool StartupProfiler::WriteJSON(const char* filename)
+{
+	FILE* file = fopen(filename, "w");
+	if (NULL == file)
+	{
+		std::cout << "Could not write startup report:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\n  \"time_to_first_frame_ms\": %.3f,\n  \"phases\": [", g_FirstFrameMs);
+	for (size_t i = 0; i < g_Phases.size(); i++)
+	{
+		const PHASE_RECORD& phase = g_Phases[i];
+		fprintf(file, "%s\n    { \"name\": ", (i > 0) ? "," : "");
+		WriteJSONString(file, phase.name);
+		fprintf(file,
+			", \"depth\": %d, \"start_ms\": %.3f, \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"io_ms\": %.3f }",
+			phase.depth,
+			phase.startMs,
+			phase.wallMs,
+			phase.cpuMs,
+			phase.ioMs);
+	}
+	fprintf(file, "\n  ]\n}\n");
+	fclose(file);
+
+	return(true);
+}
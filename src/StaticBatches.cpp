@@ -0,0 +1,297 @@
+///////////////////////////////////////////////////////////////////////////////
+// staticbatches.cpp
+// ============
+// merge the static objects of a scene into world space batches
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StaticBatches.h"
+#include "ObjectStore.h"
+#include "SceneFile.h"
+#include "GLHooks.h"
+#include "ShapeGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+
+// declaration of global variables
+namespace
+{
+	// the settings and grid cell that objects are merged by
+	struct BATCH_KEY
+	{
+		int bUseTexture;
+		int textureSlot;
+		int materialIndex;
+		glm::vec4 color;
+		glm::vec2 UVscale;
+		int cellX;
+		int cellY;
+		int cellZ;
+
+		bool operator<(const BATCH_KEY& other) const
+		{
+			return(std::tie(bUseTexture, textureSlot, materialIndex, color.r, color.g, color.b, color.a,
+				UVscale.x, UVscale.y, cellX, cellY, cellZ) <
+				std::tie(other.bUseTexture, other.textureSlot, other.materialIndex,
+				other.color.r, other.color.g, other.color.b, other.color.a,
+				other.UVscale.x, other.UVscale.y, other.cellX, other.cellY, other.cellZ));
+		}
+		bool operator!=(const BATCH_KEY& other) const
+		{
+			return((*this < other) || (other < *this));
+		}
+	};
+
+	// append a shape drawn with a model matrix in world space
+	void AppendWorldGeometry(
+		const SceneManager::DRAW_COMMAND& draw,
+		std::vector<ShapeGeometry::VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		const ShapeGeometry::GEOMETRY& geometry = ShapeGeometry::GetMeshGeometry(draw.mesh);
+		const glm::mat3 linear(draw.model);
+		const glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+		// a mirroring transform turns the triangles around
+		const bool bMirrored = (glm::dot(glm::cross(linear[0], linear[1]), linear[2]) < 0.0f);
+		const uint32_t first = (uint32_t)vertices.size();
+
+		for (const ShapeGeometry::VERTEX& vertex : geometry.vertices)
+		{
+			ShapeGeometry::VERTEX world;
+			world.position = glm::vec3(draw.model * glm::vec4(vertex.position, 1.0f));
+			world.normal = glm::normalize(normalMatrix * vertex.normal);
+			world.UV = vertex.UV;
+			vertices.push_back(world);
+		}
+		for (size_t i = 0; i < geometry.indices.size(); i += 3)
+		{
+			indices.push_back(first + geometry.indices[i]);
+			indices.push_back(first + geometry.indices[(bMirrored == true) ? i + 2 : i + 1]);
+			indices.push_back(first + geometry.indices[(bMirrored == true) ? i + 1 : i + 2]);
+		}
+	}
+
+	int GetCell(float center, float chunkSize)
+	{
+		return((chunkSize > 0.0f) ? (int)std::floor(center / chunkSize) : 0);
+	}
+}
+
+/***********************************************************
+ *  StaticBatches()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StaticBatches::StaticBatches()
+{
+	m_vertexArray = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_bufferBytes = 0;
+}
+
+/***********************************************************
+ *  ~StaticBatches()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+StaticBatches::~StaticBatches()
+{
+	DestroyBuffers();
+}
+
+/***********************************************************
+ *  Add()
+ ***********************************************************/
+void StaticBatches::Add(const SceneManager::DRAW_COMMAND& draw)
+{
+	if ((draw.mesh >= 0) && (draw.mesh < SceneManager::MESH_COUNT))
+	{
+		m_objects.push_back(draw);
+	}
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for merging the objects into batches.
+ *  The objects are sorted by their shader settings and grid
+ *  cell, keeping their order otherwise, and each run of equal
+ *  keys is transformed into world space as one batch.  The
+ *  color only splits untextured objects, as the shader does
+ *  not use it for textured ones.
+ ***********************************************************/
+void StaticBatches::Build(float chunkSize)
+{
+	DestroyBuffers();
+	m_batches.clear();
+
+	std::vector<BATCH_KEY> keys(m_objects.size());
+	std::vector<glm::vec3> worldMin(m_objects.size());
+	std::vector<glm::vec3> worldMax(m_objects.size());
+	std::vector<size_t> order(m_objects.size());
+	for (size_t i = 0; i < m_objects.size(); i++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = m_objects[i];
+		SceneFile::GetWorldBounds(draw.mesh, draw.model, worldMin[i], worldMax[i]);
+		const glm::vec3 center = (worldMin[i] + worldMax[i]) * 0.5f;
+
+		BATCH_KEY& key = keys[i];
+		key.bUseTexture = (draw.bUseTexture == true) ? 1 : 0;
+		key.textureSlot = (draw.bUseTexture == true) ? draw.textureSlot : 0;
+		key.materialIndex = draw.materialIndex;
+		key.color = (draw.bUseTexture == true) ? glm::vec4(0.0f) : draw.color;
+		key.UVscale = draw.UVscale;
+		key.cellX = GetCell(center.x, chunkSize);
+		key.cellY = GetCell(center.y, chunkSize);
+		key.cellZ = GetCell(center.z, chunkSize);
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[&keys](size_t a, size_t b) { return(keys[a] < keys[b]); });
+
+	std::vector<ShapeGeometry::VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	for (size_t k = 0; k < order.size(); k++)
+	{
+		const size_t i = order[k];
+		if ((k == 0) || (keys[i] != keys[order[k - 1]]))
+		{
+			BATCH batch;
+			batch.draw = m_objects[i];
+			batch.draw.model = glm::mat4(1.0f);
+			batch.draw.mesh = SceneManager::MESH_STATIC_BATCH;
+			batch.draw.batch = (uint32_t)m_batches.size();
+			batch.draw.stateBits = 0;
+			batch.firstIndex = (uint32_t)indices.size();
+			batch.indexCount = 0;
+			batch.objectCount = 0;
+			batch.boundsMin = worldMin[i];
+			batch.boundsMax = worldMax[i];
+			m_batches.push_back(batch);
+		}
+
+		BATCH& batch = m_batches.back();
+		AppendWorldGeometry(m_objects[i], vertices, indices);
+		batch.indexCount = (uint32_t)indices.size() - batch.firstIndex;
+		batch.objectCount++;
+		batch.boundsMin = glm::min(batch.boundsMin, worldMin[i]);
+		batch.boundsMax = glm::max(batch.boundsMax, worldMax[i]);
+	}
+	m_visible.assign(m_batches.size(), 1);
+
+	if (indices.empty() == true)
+	{
+		return;
+	}
+
+	// the buffers are accounted under their own tag
+	GLHooks::SetResourceTag("static batches");
+	glGenVertexArrays(1, &m_vertexArray);
+	glBindVertexArray(m_vertexArray);
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertices.size() * sizeof(ShapeGeometry::VERTEX)), vertices.data(), GL_STATIC_DRAW);
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint32_t)), indices.data(), GL_STATIC_DRAW);
+	GLHooks::SetResourceTag(NULL);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, normal));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ShapeGeometry::VERTEX), (void*)offsetof(ShapeGeometry::VERTEX, UV));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+
+	m_bufferBytes = vertices.size() * sizeof(ShapeGeometry::VERTEX) + indices.size() * sizeof(uint32_t);
+}
+
+/***********************************************************
+ *  Clear()
+ ***********************************************************/
+void StaticBatches::Clear()
+{
+	DestroyBuffers();
+	m_objects.clear();
+	m_batches.clear();
+	m_visible.clear();
+}
+
+/***********************************************************
+ *  DestroyBuffers()
+ ***********************************************************/
+void StaticBatches::DestroyBuffers()
+{
+	if (0 != m_vertexArray)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (0 != m_vertexBuffer)
+	{
+		glDeleteBuffers(1, &m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (0 != m_indexBuffer)
+	{
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+	m_bufferBytes = 0;
+}
+
+/***********************************************************
+ *  Cull()
+ ***********************************************************/
+uint32_t StaticBatches::Cull(const glm::mat4& viewProjection)
+{
+	glm::vec4 planes[6];
+	ObjectStore::GetFrustumPlanes(viewProjection, planes);
+
+	uint32_t visibleCount = 0;
+	for (size_t i = 0; i < m_batches.size(); i++)
+	{
+		const BATCH& batch = m_batches[i];
+		m_visible[i] = 1;
+		for (const glm::vec4& plane : planes)
+		{
+			glm::vec3 corner(
+				(plane.x >= 0.0f) ? batch.boundsMax.x : batch.boundsMin.x,
+				(plane.y >= 0.0f) ? batch.boundsMax.y : batch.boundsMin.y,
+				(plane.z >= 0.0f) ? batch.boundsMax.z : batch.boundsMin.z);
+			if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+			{
+				m_visible[i] = 0;
+				break;
+			}
+		}
+		visibleCount += m_visible[i];
+	}
+	return(visibleCount);
+}
+
+/***********************************************************
+ *  Draw()
+ ***********************************************************/
+void StaticBatches::Draw(uint32_t batch) const
+{
+	glBindVertexArray(m_vertexArray);
+	glDrawElements(GL_TRIANGLES, (GLsizei)m_batches[batch].indexCount, GL_UNSIGNED_INT,
+		(void*)(sizeof(uint32_t) * m_batches[batch].firstIndex));
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  GetBytes()
+ ***********************************************************/
+size_t StaticBatches::GetBytes() const
+{
+	return(m_objects.capacity() * sizeof(SceneManager::DRAW_COMMAND) +
+		m_batches.capacity() * sizeof(BATCH) +
+		m_visible.capacity());
+}
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// submissiontuner.cpp
+// ============
+// pick the fastest way of submitting the scene's draws on this renderer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SubmissionTuner.h"
+#include "GLTrace.h"
+
+#include "GLFW/glfw3.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// frames rendered before timing starts
+	const int WARMUP_FRAMES = 3;
+	// frames timed for each strategy, taken in turns so that
+	// clock and thermal changes affect every strategy alike
+	const int TIMED_FRAMES = 20;
+
+	// camera pose the strategies are timed from, the whole desk
+	// in view as in the default regression pose
+	const glm::vec3 CALIBRATION_POSITION = glm::vec3(0.0f, 5.0f, -90.0f);
+	const glm::vec3 CALIBRATION_FRONT = glm::vec3(0.0f, -0.5f, 2.0f);
+	const float CALIBRATION_ZOOM = 80.0f;
+}
+
+/***********************************************************
+ *  SubmissionTuner()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SubmissionTuner::SubmissionTuner(
+	SceneManager* pSceneManager,
+	ViewManager* pViewManager)
+{
+	m_pSceneManager = pSceneManager;
+	m_pViewManager = pViewManager;
+}
+
+/***********************************************************
+ *  SelectStrategy()
+ *
+ *  This method is used for selecting the submission strategy
+ *  cached for the current renderer.  When there is none, or
+ *  a new calibration is requested, the strategies are timed
+ *  and the fastest is cached.
+ ***********************************************************/
+void SubmissionTuner::SelectStrategy(const char* cacheFile, bool bRecalibrate)
+{
+	const char* rendererName = (const char*)glGetString(GL_RENDERER);
+	std::string renderer = (NULL != rendererName) ? rendererName : "unknown";
+
+	SceneManager::SUBMIT_STRATEGY strategy = SceneManager::SUBMIT_CHANGED_STATE;
+	if ((bRecalibrate == false) && (LoadCachedStrategy(cacheFile, renderer, strategy) == true))
+	{
+		std::cout << "INFO: Using cached submission strategy " << SceneManager::GetSubmitStrategyName(strategy)
+			<< " for " << renderer << std::endl;
+	}
+	else
+	{
+		strategy = Calibrate();
+		std::cout << "INFO: Selected submission strategy " << SceneManager::GetSubmitStrategyName(strategy)
+			<< " for " << renderer << std::endl;
+		SaveCachedStrategy(cacheFile, renderer, strategy);
+	}
+
+	m_pSceneManager->SetSubmitStrategy(strategy);
+}
+
+/***********************************************************
+ *  Calibrate()
+ *
+ *  This method is used for rendering the scene with every
+ *  submission strategy in turn, the changed, full and
+ *  filtered state alike, and returning the one with the
+ *  lowest median frame time.  glFinish() makes the driver and
+ *  GPU work part of each sample.  The scene is rendered from
+ *  a fixed pose straight through RenderScene(), so no input
+ *  is taken and the camera is not moved, and the frames are
+ *  left out of a GL trace being recorded.  The strategy
+ *  selected before the calibration is restored.
+ ***********************************************************/
+SceneManager::SUBMIT_STRATEGY SubmissionTuner::Calibrate()
+{
+	SceneManager::SUBMIT_STRATEGY previous = m_pSceneManager->GetSubmitStrategy();
+	std::vector<std::vector<float>> frameTimes(SceneManager::SUBMIT_STRATEGY_COUNT);
+
+	// the view is set while the trace still records, so the
+	// uniform locations it looks up the first time are in it
+	m_pViewManager->PrepareFixedView(CALIBRATION_POSITION, CALIBRATION_FRONT, CALIBRATION_ZOOM, false);
+	m_pSceneManager->SetViewMatrices(m_pViewManager->GetViewMatrix(), m_pViewManager->GetProjectionMatrix());
+	GLTrace::PauseRecording();
+	glEnable(GL_DEPTH_TEST);
+
+	for (int frame = 0; frame < WARMUP_FRAMES + TIMED_FRAMES; frame++)
+	{
+		for (int i = 0; i < SceneManager::SUBMIT_STRATEGY_COUNT; i++)
+		{
+			m_pSceneManager->SetSubmitStrategy((SceneManager::SUBMIT_STRATEGY)i);
+
+			double start = glfwGetTime();
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			m_pSceneManager->RenderScene();
+			glFinish();
+			double end = glfwGetTime();
+
+			if (frame >= WARMUP_FRAMES)
+			{
+				frameTimes[i].push_back((float)((end - start) * 1000.0));
+			}
+		}
+	}
+
+	GLTrace::ResumeRecording();
+	m_pSceneManager->SetSubmitStrategy(previous);
+
+	SceneManager::SUBMIT_STRATEGY fastest = SceneManager::SUBMIT_CHANGED_STATE;
+	float fastestMs = 0.0f;
+	for (int i = 0; i < SceneManager::SUBMIT_STRATEGY_COUNT; i++)
+	{
+		std::sort(frameTimes[i].begin(), frameTimes[i].end());
+		float medianMs = frameTimes[i][frameTimes[i].size() / 2];
+
+		std::cout << "INFO: Submission strategy " << SceneManager::GetSubmitStrategyName((SceneManager::SUBMIT_STRATEGY)i)
+			<< ": median " << medianMs << " ms" << std::endl;
+
+		if ((i == 0) || (medianMs < fastestMs))
+		{
+			fastest = (SceneManager::SUBMIT_STRATEGY)i;
+			fastestMs = medianMs;
+		}
+	}
+
+	return(fastest);
+}
+
+/***********************************************************
+ *  LoadCachedStrategy()
+ *
+ *  This method is used for reading the strategy cached for
+ *  the passed in renderer.  Each line of the cache holds a
+ *  strategy name, a tab and the renderer string.
+ ***********************************************************/
+bool SubmissionTuner::LoadCachedStrategy(
+	const char* cacheFile,
+	const std::string& renderer,
+	SceneManager::SUBMIT_STRATEGY& strategy)
+{
+	std::ifstream file(cacheFile);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		size_t tab = line.find('\t');
+		if ((tab != std::string::npos) && (line.compare(tab + 1, std::string::npos, renderer) == 0))
+		{
+			return(SceneManager::FindSubmitStrategy(line.substr(0, tab).c_str(), strategy));
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  SaveCachedStrategy()
+ *
+ *  This method is used for writing the strategy for the
+ *  passed in renderer into the cache, keeping the entries of
+ *  the other renderers.
+ ***********************************************************/
+bool SubmissionTuner::SaveCachedStrategy(
+	const char* cacheFile,
+	const std::string& renderer,
+	SceneManager::SUBMIT_STRATEGY strategy)
+{
+	std::vector<std::string> lines;
+	{
+		std::ifstream file(cacheFile);
+		std::string line;
+		while (std::getline(file, line))
+		{
+			size_t tab = line.find('\t');
+			if ((tab != std::string::npos) && (line.compare(tab + 1, std::string::npos, renderer) != 0))
+			{
+				lines.push_back(line);
+			}
+		}
+	}
+	lines.push_back(std::string(SceneManager::GetSubmitStrategyName(strategy)) + "\t" + renderer);
+
+	std::ofstream file(cacheFile);
+	if (!file)
+	{
+		std::cout << "Could not write submission cache:" << cacheFile << std::endl;
+		return(false);
+	}
+	for (const std::string& line : lines)
+	{
+		file << line << "\n";
+	}
+
+	return(true);
+}
@@ -1,278 +1,532 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	
-	//g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, -90.0f);
-	
-	//previously -2 z direction
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, 2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// receives first mouse move event to continue to track x and y positions
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-
-//Scroll calllback function which detects scroll events and proceeds to call the pre-defined "ProcessMouseScroll" function passing in the yoffset value as a parameter
-void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	g_pCamera->ProcessMouseScroll(yoffset);
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	//exits the method if camera is null
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	//processes camera zoom in and out respectively
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	//processes camera pan left and right respectively
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-
-	//processes camera's vertical movement (up and down respectively)
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-
-	// used to change perspective
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		bOrthographicProjection = false;
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		bOrthographicProjection = true;
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (bOrthographicProjection == false)
-	{
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-	else
-	{
-		// front-view orthographic projection with correct aspect ratio
-		double scale = 0.0;
-		if (WINDOW_WIDTH > WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_HEIGHT / (double)WINDOW_WIDTH;
-			projection = glm::ortho(-5.0f, 5.0f, -5.0f * (float)scale, 5.0f * (float)scale, 0.1f, 100.0f);
-		}
-		else if (WINDOW_WIDTH < WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_WIDTH / (double)WINDOW_HEIGHT;
-			projection = glm::ortho(-5.0f * (float)scale, 5.0f * (float)scale, -5.0f, 5.0f, 0.1f, 100.0f);
-		}
-		else
-		{
-			projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f);
-		}
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+#include "ProfileZone.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+#include <cstring>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height, the size can be
+	// changed before the window is created
+	int g_WindowWidth = 1000;
+	int g_WindowHeight = 800;
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = g_WindowWidth / 2.0f;
+	float gLastY = g_WindowHeight / 2.0f;
+	bool gFirstMouse = true;
+
+	// mouse and scroll movement gathered by the callbacks since
+	// the last frame, applied once per frame so it can be recorded
+	float gMouseOffsetX = 0.0f;
+	float gMouseOffsetY = 0.0f;
+	float gScrollOffset = 0.0f;
+	bool bReplayFinished = false;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	float gLastFrame = 0.0f;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pWindow = NULL;
+	// -2 marks the uniform locations as not yet looked up
+	m_viewLocation = -2;
+	m_projectionLocation = -2;
+	m_viewPositionLocation = -2;
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	g_pCamera = new Camera();
+	// default camera view parameters
+	
+	//g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, -90.0f);
+	
+	//previously -2 z direction
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, 2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	m_lastCameraPosition = g_pCamera->Position;
+	m_cameraVelocity = glm::vec3(0.0f);
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  SetWindowSize()
+ *
+ *  This method is used to change the size of the display
+ *  window, before it is created.
+ ***********************************************************/
+void ViewManager::SetWindowSize(int width, int height)
+{
+	g_WindowWidth = width;
+	g_WindowHeight = height;
+	gLastX = width / 2.0f;
+	gLastY = height / 2.0f;
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		g_WindowWidth,
+		g_WindowHeight,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	// receives first mouse move event to continue to track x and y positions
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	float xOffset = xMousePos - gLastX;
+	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	// gather the offsets, the camera is moved once per frame
+	gMouseOffsetX += xOffset;
+	gMouseOffsetY += yOffset;
+}
+
+//Scroll calllback function which gathers scroll events, the gathered yoffset is later passed to the pre-defined "ProcessMouseScroll" function
+void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	gScrollOffset += yoffset;
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+}
+
+/***********************************************************
+ *  CaptureInputFrame()
+ *
+ *  This method is used for collecting the navigation keys
+ *  and the mouse movement of the current frame.
+ ***********************************************************/
+void ViewManager::CaptureInputFrame(InputLog::INPUT_FRAME& input)
+{
+	// navigation keys and the input log bit for each of them
+	static const struct
+	{
+		int glfwKey;
+		uint8_t bit;
+	} keyBits[] =
+	{
+		{ GLFW_KEY_W, InputLog::KEY_W },
+		{ GLFW_KEY_A, InputLog::KEY_A },
+		{ GLFW_KEY_S, InputLog::KEY_S },
+		{ GLFW_KEY_D, InputLog::KEY_D },
+		{ GLFW_KEY_Q, InputLog::KEY_Q },
+		{ GLFW_KEY_E, InputLog::KEY_E },
+		{ GLFW_KEY_O, InputLog::KEY_O },
+		{ GLFW_KEY_P, InputLog::KEY_P }
+	};
+
+	input.deltaTime = gDeltaTime;
+	input.keys = 0;
+	for (const auto& keyBit : keyBits)
+	{
+		if (glfwGetKey(m_pWindow, keyBit.glfwKey) == GLFW_PRESS)
+		{
+			input.keys |= keyBit.bit;
+		}
+	}
+
+	input.mouseOffsetX = gMouseOffsetX;
+	input.mouseOffsetY = gMouseOffsetY;
+	input.scrollOffset = gScrollOffset;
+}
+
+/***********************************************************
+ *  ApplyInputFrame()
+ *
+ *  This method is used for moving the camera according to
+ *  one frame of live or replayed input.
+ ***********************************************************/
+void ViewManager::ApplyInputFrame(const InputLog::INPUT_FRAME& input)
+{
+	//exits the method if camera is null
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	//processes camera zoom in and out respectively
+	if (input.keys & InputLog::KEY_W)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, input.deltaTime);
+	}
+	if (input.keys & InputLog::KEY_S)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, input.deltaTime);
+	}
+
+	//processes camera pan left and right respectively
+	if (input.keys & InputLog::KEY_A)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, input.deltaTime);
+	}
+	if (input.keys & InputLog::KEY_D)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, input.deltaTime);
+	}
+
+	//processes camera's vertical movement (up and down respectively)
+	if (input.keys & InputLog::KEY_Q)
+	{
+		g_pCamera->ProcessKeyboard(UP, input.deltaTime);
+	}
+	if (input.keys & InputLog::KEY_E)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, input.deltaTime);
+	}
+
+	// used to change perspective
+	if (input.keys & InputLog::KEY_P)
+	{
+		bOrthographicProjection = false;
+	}
+	if (input.keys & InputLog::KEY_O)
+	{
+		bOrthographicProjection = true;
+	}
+
+	// move the 3D camera according to the gathered mouse offsets
+	if ((input.mouseOffsetX != 0.0f) || (input.mouseOffsetY != 0.0f))
+	{
+		g_pCamera->ProcessMouseMovement(input.mouseOffsetX, input.mouseOffsetY);
+	}
+	if (input.scrollOffset != 0.0f)
+	{
+		g_pCamera->ProcessMouseScroll(input.scrollOffset);
+	}
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at a fixed
+ *  position and orientation, such as the poses rendered by
+ *  the regression harness.
+ ***********************************************************/
+void ViewManager::SetCameraPose(
+	glm::vec3 position,
+	glm::vec3 front,
+	float zoom,
+	bool bOrthographic)
+{
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = front;
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = zoom;
+	bOrthographicProjection = bOrthographic;
+}
+
+/***********************************************************
+ *  StartRecording()
+ *
+ *  This method is used for recording the camera input of
+ *  every following frame into the log file.
+ ***********************************************************/
+bool ViewManager::StartRecording(const char* filename)
+{
+	return(m_inputLog.OpenForWrite(filename));
+}
+
+/***********************************************************
+ *  StartReplay()
+ *
+ *  This method is used for driving the camera from a recorded
+ *  log.  Each replayed frame advances the camera by its
+ *  recorded time step rather than the wall clock, so the
+ *  camera path is identical however fast the frames render.
+ ***********************************************************/
+bool ViewManager::StartReplay(const char* filename)
+{
+	bReplayFinished = false;
+	return(m_inputLog.OpenForRead(filename));
+}
+
+/***********************************************************
+ *  IsReplayFinished()
+ *
+ *  This method is used for checking whether the replayed log
+ *  has run out of frames.
+ ***********************************************************/
+bool ViewManager::IsReplayFinished() const
+{
+	return(bReplayFinished);
+}
+
+/***********************************************************
+ *  GetReplayFrameCount()
+ ***********************************************************/
+unsigned int ViewManager::GetReplayFrameCount() const
+{
+	return(m_inputLog.IsReading() ? m_inputLog.GetFrameCount() : 0);
+}
+
+/***********************************************************
+ *  GetCameraPosition()
+ ***********************************************************/
+glm::vec3 ViewManager::GetCameraPosition() const
+{
+	return(g_pCamera->Position);
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	ProfileZone zone("PrepareSceneView");
+
+	// per-frame timing
+	float currentFrame = glfwGetTime();
+	gDeltaTime = currentFrame - gLastFrame;
+	gLastFrame = currentFrame;
+
+	// process any keyboard events that may be waiting in the 
+	// event queue
+	ProcessKeyboardEvents();
+
+	// take this frame's camera input from the replayed log or
+	// from the live devices, recording it when requested
+	InputLog::INPUT_FRAME input;
+	if (m_inputLog.IsReading() == true)
+	{
+		if (m_inputLog.ReadFrame(input) == false)
+		{
+			memset(&input, 0, sizeof(input));
+			bReplayFinished = true;
+			glfwSetWindowShouldClose(m_pWindow, true);
+		}
+	}
+	else
+	{
+		CaptureInputFrame(input);
+	}
+	gMouseOffsetX = 0.0f;
+	gMouseOffsetY = 0.0f;
+	gScrollOffset = 0.0f;
+
+	if (m_inputLog.IsWriting() == true)
+	{
+		m_inputLog.WriteFrame(input);
+	}
+	ApplyInputFrame(input);
+
+	// the camera velocity, smoothed over a few frames, lets the
+	// scene stream ahead of where the camera is heading
+	if (gDeltaTime > 0.0f)
+	{
+		glm::vec3 velocity = (g_pCamera->Position - m_lastCameraPosition) / gDeltaTime;
+		m_cameraVelocity = glm::mix(m_cameraVelocity, velocity, 0.25f);
+	}
+	m_lastCameraPosition = g_pCamera->Position;
+
+	// get the current view matrix from the camera
+	m_view = g_pCamera->GetViewMatrix();
+	m_projection = GetProjection(g_pCamera->Zoom, bOrthographicProjection);
+	SetShaderView(g_pCamera->Position);
+}
+
+/***********************************************************
+ *  PrepareFixedView()
+ *
+ *  This method is used for setting the view of a fixed camera
+ *  pose into the shader, as PrepareSceneView() would with the
+ *  camera there, without moving the camera or taking any
+ *  input, so frames rendered for measuring leave the view of
+ *  the session as it was.
+ ***********************************************************/
+void ViewManager::PrepareFixedView(
+	glm::vec3 position,
+	glm::vec3 front,
+	float zoom,
+	bool bOrthographic)
+{
+	m_view = glm::lookAt(position, position + front, glm::vec3(0.0f, 1.0f, 0.0f));
+	m_projection = GetProjection(zoom, bOrthographic);
+	SetShaderView(position);
+}
+
+/***********************************************************
+ *  GetProjection()
+ ***********************************************************/
+glm::mat4 ViewManager::GetProjection(float zoom, bool bOrthographic) const
+{
+	glm::mat4 projection;
+
+	// define the current projection matrix
+	if (bOrthographic == false)
+	{
+		projection = glm::perspective(glm::radians(zoom), (GLfloat)g_WindowWidth / (GLfloat)g_WindowHeight, 0.1f, 100.0f);
+	}
+	else
+	{
+		// front-view orthographic projection with correct aspect ratio
+		double scale = 0.0;
+		if (g_WindowWidth > g_WindowHeight)
+		{
+			scale = (double)g_WindowHeight / (double)g_WindowWidth;
+			projection = glm::ortho(-5.0f, 5.0f, -5.0f * (float)scale, 5.0f * (float)scale, 0.1f, 100.0f);
+		}
+		else if (g_WindowWidth < g_WindowHeight)
+		{
+			scale = (double)g_WindowWidth / (double)g_WindowHeight;
+			projection = glm::ortho(-5.0f * (float)scale, 5.0f * (float)scale, -5.0f, 5.0f, 0.1f, 100.0f);
+		}
+		else
+		{
+			projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f);
+		}
+	}
+
+	return(projection);
+}
+
+/***********************************************************
+ *  SetShaderView()
+ ***********************************************************/
+void ViewManager::SetShaderView(const glm::vec3& position)
+{
+	// if the shader manager object is valid
+	if (NULL != m_pShaderManager)
+	{
+		// the shader program is loaded after the view manager is
+		// created, so the uniform locations are looked up on the
+		// first frame
+		if (m_viewLocation == -2)
+		{
+			GLint program = 0;
+			glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+			m_viewLocation = glGetUniformLocation(program, g_ViewName);
+			m_projectionLocation = glGetUniformLocation(program, g_ProjectionName);
+			m_viewPositionLocation = glGetUniformLocation(program, "viewPosition");
+		}
+
+		// set the view matrix into the shader for proper rendering
+		glUniformMatrix4fv(m_viewLocation, 1, GL_FALSE, glm::value_ptr(m_view));
+		// set the view matrix into the shader for proper rendering
+		glUniformMatrix4fv(m_projectionLocation, 1, GL_FALSE, glm::value_ptr(m_projection));
+		// set the view position of the camera into the shader for proper rendering
+		glUniform3fv(m_viewPositionLocation, 1, glm::value_ptr(position));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchcompare.cpp
+// ============
+// compare two benchmark reports and flag significant changes
+//
+//  Built from this file with src/JsonReader.cpp:
+//  BenchCompare <baseline.json> <candidate.json> [--alpha <p>]
+//  [--method mannwhitney|bootstrap] [--threshold <metric>=<percent>]
+//  [--json <verdict file>]
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JsonReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// resamples drawn for each bootstrap interval
+	const int BOOTSTRAP_RESAMPLES = 2000;
+	// fixed seed so the same reports always give the same verdict
+	const unsigned int BOOTSTRAP_SEED = 12345;
+
+	// metrics of a benchmark scene, lower is better for all of them
+	struct METRIC
+	{
+		const char* name;
+		// smallest change of the median, in percent, that counts
+		double thresholdPercent;
+	};
+
+	METRIC g_Metrics[] =
+	{
+		{ "frame_ms", 2.0 },
+		{ "draw_calls", 0.0 }
+	};
+
+	struct COMPARISON
+	{
+		std::string scene;
+		std::string metric;
+		double baselineMedian = 0.0;
+		double candidateMedian = 0.0;
+		double changePercent = 0.0;
+		double pValue = 1.0;
+		double intervalLowPercent = 0.0;
+		double intervalHighPercent = 0.0;
+		const char* result = "unchanged";
+	};
+
+	double Median(std::vector<double> samples)
+	{
+		if (samples.empty() == true)
+		{
+			return(0.0);
+		}
+		size_t middle = samples.size() / 2;
+		std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+		double upper = samples[middle];
+		if ((samples.size() % 2) == 1)
+		{
+			return(upper);
+		}
+		double lower = *std::max_element(samples.begin(), samples.begin() + middle);
+		return((lower + upper) / 2.0);
+	}
+
+	// percent change from the baseline to the candidate
+	double ChangePercent(double baseline, double candidate)
+	{
+		if (baseline == 0.0)
+		{
+			return((candidate == 0.0) ? 0.0 : 100.0);
+		}
+		return((candidate - baseline) / baseline * 100.0);
+	}
+
+	// two-sided p-value of the Mann-Whitney U test, with the normal
+	// approximation corrected for ties and continuity
+	double MannWhitneyPValue(const std::vector<double>& baseline, const std::vector<double>& candidate)
+	{
+		struct RANKED
+		{
+			double value;
+			bool bBaseline;
+		};
+
+		std::vector<RANKED> all;
+		for (double value : baseline) all.push_back({ value, true });
+		for (double value : candidate) all.push_back({ value, false });
+		std::sort(all.begin(), all.end(), [](const RANKED& a, const RANKED& b) { return(a.value < b.value); });
+
+		const double n1 = (double)baseline.size();
+		const double n2 = (double)candidate.size();
+		const double n = n1 + n2;
+
+		// tied values share the mean of their ranks
+		double rankSum = 0.0;
+		double tieTerm = 0.0;
+		size_t i = 0;
+		while (i < all.size())
+		{
+			size_t j = i;
+			while ((j + 1 < all.size()) && (all[j + 1].value == all[i].value))
+			{
+				j++;
+			}
+			double rank = (i + j + 2) / 2.0;
+			double ties = (double)(j - i + 1);
+			for (size_t k = i; k <= j; k++)
+			{
+				if (all[k].bBaseline == true)
+				{
+					rankSum += rank;
+				}
+			}
+			tieTerm += ties * ties * ties - ties;
+			i = j + 1;
+		}
+
+		double u = rankSum - n1 * (n1 + 1.0) / 2.0;
+		double mean = n1 * n2 / 2.0;
+		double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+		if (variance <= 0.0)
+		{
+			// every sample is the same value
+			return(1.0);
+		}
+
+		double z = (std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+		return(std::erfc(std::max(z, 0.0) / std::sqrt(2.0)));
+	}
+
+	// percentile bootstrap interval of the change of the median
+	void BootstrapInterval(
+		const std::vector<double>& baseline,
+		const std::vector<double>& candidate,
+		double alpha,
+		double& lowPercent,
+		double& highPercent)
+	{
+		std::mt19937 random(BOOTSTRAP_SEED);
+		std::uniform_int_distribution<size_t> pickBaseline(0, baseline.size() - 1);
+		std::uniform_int_distribution<size_t> pickCandidate(0, candidate.size() - 1);
+
+		std::vector<double> changes(BOOTSTRAP_RESAMPLES);
+		std::vector<double> baselineSample(baseline.size());
+		std::vector<double> candidateSample(candidate.size());
+		for (int r = 0; r < BOOTSTRAP_RESAMPLES; r++)
+		{
+			for (double& value : baselineSample) value = baseline[pickBaseline(random)];
+			for (double& value : candidateSample) value = candidate[pickCandidate(random)];
+			changes[r] = ChangePercent(Median(baselineSample), Median(candidateSample));
+		}
+
+		std::sort(changes.begin(), changes.end());
+		size_t low = (size_t)std::floor(alpha / 2.0 * (BOOTSTRAP_RESAMPLES - 1));
+		size_t high = (size_t)std::ceil((1.0 - alpha / 2.0) * (BOOTSTRAP_RESAMPLES - 1));
+		lowPercent = changes[low];
+		highPercent = changes[high];
+	}
+
+	// read the samples of a metric of a scene
+	bool ReadSamples(const JsonReader::JSON_VALUE& scene, const char* metric, std::vector<double>& samples)
+	{
+		const JsonReader::JSON_VALUE* values = JsonReader::Find(scene, metric);
+		if ((NULL == values) || (values->type != JsonReader::JSON_ARRAY))
+		{
+			return(false);
+		}
+		for (const JsonReader::JSON_VALUE& value : values->elements)
+		{
+			if (value.type == JsonReader::JSON_NUMBER)
+			{
+				samples.push_back(value.number);
+			}
+		}
+		return(samples.empty() == false);
+	}
+
+	void WriteJSONString(FILE* file, const std::string& text)
+	{
+		fputc('"', file);
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				fputc('\\', file);
+			}
+			fputc(((unsigned char)c < 0x20) ? ' ' : c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function compares every metric of every scene of the
+ *  candidate report against the baseline report.  A change
+ *  is significant when the selected test rejects "no change"
+ *  at the alpha level, and it counts when the median moved
+ *  by more than the metric's threshold.  The exit code is 1
+ *  when anything regressed, for use as a release gate.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <baseline.json> <candidate.json> [--alpha <p>]"
+			<< " [--method mannwhitney|bootstrap] [--threshold <metric>=<percent>] [--json <file>]" << std::endl;
+		return(2);
+	}
+
+	double alpha = 0.05;
+	bool bBootstrap = false;
+	const char* verdictFile = NULL;
+	for (int i = 3; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--alpha") == 0) && (i + 1 < argc))
+		{
+			alpha = atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--method") == 0) && (i + 1 < argc))
+		{
+			i++;
+			bBootstrap = (strcmp(argv[i], "bootstrap") == 0);
+			if ((bBootstrap == false) && (strcmp(argv[i], "mannwhitney") != 0))
+			{
+				std::cerr << "Unknown method: " << argv[i] << std::endl;
+				return(2);
+			}
+		}
+		else if ((strcmp(argv[i], "--threshold") == 0) && (i + 1 < argc))
+		{
+			std::string setting = argv[++i];
+			size_t equals = setting.find('=');
+			bool bFound = false;
+			for (METRIC& metric : g_Metrics)
+			{
+				if ((equals != std::string::npos) && (setting.compare(0, equals, metric.name) == 0))
+				{
+					metric.thresholdPercent = atof(setting.c_str() + equals + 1);
+					bFound = true;
+				}
+			}
+			if (bFound == false)
+			{
+				std::cerr << "Unknown threshold: " << setting << " (frame_ms=<percent> or draw_calls=<percent>)" << std::endl;
+				return(2);
+			}
+		}
+		else if ((strcmp(argv[i], "--json") == 0) && (i + 1 < argc))
+		{
+			verdictFile = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << std::endl;
+			return(2);
+		}
+	}
+
+	JsonReader::JSON_VALUE baseline;
+	JsonReader::JSON_VALUE candidate;
+	std::string error;
+	if ((JsonReader::ReadFile(argv[1], baseline, error) == false) ||
+		(JsonReader::ReadFile(argv[2], candidate, error) == false))
+	{
+		std::cerr << "ERROR: " << error << std::endl;
+		return(2);
+	}
+
+	const JsonReader::JSON_VALUE* baselineScenes = JsonReader::Find(baseline, "scenes");
+	const JsonReader::JSON_VALUE* candidateScenes = JsonReader::Find(candidate, "scenes");
+	if ((NULL == baselineScenes) || (NULL == candidateScenes))
+	{
+		std::cerr << "ERROR: Both reports need a \"scenes\" object" << std::endl;
+		return(2);
+	}
+
+	std::vector<COMPARISON> comparisons;
+	std::vector<std::string> missingScenes;
+	for (const auto& scene : baselineScenes->members)
+	{
+		const JsonReader::JSON_VALUE* candidateScene = JsonReader::Find(*candidateScenes, scene.first.c_str());
+		if (NULL == candidateScene)
+		{
+			missingScenes.push_back(scene.first);
+			continue;
+		}
+
+		for (const METRIC& metric : g_Metrics)
+		{
+			std::vector<double> baselineSamples;
+			std::vector<double> candidateSamples;
+			if ((ReadSamples(scene.second, metric.name, baselineSamples) == false) ||
+				(ReadSamples(*candidateScene, metric.name, candidateSamples) == false))
+			{
+				continue;
+			}
+
+			COMPARISON comparison;
+			comparison.scene = scene.first;
+			comparison.metric = metric.name;
+			comparison.baselineMedian = Median(baselineSamples);
+			comparison.candidateMedian = Median(candidateSamples);
+			comparison.changePercent = ChangePercent(comparison.baselineMedian, comparison.candidateMedian);
+			comparison.pValue = MannWhitneyPValue(baselineSamples, candidateSamples);
+			BootstrapInterval(baselineSamples, candidateSamples, alpha,
+				comparison.intervalLowPercent, comparison.intervalHighPercent);
+
+			// samples that never vary, such as draw counts, differ
+			// with certainty when their medians do
+			bool bConstant = (comparison.intervalLowPercent == comparison.intervalHighPercent);
+			bool bSignificant = false;
+			if (bConstant == true)
+			{
+				bSignificant = (comparison.changePercent != 0.0);
+			}
+			else if (bBootstrap == true)
+			{
+				bSignificant = (comparison.intervalLowPercent > 0.0) || (comparison.intervalHighPercent < 0.0);
+			}
+			else
+			{
+				bSignificant = (comparison.pValue < alpha);
+			}
+
+			if ((bSignificant == true) && (comparison.changePercent > metric.thresholdPercent))
+			{
+				comparison.result = "regression";
+			}
+			else if ((bSignificant == true) && (comparison.changePercent < -metric.thresholdPercent))
+			{
+				comparison.result = "improvement";
+			}
+			comparisons.push_back(comparison);
+		}
+	}
+
+	int regressions = 0;
+	for (const COMPARISON& comparison : comparisons)
+	{
+		printf("%-24s %-12s %10.4f -> %10.4f  %+7.2f%%  p=%.4f  CI [%+.2f%%, %+.2f%%]  %s\n",
+			comparison.scene.c_str(),
+			comparison.metric.c_str(),
+			comparison.baselineMedian,
+			comparison.candidateMedian,
+			comparison.changePercent,
+			comparison.pValue,
+			comparison.intervalLowPercent,
+			comparison.intervalHighPercent,
+			comparison.result);
+		if (strcmp(comparison.result, "regression") == 0)
+		{
+			regressions++;
+		}
+	}
+	for (const std::string& scene : missingScenes)
+	{
+		printf("%-24s missing from the candidate report\n", scene.c_str());
+	}
+
+	bool bPass = (regressions == 0) && missingScenes.empty();
+	printf("Verdict: %s (%d regressions, %zu missing scenes)\n", bPass ? "pass" : "fail", regressions, missingScenes.size());
+
+	if (NULL != verdictFile)
+	{
+		FILE* file = fopen(verdictFile, "w");
+		if (NULL == file)
+		{
+			std::cerr << "Could not write verdict:" << verdictFile << std::endl;
+			return(2);
+		}
+		fprintf(file, "{\n  \"verdict\": \"%s\",\n  \"method\": \"%s\",\n  \"alpha\": %g,\n  \"comparisons\": [",
+			bPass ? "pass" : "fail",
+			bBootstrap ? "bootstrap" : "mannwhitney",
+			alpha);
+		for (size_t i = 0; i < comparisons.size(); i++)
+		{
+			const COMPARISON& comparison = comparisons[i];
+			fprintf(file, "%s\n    { \"scene\": ", (i > 0) ? "," : "");
+			WriteJSONString(file, comparison.scene);
+			fprintf(file, ", \"metric\": \"%s\", \"baseline_median\": %.6g, \"candidate_median\": %.6g,"
+				" \"change_percent\": %.4f, \"p_value\": %.6g, \"ci_low_percent\": %.4f, \"ci_high_percent\": %.4f,"
+				" \"result\": \"%s\" }",
+				comparison.metric.c_str(),
+				comparison.baselineMedian,
+				comparison.candidateMedian,
+				comparison.changePercent,
+				comparison.pValue,
+				comparison.intervalLowPercent,
+				comparison.intervalHighPercent,
+				comparison.result);
+		}
+		fprintf(file, "\n  ],\n  \"missing_scenes\": [");
+		for (size_t i = 0; i < missingScenes.size(); i++)
+		{
+			fprintf(file, "%s", (i > 0) ? ", " : "");
+			WriteJSONString(file, missingScenes[i]);
+		}
+		fprintf(file, "]\n}\n");
+		fclose(file);
+	}
+
+	return(bPass ? 0 : 1);
+}
@@ -0,0 +1,488 @@
+///////////////////////////////////////////////////////////////////////////////
+// gltracereplay.cpp
+// ============
+// replay a recorded GL trace in a loop and time every frame
+//
+//  Built from this file with src/BenchmarkReport.cpp, against
+//  GLEW and GLFW:  GLTraceReplay <trace> [--loops <count>]
+//  [--bench-json <file>] [--visible]
+///////////////////////////////////////////////////////////////////////////////
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+#include "GLTrace.h"
+#include "BenchmarkReport.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// one record of the trace, pointing into the loaded file
+	struct TRACE_RECORD
+	{
+		GLTrace::OPCODE opcode;
+		int fieldCount;
+		const uint32_t* fields;
+		const unsigned char* data;
+		uint32_t dataBytes;
+	};
+
+	// recorded object names mapped to the names made by the replay
+	std::unordered_map<GLuint, GLuint> g_Buffers;
+	std::unordered_map<GLuint, GLuint> g_VertexArrays;
+	std::unordered_map<GLuint, GLuint> g_Textures;
+	std::unordered_map<GLuint, GLuint> g_Shaders;
+	std::unordered_map<GLuint, GLuint> g_Programs;
+	// recorded uniform locations by program, mapped to replay ones
+	std::unordered_map<uint64_t, GLint> g_Locations;
+	GLuint g_RecordedProgram = 0;
+
+	// draws issued by the last replayed frame
+	int g_DrawCalls = 0;
+
+	// look up the replay name of a recorded one, zero stays zero
+	GLuint MapName(const std::unordered_map<GLuint, GLuint>& names, uint32_t recorded)
+	{
+		auto found = names.find(recorded);
+		return((found != names.end()) ? found->second : 0);
+	}
+
+	// look up the replay location of a uniform of the current program
+	GLint MapLocation(uint32_t recorded)
+	{
+		if ((GLint)recorded < 0)
+		{
+			return(-1);
+		}
+		auto found = g_Locations.find(((uint64_t)g_RecordedProgram << 32) | recorded);
+		return((found != g_Locations.end()) ? found->second : -1);
+	}
+
+	uint64_t Join(uint32_t low, uint32_t high)
+	{
+		return((uint64_t)low | ((uint64_t)high << 32));
+	}
+
+	float FloatFromBits(uint32_t bits)
+	{
+		float value = 0.0f;
+		memcpy(&value, &bits, sizeof(value));
+		return(value);
+	}
+
+	// make replay names for recorded ones with the passed in function
+	void GenerateNames(
+		std::unordered_map<GLuint, GLuint>& names,
+		const TRACE_RECORD& record,
+		void (GLAPIENTRY *generate)(GLsizei, GLuint*))
+	{
+		std::vector<GLuint> recorded(record.fields[0]);
+		memcpy(recorded.data(), record.data, recorded.size() * sizeof(GLuint));
+		std::vector<GLuint> created(recorded.size());
+		generate((GLsizei)created.size(), created.data());
+		for (size_t i = 0; i < recorded.size(); i++)
+		{
+			names[recorded[i]] = created[i];
+		}
+	}
+
+	// delete the replay names of recorded ones with the passed in function
+	void DeleteNames(
+		std::unordered_map<GLuint, GLuint>& names,
+		const TRACE_RECORD& record,
+		void (GLAPIENTRY *destroy)(GLsizei, const GLuint*))
+	{
+		for (uint32_t i = 0; i < record.fields[0]; i++)
+		{
+			GLuint recorded = 0;
+			memcpy(&recorded, record.data + i * sizeof(GLuint), sizeof(GLuint));
+			GLuint name = MapName(names, recorded);
+			destroy(1, &name);
+			names.erase(recorded);
+		}
+	}
+
+	void GLAPIENTRY GenTextures(GLsizei count, GLuint* textures) { glGenTextures(count, textures); }
+	void GLAPIENTRY DeleteTextures(GLsizei count, const GLuint* textures) { glDeleteTextures(count, textures); }
+	void GLAPIENTRY GenBuffers(GLsizei count, GLuint* buffers) { glGenBuffers(count, buffers); }
+	void GLAPIENTRY DeleteBuffers(GLsizei count, const GLuint* buffers) { glDeleteBuffers(count, buffers); }
+	void GLAPIENTRY GenVertexArrays(GLsizei count, GLuint* arrays) { glGenVertexArrays(count, arrays); }
+	void GLAPIENTRY DeleteVertexArrays(GLsizei count, const GLuint* arrays) { glDeleteVertexArrays(count, arrays); }
+
+	// issue a recorded glUniform call
+	void ReplayUniform(const TRACE_RECORD& record)
+	{
+		GLint location = MapLocation(record.fields[1]);
+		GLsizei count = (GLsizei)record.fields[2];
+		GLboolean transpose = (GLboolean)record.fields[3];
+		const GLfloat* floats = (const GLfloat*)record.data;
+		const GLint* ints = (const GLint*)record.data;
+
+		switch (record.fields[0])
+		{
+		case GLTrace::UNIFORM_1I: glUniform1i(location, ints[0]); break;
+		case GLTrace::UNIFORM_1F: glUniform1f(location, floats[0]); break;
+		case GLTrace::UNIFORM_2F: glUniform2f(location, floats[0], floats[1]); break;
+		case GLTrace::UNIFORM_3F: glUniform3f(location, floats[0], floats[1], floats[2]); break;
+		case GLTrace::UNIFORM_4F: glUniform4f(location, floats[0], floats[1], floats[2], floats[3]); break;
+		case GLTrace::UNIFORM_1IV: glUniform1iv(location, count, ints); break;
+		case GLTrace::UNIFORM_1FV: glUniform1fv(location, count, floats); break;
+		case GLTrace::UNIFORM_2FV: glUniform2fv(location, count, floats); break;
+		case GLTrace::UNIFORM_3FV: glUniform3fv(location, count, floats); break;
+		case GLTrace::UNIFORM_4FV: glUniform4fv(location, count, floats); break;
+		case GLTrace::UNIFORM_MATRIX_4FV: glUniformMatrix4fv(location, count, transpose, floats); break;
+		default: break;
+		}
+	}
+
+	// issue one recorded call
+	void ReplayRecord(const TRACE_RECORD& record)
+	{
+		const uint32_t* f = record.fields;
+
+		switch (record.opcode)
+		{
+		case GLTrace::TRACE_GEN_BUFFERS:
+			GenerateNames(g_Buffers, record, GenBuffers);
+			break;
+		case GLTrace::TRACE_DELETE_BUFFERS:
+			DeleteNames(g_Buffers, record, DeleteBuffers);
+			break;
+		case GLTrace::TRACE_BIND_BUFFER:
+			glBindBuffer(f[0], MapName(g_Buffers, f[1]));
+			break;
+		case GLTrace::TRACE_BUFFER_DATA:
+			glBufferData(f[0], (GLsizeiptr)Join(f[2], f[3]), (f[4] != 0) ? record.data : NULL, f[1]);
+			break;
+		case GLTrace::TRACE_BUFFER_SUB_DATA:
+			glBufferSubData(f[0], (GLintptr)Join(f[1], f[2]), record.dataBytes, record.data);
+			break;
+		case GLTrace::TRACE_GEN_VERTEX_ARRAYS:
+			GenerateNames(g_VertexArrays, record, GenVertexArrays);
+			break;
+		case GLTrace::TRACE_DELETE_VERTEX_ARRAYS:
+			DeleteNames(g_VertexArrays, record, DeleteVertexArrays);
+			break;
+		case GLTrace::TRACE_BIND_VERTEX_ARRAY:
+			glBindVertexArray(MapName(g_VertexArrays, f[0]));
+			break;
+		case GLTrace::TRACE_VERTEX_ATTRIB_POINTER:
+			glVertexAttribPointer(f[0], (GLint)f[1], f[2], (GLboolean)f[3], (GLsizei)f[4], (const void*)(uintptr_t)Join(f[5], f[6]));
+			break;
+		case GLTrace::TRACE_ENABLE_VERTEX_ATTRIB_ARRAY:
+			glEnableVertexAttribArray(f[0]);
+			break;
+		case GLTrace::TRACE_DISABLE_VERTEX_ATTRIB_ARRAY:
+			glDisableVertexAttribArray(f[0]);
+			break;
+		case GLTrace::TRACE_CREATE_SHADER:
+			g_Shaders[f[1]] = glCreateShader(f[0]);
+			break;
+		case GLTrace::TRACE_SHADER_SOURCE:
+		{
+			const GLchar* source = (const GLchar*)record.data;
+			GLint length = (GLint)record.dataBytes;
+			glShaderSource(MapName(g_Shaders, f[0]), 1, &source, &length);
+			break;
+		}
+		case GLTrace::TRACE_COMPILE_SHADER:
+			glCompileShader(MapName(g_Shaders, f[0]));
+			break;
+		case GLTrace::TRACE_DELETE_SHADER:
+			glDeleteShader(MapName(g_Shaders, f[0]));
+			break;
+		case GLTrace::TRACE_CREATE_PROGRAM:
+			g_Programs[f[0]] = glCreateProgram();
+			break;
+		case GLTrace::TRACE_ATTACH_SHADER:
+			glAttachShader(MapName(g_Programs, f[0]), MapName(g_Shaders, f[1]));
+			break;
+		case GLTrace::TRACE_LINK_PROGRAM:
+			glLinkProgram(MapName(g_Programs, f[0]));
+			break;
+		case GLTrace::TRACE_USE_PROGRAM:
+			g_RecordedProgram = f[0];
+			glUseProgram(MapName(g_Programs, f[0]));
+			break;
+		case GLTrace::TRACE_DELETE_PROGRAM:
+			glDeleteProgram(MapName(g_Programs, f[0]));
+			break;
+		case GLTrace::TRACE_GET_UNIFORM_LOCATION:
+		{
+			std::string name((const char*)record.data, record.dataBytes);
+			GLint location = glGetUniformLocation(MapName(g_Programs, f[0]), name.c_str());
+			g_Locations[((uint64_t)f[0] << 32) | f[1]] = location;
+			break;
+		}
+		case GLTrace::TRACE_UNIFORM:
+			ReplayUniform(record);
+			break;
+		case GLTrace::TRACE_ACTIVE_TEXTURE:
+			glActiveTexture(f[0]);
+			break;
+		case GLTrace::TRACE_GENERATE_MIPMAP:
+			glGenerateMipmap(f[0]);
+			break;
+		case GLTrace::TRACE_GEN_TEXTURES:
+			GenerateNames(g_Textures, record, GenTextures);
+			break;
+		case GLTrace::TRACE_DELETE_TEXTURES:
+			DeleteNames(g_Textures, record, DeleteTextures);
+			break;
+		case GLTrace::TRACE_BIND_TEXTURE:
+			glBindTexture(f[0], MapName(g_Textures, f[1]));
+			break;
+		case GLTrace::TRACE_TEX_PARAMETER_I:
+			glTexParameteri(f[0], f[1], (GLint)f[2]);
+			break;
+		case GLTrace::TRACE_TEX_IMAGE_2D:
+			glPixelStorei(GL_UNPACK_ALIGNMENT, (GLint)f[8]);
+			glTexImage2D(f[0], (GLint)f[1], (GLint)f[2], (GLsizei)f[3], (GLsizei)f[4], (GLint)f[5], f[6], f[7],
+				(record.dataBytes > 0) ? record.data : NULL);
+			break;
+		case GLTrace::TRACE_PIXEL_STORE_I:
+			glPixelStorei(f[0], (GLint)f[1]);
+			break;
+		case GLTrace::TRACE_DRAW_ARRAYS:
+			glDrawArrays(f[0], (GLint)f[1], (GLsizei)f[2]);
+			g_DrawCalls++;
+			break;
+		case GLTrace::TRACE_DRAW_ELEMENTS:
+			glDrawElements(f[0], (GLsizei)f[1], f[2], (const void*)(uintptr_t)Join(f[3], f[4]));
+			g_DrawCalls++;
+			break;
+		case GLTrace::TRACE_ENABLE:
+			glEnable(f[0]);
+			break;
+		case GLTrace::TRACE_DISABLE:
+			glDisable(f[0]);
+			break;
+		case GLTrace::TRACE_BLEND_FUNC:
+			glBlendFunc(f[0], f[1]);
+			break;
+		case GLTrace::TRACE_CLEAR:
+			glClear(f[0]);
+			break;
+		case GLTrace::TRACE_CLEAR_COLOR:
+			glClearColor(FloatFromBits(f[0]), FloatFromBits(f[1]), FloatFromBits(f[2]), FloatFromBits(f[3]));
+			break;
+		case GLTrace::TRACE_VIEWPORT:
+			glViewport((GLint)f[0], (GLint)f[1], (GLsizei)f[2], (GLsizei)f[3]);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// split the loaded trace into records, checking every size
+	bool ParseTrace(const std::vector<unsigned char>& file, std::vector<TRACE_RECORD>& records)
+	{
+		size_t offset = sizeof(GLTrace::TRACE_HEADER);
+		while (offset < file.size())
+		{
+			if (offset + 6 > file.size())
+			{
+				return(false);
+			}
+
+			TRACE_RECORD record;
+			record.opcode = (GLTrace::OPCODE)file[offset];
+			record.fieldCount = file[offset + 1];
+			memcpy(&record.dataBytes, &file[offset + 2], sizeof(uint32_t));
+			offset += 6;
+
+			size_t fieldBytes = record.fieldCount * sizeof(uint32_t);
+			if (offset + fieldBytes + record.dataBytes > file.size())
+			{
+				return(false);
+			}
+			record.fields = (const uint32_t*)&file[offset];
+			record.data = &file[offset + fieldBytes];
+			offset += fieldBytes + record.dataBytes;
+
+			records.push_back(record);
+		}
+
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function loads the trace, runs the calls before the
+ *  first frame mark once to create the resources, and then
+ *  replays the recorded frames the requested number of times,
+ *  timing each frame up to the completion of its GPU work.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <trace> [--loops <count>] [--bench-json <file>] [--visible]" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	const char* traceFile = argv[1];
+	int loops = 10;
+	const char* benchmarkFile = NULL;
+	bool bVisible = false;
+	for (int i = 2; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--loops") == 0) && (i + 1 < argc))
+		{
+			loops = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--bench-json") == 0) && (i + 1 < argc))
+		{
+			benchmarkFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--visible") == 0)
+		{
+			bVisible = true;
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << std::endl;
+			return(EXIT_FAILURE);
+		}
+	}
+
+	// load the whole trace, the records point into it
+	std::vector<unsigned char> file;
+	FILE* input = fopen(traceFile, "rb");
+	if (NULL == input)
+	{
+		std::cerr << "Could not read GL trace:" << traceFile << std::endl;
+		return(EXIT_FAILURE);
+	}
+	fseek(input, 0, SEEK_END);
+	long size = ftell(input);
+	fseek(input, 0, SEEK_SET);
+	if (size > 0)
+	{
+		file.resize(size);
+		file.resize(fread(file.data(), 1, size, input));
+	}
+	fclose(input);
+
+	GLTrace::TRACE_HEADER header;
+	if (file.size() < sizeof(header))
+	{
+		std::cerr << "Not a GL trace:" << traceFile << std::endl;
+		return(EXIT_FAILURE);
+	}
+	memcpy(&header, file.data(), sizeof(header));
+	if ((memcmp(header.magic, "WSGT", 4) != 0) || (header.version != GLTrace::VERSION))
+	{
+		std::cerr << "Not a GL trace of version " << GLTrace::VERSION << ":" << traceFile << std::endl;
+		return(EXIT_FAILURE);
+	}
+	if (header.byteOrder != GLTrace::BYTE_ORDER_MARK)
+	{
+		std::cerr << "The GL trace was recorded on a host of another byte order" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	std::vector<TRACE_RECORD> records;
+	if (ParseTrace(file, records) == false)
+	{
+		std::cerr << "The GL trace is truncated:" << traceFile << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	// frames end at their marks, the calls before the first mark
+	// belong to the setup together with the first frame
+	std::vector<size_t> frameEnds;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		if (records[i].opcode == GLTrace::TRACE_FRAME_END)
+		{
+			frameEnds.push_back(i);
+		}
+	}
+	if (frameEnds.size() < 2)
+	{
+		std::cerr << "The GL trace holds fewer than two frames" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	// create a context like the application's
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, bVisible ? GLFW_TRUE : GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(header.width, header.height, "GL Trace Replay", NULL, NULL);
+	if (NULL == window)
+	{
+		std::cerr << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return(EXIT_FAILURE);
+	}
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK)
+	{
+		std::cerr << "Failed to initialize GLEW" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	const char* renderer = (const char*)glGetString(GL_RENDERER);
+	std::cout << "INFO: Replaying " << frameEnds.size() - 1 << " frames of " << traceFile
+		<< " on " << renderer << std::endl;
+
+	for (size_t i = 0; i <= frameEnds[0]; i++)
+	{
+		ReplayRecord(records[i]);
+	}
+	glFinish();
+
+	std::string workload = traceFile;
+	workload = workload.substr(workload.find_last_of("/\\") + 1);
+	BenchmarkReport benchmark;
+	benchmark.SetRenderer(renderer);
+	benchmark.ReserveFrames(workload, (frameEnds.size() - 1) * loops);
+
+	for (int loop = 0; loop < loops; loop++)
+	{
+		for (size_t frame = 1; frame < frameEnds.size(); frame++)
+		{
+			g_DrawCalls = 0;
+			double start = glfwGetTime();
+			for (size_t i = frameEnds[frame - 1] + 1; i < frameEnds[frame]; i++)
+			{
+				ReplayRecord(records[i]);
+			}
+			glFinish();
+			double end = glfwGetTime();
+
+			benchmark.AddFrame(workload, (float)((end - start) * 1000.0), g_DrawCalls);
+			if (bVisible == true)
+			{
+				glfwSwapBuffers(window);
+				glfwPollEvents();
+			}
+		}
+	}
+
+	benchmark.PrintSummary();
+	int exitCode = EXIT_SUCCESS;
+	if ((NULL != benchmarkFile) && (benchmark.WriteJSON(benchmarkFile) == false))
+	{
+		exitCode = EXIT_FAILURE;
+	}
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return(exitCode);
+}
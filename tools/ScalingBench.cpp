@@ -0,0 +1,407 @@
+///////////////////////////////////////////////////////////////////////////////
+// scalingbench.cpp
+// ============
+// benchmark the scene on llvmpipe across thread counts, resolutions and modes
+//
+//  Built from this file with src/JsonReader.cpp (POSIX only):
+//  ScalingBench <application> <input log> [--threads 1,2,4,8]
+//  [--resolutions 640x480,1280x720,1920x1080] [--modes forward,depth_prepass]
+//  [--runs <count>] [--out-dir <directory>] [--json <file>] [--verbose]
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JsonReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// declaration of global variables
+namespace
+{
+	struct RESOLUTION
+	{
+		int width;
+		int height;
+	};
+
+	// result of one thread count, resolution and mode
+	struct SCALING_CELL
+	{
+		int threads;
+		RESOLUTION resolution;
+		std::string mode;
+		bool bValid = false;
+		double medianMs = 0.0;
+		double p99Ms = 0.0;
+	};
+
+	// split a comma separated list
+	std::vector<std::string> SplitList(const char* text)
+	{
+		std::vector<std::string> items;
+		std::string list = text;
+		size_t start = 0;
+		while (start <= list.size())
+		{
+			size_t end = list.find(',', start);
+			if (end == std::string::npos)
+			{
+				end = list.size();
+			}
+			if (end > start)
+			{
+				items.push_back(list.substr(start, end - start));
+			}
+			start = end + 1;
+		}
+		return(items);
+	}
+
+	double Median(std::vector<double> values)
+	{
+		std::sort(values.begin(), values.end());
+		size_t middle = values.size() / 2;
+		return(((values.size() % 2) == 1) ? values[middle] : (values[middle - 1] + values[middle]) / 2.0);
+	}
+
+	// run the application once with llvmpipe limited to the
+	// thread count, returning false if it did not exit cleanly
+	bool RunApplication(
+		const char* application,
+		const std::vector<std::string>& arguments,
+		int threads,
+		bool bVerbose)
+	{
+		pid_t child = fork();
+		if (child < 0)
+		{
+			return(false);
+		}
+		if (child == 0)
+		{
+			setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+			setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+			setenv("LP_NUM_THREADS", std::to_string(threads).c_str(), 1);
+			if (bVerbose == false)
+			{
+				int devNull = open("/dev/null", O_WRONLY);
+				dup2(devNull, STDOUT_FILENO);
+				close(devNull);
+			}
+
+			std::vector<char*> argv;
+			argv.push_back((char*)application);
+			for (const std::string& argument : arguments)
+			{
+				argv.push_back((char*)argument.c_str());
+			}
+			argv.push_back(NULL);
+			execv(application, argv.data());
+			_exit(127);
+		}
+
+		int status = 0;
+		waitpid(child, &status, 0);
+		return(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+	}
+
+	// read the first scene's summary from a benchmark report
+	bool ReadBenchmark(const std::string& filename, double& medianMs, double& p99Ms, std::string& renderer)
+	{
+		JsonReader::JSON_VALUE report;
+		std::string error;
+		if (JsonReader::ReadFile(filename.c_str(), report, error) == false)
+		{
+			std::cerr << "ERROR: " << error << std::endl;
+			return(false);
+		}
+
+		renderer = JsonReader::GetString(report, "renderer", "");
+		const JsonReader::JSON_VALUE* scenes = JsonReader::Find(report, "scenes");
+		if ((NULL == scenes) || (scenes->members.empty() == true))
+		{
+			return(false);
+		}
+		const JsonReader::JSON_VALUE& scene = scenes->members[0].second;
+		medianMs = JsonReader::GetNumber(scene, "median_frame_ms", 0.0);
+		p99Ms = JsonReader::GetNumber(scene, "p99_frame_ms", 0.0);
+		return(medianMs > 0.0);
+	}
+
+	const SCALING_CELL* FindCell(const std::vector<SCALING_CELL>& cells, const std::string& mode, const RESOLUTION& resolution, int threads)
+	{
+		for (const SCALING_CELL& cell : cells)
+		{
+			if ((cell.mode == mode) && (cell.threads == threads) &&
+				(cell.resolution.width == resolution.width) && (cell.resolution.height == resolution.height))
+			{
+				return((cell.bValid == true) ? &cell : NULL);
+			}
+		}
+		return(NULL);
+	}
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function runs the application's replay benchmark on
+ *  llvmpipe for every combination of thread count, resolution
+ *  and render mode.  It prints the frame times with the
+ *  speedup over the smallest thread count and the parallel
+ *  efficiency, and the fewest threads within 5% of the best
+ *  time for each resolution and mode.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <application> <input log> [--threads <list>]"
+			<< " [--resolutions <list>] [--modes <list>] [--runs <count>]"
+			<< " [--out-dir <directory>] [--json <file>] [--verbose]" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	const char* application = argv[1];
+	const char* inputLog = argv[2];
+	std::vector<std::string> threadList = SplitList("1,2,4,8");
+	std::vector<std::string> resolutionList = SplitList("640x480,1280x720,1920x1080");
+	std::vector<std::string> modes = SplitList("forward,depth_prepass");
+	int runs = 1;
+	std::string outputDir = "scaling";
+	const char* jsonFile = NULL;
+	bool bVerbose = false;
+	for (int i = 3; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+		{
+			threadList = SplitList(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--resolutions") == 0) && (i + 1 < argc))
+		{
+			resolutionList = SplitList(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--modes") == 0) && (i + 1 < argc))
+		{
+			modes = SplitList(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--runs") == 0) && (i + 1 < argc))
+		{
+			runs = std::max(atoi(argv[++i]), 1);
+		}
+		else if ((strcmp(argv[i], "--out-dir") == 0) && (i + 1 < argc))
+		{
+			outputDir = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--json") == 0) && (i + 1 < argc))
+		{
+			jsonFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--verbose") == 0)
+		{
+			bVerbose = true;
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << std::endl;
+			return(EXIT_FAILURE);
+		}
+	}
+
+	std::vector<int> threadCounts;
+	for (const std::string& item : threadList)
+	{
+		int threads = atoi(item.c_str());
+		if (threads <= 0)
+		{
+			std::cerr << "Invalid thread count: " << item << std::endl;
+			return(EXIT_FAILURE);
+		}
+		threadCounts.push_back(threads);
+	}
+	std::sort(threadCounts.begin(), threadCounts.end());
+
+	std::vector<RESOLUTION> resolutions;
+	for (const std::string& item : resolutionList)
+	{
+		RESOLUTION resolution;
+		if ((sscanf(item.c_str(), "%dx%d", &resolution.width, &resolution.height) != 2) ||
+			(resolution.width <= 0) || (resolution.height <= 0))
+		{
+			std::cerr << "Invalid resolution: " << item << " (<width>x<height>)" << std::endl;
+			return(EXIT_FAILURE);
+		}
+		resolutions.push_back(resolution);
+	}
+
+	// the benchmark report of every run is kept for comparisons
+	mkdir(outputDir.c_str(), 0755);
+
+	std::vector<SCALING_CELL> cells;
+	std::string renderer;
+	for (const std::string& mode : modes)
+	{
+		for (const RESOLUTION& resolution : resolutions)
+		{
+			for (int threads : threadCounts)
+			{
+				SCALING_CELL cell;
+				cell.threads = threads;
+				cell.resolution = resolution;
+				cell.mode = mode;
+
+				std::string size = std::to_string(resolution.width) + "x" + std::to_string(resolution.height);
+				std::vector<double> medians;
+				std::vector<double> p99s;
+				for (int run = 0; run < runs; run++)
+				{
+					std::string report = outputDir + "/" + mode + "_" + size + "_t" + std::to_string(threads) +
+						"_r" + std::to_string(run) + ".json";
+					std::vector<std::string> arguments =
+					{
+						"--headless",
+						"--submit", "changed",
+						"--resolution", size,
+						"--render-mode", mode,
+						"--replay", inputLog,
+						"--bench-json", report
+					};
+
+					printf("%-14s %-10s %2d threads, run %d ... ", mode.c_str(), size.c_str(), threads, run + 1);
+					fflush(stdout);
+
+					double medianMs = 0.0;
+					double p99Ms = 0.0;
+					if ((RunApplication(application, arguments, threads, bVerbose) == false) ||
+						(ReadBenchmark(report, medianMs, p99Ms, renderer) == false))
+					{
+						printf("failed\n");
+						continue;
+					}
+					printf("%.3f ms\n", medianMs);
+					medians.push_back(medianMs);
+					p99s.push_back(p99Ms);
+				}
+
+				if (medians.empty() == false)
+				{
+					cell.bValid = true;
+					cell.medianMs = Median(medians);
+					cell.p99Ms = Median(p99s);
+				}
+				cells.push_back(cell);
+			}
+		}
+	}
+
+	if (renderer.find("llvmpipe") == std::string::npos)
+	{
+		std::cout << "WARNING: The runs did not report llvmpipe as the renderer: " << renderer << std::endl;
+	}
+
+	// median frame time, speedup and efficiency against the
+	// smallest thread count of the same resolution and mode
+	for (const std::string& mode : modes)
+	{
+		printf("\n%s: median ms (speedup, efficiency)\n%-12s", mode.c_str(), "resolution");
+		for (int threads : threadCounts)
+		{
+			printf(" %20d", threads);
+		}
+		printf("  %s\n", "best threads");
+
+		for (const RESOLUTION& resolution : resolutions)
+		{
+			char size[32];
+			snprintf(size, sizeof(size), "%dx%d", resolution.width, resolution.height);
+			printf("%-12s", size);
+
+			const SCALING_CELL* pBase = FindCell(cells, mode, resolution, threadCounts[0]);
+			double bestMs = 0.0;
+			for (int threads : threadCounts)
+			{
+				const SCALING_CELL* pCell = FindCell(cells, mode, resolution, threads);
+				if (NULL == pCell)
+				{
+					printf(" %20s", "-");
+					continue;
+				}
+				bestMs = (bestMs == 0.0) ? pCell->medianMs : std::min(bestMs, pCell->medianMs);
+
+				char text[64];
+				if (NULL != pBase)
+				{
+					double speedup = pBase->medianMs / pCell->medianMs;
+					double efficiency = speedup * threadCounts[0] / threads;
+					snprintf(text, sizeof(text), "%.2f (%.2fx, %3.0f%%)", pCell->medianMs, speedup, efficiency * 100.0);
+				}
+				else
+				{
+					snprintf(text, sizeof(text), "%.2f", pCell->medianMs);
+				}
+				printf(" %20s", text);
+			}
+
+			// the fewest threads that get within 5% of the best time
+			int bestThreads = 0;
+			for (int threads : threadCounts)
+			{
+				const SCALING_CELL* pCell = FindCell(cells, mode, resolution, threads);
+				if ((NULL != pCell) && (pCell->medianMs <= bestMs * 1.05))
+				{
+					bestThreads = threads;
+					break;
+				}
+			}
+			printf("  %d\n", bestThreads);
+		}
+	}
+
+	if (NULL != jsonFile)
+	{
+		FILE* file = fopen(jsonFile, "w");
+		if (NULL == file)
+		{
+			std::cerr << "Could not write scaling report:" << jsonFile << std::endl;
+			return(EXIT_FAILURE);
+		}
+		fprintf(file, "{\n  \"renderer\": \"");
+		for (char c : renderer)
+		{
+			fputc(((c == '"') || (c == '\\')) ? '\'' : c, file);
+		}
+		fprintf(file, "\",\n  \"runs\": %d,\n  \"results\": [", runs);
+		bool bFirst = true;
+		for (const SCALING_CELL& cell : cells)
+		{
+			if (cell.bValid == false)
+			{
+				continue;
+			}
+			fprintf(file, "%s\n    { \"mode\": \"%s\", \"width\": %d, \"height\": %d, \"threads\": %d,"
+				" \"median_frame_ms\": %.4f, \"p99_frame_ms\": %.4f, \"megapixels_per_second\": %.3f }",
+				bFirst ? "" : ",",
+				cell.mode.c_str(),
+				cell.resolution.width,
+				cell.resolution.height,
+				cell.threads,
+				cell.medianMs,
+				cell.p99Ms,
+				(double)cell.resolution.width * cell.resolution.height / (cell.medianMs * 1000.0));
+			bFirst = false;
+		}
+		fprintf(file, "\n  ]\n}\n");
+		fclose(file);
+	}
+
+	return(EXIT_SUCCESS);
+}
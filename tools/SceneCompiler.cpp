@@ -0,0 +1,382 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecompiler.cpp
+// ============
+// compile a scene description file into a binary scene or a C++ header
+//
+//  Built from this file with src/SceneBinary.cpp, src/SceneFile.cpp,
+//  src/JsonStream.cpp, src/ShapeGeometry.cpp and src/MeshOptimizer.cpp,
+//  against the GLEW and GLM headers:
+//  SceneCompiler <scene.json> <scene.scnb | BakedScene.h> [--cpp]
+//  [--floor-tiles <count>] [--sector-size <size>] [--time-load]
+//  [--mesh-stats]
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBinary.h"
+#include "SceneBake.h"
+#include "ShapeGeometry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double MillisecondsSince(Clock::time_point start)
+	{
+		return(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+	}
+
+	// add a square grid of floor tiles, with the texture and
+	// material of the first object, for measuring large scenes
+	void AddFloorTiles(SceneBinary::SCENE_SOURCE& source, unsigned int count)
+	{
+		const unsigned int side = (unsigned int)std::ceil(std::sqrt((double)count));
+		SceneFile::SCENE_OBJECT tile;
+		tile.mesh = SceneManager::MESH_PLANE;
+		tile.scale = glm::vec3(0.5f, 1.0f, 0.5f);
+		tile.rotation = glm::vec3(0.0f);
+		tile.color = glm::vec4(1.0f);
+		tile.UVscale = glm::vec2(1.0f);
+		if (source.objects.empty() == false)
+		{
+			tile.texture = source.objects[0].texture;
+			tile.material = source.objects[0].material;
+		}
+
+		source.objects.reserve(source.objects.size() + count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned int row = i / side;
+			unsigned int column = i % side;
+			tile.id = "floor_tile_" + std::to_string(i);
+			tile.position = glm::vec3(
+				(float)column - (float)side * 0.5f,
+				0.0f,
+				(float)row - (float)side * 0.5f);
+			source.objects.push_back(tile);
+		}
+	}
+
+	// write text as a C string literal
+	void WriteString(FILE* file, const std::string& text)
+	{
+		fputc('"', file);
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				fprintf(file, "\\%c", c);
+			}
+			else if ((unsigned char)c < 0x20)
+			{
+				fprintf(file, "\\%03o", (unsigned char)c);
+			}
+			else
+			{
+				fputc(c, file);
+			}
+		}
+		fputc('"', file);
+	}
+
+	// write floats as C literals that read back as the same values,
+	// with the fewest digits that do
+	void WriteFloats(FILE* file, const float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			char text[32] = {};
+			for (int digits = 6; digits <= 9; digits++)
+			{
+				snprintf(text, sizeof(text), "%.*g", digits, values[i]);
+				if (strtof(text, NULL) == values[i])
+				{
+					break;
+				}
+			}
+			bool bInteger = (strpbrk(text, ".e") == NULL);
+			fprintf(file, "%s%s%sf", (i > 0) ? ", " : "", text, bInteger ? ".0" : "");
+		}
+	}
+
+	// write the compiled scene as constexpr tables, with each
+	// model matrix left as a SceneBake::GetModelMatrix() call for
+	// the C++ compiler to evaluate
+	bool WriteBakedHeader(
+		const char* filename,
+		const char* sceneName,
+		const SceneBinary::SCENE_SOURCE& source,
+		const SceneBinary::COMPILED_SCENE& compiled)
+	{
+		FILE* file = fopen(filename, "w");
+		if (NULL == file)
+		{
+			return(false);
+		}
+
+		const char* strings = compiled.strings.data();
+		fprintf(file,
+			"///////////////////////////////////////////////////////////////////////////////\n"
+			"// bakedscene.h\n"
+			"// ============\n"
+			"// %s baked into constexpr tables\n"
+			"//\n"
+			"//  Generated by SceneCompiler --cpp, do not edit\n"
+			"///////////////////////////////////////////////////////////////////////////////\n"
+			"\n"
+			"#pragma once\n"
+			"\n"
+			"#include \"SceneBake.h\"\n"
+			"\n", sceneName);
+
+		// the tables keep one entry when empty, the counts tell
+		fprintf(file, "constexpr int g_BakedTextureCount = %zu;\n", compiled.textures.size());
+		fprintf(file, "constexpr SceneBake::BAKED_TEXTURE g_BakedTextures[] =\n{\n");
+		for (const SceneBinary::BINARY_TEXTURE& texture : compiled.textures)
+		{
+			fprintf(file, "\t{ ");
+			WriteString(file, strings + texture.tag);
+			fprintf(file, ", ");
+			WriteString(file, strings + texture.path);
+			fprintf(file, " },\n");
+		}
+		fprintf(file, "%s};\n\n", compiled.textures.empty() ? "\t{ \"\", \"\" }\n" : "");
+
+		fprintf(file, "constexpr int g_BakedMaterialCount = %zu;\n", compiled.materials.size());
+		fprintf(file, "constexpr SceneBake::BAKED_MATERIAL g_BakedMaterials[] =\n{\n");
+		for (const SceneBinary::BINARY_MATERIAL& material : compiled.materials)
+		{
+			fprintf(file, "\t{ ");
+			WriteString(file, strings + material.tag);
+			fprintf(file, ", { ");
+			WriteFloats(file, material.ambientColor, 3);
+			fprintf(file, " }, ");
+			WriteFloats(file, &material.ambientStrength, 1);
+			fprintf(file, ", { ");
+			WriteFloats(file, material.diffuseColor, 3);
+			fprintf(file, " }, { ");
+			WriteFloats(file, material.specularColor, 3);
+			fprintf(file, " }, ");
+			WriteFloats(file, &material.shininess, 1);
+			fprintf(file, " },\n");
+		}
+		fprintf(file, "%s};\n\n", compiled.materials.empty() ? "\t{ \"\" }\n" : "");
+
+		fprintf(file, "constexpr int g_BakedLightCount = %zu;\n", compiled.lights.size());
+		fprintf(file, "constexpr SceneBake::BAKED_LIGHT g_BakedLights[] =\n{\n");
+		for (const SceneBinary::BINARY_LIGHT& light : compiled.lights)
+		{
+			fprintf(file, "\t{ { ");
+			WriteFloats(file, light.position, 3);
+			fprintf(file, " }, { ");
+			WriteFloats(file, light.ambientColor, 3);
+			fprintf(file, " }, { ");
+			WriteFloats(file, light.diffuseColor, 3);
+			fprintf(file, " }, { ");
+			WriteFloats(file, light.specularColor, 3);
+			fprintf(file, " }, ");
+			const float values[3] = { light.focalStrength, light.specularIntensity, light.radius };
+			WriteFloats(file, values, 3);
+			fprintf(file, " },\n");
+		}
+		fprintf(file, "%s};\n\n", compiled.lights.empty() ? "\t{}\n" : "");
+
+		fprintf(file, "constexpr int g_BakedDrawCount = %zu;\n", source.objects.size());
+		fprintf(file, "constexpr SceneBake::BAKED_DRAW g_BakedDraws[] =\n{\n");
+		for (size_t i = 0; i < source.objects.size(); i++)
+		{
+			const SceneFile::SCENE_OBJECT& object = source.objects[i];
+			fprintf(file, "\t// %s\n\t{\n", object.id.c_str());
+			fprintf(file, "\t\tSceneBake::GetModelMatrix(\n\t\t\t");
+			WriteFloats(file, &object.scale.x, 3);
+			fprintf(file, ",\n\t\t\t");
+			WriteFloats(file, &object.rotation.x, 3);
+			fprintf(file, ",\n\t\t\t");
+			WriteFloats(file, &object.position.x, 3);
+			fprintf(file, "),\n\t\t{ ");
+			WriteFloats(file, &compiled.colors[i].x, 4);
+			fprintf(file, " }, { ");
+			WriteFloats(file, &compiled.UVscales[i].x, 2);
+			fprintf(file, " },\n\t\t%u, %d, %d, %uu\n\t},\n",
+				compiled.meshes[i], compiled.textureIDs[i],
+				compiled.materialIDs[i], compiled.stateBits[i]);
+		}
+		fprintf(file, "%s};\n\n", source.objects.empty() ? "\t{}\n" : "");
+
+		// the ids of the draws, in the same order
+		fprintf(file, "constexpr const char* g_BakedDrawIDs[] =\n{\n");
+		for (const SceneFile::SCENE_OBJECT& object : source.objects)
+		{
+			fprintf(file, "\t");
+			WriteString(file, object.id);
+			fprintf(file, ",\n");
+		}
+		fprintf(file, "%s};\n", source.objects.empty() ? "\t\"\"\n" : "");
+
+		return(fclose(file) == 0);
+	}
+
+	// map the compiled scene and read every object's bounds, as
+	// a first frame would, timing the map and the first touch
+	bool TimeLoad(const char* filename)
+	{
+		SceneBinary scene;
+
+		Clock::time_point start = Clock::now();
+		if (scene.Open(filename) == false)
+		{
+			std::cerr << "Could not map " << filename << ": " << scene.GetError() << std::endl;
+			return(false);
+		}
+		double openMs = MillisecondsSince(start);
+
+		start = Clock::now();
+		const glm::vec3* pBoundsMin = scene.GetBoundsMin();
+		const glm::mat4* pTransforms = scene.GetTransforms();
+		float checksum = 0.0f;
+		for (uint32_t i = 0; i < scene.GetObjectCount(); i++)
+		{
+			checksum += pBoundsMin[i].y + pTransforms[i][3][1];
+		}
+		double touchMs = MillisecondsSince(start);
+
+		printf("map %.3f ms, first read of %u objects in %u sectors %.3f ms (checksum %g)\n",
+			openMs, scene.GetObjectCount(), scene.GetSectorCount(), touchMs, checksum);
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function reads the scene description file, compiles
+ *  it and writes the binary scene, or the baked scene header
+ *  with --cpp.  --mesh-stats also builds the shapes the scene
+ *  draws, printing their cache and fetch statistics before
+ *  and after optimization.  Exit codes: 0 written,
+ *  1 the scene could not be read or written.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <scene.json> <scene.scnb | BakedScene.h> [--cpp]"
+			<< " [--floor-tiles <count>] [--sector-size <size>] [--time-load] [--mesh-stats]" << std::endl;
+		return(1);
+	}
+
+	unsigned int floorTiles = 0;
+	float sectorSize = 0.0f;
+	bool bTimeLoad = false;
+	bool bBakedHeader = false;
+	bool bMeshStats = false;
+	for (int i = 3; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--floor-tiles") == 0) && (i + 1 < argc))
+		{
+			floorTiles = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+		else if ((strcmp(argv[i], "--sector-size") == 0) && (i + 1 < argc))
+		{
+			sectorSize = (float)atof(argv[++i]);
+			if (sectorSize <= 0.0f)
+			{
+				std::cerr << "Invalid sector size: " << argv[i] << std::endl;
+				return(1);
+			}
+		}
+		else if (strcmp(argv[i], "--time-load") == 0)
+		{
+			bTimeLoad = true;
+		}
+		else if (strcmp(argv[i], "--cpp") == 0)
+		{
+			bBakedHeader = true;
+		}
+		else if (strcmp(argv[i], "--mesh-stats") == 0)
+		{
+			bMeshStats = true;
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << std::endl;
+			return(1);
+		}
+	}
+
+	// the baked draws keep the order of the scene file, which
+	// the baked scene check compares them with
+	if ((bBakedHeader == true) && (sectorSize > 0.0f))
+	{
+		std::cerr << "--sector-size only applies to binary scenes" << std::endl;
+		return(1);
+	}
+
+	SceneBinary::SCENE_SOURCE source;
+	std::string error;
+
+	Clock::time_point start = Clock::now();
+	if (SceneBinary::ReadSource(argv[1], source, error) == false)
+	{
+		std::cerr << "Could not read " << argv[1] << ": " << error << std::endl;
+		return(1);
+	}
+	double readMs = MillisecondsSince(start);
+	AddFloorTiles(source, floorTiles);
+
+	// the baked draws are written from the transforms of the
+	// file, which prefab parts do not have on their own; static
+	// objects are baked as the others, in file order
+	if ((bBakedHeader == true) && (source.instances.empty() == false))
+	{
+		std::cerr << "Could not bake " << argv[1] << ": prefab instances can only be compiled into binary scenes" << std::endl;
+		return(1);
+	}
+
+	start = Clock::now();
+	if (bBakedHeader == true)
+	{
+		SceneBinary::COMPILED_SCENE compiled;
+		if (SceneBinary::Compile(source, compiled, error) == false)
+		{
+			std::cerr << "Could not compile " << argv[1] << ": " << error << std::endl;
+			return(1);
+		}
+		if (WriteBakedHeader(argv[2], argv[1], source, compiled) == false)
+		{
+			std::cerr << "Could not write " << argv[2] << std::endl;
+			return(1);
+		}
+	}
+	else if (SceneBinary::Write(argv[2], source, error, sectorSize) == false)
+	{
+		std::cerr << "Could not compile " << argv[1] << ": " << error << std::endl;
+		return(1);
+	}
+	double writeMs = MillisecondsSince(start);
+
+	size_t staticCount = (size_t)std::count_if(source.objects.begin(), source.objects.end(), SceneFile::IsStaticObject);
+	printf("%s: %zu objects, %zu of them static, %zu prefab instances, %zu textures, %zu materials, %zu lights\n",
+		argv[2], source.objects.size(), staticCount, source.instances.size(), source.textures.size(),
+		source.materials.size(), source.lights.size());
+	printf("read %.3f ms, compiled and written %.3f ms\n", readMs, writeMs);
+
+	if (bMeshStats == true)
+	{
+		ShapeGeometry::Prepare();
+	}
+
+	if ((bTimeLoad == true) && (bBakedHeader == false) && (TimeLoad(argv[2]) == false))
+	{
+		return(1);
+	}
+	return(0);
+}